@@ -1,8 +1,11 @@
 #include "Character.h"
+#include <algorithm>
 #include "Library/Timer.h"
 #include "Library/ImGui/ConsoleData.h"
 #include "Library/3D/DebugPrimitive.h"
+#include "Library/3D/Camera.h"
 #include "StageManager.h"
+#include "Library/MemoryTracker.h"
 
 // 行列更新処理
 void Character::UpdateTransform()
@@ -24,6 +27,33 @@ void Character::UpdateTransform()
 	DirectX::XMStoreFloat4x4(&transform, W);
 }
 
+// ノードのワールド座標取得
+DirectX::XMFLOAT3 Character::GetNodeWorldPosition(int64_t nodeIndex) const
+{
+	const Animation::KeyFrame& keyframe = model->animationClips.at(currentAnimationIndex).sequence.at(currentKeyFrame);
+	if (nodeIndex < 0 || nodeIndex >= static_cast<int64_t>(keyframe.nodes.size())) return { 0,0,0 };
+
+	// ノード番号で直接行列を参照する
+	const DirectX::XMFLOAT4X4& m = keyframe.nodes[nodeIndex].globalTransform;
+	DirectX::XMVECTOR P = DirectX::XMVectorSet(m._41, m._42, m._43, 1.0f);
+	P = DirectX::XMVector3TransformCoord(P, DirectX::XMLoadFloat4x4(&transform));
+
+	DirectX::XMFLOAT3 position;
+	DirectX::XMStoreFloat3(&position, P);
+	return position;
+}
+
+// 視錐台カリング用のワールド空間 AABB 取得
+bool Character::GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const
+{
+	if (!model || !model->GetWorldBounds(transform, center, extents)) return false;
+
+	extents.x *= boundsScale;
+	extents.y *= boundsScale;
+	extents.z *= boundsScale;
+	return true;
+}
+
 // ダメージを与える
 bool Character::ApplyDamage(int damage, float invincibleTime)
 {
@@ -444,26 +474,18 @@ void Character::UpdateEffect()
 	DirectX::XMFLOAT4X4 world;
 	DirectX::XMStoreFloat4x4(&world, C * S * R * T);
 
-	int effectCount = model->animationClips.at(currentAnimationIndex).animEffects.size();
+	const Animation& animation = model->animationClips.at(currentAnimationIndex);
 
-	for (int i = 0; i < effectCount; i++)
+	// 前回のフレームから通過したエフェクトだけ再生する
+	effectCursor.Advance(currentAnimationIndex, animation.effectTrack, currentKeyFrame, [&](uint32_t i)
 	{
-		// 既に再生されているなら再生しない
-		if (model->animationClips.at(currentAnimationIndex).animEffects.at(i).isPlay) continue;
-
-		int startFrame = model->animationClips.at(currentAnimationIndex).animEffects.at(i).startFrame;
-		int endFrame = model->animationClips.at(currentAnimationIndex).animEffects.at(i).endFrame;
-
-		//if (currentFrameInt < startFrame || currentFrameInt > endFrame) continue;
-		if (currentKeyFrame != startFrame) continue;
-
-		model->animationClips.at(currentAnimationIndex).animEffects.at(i).isPlay = true;
+		const AnimEffect& animEffect = animation.animEffects.at(i);
 
-		EffectType type = model->animationClips.at(currentAnimationIndex).animEffects.at(i).effectType;
-		float effectScale = model->animationClips.at(currentAnimationIndex).animEffects.at(i).scale;
+		EffectType type = animEffect.effectType;
+		float effectScale = animEffect.scale;
 
-		DirectX::XMFLOAT3 effectPosition = model->animationClips.at(currentAnimationIndex).animEffects.at(i).position;
-		DirectX::XMFLOAT3 effectAngle = model->animationClips.at(currentAnimationIndex).animEffects.at(i).angle;
+		DirectX::XMFLOAT3 effectPosition = animEffect.position;
+		DirectX::XMFLOAT3 effectAngle = animEffect.angle;
 
 		// 回転後のコリジョン位置を計算
 		DirectX::XMVECTOR effectPosVec = DirectX::XMLoadFloat3(&effectPosition);
@@ -490,18 +512,13 @@ void Character::UpdateEffect()
 		effectAngle.z += angle.z;
 
 		Effect::Instance().Play(type, effectPosition, effectAngle, effectScale);
-	}
+	});
 }
 
 // エフェクトフラグクリア
 void Character::ClearEffectFlag()
 {
-	int effectCount = model->animationClips.at(currentAnimationIndex).animEffects.size();
-
-	for (int i = 0; i < effectCount; i++)
-	{
-		model->animationClips.at(currentAnimationIndex).animEffects.at(i).isPlay = false;
-	}
+	effectCursor.Reset();
 }
 
 //==========================================================================
@@ -513,36 +530,25 @@ void Character::ClearEffectFlag()
 // 効果音更新処理
 void Character::UpdateSE()
 {
-	int seCount = model->animationClips.at(currentAnimationIndex).animSEs.size();
+	const Animation& animation = model->animationClips.at(currentAnimationIndex);
 
-	for (int i = 0; i < seCount; i++)
+	// 前回のフレームから通過した効果音だけ再生する
+	seCursor.Advance(currentAnimationIndex, animation.seTrack, currentKeyFrame, [&](uint32_t i)
 	{
-		// 既に再生されているなら再生しない
-		if (model->animationClips.at(currentAnimationIndex).animSEs.at(i).isPlay) continue;
-
-		int startFrame = model->animationClips.at(currentAnimationIndex).animSEs.at(i).startFrame;
-		int endFrame = model->animationClips.at(currentAnimationIndex).animSEs.at(i).endFrame;
-
-		//if (currentFrameInt < startFrame || currentFrameInt > endFrame) continue;
-		if (currentKeyFrame != startFrame) continue;
+		MUSIC_LABEL type = animation.animSEs.at(i).musicType;
 
-		model->animationClips.at(currentAnimationIndex).animSEs.at(i).isPlay = true;
+		// 同時再生数を超えた時にカメラから遠いものから止める
+		DirectX::XMVECTOR D = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&position), DirectX::XMLoadFloat3(&Camera::Instance().GetEye()));
+		float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(D));
 
-		MUSIC_LABEL type = model->animationClips.at(currentAnimationIndex).animSEs.at(i).musicType;
-
-		AudioManager::Instance().PlayMusic(static_cast<int>(type));
-	}
+		AudioManager::Instance().PlayMusic(static_cast<int>(type), false, distance);
+	});
 }
 
 // 効果音フラグクリア
 void Character::ClearSEFlag()
 {
-	int seCount = model->animationClips.at(currentAnimationIndex).animSEs.size();
-
-	for (int i = 0; i < seCount; i++)
-	{
-		model->animationClips.at(currentAnimationIndex).animSEs.at(i).isPlay = false;
-	}
+	seCursor.Reset();
 }
 
 //==========================================================================
@@ -554,58 +560,36 @@ void Character::ClearSEFlag()
 // アニメーション再生
 void Character::PlayAnimation(int index, bool loop)
 {
+	// 遷移前のアニメーションは遷移中も進め続ける
+	blendAnimationCurrentSeconds = currentAnimationSeconds;
+	blendAnimationLoopFlag = animationLoopFlag;
+
 	currentAnimationIndex = index;
 	currentAnimationSeconds = 0.0f;
+	currentKeyFrame = 0;
 
 	animationLoopFlag = loop;
 	animationEndFlag = false;
 
 	animationBlendTime = 0.0f;
 	animationBlendSeconds = 0.2f;
+	animationPoseDirty = true;
+
+	// イベントの再生位置を先頭へ
+	ClearEffectFlag();
+	ClearSEFlag();
 }
 
 // アニメーション更新
 void Character::UpdateAnimation()
 {
-	// 最終フレーム処理
-	if (animationEndFlag) return;
-
-
-	if (blendAnimationIndex != -1)
-	{
-		// ブレンド率の計算
-		float blendRate = 1.0f;
-		if (animationBlendTime < animationBlendSeconds)
-		{
-			animationBlendTime += Timer::Instance().DeltaTime();
-			if (animationBlendTime >= animationBlendSeconds)
-			{
-				animationBlendTime = animationBlendSeconds;
-			}
-			blendRate = animationBlendTime / animationBlendSeconds;
-			blendRate *= blendRate;
-
-			Animation& blendAnimation = model->animationClips.at(blendAnimationIndex);
-			int blendAnimationMaxKeyFrame = blendAnimation.sequence.size() - 1;
-			Animation& currentAnimation = model->animationClips.at(currentAnimationIndex);
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::ANIMATION);
 
-			Animation::KeyFrame keyframe;
-			const Animation::KeyFrame* keyframes[2] =
-			{
-				&blendAnimation.sequence.at(blendAnimationMaxKeyFrame),
-				&currentAnimation.sequence.at(0)
-			};
-			model->BlendAnimations(keyframes, blendRate, keyFrame);
-			model->UpdateAnimation(keyFrame);
-
-			return;
-		}
-		else
-		{
-			blendAnimationIndex = -1;
-		}
-	}
+	// LOD 判定 (再生を終えたキャラクターも段階を更新して数える)
+	UpdateAnimationLod();
 
+	// 最終フレーム処理
+	if (animationEndFlag) return;
 
 	Animation& animation = model->animationClips.at(currentAnimationIndex);
 
@@ -620,24 +604,128 @@ void Character::UpdateAnimation()
 			// 先頭秒数へ
 			currentKeyFrame = 0;
 			currentAnimationSeconds -= animation.secondsLength;
+
+			// エフェクトフラグのクリア
+			ClearEffectFlag();
+			// 効果音フラグのクリア
+			ClearSEFlag();
 		}
 		else
 		{
-			// 最終秒数で停止
+			// 最終秒数で停止 (再生位置はそのまま、最終フレームまでのイベントを再生する)
 			currentKeyFrame = animation.sequence.size() - 1;
 			currentAnimationSeconds = animation.secondsLength;
 			animationEndFlag = true;
 		}
-		// エフェクトフラグのクリア
-		ClearEffectFlag();
-		// 効果音フラグのクリア
-		ClearSEFlag();
 	}
 
+	// 遷移中は遷移前のアニメーションも時間を進めておく
+	bool blending = false;
+	if (blendAnimationIndex != -1)
+	{
+		animationBlendTime += Timer::Instance().DeltaTime();
+		blendAnimationCurrentSeconds += Timer::Instance().DeltaTime();
+		if (animationBlendTime >= animationBlendSeconds)
+		{
+			blendAnimationIndex = -1;
+		}
+		else
+		{
+			blending = true;
+		}
+	}
+
+	// ポーズの更新を LOD に応じて間引く (時間とイベントは上で進めている)
+	const AnimationLodPolicy& policy = model->animationLodPolicy;
+	if (animationLod == AnimationLod::Culled && !keyFrame.nodes.empty()) return;
+	if (!animationPoseDirty)
+	{
+		int interval = 1;
+		if (animationLod == AnimationLod::Reduced) interval = policy.reducedInterval;
+		if (animationLod == AnimationLod::Far) interval = policy.farInterval;
+
+		if (++animationLodFrame % (std::max)(interval, 1) != 0) return;
+	}
+	animationPoseDirty = false;
+
 	// keyFrame設定
 	keyFrame = animation.sequence.at(currentKeyFrame);
+
+	// 遷移中は遷移前・遷移後の両方を再生したままブレンドする
+	if (blending && (animationLod != AnimationLod::Far || policy.blendOnFar))
+	{
+		// ブレンド率の計算
+		float blendRate = animationBlendTime / animationBlendSeconds;
+		blendRate *= blendRate;
+
+		// ブレンドツリーは最初の遷移で組み立てて使い回す (クリップと時間・重みだけ毎回書き換える)
+		if (transitionFromNode < 0)
+		{
+			transitionFromNode = transitionTree.AddClip(blendAnimationIndex);
+			transitionToNode = transitionTree.AddClip(currentAnimationIndex);
+			transitionBlendNode = transitionTree.AddBlend({ transitionFromNode, transitionToNode }, { 1.0f, 0.0f });
+		}
+
+		AnimationBlendTree::Node& fromNode = transitionTree.GetNode(transitionFromNode);
+		fromNode.clipIndex = blendAnimationIndex;
+		fromNode.seconds = blendAnimationCurrentSeconds;
+		fromNode.loop = blendAnimationLoopFlag;
+
+		AnimationBlendTree::Node& toNode = transitionTree.GetNode(transitionToNode);
+		toNode.clipIndex = currentAnimationIndex;
+		toNode.seconds = currentAnimationSeconds;
+		toNode.loop = animationLoopFlag;
+
+		AnimationBlendTree::Node& blendNode = transitionTree.GetNode(transitionBlendNode);
+		blendNode.weights[0] = 1.0f - blendRate;
+		blendNode.weights[1] = blendRate;
+
+		transitionTree.Evaluate(*model, keyFrame);
+
+		model->UpdateAnimation(keyFrame);
+	}
 }
 
+// アニメーション LOD 判定
+void Character::UpdateAnimationLod()
+{
+	const AnimationLod oldLod = animationLod;
+	const Camera& camera = Camera::Instance();
+
+	// 円柱を囲む球で画面内判定
+	const float boundingRadius = (std::max)(radius, height * 0.5f) * (std::max)(scale.x, (std::max)(scale.y, scale.z));
+	const DirectX::XMFLOAT3 center = { position.x, position.y + height * 0.5f, position.z };
+
+	if (!camera.GetFrustum().IntersectSphere(center, boundingRadius))
+	{
+		animationLod = AnimationLod::Culled;
+	}
+	else
+	{
+		// カメラからの距離で段階を決める
+		const DirectX::XMFLOAT3& eye = camera.GetEye();
+		const float dx = center.x - eye.x;
+		const float dy = center.y - eye.y;
+		const float dz = center.z - eye.z;
+		const float distanceSq = dx * dx + dy * dy + dz * dz;
+
+		const AnimationLodPolicy& policy = model->animationLodPolicy;
+		if (distanceSq > policy.farDistance * policy.farDistance)				animationLod = AnimationLod::Far;
+		else if (distanceSq > policy.reducedDistance * policy.reducedDistance)	animationLod = AnimationLod::Reduced;
+		else																	animationLod = AnimationLod::Full;
+	}
+
+	// 画面外から戻った・近づいた場合はすぐにポーズを作り直す
+	if (animationLod < oldLod) animationPoseDirty = true;
+
+	animationLodCounts[static_cast<int>(animationLod)]++;
+}
+
+// 段階ごとのアニメーション更新数をクリア
+void Character::ResetAnimationLodCounts()
+{
+	for (int& count : animationLodCounts) count = 0;
+}
 
 //==========================================================================
 //
@@ -650,15 +738,10 @@ void Character::DrawDebugPrimitive()
 	// --- コリジョン描画 ---
 	if (model && model->animationClips.size() > 0)
 	{
-		// sphere
-		int collisionCount = model->animationClips.at(currentAnimationIndex).spheres.size();
-
-		for (int i = 0; i < collisionCount; i++)
+		// sphere (現在のフレームで有効なものだけ)
+		model->animationClips.at(currentAnimationIndex).sphereTrack.ForEachActive(currentKeyFrame, [&](const AnimationEventTrack::Event& sphereEvent)
 		{
-			int startFrame = model->animationClips.at(currentAnimationIndex).spheres.at(i).startFrame;
-			int endFrame = model->animationClips.at(currentAnimationIndex).spheres.at(i).endFrame;
-
-			if (currentKeyFrame < startFrame || currentKeyFrame > endFrame) continue;
+			int i = sphereEvent.index;
 
 			float radius = model->animationClips.at(currentAnimationIndex).spheres.at(i).radius;
 			DirectX::XMFLOAT4 color = model->animationClips.at(currentAnimationIndex).spheres.at(i).color;
@@ -668,26 +751,8 @@ void Character::DrawDebugPrimitive()
 
 			if (model->animationClips.at(currentAnimationIndex).spheres.at(i).bindBoneName != "")
 			{
-				Animation::KeyFrame& keyframe = model->animationClips.at(currentAnimationIndex).sequence.at(currentKeyFrame);
-
-				int nodeCount = keyframe.nodes.size();
-				for (int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
-				{
-					Animation::KeyFrame::Node& node = keyframe.nodes.at(nodeIndex);
-
-					// ボーンのノードと同じ名前なら処理する
-					if (node.name != model->animationClips.at(currentAnimationIndex).spheres.at(i).bindBoneName) continue;
-
-					DirectX::XMMATRIX T = DirectX::XMLoadFloat4x4(&transform);
-					DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&node.globalTransform);
-
-					DirectX::XMMATRIX W = M * T;
-					DirectX::XMFLOAT4X4 w;
-					DirectX::XMStoreFloat4x4(&w, W);
-
-					collisionPosition = { w._41, w._42, w._43 };
-					break;
-				}
+				// ボーンのノード番号から位置を取得
+				collisionPosition = GetNodeWorldPosition(model->animationClips.at(currentAnimationIndex).spheres.at(i).bindNodeIndex);
 			}
 			else
 			{
@@ -720,6 +785,6 @@ void Character::DrawDebugPrimitive()
 			}
 
 			DebugPrimitive::Instance().AddSphere(collisionPosition, radius, color);
-		}
+		});
 	}
 }
@@ -2,8 +2,20 @@
 #include <DirectXMath.h>
 #include <memory>
 #include "Library/3D/SkinnedMesh.h"
+#include "Library/3D/AnimationBlendTree.h"
 #include "Library/Effekseer/Effect.h"
 
+// アニメーションの LOD 段階
+enum class AnimationLod
+{
+	Full,		// 毎フレーム更新
+	Reduced,	// 間引いて更新
+	Far,		// さらに間引いて更新 (遷移ブレンドなし)
+	Culled,		// 画面外 (時間とイベントだけ進める)
+
+	Count,
+};
+
 class Character
 {
 public:
@@ -46,6 +58,20 @@ public:
 
 	
 
+	// アニメーション LOD 取得
+	AnimationLod GetAnimationLod() const { return animationLod; }
+
+	// 段階ごとのアニメーション更新数 (ResetAnimationLodCounts から数えたもの)
+	static int GetAnimationLodCount(AnimationLod lod) { return animationLodCounts[static_cast<int>(lod)]; }
+	// 段階ごとのアニメーション更新数をクリア (毎フレーム更新前に呼ぶ)
+	static void ResetAnimationLodCounts();
+
+	// ノードのワールド座標取得 (当たり判定用、nodeIndex が無効なら原点)
+	DirectX::XMFLOAT3 GetNodeWorldPosition(int64_t nodeIndex) const;
+
+	// 視錐台カリング用のワールド空間 AABB 取得 (モデルがなければ false)
+	bool GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const;
+
 	// ダメージを与える
 	bool ApplyDamage(int damage, float invincibleTime);
 	// 衝撃を与える
@@ -91,7 +117,7 @@ protected:
 
 	// エフェクト更新処理
 	void UpdateEffect();
-	// エフェクトフラグクリア
+	// エフェクトフラグクリア (再生位置を先頭に戻す)
 	void ClearEffectFlag();
 
 	//--------------------------------------------------------------
@@ -100,7 +126,7 @@ protected:
 
 	// 効果音更新処理
 	void UpdateSE();
-	// 効果音フラグクリア
+	// 効果音フラグクリア (再生位置を先頭に戻す)
 	void ClearSEFlag();
 
 	//--------------------------------------------------------------
@@ -111,6 +137,8 @@ protected:
 	void PlayAnimation(int index, bool loop);
 	// アニメーション更新
 	void UpdateAnimation();
+	// アニメーション LOD 判定
+	void UpdateAnimationLod();
 
 	//--------------------------------------------------------------
 	//  デバッグ描画
@@ -147,6 +175,9 @@ protected:
 	float moveVecX = 0.0f;
 	float moveVecZ = 0.0f;
 
+	// バインドポーズの AABB に掛ける倍率 (アニメーションではみ出す分の余裕)
+	float boundsScale = 1.25f;
+
 	// RayCastのオフセット
 	float stepOffset = 0.5f;
 	float stepOffset1 = 0.1f;
@@ -167,4 +198,23 @@ public:
 	float animationBlendTime = 0.0f;
 	float animationBlendSeconds = 0.0f;
 	int blendAnimationIndex = -1;			// 遷移前のアニメーション番号
+	float blendAnimationCurrentSeconds = 0.0f;	// 遷移前のアニメーションの再生秒数
+	bool blendAnimationLoopFlag = true;		// 遷移前のアニメーションがループするか
+	AnimationBlendTree transitionTree;		// 遷移用のブレンドツリー (遷移前・遷移後のクリップを Blend でまとめる)
+	int transitionFromNode = -1;			// 遷移前のクリップのノード番号
+	int transitionToNode = -1;				// 遷移後のクリップのノード番号
+	int transitionBlendNode = -1;			// 2 つをまとめる Blend のノード番号
+
+	// --- アニメーション LOD ---
+	AnimationLod animationLod = AnimationLod::Full;
+	int animationLodFrame = animationLodPhase++;	// 間引きのフレームカウンタ (インスタンスごとにずらす)
+	bool animationPoseDirty = true;			// 次の更新で必ずポーズを作り直す
+
+	// --- アニメーションイベント (インスタンスごと) ---
+	AnimationEventCursor effectCursor;		// エフェクトの再生位置
+	AnimationEventCursor seCursor;			// 効果音の再生位置
+
+private:
+	static inline int animationLodPhase = 0;
+	static inline int animationLodCounts[static_cast<int>(AnimationLod::Count)] = {};
 };
\ No newline at end of file
@@ -83,147 +83,30 @@ bool Collision::IntersectSphereVsCylinder(const DirectX::XMFLOAT3& spherePositio
 // レイとモデルの交差判定
 bool Collision::IntersectRayVsModel(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, const SkinnedMesh* model, HitResult& result)
 {
-    // ワールド空間でのレイベクトルを求める
-    DirectX::XMVECTOR WorldStart = DirectX::XMLoadFloat3(&start);
-    DirectX::XMVECTOR WorldEnd = DirectX::XMLoadFloat3(&end);
-    DirectX::XMVECTOR WorldRayVec = DirectX::XMVectorSubtract(WorldEnd, WorldStart);
-    DirectX::XMVECTOR WorldRayLength = DirectX::XMVector3Length(WorldRayVec);
+    // サイズの修正
+    const float scaleFactor = model->scaleFactors[model->fbxUnit];
+    DirectX::XMMATRIX C = DirectX::XMLoadFloat4x4(&model->coordinateSystemTransform[model->coordinateSystemIndex]) * DirectX::XMMatrixScaling(scaleFactor, scaleFactor, scaleFactor);
 
-    // ワールド空間のレイの長さ
-    DirectX::XMStoreFloat(&result.distance, WorldRayLength);
+    DirectX::XMFLOAT4X4 transform;
+    DirectX::XMStoreFloat4x4(&transform, C);
 
-    bool hit = false;
-    for (const SkinnedMesh::Mesh& mesh : model->meshes)
-    {
-        // レイをワールド空間からローカル空間へ変換
-        
-        // サイズの修正
-        const float scaleFactor = model->scaleFactors[model->fbxUnit];
-        DirectX::XMMATRIX C = DirectX::XMLoadFloat4x4(&model->coordinateSystemTransform[model->coordinateSystemIndex]) * DirectX::XMMatrixScaling(scaleFactor, scaleFactor, scaleFactor);
-        DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&mesh.defaultGlobalTransform);
-
-        // メッシュのワールド行列と逆行列を求める
-        DirectX::XMMATRIX WorldTransform = M * C;
-        DirectX::XMMATRIX InverseWorldTransform = DirectX::XMMatrixInverse(nullptr, WorldTransform);
-
-        // レイベクトルをメッシュ空間に変換
-        DirectX::XMVECTOR S = DirectX::XMVector3TransformCoord(WorldStart, InverseWorldTransform);
-        DirectX::XMVECTOR E = DirectX::XMVector3TransformCoord(WorldEnd, InverseWorldTransform);
-        DirectX::XMVECTOR SE = DirectX::XMVectorSubtract(E, S);
-        DirectX::XMVECTOR V = DirectX::XMVector3Normalize(SE);
-        DirectX::XMVECTOR Length = DirectX::XMVector3Length(SE);
-
-        // メッシュ空間でのレイの長さ
-        float neart;
-        DirectX::XMStoreFloat(&neart, Length);
-
-        // 三角形（面）との交差判定
-        const std::vector<SkinnedMesh::Vertex>& vertices = mesh.vertices;
-        const std::vector<UINT> indices = mesh.indices;
-
-        int materialIndex = -1;
-        DirectX::XMVECTOR HitPosition;
-        DirectX::XMVECTOR HitNormal;
-        for (const SkinnedMesh::Mesh::Subset& subset : mesh.subsets)
-        {
-            for (UINT i = 0; i < subset.indexCount; i += 3)
-            {
-                UINT index = subset.startIndexLocation + i;
-
-                // 三角形の頂点を抽出
-                const SkinnedMesh::Vertex& a = vertices.at(indices.at(index));
-                const SkinnedMesh::Vertex& b = vertices.at(indices.at(index+1));
-                const SkinnedMesh::Vertex& c = vertices.at(indices.at(index+2));
-
-                DirectX::XMVECTOR A = DirectX::XMLoadFloat3(&a.position);
-                DirectX::XMVECTOR B = DirectX::XMLoadFloat3(&b.position);
-                DirectX::XMVECTOR C = DirectX::XMLoadFloat3(&c.position);
-
-                // 三角形の三辺ベクトルを算出
-                DirectX::XMVECTOR AB = DirectX::XMVectorSubtract(B, A);
-                DirectX::XMVECTOR BC = DirectX::XMVectorSubtract(C, B);
-                DirectX::XMVECTOR CA = DirectX::XMVectorSubtract(A, C);
-
-                // 三角形の法線ベクトルを算出
-                DirectX::XMVECTOR N = DirectX::XMVector3Cross(AB, BC);
-
-                // 内積の結果がプラスならば裏向き
-                DirectX::XMVECTOR Dot = DirectX::XMVector3Dot(V, N);
-                float dot;
-                DirectX::XMStoreFloat(&dot, Dot);
-                if (dot >= 0) continue;
-
-                // レイと平面の交点を算出
-                DirectX::XMVECTOR SA = DirectX::XMVectorSubtract(A, S); // レイの開始点から点Ａへのベクトル
-                DirectX::XMVECTOR X = DirectX::XMVectorDivide(DirectX::XMVector3Dot(SA, N), Dot);
-                float x;
-                DirectX::XMStoreFloat(&x, X);
-                if (x < 0.0f || x > neart) continue;
-
-                DirectX::XMVECTOR P = DirectX::XMVectorAdd(S, DirectX::XMVectorScale(V, x));
-
-                // 交点が三角形の内側にあるか判定
-                // １つめ
-                DirectX::XMVECTOR PA = DirectX::XMVectorSubtract(A, P);
-                DirectX::XMVECTOR Cross1 = DirectX::XMVector3Cross(PA, AB);
-                DirectX::XMVECTOR Dot1 = DirectX::XMVector3Dot(Cross1, N);
-                float dot1;
-                DirectX::XMStoreFloat(&dot1, Dot1);
-                if (dot1 < 0.0f) continue;
-
-                // ２つめ
-                DirectX::XMVECTOR PB = DirectX::XMVectorSubtract(B, P);
-                DirectX::XMVECTOR Cross2 = DirectX::XMVector3Cross(PB, BC);
-                DirectX::XMVECTOR Dot2 = DirectX::XMVector3Dot(Cross2, N);
-                float dot2;
-                DirectX::XMStoreFloat(&dot2, Dot2);
-                if (dot2 < 0.0f) continue;
-
-                // ３つめ
-                DirectX::XMVECTOR PC = DirectX::XMVectorSubtract(C, P);
-                DirectX::XMVECTOR Cross3 = DirectX::XMVector3Cross(PC, CA);
-                DirectX::XMVECTOR Dot3 = DirectX::XMVector3Dot(Cross3, N);
-                float dot3;
-                DirectX::XMStoreFloat(&dot3, Dot3);
-                if (dot3 < 0.0f) continue;
-
-                // 最短距離を更新
-                neart = x;
-
-                // 交点と法線を更新
-                HitPosition = P;
-                HitNormal = N;
-                materialIndex = subset.materialUniqueId;
-            }
-        }
-        if (materialIndex >= 0)
-        {
-            // メッシュ空間からワールド空間へ変換
-            DirectX::XMVECTOR WorldPosition = DirectX::XMVector3TransformCoord(HitPosition, WorldTransform);
-            DirectX::XMVECTOR WorldCrossVec = DirectX::XMVectorSubtract(WorldPosition, WorldStart);
-            DirectX::XMVECTOR WorldCrossLength = DirectX::XMVector3Length(WorldCrossVec);
-            float distance;
-            DirectX::XMStoreFloat(&distance, WorldCrossLength);
-
-            // ヒット情報保存（レイに当たった中で一番近い面で処理を行う）
-            if (result.distance > distance)
-            {
-                DirectX::XMVECTOR WorldNormal = DirectX::XMVector3TransformNormal(HitNormal, WorldTransform);
-
-                result.distance = distance;
-                result.materialIndex = materialIndex;
-                DirectX::XMStoreFloat3(&result.position, WorldPosition);
-                DirectX::XMStoreFloat3(&result.normal, DirectX::XMVector3Normalize(WorldNormal));
-                hit = true;
-            }
-        }
-    }
-
-    return hit;
+    return IntersectRayVsCollisionMesh(start, end, model->collisionMesh, transform, result);
 }
 
 // レイとモデルの交差判定
 bool Collision::IntersectRayVsModel(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, const SkinnedMesh* model, const DirectX::XMFLOAT4X4& transform, HitResult& result)
+{
+    return IntersectRayVsCollisionMesh(start, end, model->collisionMesh, transform, result);
+}
+
+// レイと当たり判定メッシュの交差判定
+bool Collision::IntersectRayVsCollisionMesh(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, const CollisionMesh& collisionMesh, HitResult& result)
+{
+    return IntersectRayVsCollisionMesh(start, end, collisionMesh, collisionMesh.systemTransform, result);
+}
+
+// レイと当たり判定メッシュの交差判定
+bool Collision::IntersectRayVsCollisionMesh(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, const CollisionMesh& collisionMesh, const DirectX::XMFLOAT4X4& transform, HitResult& result)
 {
     // ワールド空間でのレイベクトルを求める
     DirectX::XMVECTOR WorldStart = DirectX::XMLoadFloat3(&start);
@@ -234,131 +117,104 @@ bool Collision::IntersectRayVsModel(const DirectX::XMFLOAT3& start, const Direct
     // ワールド空間のレイの長さ
     DirectX::XMStoreFloat(&result.distance, WorldRayLength);
 
-    bool hit = false;
-    for (const SkinnedMesh::Mesh& mesh : model->meshes)
+    // 三角形はモデル空間に焼き込み済みなので、逆行列はレイ１本につき１回だけ求める
+    DirectX::XMMATRIX WorldTransform = DirectX::XMLoadFloat4x4(&transform);
+    DirectX::XMMATRIX InverseWorldTransform = DirectX::XMMatrixInverse(nullptr, WorldTransform);
+
+    // レイベクトルをモデル空間に変換
+    DirectX::XMVECTOR S = DirectX::XMVector3TransformCoord(WorldStart, InverseWorldTransform);
+    DirectX::XMVECTOR E = DirectX::XMVector3TransformCoord(WorldEnd, InverseWorldTransform);
+    DirectX::XMVECTOR SE = DirectX::XMVectorSubtract(E, S);
+    DirectX::XMVECTOR V = DirectX::XMVector3Normalize(SE);
+    DirectX::XMVECTOR Length = DirectX::XMVector3Length(SE);
+
+    // モデル空間でのレイの長さ
+    float neart;
+    DirectX::XMStoreFloat(&neart, Length);
+
+    // 三角形（面）との交差判定
+    bool hitTriangle = false;
+    int materialIndex = -1;
+    DirectX::XMVECTOR HitPosition = DirectX::XMVectorZero();
+    DirectX::XMVECTOR HitNormal = DirectX::XMVectorZero();
+    for (const CollisionMesh::Triangle& triangle : collisionMesh.GetTriangles())
     {
-        // レイをワールド空間からローカル空間へ変換
-
-        // サイズの修正
-        DirectX::XMMATRIX T = DirectX::XMLoadFloat4x4(&transform);
-        DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&mesh.defaultGlobalTransform);
-
-        // メッシュのワールド行列と逆行列を求める
-        DirectX::XMMATRIX WorldTransform = M * T;
-        DirectX::XMMATRIX InverseWorldTransform = DirectX::XMMatrixInverse(nullptr, WorldTransform);
-
-        // レイベクトルをメッシュ空間に変換
-        DirectX::XMVECTOR S = DirectX::XMVector3TransformCoord(WorldStart, InverseWorldTransform);
-        DirectX::XMVECTOR E = DirectX::XMVector3TransformCoord(WorldEnd, InverseWorldTransform);
-        DirectX::XMVECTOR SE = DirectX::XMVectorSubtract(E, S);
-        DirectX::XMVECTOR V = DirectX::XMVector3Normalize(SE);
-        DirectX::XMVECTOR Length = DirectX::XMVector3Length(SE);
-
-        // メッシュ空間でのレイの長さ
-        float neart;
-        DirectX::XMStoreFloat(&neart, Length);
-
-        // 三角形（面）との交差判定
-        const std::vector<SkinnedMesh::Vertex>& vertices = mesh.vertices;
-        const std::vector<UINT> indices = mesh.indices;
-
-        int materialIndex = -1;
-        DirectX::XMVECTOR HitPosition;
-        DirectX::XMVECTOR HitNormal;
-        for (const SkinnedMesh::Mesh::Subset& subset : mesh.subsets)
-        {
-            for (UINT i = 0; i < subset.indexCount; i += 3)
-            {
-                UINT index = subset.startIndexLocation + i;
-
-                // 三角形の頂点を抽出
-                const SkinnedMesh::Vertex& a = vertices.at(indices.at(index));
-                const SkinnedMesh::Vertex& b = vertices.at(indices.at(index + 1));
-                const SkinnedMesh::Vertex& c = vertices.at(indices.at(index + 2));
-
-                DirectX::XMVECTOR A = DirectX::XMLoadFloat3(&a.position);
-                DirectX::XMVECTOR B = DirectX::XMLoadFloat3(&b.position);
-                DirectX::XMVECTOR C = DirectX::XMLoadFloat3(&c.position);
-
-                // 三角形の三辺ベクトルを算出
-                DirectX::XMVECTOR AB = DirectX::XMVectorSubtract(B, A);
-                DirectX::XMVECTOR BC = DirectX::XMVectorSubtract(C, B);
-                DirectX::XMVECTOR CA = DirectX::XMVectorSubtract(A, C);
-
-                // 三角形の法線ベクトルを算出
-                DirectX::XMVECTOR N = DirectX::XMVector3Cross(AB, BC);
-
-                // 内積の結果がプラスならば裏向き
-                DirectX::XMVECTOR Dot = DirectX::XMVector3Dot(V, N);
-                float dot;
-                DirectX::XMStoreFloat(&dot, Dot);
-                if (dot >= 0) continue;
-
-                // レイと平面の交点を算出
-                DirectX::XMVECTOR SA = DirectX::XMVectorSubtract(A, S); // レイの開始点から点Ａへのベクトル
-                DirectX::XMVECTOR X = DirectX::XMVectorDivide(DirectX::XMVector3Dot(SA, N), Dot);
-                float x;
-                DirectX::XMStoreFloat(&x, X);
-                if (x < 0.0f || x > neart) continue;
-
-                DirectX::XMVECTOR P = DirectX::XMVectorAdd(S, DirectX::XMVectorScale(V, x));
-
-                // 交点が三角形の内側にあるか判定
-                // １つめ
-                DirectX::XMVECTOR PA = DirectX::XMVectorSubtract(A, P);
-                DirectX::XMVECTOR Cross1 = DirectX::XMVector3Cross(PA, AB);
-                DirectX::XMVECTOR Dot1 = DirectX::XMVector3Dot(Cross1, N);
-                float dot1;
-                DirectX::XMStoreFloat(&dot1, Dot1);
-                if (dot1 < 0.0f) continue;
-
-                // ２つめ
-                DirectX::XMVECTOR PB = DirectX::XMVectorSubtract(B, P);
-                DirectX::XMVECTOR Cross2 = DirectX::XMVector3Cross(PB, BC);
-                DirectX::XMVECTOR Dot2 = DirectX::XMVector3Dot(Cross2, N);
-                float dot2;
-                DirectX::XMStoreFloat(&dot2, Dot2);
-                if (dot2 < 0.0f) continue;
-
-                // ３つめ
-                DirectX::XMVECTOR PC = DirectX::XMVectorSubtract(C, P);
-                DirectX::XMVECTOR Cross3 = DirectX::XMVector3Cross(PC, CA);
-                DirectX::XMVECTOR Dot3 = DirectX::XMVector3Dot(Cross3, N);
-                float dot3;
-                DirectX::XMStoreFloat(&dot3, Dot3);
-                if (dot3 < 0.0f) continue;
-
-                // 最短距離を更新
-                neart = x;
-
-                // 交点と法線を更新
-                HitPosition = P;
-                HitNormal = N;
-                materialIndex = subset.materialUniqueId;
-            }
-        }
-        if (materialIndex >= 0)
-        {
-            // メッシュ空間からワールド空間へ変換
-            DirectX::XMVECTOR WorldPosition = DirectX::XMVector3TransformCoord(HitPosition, WorldTransform);
-            DirectX::XMVECTOR WorldCrossVec = DirectX::XMVectorSubtract(WorldPosition, WorldStart);
-            DirectX::XMVECTOR WorldCrossLength = DirectX::XMVector3Length(WorldCrossVec);
-            float distance;
-            DirectX::XMStoreFloat(&distance, WorldCrossLength);
-
-            // ヒット情報保存（レイに当たった中で一番近い面で処理を行う）
-            if (result.distance > distance)
-            {
-                DirectX::XMVECTOR WorldNormal = DirectX::XMVector3TransformNormal(HitNormal, WorldTransform);
-
-                result.distance = distance;
-                result.materialIndex = materialIndex;
-                DirectX::XMStoreFloat3(&result.position, WorldPosition);
-                DirectX::XMStoreFloat3(&result.normal, DirectX::XMVector3Normalize(WorldNormal));
-                hit = true;
-            }
-        }
+        // 三角形の頂点と辺ベクトル、法線は焼き込み済み
+        DirectX::XMVECTOR A = DirectX::XMLoadFloat3(&triangle.a);
+        DirectX::XMVECTOR AB = DirectX::XMLoadFloat3(&triangle.ab);
+        DirectX::XMVECTOR BC = DirectX::XMLoadFloat3(&triangle.bc);
+        DirectX::XMVECTOR N = DirectX::XMLoadFloat3(&triangle.normal);
+
+        // 内積の結果がプラスならば裏向き
+        DirectX::XMVECTOR Dot = DirectX::XMVector3Dot(V, N);
+        float dot;
+        DirectX::XMStoreFloat(&dot, Dot);
+        if (dot >= 0) continue;
+
+        // レイと平面の交点を算出
+        DirectX::XMVECTOR SA = DirectX::XMVectorSubtract(A, S); // レイの開始点から点Ａへのベクトル
+        DirectX::XMVECTOR X = DirectX::XMVectorDivide(DirectX::XMVector3Dot(SA, N), Dot);
+        float x;
+        DirectX::XMStoreFloat(&x, X);
+        if (x < 0.0f || x > neart) continue;
+
+        DirectX::XMVECTOR P = DirectX::XMVectorAdd(S, DirectX::XMVectorScale(V, x));
+
+        // 交点が三角形の内側にあるか判定
+        // １つめ
+        DirectX::XMVECTOR PA = DirectX::XMVectorSubtract(A, P);
+        DirectX::XMVECTOR Cross1 = DirectX::XMVector3Cross(PA, AB);
+        DirectX::XMVECTOR Dot1 = DirectX::XMVector3Dot(Cross1, N);
+        float dot1;
+        DirectX::XMStoreFloat(&dot1, Dot1);
+        if (dot1 < 0.0f) continue;
+
+        // ２つめ
+        DirectX::XMVECTOR B = DirectX::XMVectorAdd(A, AB);
+        DirectX::XMVECTOR PB = DirectX::XMVectorSubtract(B, P);
+        DirectX::XMVECTOR Cross2 = DirectX::XMVector3Cross(PB, BC);
+        DirectX::XMVECTOR Dot2 = DirectX::XMVector3Dot(Cross2, N);
+        float dot2;
+        DirectX::XMStoreFloat(&dot2, Dot2);
+        if (dot2 < 0.0f) continue;
+
+        // ３つめ
+        DirectX::XMVECTOR C = DirectX::XMVectorAdd(B, BC);
+        DirectX::XMVECTOR CA = DirectX::XMVectorSubtract(A, C);
+        DirectX::XMVECTOR PC = DirectX::XMVectorSubtract(C, P);
+        DirectX::XMVECTOR Cross3 = DirectX::XMVector3Cross(PC, CA);
+        DirectX::XMVECTOR Dot3 = DirectX::XMVector3Dot(Cross3, N);
+        float dot3;
+        DirectX::XMStoreFloat(&dot3, Dot3);
+        if (dot3 < 0.0f) continue;
+
+        // 最短距離を更新
+        neart = x;
+
+        // 交点と法線を更新
+        HitPosition = P;
+        HitNormal = N;
+        materialIndex = triangle.materialIndex;
+        hitTriangle = true;
     }
+    if (!hitTriangle) return false;
 
-    return hit;
+    // モデル空間からワールド空間へ変換
+    DirectX::XMVECTOR WorldPosition = DirectX::XMVector3TransformCoord(HitPosition, WorldTransform);
+    DirectX::XMVECTOR WorldCrossVec = DirectX::XMVectorSubtract(WorldPosition, WorldStart);
+    DirectX::XMVECTOR WorldCrossLength = DirectX::XMVector3Length(WorldCrossVec);
+    float distance;
+    DirectX::XMStoreFloat(&distance, WorldCrossLength);
+
+    // ヒット情報保存
+    if (result.distance <= distance) return false;
+
+    DirectX::XMVECTOR WorldNormal = DirectX::XMVector3TransformNormal(HitNormal, WorldTransform);
+
+    result.distance = distance;
+    result.materialIndex = materialIndex;
+    DirectX::XMStoreFloat3(&result.position, WorldPosition);
+    DirectX::XMStoreFloat3(&result.normal, DirectX::XMVector3Normalize(WorldNormal));
+
+    return true;
 }
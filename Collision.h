@@ -2,6 +2,7 @@
 
 #include <DirectXMath.h>
 #include "Library/3D/SkinnedMesh.h"
+#include "Library/3D/CollisionMesh.h"
 
 // ヒット判定
 struct HitResult
@@ -63,4 +64,21 @@ public:
 		const DirectX::XMFLOAT4X4& transform,
 		HitResult& result
 	);
+
+	// レイと当たり判定メッシュの交差判定 (焼き込み時の軸補正行列を使う)
+	static bool IntersectRayVsCollisionMesh(
+		const DirectX::XMFLOAT3& start,
+		const DirectX::XMFLOAT3& end,
+		const CollisionMesh& collisionMesh,
+		HitResult& result
+	);
+
+	// レイと当たり判定メッシュの交差判定
+	static bool IntersectRayVsCollisionMesh(
+		const DirectX::XMFLOAT3& start,
+		const DirectX::XMFLOAT3& end,
+		const CollisionMesh& collisionMesh,
+		const DirectX::XMFLOAT4X4& transform,
+		HitResult& result
+	);
 };
\ No newline at end of file
@@ -1,59 +1,191 @@
+#include <algorithm>
 #include "DamageTextManager.h"
+#include "Library/Text/DispString.h"
+#include "Library/Graphics/Graphics.h"
+#include "Library/3D/Camera.h"
+#include "Library/Timer.h"
+#include "Library/ImGui/Include/imgui.h"
+
+using namespace DirectX;
 
 // 更新処理
 void DamageTextManager::Update()
 {
-	// 更新処理
-	for (DamageText* damageText : damageTexts)
-	{
-		damageText->Update();
-	}
+	const float deltaTime = Timer::Instance().DeltaTime();
 
-	// 破棄処理
-	for (DamageText* damageText : removes)
+	// ステート処理 (消えたものは最後のものを詰めるので、後ろから回す)
+	for (int i = count - 1; i >= 0; --i)
 	{
-		std::vector<DamageText*>::iterator it = std::find(damageTexts.begin(), damageTexts.end(), damageText);
+		timers[i] += deltaTime;
 
-		if (it != damageTexts.end())
+		switch (states[i])
 		{
-			damageTexts.erase(it);
+		case State::Idle:
+			// 待機が終わったらフェードアウトへ
+			if (timers[i] >= idleTime)
+			{
+				timers[i] = 0.0f;
+				states[i] = State::fadeOut;
+			}
+			break;
+		case State::fadeOut:
+			if (timers[i] >= fadeOutTime)
+			{
+				RemoveAt(i);
+				continue;
+			}
+			addYs[i] += 2 * deltaTime;
+			break;
 		}
-		// ダメージテキストの破棄処理
-		delete damageText;
 	}
-	// 破棄リストをクリア
-	removes.clear();
+
+	// 座標更新
+	ProjectAll();
 }
 
 //　描画処理
 void DamageTextManager::Render()
 {
-	for (DamageText* damageText : damageTexts)
+	DispString& dispString = DispString::Instance();
+	for (int i = 0; i < count; ++i)
 	{
-		damageText->Render();
+		if (!visibles[i]) continue;
+
+		const float alpha = (states[i] == State::fadeOut) ? 1.0f - (timers[i] / fadeOutTime) : 1.0f;
+		dispString.Draw(texts[i], drawPositions[i], size, TEXT_ALIGN::MIDDLE, { 0, 1, 1, alpha }, true, { 0,0,0,1 }, 2);
 	}
 }
 
 // ダメージテキスト登録
-void DamageTextManager::Register(DamageText* damageText)
+void DamageTextManager::Register(const DirectX::XMFLOAT3& position, const TCHAR* text)
 {
-	damageTexts.emplace_back(damageText);
+	if (count >= Capacity)
+	{
+		++droppedCount;
+		return;
+	}
+
+	const int i = count++;
+	xs[i] = position.x;
+	ys[i] = position.y;
+	zs[i] = position.z;
+	addYs[i] = 0.0f;
+	timers[i] = 0.0f;
+	states[i] = State::Idle;
+	drawPositions[i] = { 0,0 };
+	visibles[i] = false;	// 次の Update で変換するまでは描かない
+	_tcsncpy_s(texts[i], TextLength, text, _TRUNCATE);
 }
 
+// ダメージテキスト全削除
+void DamageTextManager::Clear()
+{
+	count = 0;
+	visibleCount = 0;
+}
 
-// ダメージテキスト削除
-void DamageTextManager::Remove(DamageText* damageText)
+// デバッグ用GUI描画
+void DamageTextManager::DrawDebugGui()
 {
-	// 破棄リストに追加
-	removes.insert(damageText);
+	if (ImGui::CollapsingHeader("DamageText", ImGuiTreeNodeFlags_None))
+	{
+		ImGui::Text("Count : %d / %d", count, Capacity);
+		ImGui::Text("Visible : %d", visibleCount);
+		ImGui::Text("Dropped : %d", droppedCount);
+	}
 }
 
-// ダメージテキスト全削除
-void DamageTextManager::Clear()
+// テキストを消す (最後のものを空いた所へ詰める)
+void DamageTextManager::RemoveAt(int index)
+{
+	const int last = --count;
+	if (index == last) return;
+
+	xs[index] = xs[last];
+	ys[index] = ys[last];
+	zs[index] = zs[last];
+	addYs[index] = addYs[last];
+	timers[index] = timers[last];
+	states[index] = states[last];
+	drawPositions[index] = drawPositions[last];
+	visibles[index] = visibles[last];
+	_tcscpy_s(texts[index], TextLength, texts[last]);
+}
+
+// 全てのテキストのスクリーン座標をまとめて求める
+void DamageTextManager::ProjectAll()
 {
-	for (DamageText* damageText : damageTexts)
+	visibleCount = 0;
+	if (count == 0) return;
+
+	// ビューポート (フレームに 1 回だけ取る)
+	D3D11_VIEWPORT viewport;
+	UINT numViewports = 1;
+	Graphics::Instance().stateCache.RSGetViewports(&numViewports, &viewport);
+
+	// ワールド座標 → クリップ座標 (4 つずつ変換するので、使う要素を 1 つずつ全成分に並べておく)
+	XMFLOAT4X4 viewProjection;
+	XMStoreFloat4x4(&viewProjection, XMMatrixMultiply(
+		XMLoadFloat4x4(&Camera::Instance().GetView()),
+		XMLoadFloat4x4(&Camera::Instance().GetProjection())));
+	const XMVECTOR M11 = XMVectorReplicate(viewProjection._11), M12 = XMVectorReplicate(viewProjection._12), M14 = XMVectorReplicate(viewProjection._14);
+	const XMVECTOR M21 = XMVectorReplicate(viewProjection._21), M22 = XMVectorReplicate(viewProjection._22), M24 = XMVectorReplicate(viewProjection._24);
+	const XMVECTOR M31 = XMVectorReplicate(viewProjection._31), M32 = XMVectorReplicate(viewProjection._32), M34 = XMVectorReplicate(viewProjection._34);
+	const XMVECTOR M41 = XMVectorReplicate(viewProjection._41), M42 = XMVectorReplicate(viewProjection._42), M44 = XMVectorReplicate(viewProjection._44);
+
+	// NDC → スクリーン座標 (y は下向き)
+	const XMVECTOR ScaleX = XMVectorReplicate(viewport.Width * 0.5f);
+	const XMVECTOR ScaleY = XMVectorReplicate(-viewport.Height * 0.5f);
+	const XMVECTOR OffsetX = XMVectorReplicate(viewport.TopLeftX + viewport.Width * 0.5f);
+	const XMVECTOR OffsetY = XMVectorReplicate(viewport.TopLeftY + viewport.Height * 0.5f);
+
+	// 文字の大きさ分は画面の外にはみ出しても描く
+	const XMVECTOR MinX = XMVectorReplicate(viewport.TopLeftX - size);
+	const XMVECTOR MinY = XMVectorReplicate(viewport.TopLeftY - size);
+	const XMVECTOR MaxX = XMVectorReplicate(viewport.TopLeftX + viewport.Width + size);
+	const XMVECTOR MaxY = XMVectorReplicate(viewport.TopLeftY + viewport.Height + size);
+
+	const XMVECTOR Epsilon = XMVectorReplicate(1.0e-5f);
+
+	// count を超えた分 (Capacity までの 4 の倍数) も変換するが、結果は使わない
+	for (int i = 0; i < count; i += 4)
 	{
-		delete damageText;
+		// エネミー頭上の座標
+		const XMVECTOR X = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&xs[i]));
+		const XMVECTOR Y = XMVectorAdd(XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&ys[i])), XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&addYs[i])));
+		const XMVECTOR Z = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&zs[i]));
+
+		// クリップ座標 (z は使わない)
+		const XMVECTOR ClipX = XMVectorMultiplyAdd(Z, M31, XMVectorMultiplyAdd(Y, M21, XMVectorMultiplyAdd(X, M11, M41)));
+		const XMVECTOR ClipY = XMVectorMultiplyAdd(Z, M32, XMVectorMultiplyAdd(Y, M22, XMVectorMultiplyAdd(X, M12, M42)));
+		const XMVECTOR ClipW = XMVectorMultiplyAdd(Z, M34, XMVectorMultiplyAdd(Y, M24, XMVectorMultiplyAdd(X, M14, M44)));
+
+		// カメラの後ろのものは W で割った値が壊れるが、下の判定で落とす
+		const XMVECTOR InvW = XMVectorReciprocal(ClipW);
+		const XMVECTOR ScreenX = XMVectorMultiplyAdd(XMVectorMultiply(ClipX, InvW), ScaleX, OffsetX);
+		const XMVECTOR ScreenY = XMVectorMultiplyAdd(XMVectorMultiply(ClipY, InvW), ScaleY, OffsetY);
+
+		// カメラの前で、画面内のもの
+		XMVECTOR Visible = XMVectorGreater(ClipW, Epsilon);
+		Visible = XMVectorAndInt(Visible, XMVectorGreaterOrEqual(ScreenX, MinX));
+		Visible = XMVectorAndInt(Visible, XMVectorLessOrEqual(ScreenX, MaxX));
+		Visible = XMVectorAndInt(Visible, XMVectorGreaterOrEqual(ScreenY, MinY));
+		Visible = XMVectorAndInt(Visible, XMVectorLessOrEqual(ScreenY, MaxY));
+
+		XMFLOAT4A screenX, screenY;
+		XMStoreFloat4A(&screenX, ScreenX);
+		XMStoreFloat4A(&screenY, ScreenY);
+		uint32_t visible[4];
+		XMStoreInt4(visible, Visible);
+
+		const int laneCount = (std::min)(4, count - i);
+		for (int lane = 0; lane < laneCount; ++lane)
+		{
+			visibles[i + lane] = visible[lane] != 0;
+			if (!visibles[i + lane]) continue;
+
+			drawPositions[i + lane] = { (&screenX.x)[lane], (&screenY.x)[lane] };
+			++visibleCount;
+		}
 	}
-	damageTexts.clear();
 }
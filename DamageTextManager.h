@@ -1,10 +1,13 @@
 #pragma once
 
-#include <vector>
-#include <set>
-#include "DamageText.h"
+#include <DirectXMath.h>
+#include <tchar.h>
+#include <cstdint>
 
 // ダメージテキストマネージャー
+// テキストは固定数のプールに項目ごとの配列 (SoA) で持ち、文字列もプールの中に持つ (登録でメモリを確保しない)
+// スクリーン座標への変換は Update で 1 回だけビュープロジェクションとビューポートの変換を作り、
+// 生きている全てのテキストを 4 つずつまとめて変換する (画面外・カメラの後ろのものは描かない)
 class DamageTextManager
 {
 private:
@@ -19,6 +22,14 @@ public:
 		return instance;
 	}
 
+	// 同時に出せるテキストの最大数 (一杯の時の登録は捨てる)
+	// (4 つずつ変換するので 4 の倍数)
+	static constexpr int Capacity = 256;
+	static_assert(Capacity % 4 == 0, "DamageTextManager::Capacity must be a multiple of 4.");
+
+	// テキスト 1 つに入る文字数 (null 終端を含む、超えた分は切り捨てる)
+	static constexpr int TextLength = 16;
+
 	// 更新処理
 	void Update();
 
@@ -26,24 +37,49 @@ public:
 	void Render();
 
 	// ダメージテキスト登録
-	void Register(DamageText* damageText);
-
-	// ダメージテキスト削除
-	void Remove(DamageText* damageText);
+	void Register(const DirectX::XMFLOAT3& position, const TCHAR* text);
 
 	// ダメージテキスト全削除
 	void Clear();
 
 	// ダメージテキスト数取得
-	int GetDamageTextCount() const { return static_cast<int>(damageTexts.size()); }
-
-	// ダメージテキスト取得
-	DamageText* GetDamageText(int index) { return damageTexts.at(index); }
+	int GetDamageTextCount() const { return count; }
 
 	// デバッグ用GUI描画
 	void DrawDebugGui();
 
 private:
-	std::vector<DamageText*> damageTexts;
-	std::set<DamageText*> removes;
-};
\ No newline at end of file
+	// テキストを消す (最後のものを空いた所へ詰める)
+	void RemoveAt(int index);
+
+	// 全てのテキストのスクリーン座標をまとめて求める
+	void ProjectAll();
+
+private:
+	enum class State : uint8_t
+	{
+		Idle,
+		fadeOut,
+	};
+
+	static constexpr float size = 32;
+	static constexpr float idleTime = 0.5f;
+	static constexpr float fadeOutTime = 0.15f;
+
+	// ---- テキストごとの値 (先頭から count 個が生きている) ----
+	// 出した場所 (ワールド座標、4 つずつ読むので成分ごとに分けて 16byte 境界に置く)
+	alignas(16) float	xs[Capacity];
+	alignas(16) float	ys[Capacity];
+	alignas(16) float	zs[Capacity];
+	alignas(16) float	addYs[Capacity];				// フェードアウト中に上がる量
+	float				timers[Capacity];
+	State				states[Capacity];
+	DirectX::XMFLOAT2	drawPositions[Capacity];		// スクリーン座標
+	bool				visibles[Capacity];				// 画面内か
+	TCHAR				texts[Capacity][TextLength];
+
+	int count = 0;
+
+	int visibleCount = 0;		// 前回の Update で画面内だった数
+	int droppedCount = 0;		// プールが一杯で捨てた数 (累計)
+};
@@ -58,25 +58,8 @@ void EnemyDragon::Render()
 
 		if (model->skeletonSpheres.at(i).name != "")
 		{
-			const Animation::KeyFrame& keyframe = model->animationClips.at(currentAnimationIndex).sequence.at(currentKeyFrame);
-
-			int nodeCount = keyframe.nodes.size();
-			for (int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
-			{
-				const Animation::KeyFrame::Node& node = keyframe.nodes.at(nodeIndex);
-
-				// ボーンのノードと同じ名前なら処理する
-				if (node.name != model->skeletonSpheres.at(i).name) continue;
-
-				DirectX::XMMATRIX T = DirectX::XMLoadFloat4x4(&transform);
-				DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&node.globalTransform);
-
-				DirectX::XMMATRIX W = M * T;
-				DirectX::XMFLOAT4X4 w;
-				DirectX::XMStoreFloat4x4(&w, W);
-
-				collisionPosition = { w._41, w._42, w._43};
-			}
+			// ボーンのノード番号から位置を取得
+			collisionPosition = GetNodeWorldPosition(model->skeletonSpheres.at(i).nodeIndex);
 		}
 
 		DebugPrimitive::Instance().AddSphere(collisionPosition, radius, {0,0,1,1});
@@ -1,5 +1,8 @@
 #include "EnemyManager.h"
+#include "Library/3D/Camera.h"
+#include "Library/3D/OcclusionCuller.h"
 #include "Library/ImGui/Include/imgui.h"
+#include "Library/FrameArena.h"
 #include "Collision.h"
 #include "EnemySlime.h"
 
@@ -31,9 +34,29 @@ void EnemyManager::Update()
 //　描画処理
 void EnemyManager::Render()
 {
+	// 視錐台カリング
+	cullingBatch.Clear();
 	for (Enemy* enemy : enemies)
 	{
-		enemy->Render();
+		DirectX::XMFLOAT3 center, extents;
+		if (enemy->GetWorldBounds(center, extents))
+		{
+			cullingBatch.Add(center, extents);
+		}
+		else
+		{
+			cullingBatch.AddAlwaysVisible();
+		}
+	}
+	Camera::Instance().Cull(cullingBatch);
+	// 遮蔽カリング (ステージの壁の裏にあるもの)
+	OcclusionCuller::Instance().Cull(cullingBatch);
+
+	for (size_t i = 0; i < enemies.size(); i++)
+	{
+		if (!cullingBatch.IsVisible(i)) continue;
+
+		enemies[i]->Render();
 	}
 
 	// 敵同士の衝突処理
@@ -193,11 +216,15 @@ void EnemyManager::DrawDebugGui()
 			Clear();
 		}
 
+		// アニメーション LOD ごとの更新数 (プレイヤーも含む)
+		ImGui::Text("AnimLod Full : %d  Reduced : %d", Character::GetAnimationLodCount(AnimationLod::Full), Character::GetAnimationLodCount(AnimationLod::Reduced));
+		ImGui::Text("AnimLod Far : %d  Culled : %d", Character::GetAnimationLodCount(AnimationLod::Far), Character::GetAnimationLodCount(AnimationLod::Culled));
+
 		uint32_t enemyCount = enemies.size();
 		for (int i = 0; i < enemyCount; i++)
 		{
 			Enemy* enemy = enemies.at(i);
-			if (ImGui::CollapsingHeader(("Enemy - " + std::to_string(i)).c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+			if (ImGui::CollapsingHeader(FrameArena::Instance().Format("Enemy - %d", i), ImGuiTreeNodeFlags_DefaultOpen))
 			{
 				// 位置
 				DirectX::XMFLOAT3 position = enemy->GetPosition();
@@ -3,6 +3,7 @@
 #include <vector>
 #include <set>
 #include "Enemy.h"
+#include "Library/3D/Frustum.h"
 
 // エネミーマネージャー
 class EnemyManager
@@ -57,4 +58,7 @@ private:
 private:
 	std::vector<Enemy*> enemies;
 	std::set<Enemy*> removes;
+
+	// 視錐台カリング (enemies と同じ順番で登録する)
+	FrustumCullingBatch cullingBatch;
 };
\ No newline at end of file
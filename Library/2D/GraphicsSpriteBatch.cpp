@@ -82,7 +82,7 @@ void GraphicsSpriteBatch::render(float dx, float dy, float dw, float dh, float r
 	//--- < スクリーン(ビューポート)のサイズを取得 > ---
 	D3D11_VIEWPORT viewport{};
 	UINT numViewports = 1;
-	gfx.deviceContext->RSGetViewports(&numViewports, &viewport);
+	gfx.stateCache.RSGetViewports(&numViewports, &viewport);
 
 	//--- < 矩形の各頂点の位置(スクリーン座標系)を計算する > ---
 
@@ -150,11 +150,11 @@ void GraphicsSpriteBatch::begin()
 	vertices.clear();
 
 	//--- < シェーダーのバインド > ---
-	gfx.deviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
-	gfx.deviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+	gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
 
 	//--- < シェーダーリソースのバインド > ---
-	gfx.deviceContext->PSSetShaderResources(0, 1, shaderResourceView.GetAddressOf());
+	gfx.stateCache.PSSetShaderResources(0, 1, shaderResourceView.GetAddressOf());
 }
 
 void GraphicsSpriteBatch::end()
@@ -164,7 +164,7 @@ void GraphicsSpriteBatch::end()
 	//--- < 頂点情報を元に頂点バッファオブジェクトを更新する > ---
 	HRESULT hr = S_OK;
 	D3D11_MAPPED_SUBRESOURCE mappedSubresource{};
-	hr = gfx.deviceContext->Map(vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+	hr = gfx.stateCache.Map(vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
 
 	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 
@@ -176,19 +176,19 @@ void GraphicsSpriteBatch::end()
 		const vertex* p = vertices.data();
 		memcpy_s(data, maxVertices * sizeof(vertex), p, vertexCount * sizeof(vertex));
 	}
-	gfx.deviceContext->Unmap(vertexBuffer.Get(), 0);
+	gfx.stateCache.Unmap(vertexBuffer.Get(), 0, static_cast<UINT>(vertexCount * sizeof(vertex)));
 
 	//--- < 頂点バッファーのバインド > ---
 	UINT stride = sizeof(vertex);
 	UINT offset = 0;
-	gfx.deviceContext->IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
+	gfx.stateCache.IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
 
 	//--- < プリミティブタイプおよにデータ順序に関する情報のバインド > ---
-	gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	//--- < 入力レイアウトオブジェクトのバインド > ---
-	gfx.deviceContext->IASetInputLayout(inputLayout.Get());
+	gfx.stateCache.IASetInputLayout(inputLayout.Get());
 
 	//--- < プリミティブの描画 > ---
-	gfx.deviceContext->Draw(static_cast<UINT>(vertexCount), 0);
+	gfx.stateCache.Draw(static_cast<UINT>(vertexCount), 0);
 }
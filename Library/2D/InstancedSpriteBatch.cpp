@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <cstring>
+#include "InstancedSpriteBatch.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/Shader.h"
+#include "../Graphics/Texture.h"
+#include "../ErrorLogger.h"
+
+using namespace DirectX;
+
+//--------------------------------------------------------------
+// TextureArray
+//--------------------------------------------------------------
+
+// 全ての画像を読み込んで 1 つの配列にする
+bool InstancedSpriteBatch::TextureArray::Load(const wchar_t* const* filenames, UINT count)
+{
+	Graphics& gfx = Graphics::Instance();
+
+	_ASSERT_EXPR(count > 0, L"TextureArray : 画像がありません");
+	if (count == 0) return false;
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> arrayTexture;
+	D3D11_TEXTURE2D_DESC arrayDesc{};
+
+	for (UINT i = 0; i < count; ++i)
+	{
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> sourceView;
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> sourceTexture;
+		D3D11_TEXTURE2D_DESC sourceDesc{};
+		HRESULT hr = LoadTextureFromFile(filenames[i], sourceView.GetAddressOf(), &sourceDesc, sourceTexture.GetAddressOf());
+		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+		if (FAILED(hr)) return false;
+
+		if (i == 0)
+		{
+			// 1 枚目に合わせて配列を作る
+			arrayDesc = sourceDesc;
+			arrayDesc.ArraySize = count;
+			arrayDesc.Usage = D3D11_USAGE_DEFAULT;
+			arrayDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+			arrayDesc.CPUAccessFlags = 0;
+			arrayDesc.MiscFlags = 0;
+			hr = gfx.device->CreateTexture2D(&arrayDesc, nullptr, arrayTexture.GetAddressOf());
+			_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+			if (FAILED(hr)) return false;
+		}
+		else if (sourceDesc.Width != arrayDesc.Width || sourceDesc.Height != arrayDesc.Height ||
+			sourceDesc.Format != arrayDesc.Format || sourceDesc.MipLevels != arrayDesc.MipLevels)
+		{
+			_ASSERT_EXPR(false, L"TextureArray : 大きさかフォーマットが 1 枚目と違います");
+			return false;
+		}
+
+		// ミップごとにスライスへコピー
+		for (UINT mip = 0; mip < arrayDesc.MipLevels; ++mip)
+		{
+			gfx.stateCache.CopySubresourceRegion(arrayTexture.Get(), D3D11CalcSubresource(mip, i, arrayDesc.MipLevels), 0, 0, 0,
+				sourceTexture.Get(), D3D11CalcSubresource(mip, 0, sourceDesc.MipLevels), nullptr);
+		}
+	}
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
+	shaderResourceViewDesc.Format = arrayDesc.Format;
+	shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	shaderResourceViewDesc.Texture2DArray.MostDetailedMip = 0;
+	shaderResourceViewDesc.Texture2DArray.MipLevels = arrayDesc.MipLevels;
+	shaderResourceViewDesc.Texture2DArray.FirstArraySlice = 0;
+	shaderResourceViewDesc.Texture2DArray.ArraySize = count;
+	HRESULT hr = gfx.device->CreateShaderResourceView(arrayTexture.Get(), &shaderResourceViewDesc, shaderResourceView.ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	if (FAILED(hr)) return false;
+
+	width = arrayDesc.Width;
+	height = arrayDesc.Height;
+	sliceCount = count;
+	return true;
+}
+
+//--------------------------------------------------------------
+// InstancedSpriteBatch
+//--------------------------------------------------------------
+
+InstancedSpriteBatch::InstancedSpriteBatch(UINT initialCapacity)
+{
+	Graphics& gfx = Graphics::Instance();
+
+	//--- < インスタンスバッファの生成 > ---
+	CreateInstanceBuffer((std::clamp)(initialCapacity, 1u, InstanceMax));
+
+	//--- < 定数バッファの生成 > ---
+	D3D11_BUFFER_DESC bufferDesc{};
+	bufferDesc.ByteWidth = sizeof(Constants);
+	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	HRESULT hr = gfx.device->CreateBuffer(&bufferDesc, nullptr, constantBuffer.GetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	//--- < 頂点シェーダーオブジェクトと入力レイアウトオブジェクトの生成 > ---
+	// 頂点ごとのデータはないので、入力は全てインスタンスごと
+	D3D11_INPUT_ELEMENT_DESC inputElementDesc[]
+	{
+		{"RECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"TEXCOORD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"PARAM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+	};
+	CreateVsFromCso("./Data/Shader/SpriteBatch_VS.cso", vertexShader.GetAddressOf(), inputLayout.GetAddressOf(), inputElementDesc, _countof(inputElementDesc));
+
+	//--- < ピクセルシェーダーオブジェクトの生成 > ---
+	CreatePsFromCso("./Data/Shader/SpriteBatch_PS.cso", pixelShader.GetAddressOf());
+
+	sprites.reserve(instanceCapacity);
+}
+
+void InstancedSpriteBatch::Begin(SORT_MODE sortMode)
+{
+	_ASSERT_EXPR(!inBeginEndPair, L"InstancedSpriteBatch : End が呼ばれていません");
+	inBeginEndPair = true;
+
+	this->sortMode = sortMode;
+	sprites.clear();
+	statistics = {};
+}
+
+void InstancedSpriteBatch::Draw(const TextureArray& texture, float dx, float dy, float dw, float dh)
+{
+	Draw(texture, dx, dy, dw, dh, 1, 1, 1, 1, 0, 0, 0, static_cast<float>(texture.GetWidth()), static_cast<float>(texture.GetHeight()));
+}
+
+void InstancedSpriteBatch::Draw(const TextureArray& texture, float dx, float dy, float dw, float dh,
+	float r, float g, float b, float a, float angle, UINT slice, float depth)
+{
+	Draw(texture, dx, dy, dw, dh, r, g, b, a, angle, 0, 0, static_cast<float>(texture.GetWidth()), static_cast<float>(texture.GetHeight()), slice, depth);
+}
+
+void InstancedSpriteBatch::Draw(const TextureArray& texture, float dx, float dy, float dw, float dh,
+	float r, float g, float b, float a, float angle,
+	float sx, float sy, float sw, float sh, UINT slice, float depth)
+{
+	_ASSERT_EXPR(inBeginEndPair, L"InstancedSpriteBatch : Begin が呼ばれていません");
+	_ASSERT_EXPR(slice < texture.GetSliceCount(), L"InstancedSpriteBatch : スライス番号が範囲外です");
+
+	// 並べ替えなしならバッファに入る分だけ溜めて描く
+	if (sortMode == SORT_MODE::DEFERRED && sprites.size() >= InstanceMax) Flush();
+
+	//--- < テクセル座標系からUV座標系への変換 > ---
+	const float invWidth = 1.0f / static_cast<float>(texture.GetWidth());
+	const float invHeight = 1.0f / static_cast<float>(texture.GetHeight());
+
+	Sprite& sprite = sprites.emplace_back();
+	sprite.instance.rect = { dx, dy, dw, dh };
+	sprite.instance.texcoord = { sx * invWidth, sy * invHeight, (sx + sw) * invWidth, (sy + sh) * invHeight };
+	sprite.instance.color = { r, g, b, a };
+	sprite.instance.param = { XMConvertToRadians(angle), static_cast<float>(slice), depth, 0 };
+	sprite.texture = &texture;
+}
+
+void InstancedSpriteBatch::End()
+{
+	_ASSERT_EXPR(inBeginEndPair, L"InstancedSpriteBatch : Begin が呼ばれていません");
+	inBeginEndPair = false;
+
+	Flush();
+
+	statistics.capacity = instanceCapacity;
+	lastStatistics = statistics;
+}
+
+// 溜めているスプライトを描く
+void InstancedSpriteBatch::Flush()
+{
+	if (sprites.empty()) return;
+
+	//--- < 並べ替え (同じキーなら Draw の順を保つ) > ---
+	switch (sortMode)
+	{
+	case SORT_MODE::TEXTURE:
+		std::stable_sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) { return a.texture < b.texture; });
+		break;
+	case SORT_MODE::BACK_TO_FRONT:
+		std::stable_sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) { return a.instance.param.z > b.instance.param.z; });
+		break;
+	case SORT_MODE::FRONT_TO_BACK:
+		std::stable_sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) { return a.instance.param.z < b.instance.param.z; });
+		break;
+	default:
+		break;
+	}
+
+	//--- < 足りなければインスタンスバッファを広げる (InstanceMax まで) > ---
+	if (sprites.size() > instanceCapacity && instanceCapacity < InstanceMax)
+	{
+		UINT capacity = instanceCapacity;
+		while (capacity < sprites.size() && capacity < InstanceMax) capacity *= 2;
+		CreateInstanceBuffer((std::min)(capacity, InstanceMax));
+	}
+
+	BindStates();
+
+	//--- < バッファに入る分ずつ書き込んで描く > ---
+	const Sprite* data = sprites.data();
+	size_t remaining = sprites.size();
+	while (remaining > 0)
+	{
+		const size_t count = (std::min)(remaining, static_cast<size_t>(instanceCapacity));
+		DrawSprites(data, count);
+		data += count;
+		remaining -= count;
+	}
+
+	sprites.clear();
+}
+
+// テクスチャが同じ区間ごとにインスタンスバッファへ書いて描く
+void InstancedSpriteBatch::DrawSprites(const Sprite* data, size_t count)
+{
+	Graphics& gfx = Graphics::Instance();
+
+	//--- < 書き込む位置 (後ろに入らなければ DISCARD して先頭から) > ---
+	D3D11_MAP mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+	if (instanceCursor + count > instanceCapacity)
+	{
+		mapType = D3D11_MAP_WRITE_DISCARD;
+		instanceCursor = 0;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mappedSubresource{};
+	HRESULT hr = gfx.stateCache.Map(instanceBuffer.Get(), 0, mapType, 0, &mappedSubresource);
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	Instance* instances = reinterpret_cast<Instance*>(mappedSubresource.pData) + instanceCursor;
+	for (size_t i = 0; i < count; ++i)
+	{
+		instances[i] = data[i].instance;
+	}
+	gfx.stateCache.Unmap(instanceBuffer.Get(), 0, static_cast<UINT>(sizeof(Instance) * count));
+	++statistics.flushCount;
+
+	//--- < テクスチャ配列が変わる所で区切って描く > ---
+	size_t start = 0;
+	while (start < count)
+	{
+		const TextureArray* texture = data[start].texture;
+		size_t end = start + 1;
+		while (end < count && data[end].texture == texture) ++end;
+
+		ID3D11ShaderResourceView* shaderResourceView = texture->GetShaderResourceView();
+		gfx.stateCache.PSSetShaderResources(0, 1, &shaderResourceView);
+		gfx.stateCache.DrawInstanced(4, static_cast<UINT>(end - start), 0, instanceCursor + static_cast<UINT>(start));
+		++statistics.drawCalls;
+
+		start = end;
+	}
+
+	instanceCursor += static_cast<UINT>(count);
+	statistics.spriteCount += static_cast<uint32_t>(count);
+}
+
+// インスタンスバッファの作り直し
+void InstancedSpriteBatch::CreateInstanceBuffer(UINT capacity)
+{
+	Graphics& gfx = Graphics::Instance();
+
+	D3D11_BUFFER_DESC bufferDesc{};
+	bufferDesc.ByteWidth = sizeof(Instance) * capacity;
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	HRESULT hr = gfx.device->CreateBuffer(&bufferDesc, nullptr, instanceBuffer.ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	instanceCapacity = capacity;
+	instanceCursor = 0;
+}
+
+// 描画に使うステートの設定
+void InstancedSpriteBatch::BindStates()
+{
+	Graphics& gfx = Graphics::Instance();
+
+	//--- < スクリーン(ビューポート)のサイズから NDC への係数を求める > ---
+	D3D11_VIEWPORT viewport{};
+	UINT numViewports = 1;
+	gfx.stateCache.RSGetViewports(&numViewports, &viewport);
+
+	Constants constants{};
+	constants.screenScale = { 2.0f / viewport.Width, 2.0f / viewport.Height };
+	gfx.stateCache.UpdateSubresource(constantBuffer.Get(), 0, nullptr, &constants, 0, 0);
+
+	//--- < シェーダーとバッファのバインド > ---
+	gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
+	gfx.stateCache.VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+
+	UINT stride = sizeof(Instance);
+	UINT offset = 0;
+	gfx.stateCache.IASetVertexBuffers(0, 1, instanceBuffer.GetAddressOf(), &stride, &offset);
+	gfx.stateCache.IASetInputLayout(inputLayout.Get());
+
+	// 頂点は SV_VertexID から作る 4 頂点のストリップ
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// InstancedSpriteBatch
+//--------------------------------------------------------------
+// スプライト 1 枚を 1 インスタンス (64byte) として動的バッファに詰め、DrawInstanced でまとめて描く
+// 矩形の 4 頂点は頂点シェーダーが SV_VertexID から作るので、CPU では回転も NDC 変換もしない
+// テクスチャは Texture2DArray にまとめておき、スライス番号で絵を選ぶ (同じ配列なら 1 回で描ける)
+//
+// Begin ~ End の間に Draw を呼ぶ
+// DEFERRED はテクスチャ配列が変わった時とバッファが一杯になった時に自動で描画する
+// 並べ替えありのモードは End でまとめて並べ替えてから描画する
+class InstancedSpriteBatch
+{
+public:
+	// 同じ大きさ・フォーマットの画像をまとめたテクスチャ配列
+	class TextureArray
+	{
+	public:
+		// 全ての画像を読み込んで 1 つの配列にする (大きさかフォーマットが違えば失敗)
+		bool Load(const wchar_t* const* filenames, UINT count);
+
+		ID3D11ShaderResourceView* GetShaderResourceView() const { return shaderResourceView.Get(); }
+		UINT GetWidth() const { return width; }
+		UINT GetHeight() const { return height; }
+		UINT GetSliceCount() const { return sliceCount; }
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceView;
+		UINT width = 0;
+		UINT height = 0;
+		UINT sliceCount = 0;
+	};
+
+	// 描画順
+	enum class SORT_MODE
+	{
+		DEFERRED,			// Draw の順 (テクスチャ配列が変わる所で区切る)
+		TEXTURE,			// テクスチャ配列ごと
+		BACK_TO_FRONT,		// 深度の大きいものから
+		FRONT_TO_BACK,		// 深度の小さいものから
+	};
+
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		uint32_t spriteCount = 0;
+		uint32_t drawCalls = 0;
+		uint32_t flushCount = 0;		// インスタンスバッファへの書き込み回数
+		uint32_t capacity = 0;			// インスタンスバッファに入る数
+	};
+
+	// インスタンスバッファに入る最大数 (これを超えると途中で描画する)
+	static constexpr UINT InstanceMax = 65536;
+
+public:
+	// initialCapacity : 最初に確保するインスタンス数 (足りなければ InstanceMax まで倍に広げる)
+	InstancedSpriteBatch(UINT initialCapacity = 1024);
+	~InstancedSpriteBatch() {}
+
+	void Begin(SORT_MODE sortMode = SORT_MODE::DEFERRED);
+
+	// dx, dy, dw, dh : 描画先の矩形 (スクリーン座標)
+	// sx, sy, sw, sh : 切り抜く矩形 (テクセル)
+	// angle : 矩形の中心で回す角度 (度)
+	// slice : テクスチャ配列の番号
+	// depth : 深度 (0 ~ 1、並べ替えにも使う)
+	void Draw(const TextureArray& texture, float dx, float dy, float dw, float dh);
+	void Draw(const TextureArray& texture, float dx, float dy, float dw, float dh,
+		float r, float g, float b, float a, float angle, UINT slice = 0, float depth = 0);
+	void Draw(const TextureArray& texture, float dx, float dy, float dw, float dh,
+		float r, float g, float b, float a, float angle,
+		float sx, float sy, float sw, float sh, UINT slice = 0, float depth = 0);
+
+	void End();
+
+	// 前フレームの統計
+	const Statistics& GetStatistics() const { return lastStatistics; }
+
+private:
+	// インスタンス (SpriteBatch.hlsli の VS_IN と合わせる)
+	struct Instance
+	{
+		DirectX::XMFLOAT4 rect;			// 左上の座標と大きさ
+		DirectX::XMFLOAT4 texcoord;		// 左上と右下の UV
+		DirectX::XMFLOAT4 color;
+		DirectX::XMFLOAT4 param;		// x : 回転 (ラジアン), y : スライス, z : 深度
+	};
+
+	// 溜めているスプライト
+	struct Sprite
+	{
+		Instance instance;
+		const TextureArray* texture;
+	};
+
+	struct Constants
+	{
+		DirectX::XMFLOAT2 screenScale;
+		DirectX::XMFLOAT2 pad;
+	};
+
+	// 溜めているスプライトを描く
+	void Flush();
+
+	// テクスチャが同じ区間ごとにインスタンスバッファへ書いて描く
+	void DrawSprites(const Sprite* sprites, size_t count);
+
+	// インスタンスバッファの作り直し
+	void CreateInstanceBuffer(UINT capacity);
+
+	// 描画に使うステートの設定
+	void BindStates();
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
+	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
+	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> instanceBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
+
+	std::vector<Sprite> sprites;
+
+	UINT instanceCapacity = 0;
+	UINT instanceCursor = 0;		// 次に書き込む位置 (一杯になったら DISCARD して 0 に戻す)
+
+	SORT_MODE sortMode = SORT_MODE::DEFERRED;
+	bool inBeginEndPair = false;
+
+	Statistics statistics;
+	Statistics lastStatistics;
+};
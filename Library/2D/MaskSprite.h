@@ -3,6 +3,8 @@
 #include <DirectXMath.h>
 #include "../Graphics/Texture.h"
 
+// 描画は Renderer2D に積まれ、Renderer2D::Flush でまとめて描かれる
+// (maskConstant は Render を呼んだ時の値がインスタンスデータに入る)
 class MaskSprite
 {
 public:
@@ -12,22 +14,10 @@ public:
 	void Render(float dx, float dy, float dw, float dh, float r, float g, float b, float a, float angle, float sx, float sy, float sw, float sh);
 
 private:
-	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
-	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
-	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceView;
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> maskSRV;
 	D3D11_TEXTURE2D_DESC texture2dDesc;
 
-	struct vertex
-	{
-		DirectX::XMFLOAT3 position;
-		DirectX::XMFLOAT4 color;
-		DirectX::XMFLOAT2 texcoord;
-	};
-
 	struct MaskConstant
 	{
 		float dissolveThreshold;		// ディゾルブ量
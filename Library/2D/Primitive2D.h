@@ -3,6 +3,7 @@
 #include <DirectXMath.h>
 #include "../Graphics/Texture.h"
 
+// 描画は Renderer2D に積まれ、Renderer2D::Flush でまとめて描かれる
 class Primitive2D
 {
 public:
@@ -10,16 +11,4 @@ public:
 	~Primitive2D();
 
 	void Render(float dx, float dy, float dw, float dh, float r, float g, float b, float a, float angle);
-
-private:
-	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
-	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
-	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
-
-	struct vertex
-	{
-		DirectX::XMFLOAT3 position;
-		DirectX::XMFLOAT4 color;
-	};
 };
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include "Renderer2D.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/Shader.h"
+#include "../ErrorLogger.h"
+#include "../MemoryTracker.h"
+
+using namespace DirectX;
+
+// 初期化
+void Renderer2D::Initialize()
+{
+	Graphics& gfx = Graphics::Instance();
+
+	//--- < インスタンスバッファの生成 > ---
+	CreateInstanceBuffer(1024);
+
+	//--- < 定数バッファの生成 > ---
+	D3D11_BUFFER_DESC bufferDesc{};
+	bufferDesc.ByteWidth = sizeof(Constants);
+	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	HRESULT hr = gfx.device->CreateBuffer(&bufferDesc, nullptr, constantBuffer.GetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	//--- < 頂点シェーダーオブジェクトと入力レイアウトオブジェクトの生成 > ---
+	// 頂点ごとのデータはないので、入力は全てインスタンスごと
+	D3D11_INPUT_ELEMENT_DESC inputElementDesc[]
+	{
+		{"RECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"TEXCOORD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"EFFECT_PARAM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"EFFECT_COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+	};
+	CreateVsFromCso("./Data/Shader/Renderer2D_VS.cso", vertexShader.GetAddressOf(), inputLayout.GetAddressOf(), inputElementDesc, _countof(inputElementDesc));
+
+	//--- < ピクセルシェーダーオブジェクトの生成 > ---
+	CreatePsFromCso("./Data/Shader/Renderer2DColor_PS.cso", pixelShaders[static_cast<size_t>(EFFECT::COLOR)].GetAddressOf());
+	CreatePsFromCso("./Data/Shader/Renderer2DSprite_PS.cso", pixelShaders[static_cast<size_t>(EFFECT::SPRITE)].GetAddressOf());
+	CreatePsFromCso("./Data/Shader/Renderer2DFont_PS.cso", pixelShaders[static_cast<size_t>(EFFECT::FONT)].GetAddressOf());
+	CreatePsFromCso("./Data/Shader/Renderer2DMask_PS.cso", pixelShaders[static_cast<size_t>(EFFECT::MASK)].GetAddressOf());
+
+	commands.reserve(instanceCapacity);
+}
+
+// 矩形の設定
+Renderer2D::Quad Renderer2D::MakeQuad(float dx, float dy, float dw, float dh, float r, float g, float b, float a, float angle)
+{
+	Quad quad;
+	quad.rect = { dx, dy, dw, dh };
+	quad.color = { r, g, b, a };
+	quad.transform.x = XMConvertToRadians(angle);
+	return quad;
+}
+
+// テクセルの矩形から UV を設定
+void Renderer2D::SetTexcoord(Quad& quad, const D3D11_TEXTURE2D_DESC& texture2dDesc, float sx, float sy, float sw, float sh)
+{
+	//--- < テクセル座標系からUV座標系への変換 > ---
+	const float invWidth = 1.0f / static_cast<float>(texture2dDesc.Width);
+	const float invHeight = 1.0f / static_cast<float>(texture2dDesc.Height);
+	quad.texcoord = { sx * invWidth, sy * invHeight, (sx + sw) * invWidth, (sy + sh) * invHeight };
+}
+
+// 描画を積む
+void Renderer2D::Draw(EFFECT effect, ID3D11ShaderResourceView* texture0, ID3D11ShaderResourceView* texture1, const Quad& quad)
+{
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::RENDER);
+
+	Command& command = commands.emplace_back();
+	command.quad = quad;
+	command.effect = effect;
+	command.textures[0] = texture0;
+	command.textures[1] = texture1;
+	command.order = static_cast<uint32_t>(commands.size());
+}
+
+// 積んだ描画を 1 レイヤーとして描く
+void Renderer2D::Flush()
+{
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::RENDER);
+
+	if (commands.empty()) return;
+
+	Graphics& gfx = Graphics::Instance();
+
+	//--- < (エフェクト, テクスチャ) で並べ替え (同じものは積んだ順) > ---
+	if (sortInLayer)
+	{
+		std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b)
+			{
+				if (a.effect != b.effect) return a.effect < b.effect;
+				if (a.textures[0] != b.textures[0]) return a.textures[0] < b.textures[0];
+				if (a.textures[1] != b.textures[1]) return a.textures[1] < b.textures[1];
+				return a.order < b.order;
+			});
+	}
+
+	//--- < 足りなければインスタンスバッファを広げる (InstanceMax まで) > ---
+	if (commands.size() > instanceCapacity && instanceCapacity < InstanceMax)
+	{
+		UINT capacity = instanceCapacity;
+		while (capacity < commands.size() && capacity < InstanceMax) capacity *= 2;
+		CreateInstanceBuffer((std::min)(capacity, InstanceMax));
+	}
+
+	//--- < スクリーン(ビューポート)のサイズから NDC への係数を求める > ---
+	D3D11_VIEWPORT viewport{};
+	UINT numViewports = 1;
+	gfx.stateCache.RSGetViewports(&numViewports, &viewport);
+
+	Constants constants{};
+	constants.screenScale = { 2.0f / viewport.Width, 2.0f / viewport.Height };
+	gfx.stateCache.UpdateSubresource(constantBuffer.Get(), 0, nullptr, &constants, 0, 0);
+
+	//--- < 全ての描画で共通のバインド > ---
+	gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+
+	UINT stride = sizeof(Quad);
+	UINT offset = 0;
+	gfx.stateCache.IASetVertexBuffers(0, 1, instanceBuffer.GetAddressOf(), &stride, &offset);
+	gfx.stateCache.IASetInputLayout(inputLayout.Get());
+
+	// 頂点は SV_VertexID から作る 4 頂点のストリップ
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+
+	//--- < バッファに入る分ずつ書き込んで描く > ---
+	const Command* data = commands.data();
+	size_t remaining = commands.size();
+	while (remaining > 0)
+	{
+		const size_t count = (std::min)(remaining, static_cast<size_t>(instanceCapacity));
+		DrawCommands(data, count);
+		data += count;
+		remaining -= count;
+	}
+
+	statistics.commandCount += static_cast<uint32_t>(commands.size());
+	++statistics.layerCount;
+
+	commands.clear();
+}
+
+// フレームの開始
+void Renderer2D::BeginFrame()
+{
+	lastStatistics = statistics;
+	statistics = {};
+}
+
+// インスタンスバッファに書き込んで描く
+void Renderer2D::DrawCommands(const Command* data, size_t count)
+{
+	Graphics& gfx = Graphics::Instance();
+
+	//--- < 書き込む位置 (後ろに入らなければ DISCARD して先頭から) > ---
+	D3D11_MAP mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+	if (instanceCursor + count > instanceCapacity)
+	{
+		mapType = D3D11_MAP_WRITE_DISCARD;
+		instanceCursor = 0;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mappedSubresource{};
+	HRESULT hr = gfx.stateCache.Map(instanceBuffer.Get(), 0, mapType, 0, &mappedSubresource);
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	Quad* quads = reinterpret_cast<Quad*>(mappedSubresource.pData) + instanceCursor;
+	for (size_t i = 0; i < count; ++i)
+	{
+		quads[i] = data[i].quad;
+	}
+	gfx.stateCache.Unmap(instanceBuffer.Get(), 0, static_cast<UINT>(sizeof(Quad) * count));
+
+	//--- < 同じシェーダー・テクスチャが続く所をまとめて描く > ---
+	size_t start = 0;
+	while (start < count)
+	{
+		const Command& command = data[start];
+		size_t end = start + 1;
+		while (end < count && IsSameBatch(command, data[end])) ++end;
+
+		gfx.stateCache.PSSetShader(pixelShaders[static_cast<size_t>(command.effect)].Get(), nullptr, 0);
+		if (command.effect == EFFECT::MASK)
+		{
+			gfx.stateCache.PSSetShaderResources(0, 2, command.textures);
+		}
+		else if (command.effect != EFFECT::COLOR)
+		{
+			gfx.stateCache.PSSetShaderResources(0, 1, command.textures);
+		}
+		gfx.stateCache.DrawInstanced(4, static_cast<UINT>(end - start), 0, instanceCursor + static_cast<UINT>(start));
+		++statistics.drawCalls;
+
+		start = end;
+	}
+
+	instanceCursor += static_cast<UINT>(count);
+}
+
+// インスタンスバッファの作り直し
+void Renderer2D::CreateInstanceBuffer(UINT capacity)
+{
+	Graphics& gfx = Graphics::Instance();
+
+	D3D11_BUFFER_DESC bufferDesc{};
+	bufferDesc.ByteWidth = sizeof(Quad) * capacity;
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	HRESULT hr = gfx.device->CreateBuffer(&bufferDesc, nullptr, instanceBuffer.ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	instanceCapacity = capacity;
+	instanceCursor = 0;
+}
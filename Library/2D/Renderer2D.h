@@ -0,0 +1,130 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// Renderer2D
+//--------------------------------------------------------------
+// Sprite, Primitive2D, UVScrollSprite, MaskSprite, DispString の描画をまとめる 2D コマンドリスト
+// 各クラスの Render は矩形とエフェクトの値をインスタンスデータとして積むだけで、ここではまだ描かない
+// Flush で 1 レイヤー分を (エフェクト, テクスチャ) で並べ替え、同じものを DrawInstanced 1 回にまとめて描く
+//
+// 同じレイヤー内の重なり順は (エフェクト, テクスチャ) の順になるので、
+// 重なり順を守りたい所 (背景と HUD の間など) で Flush を呼んでレイヤーを区切ること
+// 描き先・深度ステートなどは Flush した時点のものが使われる
+class Renderer2D
+{
+private:
+	Renderer2D() {}
+	~Renderer2D() {}
+
+public:
+	static Renderer2D& Instance()
+	{
+		static Renderer2D instance;
+		return instance;
+	}
+
+	// 描画の種類 (ピクセルシェーダーが変わる)
+	enum class EFFECT
+	{
+		COLOR,		// 単色 (Primitive2D)
+		SPRITE,		// テクスチャ (Sprite, UVScrollSprite)
+		FONT,		// 文字 (DispString)
+		MASK,		// ディゾルブ (MaskSprite)
+
+		EFFECT_COUNT
+	};
+
+	// 2D 描画 1 つ分 (Renderer2D.hlsli の VS_IN と合わせる)
+	struct Quad
+	{
+		DirectX::XMFLOAT4 rect = { 0,0,0,0 };			// 左上の座標と大きさ (スクリーン座標)
+		DirectX::XMFLOAT4 texcoord = { 0,0,1,1 };		// 左上と右下の UV
+		DirectX::XMFLOAT4 color = { 1,1,1,1 };
+		DirectX::XMFLOAT4 transform = { 0,0,0,0 };		// x : 回転 (ラジアン), yz : UV スクロール量
+		DirectX::XMFLOAT4 effectParam = { 0,0,0,0 };	// x : ディゾルブ量, y : 縁の閾値
+		DirectX::XMFLOAT4 effectColor = { 0,0,0,0 };	// 縁の色
+	};
+
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		uint32_t commandCount = 0;	// 積まれた描画
+		uint32_t drawCalls = 0;
+		uint32_t layerCount = 0;	// 描画のあった Flush
+	};
+
+	// インスタンスバッファに入る最大数 (これを超えると分けて書き込む)
+	static constexpr UINT InstanceMax = 16384;
+
+public:
+	// 初期化
+	void Initialize();
+
+	// 矩形の設定 (dx, dy, dw, dh はスクリーン座標、angle は度)
+	static Quad MakeQuad(float dx, float dy, float dw, float dh, float r, float g, float b, float a, float angle);
+	// テクセルの矩形から UV を設定
+	static void SetTexcoord(Quad& quad, const D3D11_TEXTURE2D_DESC& texture2dDesc, float sx, float sy, float sw, float sh);
+
+	// 描画を積む (texture1 は MASK のマスク画像)
+	void Draw(EFFECT effect, ID3D11ShaderResourceView* texture0, ID3D11ShaderResourceView* texture1, const Quad& quad);
+
+	// 積んだ描画を 1 レイヤーとして描く
+	void Flush();
+
+	// フレームの開始 (統計を前フレーム分へ移す)
+	void BeginFrame();
+
+	// 前フレームの統計
+	const Statistics& GetStatistics() const { return lastStatistics; }
+
+public:
+	// false にすると積んだ順のまま描く (隣り合った同じものだけまとめる)
+	bool sortInLayer = true;
+
+private:
+	struct Command
+	{
+		Quad quad;
+		EFFECT effect;
+		ID3D11ShaderResourceView* textures[2];
+		uint32_t order;		// 積んだ順 (並べ替えで同じキーの順を保つ)
+	};
+
+	struct Constants
+	{
+		DirectX::XMFLOAT2 screenScale;
+		DirectX::XMFLOAT2 pad;
+	};
+
+	// 同じシェーダー・テクスチャで描けるか
+	static bool IsSameBatch(const Command& a, const Command& b)
+	{
+		return a.effect == b.effect && a.textures[0] == b.textures[0] && a.textures[1] == b.textures[1];
+	}
+
+	// インスタンスバッファに書き込んで描く
+	void DrawCommands(const Command* commands, size_t count);
+
+	// インスタンスバッファの作り直し
+	void CreateInstanceBuffer(UINT capacity);
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
+	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShaders[static_cast<size_t>(EFFECT::EFFECT_COUNT)];
+	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> instanceBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
+
+	std::vector<Command> commands;
+
+	UINT instanceCapacity = 0;
+	UINT instanceCursor = 0;		// 次に書き込む位置 (一杯になったら DISCARD して 0 に戻す)
+
+	Statistics statistics;
+	Statistics lastStatistics;
+};
@@ -3,6 +3,7 @@
 #include <DirectXMath.h>
 #include "../Graphics/Texture.h"
 
+// 描画は Renderer2D に積まれ、Renderer2D::Flush でまとめて描かれる
 class Sprite
 {
 public:
@@ -12,17 +13,6 @@ public:
 	void Render(float dx, float dy, float dw, float dh, float r, float g, float b, float a, float angle, float sx, float sy, float sw, float sh);
 
 private:
-	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
-	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
-	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceView;
 	D3D11_TEXTURE2D_DESC texture2dDesc;
-
-	struct vertex
-	{
-		DirectX::XMFLOAT3 position;
-		DirectX::XMFLOAT4 color;
-		DirectX::XMFLOAT2 texcoord;
-	};
 };
\ No newline at end of file
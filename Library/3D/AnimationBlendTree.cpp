@@ -0,0 +1,545 @@
+#include <cmath>
+#include <algorithm>
+#include "AnimationBlendTree.h"
+
+using namespace DirectX;
+
+// これより回転差の大きい (内積の小さい) ノードは nlerp の誤差が目立つので slerp で計算し直す
+static const float SLERP_THRESHOLD = 0.7f;
+
+//--------------------------------------------------------------
+// SoA 演算
+//--------------------------------------------------------------
+
+// 4 ノード分のクォータニオン
+struct QuaternionBlock
+{
+	XMVECTOR x, y, z, w;
+};
+
+static QuaternionBlock LoadQuaternion(const AnimationPose& pose, size_t block)
+{
+	return
+	{
+		XMLoadFloat4A(&pose.qx[block]),
+		XMLoadFloat4A(&pose.qy[block]),
+		XMLoadFloat4A(&pose.qz[block]),
+		XMLoadFloat4A(&pose.qw[block]),
+	};
+}
+
+static void StoreQuaternion(AnimationPose& pose, size_t block, const QuaternionBlock& q)
+{
+	XMStoreFloat4A(&pose.qx[block], q.x);
+	XMStoreFloat4A(&pose.qy[block], q.y);
+	XMStoreFloat4A(&pose.qz[block], q.z);
+	XMStoreFloat4A(&pose.qw[block], q.w);
+}
+
+static XMVECTOR Dot(const QuaternionBlock& a, const QuaternionBlock& b)
+{
+	XMVECTOR d = XMVectorMultiply(a.x, b.x);
+	d = XMVectorMultiplyAdd(a.y, b.y, d);
+	d = XMVectorMultiplyAdd(a.z, b.z, d);
+	return XMVectorMultiplyAdd(a.w, b.w, d);
+}
+
+// 正規化 (長さ 0 のレーンは単位クォータニオンにする)
+static QuaternionBlock Normalize(const QuaternionBlock& q)
+{
+	const XMVECTOR lengthSq = Dot(q, q);
+	const XMVECTOR valid = XMVectorGreater(lengthSq, XMVectorReplicate(1.0e-12f));
+	const XMVECTOR invLength = XMVectorReciprocalSqrt(XMVectorSelect(g_XMOne, lengthSq, valid));
+	return
+	{
+		XMVectorSelect(g_XMZero, XMVectorMultiply(q.x, invLength), valid),
+		XMVectorSelect(g_XMZero, XMVectorMultiply(q.y, invLength), valid),
+		XMVectorSelect(g_XMZero, XMVectorMultiply(q.z, invLength), valid),
+		XMVectorSelect(g_XMOne, XMVectorMultiply(q.w, invLength), valid),
+	};
+}
+
+// 符号反転 (sign は 1 か -1)
+static QuaternionBlock Scale(const QuaternionBlock& q, FXMVECTOR s)
+{
+	return { XMVectorMultiply(q.x, s), XMVectorMultiply(q.y, s), XMVectorMultiply(q.z, s), XMVectorMultiply(q.w, s) };
+}
+
+// 内積が負なら -1 (最短経路で補間するため)
+static XMVECTOR HemisphereSign(FXMVECTOR dot)
+{
+	return XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(dot, g_XMZero));
+}
+
+// ハミルトン積 p * q (q を回してから p を回す)
+static QuaternionBlock Multiply(const QuaternionBlock& p, const QuaternionBlock& q)
+{
+	QuaternionBlock r;
+	r.w = XMVectorSubtract(XMVectorSubtract(XMVectorSubtract(XMVectorMultiply(p.w, q.w), XMVectorMultiply(p.x, q.x)), XMVectorMultiply(p.y, q.y)), XMVectorMultiply(p.z, q.z));
+	r.x = XMVectorSubtract(XMVectorAdd(XMVectorAdd(XMVectorMultiply(p.w, q.x), XMVectorMultiply(p.x, q.w)), XMVectorMultiply(p.y, q.z)), XMVectorMultiply(p.z, q.y));
+	r.y = XMVectorAdd(XMVectorAdd(XMVectorSubtract(XMVectorMultiply(p.w, q.y), XMVectorMultiply(p.x, q.z)), XMVectorMultiply(p.y, q.w)), XMVectorMultiply(p.z, q.x));
+	r.z = XMVectorAdd(XMVectorSubtract(XMVectorAdd(XMVectorMultiply(p.w, q.z), XMVectorMultiply(p.x, q.y)), XMVectorMultiply(p.y, q.x)), XMVectorMultiply(p.z, q.w));
+	return r;
+}
+
+static XMVECTOR LerpLane(const std::vector<XMFLOAT4A>& a, const std::vector<XMFLOAT4A>& b, size_t block, FXMVECTOR t)
+{
+	return XMVectorLerpV(XMLoadFloat4A(&a[block]), XMLoadFloat4A(&b[block]), t);
+}
+
+//--------------------------------------------------------------
+// BoneMask
+//--------------------------------------------------------------
+
+// 全ノード weight で初期化
+void BoneMask::Resize(size_t nodeCount, float weight)
+{
+	this->nodeCount = nodeCount;
+	weights.assign((nodeCount + 3) / 4, XMFLOAT4A(weight, weight, weight, weight));
+}
+
+// rootNodeName のノードとその子孫に weight を設定する
+void BoneMask::SetBranch(const SkinnedMesh& model, const std::string& rootNodeName, float weight)
+{
+	const size_t count = model.sceneView.nodes.size();
+	if (nodeCount != count) Resize(count);
+
+	const int64_t rootIndex = model.FindNodeIndex(rootNodeName);
+	if (rootIndex < 0) return;
+
+	// ノードは親が先に並んでいるので、親が含まれていれば子も含める
+	std::vector<bool> inBranch(count, false);
+	for (size_t nodeIndex = 0; nodeIndex < count; nodeIndex++)
+	{
+		const int64_t parentIndex = model.sceneView.nodes.at(nodeIndex).parentIndex;
+		inBranch[nodeIndex] = (static_cast<int64_t>(nodeIndex) == rootIndex) || (parentIndex >= 0 && inBranch[parentIndex]);
+		if (inBranch[nodeIndex]) SetWeight(nodeIndex, weight);
+	}
+}
+
+//--------------------------------------------------------------
+// AnimationPose
+//--------------------------------------------------------------
+
+// ノード数設定
+void AnimationPose::Resize(size_t nodeCount)
+{
+	if (this->nodeCount == nodeCount && !tx.empty()) return;
+	this->nodeCount = nodeCount;
+
+	const size_t blockCount = (nodeCount + 3) / 4;
+	const XMFLOAT4A zero(0, 0, 0, 0);
+	const XMFLOAT4A one(1, 1, 1, 1);
+	tx.assign(blockCount, zero);
+	ty.assign(blockCount, zero);
+	tz.assign(blockCount, zero);
+	qx.assign(blockCount, zero);
+	qy.assign(blockCount, zero);
+	qz.assign(blockCount, zero);
+	qw.assign(blockCount, one);
+	sx.assign(blockCount, one);
+	sy.assign(blockCount, one);
+	sz.assign(blockCount, one);
+}
+
+// キーフレームから読み込み
+void AnimationPose::SetFromKeyFrame(const Animation::KeyFrame& keyFrame)
+{
+	const size_t count = keyFrame.nodes.size();
+	Resize(count);
+	if (count == 0) return;
+
+	float* t[3] = { &tx[0].x, &ty[0].x, &tz[0].x };
+	float* q[4] = { &qx[0].x, &qy[0].x, &qz[0].x, &qw[0].x };
+	float* s[3] = { &sx[0].x, &sy[0].x, &sz[0].x };
+	for (size_t nodeIndex = 0; nodeIndex < count; nodeIndex++)
+	{
+		const Animation::KeyFrame::Node& node = keyFrame.nodes[nodeIndex];
+		t[0][nodeIndex] = node.translation.x;
+		t[1][nodeIndex] = node.translation.y;
+		t[2][nodeIndex] = node.translation.z;
+		q[0][nodeIndex] = node.rotation.x;
+		q[1][nodeIndex] = node.rotation.y;
+		q[2][nodeIndex] = node.rotation.z;
+		q[3][nodeIndex] = node.rotation.w;
+		s[0][nodeIndex] = node.scaling.x;
+		s[1][nodeIndex] = node.scaling.y;
+		s[2][nodeIndex] = node.scaling.z;
+	}
+}
+
+// キーフレームへ書き出し
+void AnimationPose::WriteToKeyFrame(Animation::KeyFrame& keyFrame) const
+{
+	const size_t count = (std::min)(keyFrame.nodes.size(), nodeCount);
+	if (count == 0) return;
+
+	const float* t[3] = { &tx[0].x, &ty[0].x, &tz[0].x };
+	const float* q[4] = { &qx[0].x, &qy[0].x, &qz[0].x, &qw[0].x };
+	const float* s[3] = { &sx[0].x, &sy[0].x, &sz[0].x };
+	for (size_t nodeIndex = 0; nodeIndex < count; nodeIndex++)
+	{
+		Animation::KeyFrame::Node& node = keyFrame.nodes[nodeIndex];
+		node.translation = { t[0][nodeIndex], t[1][nodeIndex], t[2][nodeIndex] };
+		node.rotation = { q[0][nodeIndex], q[1][nodeIndex], q[2][nodeIndex], q[3][nodeIndex] };
+		node.scaling = { s[0][nodeIndex], s[1][nodeIndex], s[2][nodeIndex] };
+	}
+}
+
+// 2 ポーズの補間
+void AnimationPose::Lerp(const AnimationPose& a, const AnimationPose& b, float t, AnimationPose& out)
+{
+	LerpBlocks(a, b, t, nullptr, out);
+}
+
+// レイヤー
+void AnimationPose::Layer(const AnimationPose& base, const AnimationPose& layer, float weight, const BoneMask* mask, AnimationPose& out)
+{
+	LerpBlocks(base, layer, weight, mask, out);
+}
+
+// t をノードごとに与える補間
+void AnimationPose::LerpBlocks(const AnimationPose& a, const AnimationPose& b, float t, const BoneMask* mask, AnimationPose& out)
+{
+	const size_t count = (std::min)(a.nodeCount, b.nodeCount);
+	out.Resize(count);
+
+	// マスクの重み * t をノードごとの補間率にする
+	const bool useMask = mask && mask->GetNodeCount() == count;
+	const XMVECTOR uniformT = XMVectorReplicate(t);
+
+	const XMVECTOR threshold = XMVectorReplicate(SLERP_THRESHOLD);
+	const size_t blockCount = (count + 3) / 4;
+	for (size_t block = 0; block < blockCount; block++)
+	{
+		const XMVECTOR T = useMask ? XMVectorMultiply(XMLoadFloat4A(&mask->weights[block]), uniformT) : uniformT;
+
+		// 移動・拡縮は線形補間
+		const XMVECTOR TX = LerpLane(a.tx, b.tx, block, T);
+		const XMVECTOR TY = LerpLane(a.ty, b.ty, block, T);
+		const XMVECTOR TZ = LerpLane(a.tz, b.tz, block, T);
+		const XMVECTOR SX = LerpLane(a.sx, b.sx, block, T);
+		const XMVECTOR SY = LerpLane(a.sy, b.sy, block, T);
+		const XMVECTOR SZ = LerpLane(a.sz, b.sz, block, T);
+
+		// 回転は nlerp
+		const QuaternionBlock qa = LoadQuaternion(a, block);
+		QuaternionBlock qb = LoadQuaternion(b, block);
+		const XMVECTOR dot = Dot(qa, qb);
+		qb = Scale(qb, HemisphereSign(dot));
+
+		QuaternionBlock q =
+		{
+			XMVectorLerpV(qa.x, qb.x, T),
+			XMVectorLerpV(qa.y, qb.y, T),
+			XMVectorLerpV(qa.z, qb.z, T),
+			XMVectorLerpV(qa.w, qb.w, T),
+		};
+		q = Normalize(q);
+
+		XMStoreFloat4A(&out.tx[block], TX);
+		XMStoreFloat4A(&out.ty[block], TY);
+		XMStoreFloat4A(&out.tz[block], TZ);
+		XMStoreFloat4A(&out.sx[block], SX);
+		XMStoreFloat4A(&out.sy[block], SY);
+		XMStoreFloat4A(&out.sz[block], SZ);
+		StoreQuaternion(out, block, q);
+
+		// 角度の大きいレーンだけ slerp で計算し直す
+		XMVECTOR needSlerp = XMVectorLess(XMVectorAbs(dot), threshold);
+		if (XMVector4EqualInt(needSlerp, XMVectorFalseInt())) continue;
+
+		// out が a / b と同じ場合があるので、保存前に読んだ値から計算する
+		uint32_t laneMask[4];
+		XMStoreInt4(laneMask, needSlerp);
+		XMFLOAT4A laneT, ax, ay, az, aw, bx, by, bz, bw;
+		XMStoreFloat4A(&laneT, T);
+		XMStoreFloat4A(&ax, qa.x); XMStoreFloat4A(&ay, qa.y); XMStoreFloat4A(&az, qa.z); XMStoreFloat4A(&aw, qa.w);
+		XMStoreFloat4A(&bx, qb.x); XMStoreFloat4A(&by, qb.y); XMStoreFloat4A(&bz, qb.z); XMStoreFloat4A(&bw, qb.w);
+		for (size_t lane = 0; lane < 4; lane++)
+		{
+			const size_t nodeIndex = block * 4 + lane;
+			if (!laneMask[lane] || nodeIndex >= count) continue;
+
+			const XMVECTOR Q0 = XMVectorSet((&ax.x)[lane], (&ay.x)[lane], (&az.x)[lane], (&aw.x)[lane]);
+			const XMVECTOR Q1 = XMVectorSet((&bx.x)[lane], (&by.x)[lane], (&bz.x)[lane], (&bw.x)[lane]);
+
+			XMFLOAT4 r;
+			XMStoreFloat4(&r, XMQuaternionSlerp(Q0, Q1, (&laneT.x)[lane]));
+			(&out.qx[block].x)[lane] = r.x;
+			(&out.qy[block].x)[lane] = r.y;
+			(&out.qz[block].x)[lane] = r.z;
+			(&out.qw[block].x)[lane] = r.w;
+		}
+	}
+}
+
+// N ポーズの重み付きブレンド
+void AnimationPose::Blend(const AnimationPose* const* poses, const float* weights, size_t count, AnimationPose& out)
+{
+	if (count == 0) return;
+
+	size_t nodeCount = poses[0]->nodeCount;
+	for (size_t i = 1; i < count; i++) nodeCount = (std::min)(nodeCount, poses[i]->nodeCount);
+	out.Resize(nodeCount);
+
+	const size_t blockCount = (nodeCount + 3) / 4;
+	for (size_t block = 0; block < blockCount; block++)
+	{
+		const AnimationPose& first = *poses[0];
+		const XMVECTOR W0 = XMVectorReplicate(weights[0]);
+
+		XMVECTOR TX = XMVectorMultiply(XMLoadFloat4A(&first.tx[block]), W0);
+		XMVECTOR TY = XMVectorMultiply(XMLoadFloat4A(&first.ty[block]), W0);
+		XMVECTOR TZ = XMVectorMultiply(XMLoadFloat4A(&first.tz[block]), W0);
+		XMVECTOR SX = XMVectorMultiply(XMLoadFloat4A(&first.sx[block]), W0);
+		XMVECTOR SY = XMVectorMultiply(XMLoadFloat4A(&first.sy[block]), W0);
+		XMVECTOR SZ = XMVectorMultiply(XMLoadFloat4A(&first.sz[block]), W0);
+
+		const QuaternionBlock q0 = LoadQuaternion(first, block);
+		QuaternionBlock q = Scale(q0, W0);
+
+		for (size_t i = 1; i < count; i++)
+		{
+			const AnimationPose& pose = *poses[i];
+			const XMVECTOR W = XMVectorReplicate(weights[i]);
+
+			TX = XMVectorMultiplyAdd(XMLoadFloat4A(&pose.tx[block]), W, TX);
+			TY = XMVectorMultiplyAdd(XMLoadFloat4A(&pose.ty[block]), W, TY);
+			TZ = XMVectorMultiplyAdd(XMLoadFloat4A(&pose.tz[block]), W, TZ);
+			SX = XMVectorMultiplyAdd(XMLoadFloat4A(&pose.sx[block]), W, SX);
+			SY = XMVectorMultiplyAdd(XMLoadFloat4A(&pose.sy[block]), W, SY);
+			SZ = XMVectorMultiplyAdd(XMLoadFloat4A(&pose.sz[block]), W, SZ);
+
+			// 最初のポーズと同じ半球に揃えてから足す
+			const QuaternionBlock qi = LoadQuaternion(pose, block);
+			const XMVECTOR signedW = XMVectorMultiply(W, HemisphereSign(Dot(q0, qi)));
+			q.x = XMVectorMultiplyAdd(qi.x, signedW, q.x);
+			q.y = XMVectorMultiplyAdd(qi.y, signedW, q.y);
+			q.z = XMVectorMultiplyAdd(qi.z, signedW, q.z);
+			q.w = XMVectorMultiplyAdd(qi.w, signedW, q.w);
+		}
+
+		XMStoreFloat4A(&out.tx[block], TX);
+		XMStoreFloat4A(&out.ty[block], TY);
+		XMStoreFloat4A(&out.tz[block], TZ);
+		XMStoreFloat4A(&out.sx[block], SX);
+		XMStoreFloat4A(&out.sy[block], SY);
+		XMStoreFloat4A(&out.sz[block], SZ);
+		StoreQuaternion(out, block, Normalize(q));
+	}
+}
+
+// 加算レイヤー
+void AnimationPose::Additive(const AnimationPose& base, const AnimationPose& additive, const AnimationPose& reference, float weight, const BoneMask* mask, AnimationPose& out)
+{
+	const size_t nodeCount = (std::min)(base.nodeCount, (std::min)(additive.nodeCount, reference.nodeCount));
+	out.Resize(nodeCount);
+
+	const bool useMask = mask && mask->GetNodeCount() == nodeCount;
+	const XMVECTOR weightV = XMVectorReplicate(weight);
+	const QuaternionBlock identity = { g_XMZero, g_XMZero, g_XMZero, g_XMOne };
+
+	const size_t blockCount = (nodeCount + 3) / 4;
+	for (size_t block = 0; block < blockCount; block++)
+	{
+		const XMVECTOR W = useMask ? XMVectorMultiply(XMLoadFloat4A(&mask->weights[block]), weightV) : weightV;
+
+		// 移動 : base + (additive - reference) * W
+		const XMVECTOR TX = XMVectorMultiplyAdd(XMVectorSubtract(XMLoadFloat4A(&additive.tx[block]), XMLoadFloat4A(&reference.tx[block])), W, XMLoadFloat4A(&base.tx[block]));
+		const XMVECTOR TY = XMVectorMultiplyAdd(XMVectorSubtract(XMLoadFloat4A(&additive.ty[block]), XMLoadFloat4A(&reference.ty[block])), W, XMLoadFloat4A(&base.ty[block]));
+		const XMVECTOR TZ = XMVectorMultiplyAdd(XMVectorSubtract(XMLoadFloat4A(&additive.tz[block]), XMLoadFloat4A(&reference.tz[block])), W, XMLoadFloat4A(&base.tz[block]));
+
+		// 拡縮 : base * lerp(1, additive / reference, W)
+		const XMVECTOR SX = XMVectorMultiply(XMLoadFloat4A(&base.sx[block]), XMVectorLerpV(g_XMOne, XMVectorDivide(XMLoadFloat4A(&additive.sx[block]), XMLoadFloat4A(&reference.sx[block])), W));
+		const XMVECTOR SY = XMVectorMultiply(XMLoadFloat4A(&base.sy[block]), XMVectorLerpV(g_XMOne, XMVectorDivide(XMLoadFloat4A(&additive.sy[block]), XMLoadFloat4A(&reference.sy[block])), W));
+		const XMVECTOR SZ = XMVectorMultiply(XMLoadFloat4A(&base.sz[block]), XMVectorLerpV(g_XMOne, XMVectorDivide(XMLoadFloat4A(&additive.sz[block]), XMLoadFloat4A(&reference.sz[block])), W));
+
+		// 回転 : base * nlerp(identity, conjugate(reference) * additive, W)
+		QuaternionBlock inverseReference = LoadQuaternion(reference, block);
+		inverseReference.x = XMVectorNegate(inverseReference.x);
+		inverseReference.y = XMVectorNegate(inverseReference.y);
+		inverseReference.z = XMVectorNegate(inverseReference.z);
+		QuaternionBlock delta = Multiply(inverseReference, LoadQuaternion(additive, block));
+		delta = Scale(delta, HemisphereSign(delta.w));
+
+		QuaternionBlock scaled =
+		{
+			XMVectorLerpV(identity.x, delta.x, W),
+			XMVectorLerpV(identity.y, delta.y, W),
+			XMVectorLerpV(identity.z, delta.z, W),
+			XMVectorLerpV(identity.w, delta.w, W),
+		};
+		const QuaternionBlock q = Normalize(Multiply(LoadQuaternion(base, block), Normalize(scaled)));
+
+		XMStoreFloat4A(&out.tx[block], TX);
+		XMStoreFloat4A(&out.ty[block], TY);
+		XMStoreFloat4A(&out.tz[block], TZ);
+		XMStoreFloat4A(&out.sx[block], SX);
+		XMStoreFloat4A(&out.sy[block], SY);
+		XMStoreFloat4A(&out.sz[block], SZ);
+		StoreQuaternion(out, block, q);
+	}
+}
+
+//--------------------------------------------------------------
+// AnimationBlendTree
+//--------------------------------------------------------------
+
+// クリップ追加
+int AnimationBlendTree::AddClip(int clipIndex, bool loop)
+{
+	Node& node = nodes.emplace_back();
+	node.type = NodeType::Clip;
+	node.clipIndex = clipIndex;
+	node.loop = loop;
+
+	root = static_cast<int>(nodes.size()) - 1;
+	poses.resize(nodes.size());
+	return root;
+}
+
+// N 方向ブレンド追加
+int AnimationBlendTree::AddBlend(const std::vector<int>& inputs, const std::vector<float>& weights)
+{
+	_ASSERT_EXPR(inputs.size() == weights.size(), L"ブレンドの入力と重みの数が違います");
+
+	Node& node = nodes.emplace_back();
+	node.type = NodeType::Blend;
+	node.inputs = inputs;
+	node.weights = weights;
+
+	root = static_cast<int>(nodes.size()) - 1;
+	poses.resize(nodes.size());
+	return root;
+}
+
+// レイヤー追加
+int AnimationBlendTree::AddLayer(int base, int layer, float weight, const BoneMask* mask)
+{
+	Node& node = nodes.emplace_back();
+	node.type = NodeType::Layer;
+	node.inputs = { base, layer };
+	node.weight = weight;
+	node.mask = mask;
+
+	root = static_cast<int>(nodes.size()) - 1;
+	poses.resize(nodes.size());
+	return root;
+}
+
+// 加算レイヤー追加
+int AnimationBlendTree::AddAdditive(int base, int additive, int reference, float weight, const BoneMask* mask)
+{
+	Node& node = nodes.emplace_back();
+	node.type = NodeType::Additive;
+	node.inputs = { base, additive, reference };
+	node.weight = weight;
+	node.mask = mask;
+
+	root = static_cast<int>(nodes.size()) - 1;
+	poses.resize(nodes.size());
+	return root;
+}
+
+// 全削除
+void AnimationBlendTree::Clear()
+{
+	nodes.clear();
+	poses.clear();
+	root = -1;
+}
+
+// 評価して keyFrame に書き込む
+void AnimationBlendTree::Evaluate(const SkinnedMesh& model, Animation::KeyFrame& keyFrame)
+{
+	const AnimationPose& pose = Evaluate(model);
+
+	// ノード名などを持たせるため、形が違う場合は先頭フレームで初期化しておく
+	if (keyFrame.nodes.size() != pose.GetNodeCount())
+	{
+		for (const Node& node : nodes)
+		{
+			if (node.type != NodeType::Clip) continue;
+			keyFrame = model.animationClips.at(node.clipIndex).sequence.at(0);
+			break;
+		}
+	}
+
+	pose.WriteToKeyFrame(keyFrame);
+}
+
+// 評価結果のポーズ
+const AnimationPose& AnimationBlendTree::Evaluate(const SkinnedMesh& model)
+{
+	_ASSERT_EXPR(root >= 0 && root < static_cast<int>(nodes.size()), L"ブレンドツリーが空です");
+	return EvaluateNode(model, root);
+}
+
+// クリップのキーフレーム番号
+int AnimationBlendTree::ClipKeyFrame(const Animation& animation, float seconds, bool loop)
+{
+	const int frameCount = static_cast<int>(animation.sequence.size());
+	if (frameCount == 0) return 0;
+
+	int frame = static_cast<int>(seconds * animation.samplingRate);
+	if (loop)
+	{
+		frame %= frameCount;
+		if (frame < 0) frame += frameCount;
+	}
+	else
+	{
+		frame = (std::max)(0, (std::min)(frame, frameCount - 1));
+	}
+	return frame;
+}
+
+const AnimationPose& AnimationBlendTree::EvaluateNode(const SkinnedMesh& model, int index)
+{
+	const Node& node = nodes.at(index);
+	AnimationPose& pose = poses.at(index);
+
+	switch (node.type)
+	{
+	case NodeType::Clip:
+	{
+		const Animation& animation = model.animationClips.at(node.clipIndex);
+		pose.SetFromKeyFrame(animation.sequence.at(ClipKeyFrame(animation, node.seconds, node.loop)));
+		break;
+	}
+	case NodeType::Blend:
+	{
+		// 先に入力を全て評価してから (入力の評価中に blendInputs を使うため) 並べる
+		for (int input : node.inputs) EvaluateNode(model, input);
+
+		// 2 方向なら角度の大きいノードを slerp にできる Lerp を使う (重みの合計は 1 を想定)
+		if (node.inputs.size() == 2)
+		{
+			AnimationPose::Lerp(poses.at(node.inputs[0]), poses.at(node.inputs[1]), node.weights[1], pose);
+			break;
+		}
+
+		blendInputs.clear();
+		for (int input : node.inputs) blendInputs.emplace_back(&poses.at(input));
+		AnimationPose::Blend(blendInputs.data(), node.weights.data(), blendInputs.size(), pose);
+		break;
+	}
+	case NodeType::Layer:
+	{
+		const AnimationPose& base = EvaluateNode(model, node.inputs.at(0));
+		const AnimationPose& layer = EvaluateNode(model, node.inputs.at(1));
+		AnimationPose::Layer(base, layer, node.weight, node.mask, pose);
+		break;
+	}
+	case NodeType::Additive:
+	{
+		const AnimationPose& base = EvaluateNode(model, node.inputs.at(0));
+		const AnimationPose& additive = EvaluateNode(model, node.inputs.at(1));
+		const AnimationPose& reference = EvaluateNode(model, node.inputs.at(2));
+		AnimationPose::Additive(base, additive, reference, node.weight, node.mask, pose);
+		break;
+	}
+	}
+	return pose;
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <string>
+#include "SkinnedMesh.h"
+
+//--------------------------------------------------------------
+// BoneMask
+//--------------------------------------------------------------
+// ノードごとのブレンド重み (0 ~ 1)
+// AnimationPose と同じく 4 ノード単位で並べる
+class BoneMask
+{
+public:
+	BoneMask() {}
+	~BoneMask() {}
+
+	// 全ノード weight で初期化
+	void Resize(size_t nodeCount, float weight = 0.0f);
+
+	// rootNodeName のノードとその子孫に weight を設定する
+	void SetBranch(const SkinnedMesh& model, const std::string& rootNodeName, float weight = 1.0f);
+
+	// ノード単体に設定
+	void SetWeight(size_t nodeIndex, float weight) { reinterpret_cast<float*>(weights.data())[nodeIndex] = weight; }
+
+	size_t GetNodeCount() const { return nodeCount; }
+
+public:
+	std::vector<DirectX::XMFLOAT4A> weights;
+
+private:
+	size_t nodeCount = 0;
+};
+
+//--------------------------------------------------------------
+// AnimationPose
+//--------------------------------------------------------------
+// ポーズ (全ノードの SRT) を SoA で持つ
+// 成分ごとに 4 ノード分を XMFLOAT4A ひとつにまとめ、ブレンドは 4 ノードずつ SIMD で処理する
+class AnimationPose
+{
+public:
+	AnimationPose() {}
+	~AnimationPose() {}
+
+	// ノード数設定 (余りのレーンは単位姿勢で埋める)
+	void Resize(size_t nodeCount);
+
+	// キーフレームから読み込み
+	void SetFromKeyFrame(const Animation::KeyFrame& keyFrame);
+	// キーフレームへ書き出し (scaling / rotation / translation のみ、globalTransform は SkinnedMesh::UpdateAnimation で計算する)
+	void WriteToKeyFrame(Animation::KeyFrame& keyFrame) const;
+
+	size_t GetNodeCount() const { return nodeCount; }
+	size_t GetBlockCount() const { return tx.size(); }
+
+	// 2 ポーズの補間 (nlerp、角度の大きいノードだけ slerp)
+	static void Lerp(const AnimationPose& a, const AnimationPose& b, float t, AnimationPose& out);
+
+	// N ポーズの重み付きブレンド (weights の合計は 1 を想定)
+	static void Blend(const AnimationPose* const* poses, const float* weights, size_t count, AnimationPose& out);
+
+	// レイヤー (mask の付いたノードだけ layer で上書きする)
+	static void Layer(const AnimationPose& base, const AnimationPose& layer, float weight, const BoneMask* mask, AnimationPose& out);
+
+	// 加算レイヤー (additive と reference の差分を base に足す)
+	static void Additive(const AnimationPose& base, const AnimationPose& additive, const AnimationPose& reference, float weight, const BoneMask* mask, AnimationPose& out);
+
+private:
+	// 補間率 t (mask があればノードごとに mask の重みを掛ける) で補間 (Lerp / Layer 共通)
+	static void LerpBlocks(const AnimationPose& a, const AnimationPose& b, float t, const BoneMask* mask, AnimationPose& out);
+
+public:
+	// 成分ごとの配列 (1 要素 = 4 ノード)
+	std::vector<DirectX::XMFLOAT4A> tx, ty, tz;
+	std::vector<DirectX::XMFLOAT4A> qx, qy, qz, qw;
+	std::vector<DirectX::XMFLOAT4A> sx, sy, sz;
+
+private:
+	size_t nodeCount = 0;
+};
+
+//--------------------------------------------------------------
+// AnimationBlendTree
+//--------------------------------------------------------------
+// クリップ・N 方向ブレンド・マスク付きレイヤー・加算レイヤーを組み合わせて評価する
+// ノードごとにポーズを持ち回すので、組み立てた後は毎フレームの確保が発生しない
+class AnimationBlendTree
+{
+public:
+	enum class NodeType
+	{
+		Clip,		// クリップの再生
+		Blend,		// N 方向ブレンド (2 方向なら Lerp)
+		Layer,		// マスク付き上書き
+		Additive,	// 加算
+	};
+
+	struct Node
+	{
+		NodeType type = NodeType::Clip;
+
+		// Clip
+		int clipIndex = -1;
+		float seconds = 0.0f;
+		bool loop = true;
+
+		// Blend / Layer / Additive の入力ノード番号
+		// Layer : { base, layer }  Additive : { base, additive, reference }
+		std::vector<int> inputs;
+		// Blend の重み
+		std::vector<float> weights;
+
+		// Layer / Additive
+		float weight = 1.0f;
+		const BoneMask* mask = nullptr;
+	};
+
+public:
+	AnimationBlendTree() {}
+	~AnimationBlendTree() {}
+
+	// ノード追加 (戻り値はノード番号、最後に追加したノードが根になる)
+	int AddClip(int clipIndex, bool loop = true);
+	int AddBlend(const std::vector<int>& inputs, const std::vector<float>& weights);
+	int AddLayer(int base, int layer, float weight, const BoneMask* mask);
+	int AddAdditive(int base, int additive, int reference, float weight, const BoneMask* mask);
+
+	// 全削除
+	void Clear();
+
+	// ノード取得 (毎フレームの時間・重みの更新用)
+	Node& GetNode(int index) { return nodes.at(index); }
+
+	// 根ノード設定
+	void SetRoot(int index) { root = index; }
+
+	// 評価して keyFrame の scaling / rotation / translation に書き込む
+	void Evaluate(const SkinnedMesh& model, Animation::KeyFrame& keyFrame);
+
+	// 評価結果のポーズ
+	const AnimationPose& Evaluate(const SkinnedMesh& model);
+
+	// クリップのキーフレーム番号 (秒数から、ループなら折り返し・それ以外は最終フレームで止める)
+	static int ClipKeyFrame(const Animation& animation, float seconds, bool loop);
+
+private:
+	const AnimationPose& EvaluateNode(const SkinnedMesh& model, int index);
+
+private:
+	std::vector<Node> nodes;
+	std::vector<AnimationPose> poses;		// ノードごとの評価結果
+	std::vector<const AnimationPose*> blendInputs;
+	int root = -1;
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------
+// AssetManifest
+//--------------------------------------------------------------
+// シーンが使うモデル・テクスチャの一覧 (Scene::DeclareAssets で作る)
+// SceneManager はシーン切り替え時に ResourceManager::SetResident へ渡し、
+// 前のシーンと共通のものは残したまま、足りないものだけを読み込む
+//
+// prefetch には次に遷移しそうなシーンのものを入れておく
+// (現在のシーンの間にバックグラウンドで読み込まれ、遷移時には読み込み済みになる)
+struct AssetManifest
+{
+	struct Model
+	{
+		std::string filename;
+		bool triangulate = false;
+		bool keepVertices = false;
+		bool staticMesh = false;		// StaticMesh の焼き込み元 (ResourceManager::LoadStaticModelResource)
+
+		bool operator==(const Model& other) const
+		{
+			return filename == other.filename && triangulate == other.triangulate && keepVertices == other.keepVertices && staticMesh == other.staticMesh;
+		}
+	};
+
+	std::vector<Model> models;
+	std::vector<std::wstring> textures;
+
+	std::vector<Model> prefetchModels;
+	std::vector<std::wstring> prefetchTextures;
+
+	// 使うモデル (ResourceManager::LoadModelResource と同じ引数)
+	void AddModel(const char* filename, bool triangulate = false, bool keepVertices = false)
+	{
+		models.push_back({ filename, triangulate, keepVertices });
+	}
+	// StaticMesh にして使うモデル (ResourceManager::LoadStaticModelResource と同じ引数)
+	void AddStaticModel(const char* filename, bool triangulate = false)
+	{
+		models.push_back({ filename, triangulate, true, true });
+	}
+	// 使うテクスチャ
+	void AddTexture(const wchar_t* filename)
+	{
+		textures.push_back(filename);
+	}
+
+	// 次のシーンの一覧を先読みとして加える
+	void AddPrefetch(const AssetManifest& next)
+	{
+		prefetchModels.insert(prefetchModels.end(), next.models.begin(), next.models.end());
+		prefetchTextures.insert(prefetchTextures.end(), next.textures.begin(), next.textures.end());
+	}
+};
@@ -4,6 +4,7 @@
 #include "../Input/InputManager.h"
 #include "../Timer.h"
 #include "../ImGui/ConsoleData.h"
+#include "OcclusionCuller.h"
 
 
 Camera::Camera()
@@ -14,7 +15,7 @@ Camera::Camera()
 	// --- プロジェクション座標変換行列作成 ---
 	D3D11_VIEWPORT viewport;
 	UINT numViewports{ 1 };
-	gfx.deviceContext->RSGetViewports(&numViewports, &viewport);
+	gfx.stateCache.RSGetViewports(&numViewports, &viewport);
 
 	float aspectRatio{ viewport.Width / viewport.Height };
 	SetPerspectiveFov(XMConvertToRadians(30), aspectRatio, 0.1f, 1000.0f);
@@ -35,6 +36,12 @@ Camera::Camera()
 
 void Camera::Update()
 {
+	// --- カリングのカウンターを前フレームの値に移す ---
+	lastVisibleCount = visibleCount;
+	lastCulledCount = culledCount;
+	visibleCount = 0;
+	culledCount = 0;
+
 	// --- 入力処理 ---
 	InputManager& inputManager = InputManager::Instance();
 	inputManager.ResetScrollWheelValue();
@@ -281,6 +288,9 @@ void Camera::SetLookAt(const DirectX::XMFLOAT3& eye, const DirectX::XMFLOAT3& fo
 	// 視点、注視点を保存
 	this->eye = eye;
 	this->focus = focus;
+
+	// 視錐台更新
+	frustum.Set(view, projection);
 }
 
 // projection 設定
@@ -288,6 +298,25 @@ void Camera::SetPerspectiveFov(float fovY, float aspect, float nearZ, float farZ
 {
 	DirectX::XMMATRIX Projection = XMMatrixPerspectiveFovLH(fovY, aspect, nearZ, farZ);
 	DirectX::XMStoreFloat4x4(&projection, Projection);
+
+	// 視錐台更新
+	frustum.Set(view, projection);
+}
+
+// 視錐台カリング
+void Camera::Cull(FrustumCullingBatch& batch)
+{
+	if (enableFrustumCulling)
+	{
+		batch.Cull(frustum);
+	}
+	else
+	{
+		batch.SetAllVisible();
+	}
+
+	visibleCount += batch.GetVisibleCount();
+	culledCount += batch.GetCount() - batch.GetVisibleCount();
 }
 
 void Camera::DrawDebugGui()
@@ -327,6 +356,16 @@ void Camera::DrawDebugGui()
 		// drawFocusSphere
 		ImGui::Checkbox("DrawFocusSphere", &drawFocusSphere);
 
+		// 視錐台カリング
+		ImGui::Checkbox("FrustumCulling", &enableFrustumCulling);
+		ImGui::Text("Visible : %zu  Culled : %zu", lastVisibleCount, lastCulledCount);
+
+		// 遮蔽カリング
+		OcclusionCuller& occlusionCuller = OcclusionCuller::Instance();
+		ImGui::Checkbox("OcclusionCulling", &occlusionCuller.enable);
+		ImGui::Text("Occluders : %zu  (%d x %d)", occlusionCuller.GetOccluderTriangleCount(), occlusionCuller.GetWidth(), occlusionCuller.GetHeight());
+		ImGui::Text("Tested : %zu  Occluded : %zu", occlusionCuller.GetTestedCount(), occlusionCuller.GetOccludedCount());
+
 		// 位置
 		ImGui::DragFloat3("Eye", &eye.x, 0.1f);
 		// focus
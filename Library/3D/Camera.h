@@ -2,6 +2,7 @@
 #include <memory>
 #include <DirectXMath.h>
 #include "SpherePrimitive.h"
+#include "Frustum.h"
 using namespace DirectX;
 
 
@@ -44,6 +45,14 @@ public:
 	const DirectX::XMFLOAT4X4& GetView() const { return view; }
 	// Projection 取得
 	const DirectX::XMFLOAT4X4& GetProjection() const { return projection; }
+	// 視錐台取得 (view / projection 設定時に更新)
+	const Frustum& GetFrustum() const { return frustum; }
+
+	// 視錐台カリング (結果は batch.IsVisible で取得、カウンターに加算される)
+	void Cull(FrustumCullingBatch& batch);
+	// 前フレームのカリング結果
+	size_t GetVisibleCount() const { return lastVisibleCount; }
+	size_t GetCulledCount() const { return lastCulledCount; }
 
 	// 視点取得
 	const DirectX::XMFLOAT3& GetEye() const { return eye; }
@@ -64,6 +73,9 @@ public:
 	std::unique_ptr<SpherePrimitive> focusSphere;
 	bool drawFocusSphere = false;
 
+	// 視錐台カリングを行うか
+	bool enableFrustumCulling = true;
+
 	enum CAMERA
 	{
 		TARGET_PLAYER,
@@ -76,6 +88,14 @@ private:
 	// View Projection 行列
 	DirectX::XMFLOAT4X4 view;
 	DirectX::XMFLOAT4X4 projection;
+	// 視錐台
+	Frustum frustum;
+
+	// カリングのカウンター (Update で前フレームの値に移す)
+	size_t visibleCount = 0;
+	size_t culledCount = 0;
+	size_t lastVisibleCount = 0;
+	size_t lastCulledCount = 0;
 
 	// カメラの位置
 	DirectX::XMFLOAT3 eye;
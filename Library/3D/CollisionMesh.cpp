@@ -0,0 +1,177 @@
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <algorithm>
+#include "CollisionMesh.h"
+#include "SkinnedMesh.h"
+#include "../MemoryTracker.h"
+
+using namespace DirectX;
+
+// メッシュの追加
+void CollisionMesh::AppendMesh(const XMFLOAT4X4& transform, const void* positions, size_t positionStride, const uint32_t* indices, size_t indexCount, int materialIndex)
+{
+	const XMMATRIX M = XMLoadFloat4x4(&transform);
+	const uint8_t* base = static_cast<const uint8_t*>(positions);
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		uint32_t welded[3];
+		for (int j = 0; j < 3; j++)
+		{
+			// モデル空間に変換
+			const XMFLOAT3* source = reinterpret_cast<const XMFLOAT3*>(base + positionStride * indices[i + j]);
+			XMFLOAT3 position;
+			XMStoreFloat3(&position, XMVector3TransformCoord(XMLoadFloat3(source), M));
+
+			// 同じ座標の頂点はひとつにまとめる
+			WeldKey key;
+			std::memcpy(&key.x, &position.x, sizeof(uint32_t));
+			std::memcpy(&key.y, &position.y, sizeof(uint32_t));
+			std::memcpy(&key.z, &position.z, sizeof(uint32_t));
+
+			auto it = weldMap.find(key);
+			if (it != weldMap.end())
+			{
+				welded[j] = it->second;
+			}
+			else
+			{
+				welded[j] = static_cast<uint32_t>(this->positions.size());
+				this->positions.emplace_back(position);
+				weldMap.emplace(key, welded[j]);
+			}
+		}
+
+		// 溶接で潰れた三角形は捨てる
+		if (welded[0] == welded[1] || welded[1] == welded[2] || welded[2] == welded[0]) continue;
+
+		this->indices.insert(this->indices.end(), welded, welded + 3);
+		materialIndices.emplace_back(materialIndex);
+	}
+}
+
+// 三角形の事前計算
+void CollisionMesh::Build()
+{
+	weldMap.clear();
+
+	triangles.clear();
+	triangles.reserve(materialIndices.size());
+
+	boundingBox[0] = { +FLT_MAX, +FLT_MAX, +FLT_MAX };
+	boundingBox[1] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (const XMFLOAT3& p : positions)
+	{
+		boundingBox[0].x = (std::min)(boundingBox[0].x, p.x);
+		boundingBox[0].y = (std::min)(boundingBox[0].y, p.y);
+		boundingBox[0].z = (std::min)(boundingBox[0].z, p.z);
+		boundingBox[1].x = (std::max)(boundingBox[1].x, p.x);
+		boundingBox[1].y = (std::max)(boundingBox[1].y, p.y);
+		boundingBox[1].z = (std::max)(boundingBox[1].z, p.z);
+	}
+
+	const size_t triangleCount = materialIndices.size();
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		XMVECTOR A = XMLoadFloat3(&positions[indices[i * 3 + 0]]);
+		XMVECTOR B = XMLoadFloat3(&positions[indices[i * 3 + 1]]);
+		XMVECTOR C = XMLoadFloat3(&positions[indices[i * 3 + 2]]);
+
+		XMVECTOR AB = XMVectorSubtract(B, A);
+		XMVECTOR BC = XMVectorSubtract(C, B);
+		XMVECTOR N = XMVector3Cross(AB, BC);
+
+		// 面積のない三角形は当たらないので捨てる
+		if (XMVector3Equal(N, XMVectorZero())) continue;
+
+		Triangle& triangle = triangles.emplace_back();
+		XMStoreFloat3(&triangle.a, A);
+		XMStoreFloat3(&triangle.ab, AB);
+		XMStoreFloat3(&triangle.bc, BC);
+		XMStoreFloat3(&triangle.normal, N);
+		triangle.materialIndex = materialIndices[i];
+	}
+	triangles.shrink_to_fit();
+}
+
+// 全削除
+void CollisionMesh::Clear()
+{
+	positions.clear();
+	indices.clear();
+	materialIndices.clear();
+	triangles.clear();
+	weldMap.clear();
+}
+
+// ファイル書き出し
+bool CollisionMesh::Save(const std::string& filename) const
+{
+	std::ofstream ofs(filename.c_str(), std::ios::binary);
+	if (!ofs) return false;
+
+	cereal::BinaryOutputArchive serialization(ofs);
+	serialization(systemTransform, positions, indices, materialIndices);
+	return true;
+}
+
+// ファイル読み込み
+bool CollisionMesh::Load(const std::string& filename)
+{
+	if (!std::filesystem::exists(filename)) return false;
+
+	std::ifstream ifs(filename.c_str(), std::ios::binary);
+	if (!ifs) return false;
+
+	Clear();
+	cereal::BinaryInputArchive deserialization(ifs);
+	deserialization(systemTransform, positions, indices, materialIndices);
+
+	Build();
+	return true;
+}
+
+// fbx に対応する .collision を読み込む
+bool CollisionMesh::LoadFromFbx(const char* fbxFilename)
+{
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::COLLISION);
+
+	// 焼き込み済みで fbx が更新されていなければそれを使う
+	if (IsCacheUpToDate(fbxFilename) && Load(MakeCollisionPath(fbxFilename))) return true;
+
+	if (!std::filesystem::exists(fbxFilename)) return false;
+
+	// 形状だけ読み込んで焼き込む (.collision も書き出される、描画用のバッファやテクスチャは作らない)
+	{
+		SkinnedMesh source(fbxFilename, true, 0.0f, false, true);
+		source.LoadGeometry(true, 0.0f);
+		*this = source.collisionMesh;
+	}
+	return !IsEmpty();
+}
+
+// fbx に対応する .collision のパス
+std::string CollisionMesh::MakeCollisionPath(const char* fbxFilename)
+{
+	std::filesystem::path path(fbxFilename);
+	return path.parent_path().string() + "/" + path.stem().string() + ".collision";
+}
+
+// .collision があり、fbx より新しいか
+bool CollisionMesh::IsCacheUpToDate(const char* fbxFilename)
+{
+	std::error_code error;
+	const std::filesystem::path collisionPath(MakeCollisionPath(fbxFilename));
+	if (!std::filesystem::exists(collisionPath, error)) return false;
+
+	// fbx を含めずに配布している場合は焼き込み済みのものを使う
+	if (!std::filesystem::exists(fbxFilename, error)) return true;
+
+	const auto collisionTime = std::filesystem::last_write_time(collisionPath, error);
+	if (error) return false;
+	const auto fbxTime = std::filesystem::last_write_time(fbxFilename, error);
+	if (error) return true;
+
+	return collisionTime >= fbxTime;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cfloat>
+#include <unordered_map>
+
+//--------------------------------------------------------------
+// CollisionMesh
+//--------------------------------------------------------------
+// 当たり判定専用のメッシュ
+// 描画用の頂点(80byte)は使わず、溶接(weld)した座標とモデル空間に変換済みの三角形だけを持つ
+class CollisionMesh
+{
+public:
+	// 三角形(レイキャスト用に辺と法線を事前計算しておく)
+	struct Triangle
+	{
+		DirectX::XMFLOAT3 a;		// 頂点A
+		DirectX::XMFLOAT3 ab;		// 辺 A → B
+		DirectX::XMFLOAT3 bc;		// 辺 B → C
+		DirectX::XMFLOAT3 normal;	// 法線 (ab x bc 正規化はしない)
+		int materialIndex = -1;		// マテリアル番号
+	};
+
+public:
+	CollisionMesh() {}
+	~CollisionMesh() {}
+
+	// メッシュの追加 (positions は stride バイトごとに並んだ座標、transform でモデル空間に変換される)
+	void AppendMesh(
+		const DirectX::XMFLOAT4X4& transform,
+		const void* positions,
+		size_t positionStride,
+		const uint32_t* indices,
+		size_t indexCount,
+		int materialIndex
+	);
+
+	// 三角形の事前計算 (AppendMesh を全て終えた後に呼ぶ)
+	void Build();
+
+	// 全削除
+	void Clear();
+
+	// ファイル書き出し / 読み込み
+	bool Save(const std::string& filename) const;
+	bool Load(const std::string& filename);
+
+	// fbx に対応する .collision を読み込む (ないか古ければ fbx から焼き込んで書き出す)
+	bool LoadFromFbx(const char* fbxFilename);
+
+	// fbx に対応する .collision のパス
+	static std::string MakeCollisionPath(const char* fbxFilename);
+	// .collision があり、fbx より新しいか (fbx がなければ .collision があれば良い)
+	static bool IsCacheUpToDate(const char* fbxFilename);
+
+	// 取得
+	const std::vector<Triangle>& GetTriangles() const { return triangles; }
+	const std::vector<DirectX::XMFLOAT3>& GetPositions() const { return positions; }
+	bool IsEmpty() const { return triangles.empty(); }
+
+public:
+	// 焼き込み元モデルの軸・単位補正行列 (モデル単体でレイキャストする場合に使う)
+	DirectX::XMFLOAT4X4 systemTransform =
+	{
+		1,0,0,0,
+		0,1,0,0,
+		0,0,1,0,
+		0,0,0,1
+	};
+
+	// モデル空間でのバウンディングボックス
+	DirectX::XMFLOAT3 boundingBox[2] =
+	{
+		{ +FLT_MAX, +FLT_MAX, +FLT_MAX },
+		{ -FLT_MAX, -FLT_MAX, -FLT_MAX },
+	};
+
+private:
+	// 溶接済みの座標
+	std::vector<DirectX::XMFLOAT3> positions;
+	// 三角形ごとの座標インデックス
+	std::vector<uint32_t> indices;
+	// 三角形ごとのマテリアル番号
+	std::vector<int> materialIndices;
+
+	// レイキャスト用の三角形 (Build で生成、保存はしない)
+	std::vector<Triangle> triangles;
+
+	// 溶接用 (座標のビット列 → positions の index)
+	struct WeldKey
+	{
+		uint32_t x, y, z;
+		bool operator==(const WeldKey& other) const { return x == other.x && y == other.y && z == other.z; }
+	};
+	struct WeldKeyHash
+	{
+		size_t operator()(const WeldKey& key) const { return (key.x * 73856093u) ^ (key.y * 19349663u) ^ (key.z * 83492791u); }
+	};
+	std::unordered_map<WeldKey, uint32_t, WeldKeyHash> weldMap;
+};
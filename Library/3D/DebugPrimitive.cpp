@@ -1,7 +1,10 @@
+#include <cmath>
+#include <cstring>
 #include "DebugPrimitive.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Shader.h"
 #include "../ErrorLogger.h"
+#include "../MemoryTracker.h"
 
 // 初期化
 void DebugPrimitive::Initialize()
@@ -9,129 +12,225 @@ void DebugPrimitive::Initialize()
 	// --- Graphics 取得 ---
 	Graphics& gfx = Graphics::Instance();
 
-	HRESULT hr = S_OK;
-
 	//--- 頂点シェーダーオブジェクトと入力レイアウトオブジェクトの生成 ---
+	// スロット 0 : メッシュの頂点, スロット 1 : 図形ごとのインスタンス
 	D3D11_INPUT_ELEMENT_DESC inputElementDesc[]
 	{
-		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"SCALE", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		{"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
 	};
-	CreateVsFromCso("./Data/Shader/GeometricPrimitive_VS.cso", vertexShader.GetAddressOf(), inputLayout.GetAddressOf(), inputElementDesc, ARRAYSIZE(inputElementDesc));
+	CreateVsFromCso("./Data/Shader/DebugPrimitive_VS.cso", vertexShader.GetAddressOf(), inputLayout.GetAddressOf(), inputElementDesc, ARRAYSIZE(inputElementDesc));
 
 	//--- ピクセルシェーダーオブジェクトの生成 ---
 	CreatePsFromCso("./Data/Shader/GeometricPrimitive_PS.cso", pixelShader.GetAddressOf());
 
-	//--- 定数バッファオブジェクトの生成 ---
-	D3D11_BUFFER_DESC bufferDesc{};
-	bufferDesc.ByteWidth = sizeof(Constants);
-	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	hr = gfx.device->CreateBuffer(&bufferDesc, nullptr, constantBuffer.GetAddressOf());
-	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	//--- 全図形のメッシュを 1 つの頂点バッファにまとめる ---
+	std::vector<DirectX::XMFLOAT4> vertices;
+	auto createMesh = [&](SHAPE shape, auto create)
+		{
+			Shape& s = shapes[static_cast<size_t>(shape)];
+			s.startVertex = static_cast<UINT>(vertices.size());
+			create();
+			s.vertexCount = static_cast<UINT>(vertices.size()) - s.startVertex;
+		};
+	createMesh(SHAPE::SPHERE, [&]() { CreateSphereMesh(vertices, 1.0f, 16, 16); });
+	createMesh(SHAPE::CYLINDER, [&]() { CreateCylinderMesh(vertices, 1.0f, 1.0f, 0.0f, 1.0f, 16, 1); });
+	createMesh(SHAPE::BOX, [&]() { CreateBoxMesh(vertices); });
+	createMesh(SHAPE::CAPSULE, [&]() { CreateCapsuleMesh(vertices, 16, 8); });
+	createMesh(SHAPE::ARROW, [&]() { CreateArrowMesh(vertices, 8); });
+
+	D3D11_BUFFER_DESC bufferDesc = {};
+	D3D11_SUBRESOURCE_DATA subresourceData = {};
 
-	//--- 球メッシュ作成 ---
-	CreateSphereMesh(1.0f, 16, 16);
+	bufferDesc.ByteWidth = static_cast<UINT>(sizeof(DirectX::XMFLOAT4) * vertices.size());
+	bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	subresourceData.pSysMem = vertices.data();
+
+	HRESULT hr = gfx.device->CreateBuffer(&bufferDesc, &subresourceData, vertexBuffer.GetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 
-	//--- 円柱メッシュ作成 ---
-	CreateCylinderMesh(1.0f, 1.0f, 0.0f, 1.0f, 16, 1);
+	//--- インスタンスバッファ作成 (足りなくなったら Render で倍にする) ---
+	for (size_t i = 0; i < static_cast<size_t>(SHAPE::SHAPE_COUNT); ++i)
+	{
+		CreateInstanceBuffer(static_cast<SHAPE>(i), 64);
+	}
 }
 
 // 描画実行
 void DebugPrimitive::Render()
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::RENDER);
+
 	// --- Graphics 取得 ---
 	Graphics& gfx = Graphics::Instance();
 
 	// シェーダー設定
-	gfx.deviceContext->IASetInputLayout(inputLayout.Get());
+	gfx.stateCache.IASetInputLayout(inputLayout.Get());
 
-	gfx.deviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
-	gfx.deviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+	gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
 
 	// プリミティブ設定
-	UINT stride = sizeof(DirectX::XMFLOAT3);
+	UINT stride = sizeof(DirectX::XMFLOAT4);
 	UINT offset = 0;
-	gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+	gfx.stateCache.IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
 
-	// 球描画
-	gfx.deviceContext->IASetVertexBuffers(0, 1, sphereVertexBuffer.GetAddressOf(), &stride, &offset);
-	for (const Sphere& sphere : spheres)
+	// 図形の種類ごとに 1 回で描く
+	lastInstanceCount = 0;
+	for (size_t i = 0; i < static_cast<size_t>(SHAPE::SHAPE_COUNT); ++i)
 	{
-		// ワールド行列作成
-		DirectX::XMMATRIX S = DirectX::XMMatrixScaling(sphere.radius, sphere.radius, sphere.radius);
-		DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(sphere.center.x, sphere.center.y, sphere.center.z);
-		DirectX::XMMATRIX W = S * T;
+		Shape& shape = shapes[i];
+		if (shape.instances.empty()) continue;
 
-		DirectX::XMFLOAT4X4 w;
-		DirectX::XMStoreFloat4x4(&w, W);
+		const UINT instanceCount = static_cast<UINT>(shape.instances.size());
 
-		// 定数バッファ更新
-		Constants data = { w, sphere.color };
-		gfx.deviceContext->UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
-		gfx.deviceContext->VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+		// 足りなければ倍々に広げる
+		if (instanceCount > shape.capacity)
+		{
+			UINT capacity = shape.capacity;
+			while (capacity < instanceCount) capacity *= 2;
+			CreateInstanceBuffer(static_cast<SHAPE>(i), capacity);
+		}
 
-		gfx.deviceContext->Draw(sphereVertexCount, 0);
-	}
-	spheres.clear();
+		// インスタンスバッファ更新
+		D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+		HRESULT hr = gfx.stateCache.Map(shape.instanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 
-	// 円柱描画
-	gfx.deviceContext->IASetVertexBuffers(0, 1, cylinderVertexBuffer.GetAddressOf(), &stride, &offset);
-	for (const Cylinder& cylinder : cylinders)
-	{
-		// ワールド行列作成
-		DirectX::XMMATRIX S = DirectX::XMMatrixScaling(cylinder.radius, cylinder.height, cylinder.radius);
-		DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(cylinder.position.x, cylinder.position.y, cylinder.position.z);
-		DirectX::XMMATRIX W = S * T;
+		memcpy(mappedSubresource.pData, shape.instances.data(), sizeof(Instance) * instanceCount);
+
+		gfx.stateCache.Unmap(shape.instanceBuffer.Get(), 0, sizeof(Instance) * instanceCount);
 
-		DirectX::XMFLOAT4X4 w;
-		DirectX::XMStoreFloat4x4(&w, W);
+		UINT instanceStride = sizeof(Instance);
+		gfx.stateCache.IASetVertexBuffers(1, 1, shape.instanceBuffer.GetAddressOf(), &instanceStride, &offset);
 
-		// 定数バッファ更新
-		Constants data = { w, cylinder.color };
-		gfx.deviceContext->UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
-		gfx.deviceContext->VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+		gfx.stateCache.DrawInstanced(shape.vertexCount, instanceCount, shape.startVertex, 0);
 
-		gfx.deviceContext->Draw(cylinderVertexCount, 0);
+		lastInstanceCount += instanceCount;
+		shape.instances.clear();
 	}
-	cylinders.clear();
 }
 
 // 球追加
 void DebugPrimitive::AddSphere(const DirectX::XMFLOAT3& center, float radius, const DirectX::XMFLOAT4& color)
 {
-	Sphere sphere;
-	sphere.center = center;
-	sphere.radius = radius;
-	sphere.color = color;
-	spheres.emplace_back(sphere);
+	DirectX::XMFLOAT4X4 world;
+	DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixTranslation(center.x, center.y, center.z));
+	AddInstance(SHAPE::SPHERE, world, { radius, radius, radius, 0 }, color);
 }
 
 // 円柱追加
 void DebugPrimitive::AddCylinder(const DirectX::XMFLOAT3& position, float radius, float height, const DirectX::XMFLOAT4& color)
 {
-	Cylinder cylinder;
-	cylinder.position = position;
-	cylinder.radius = radius;
-	cylinder.height = height;
-	cylinder.color = color;
-	cylinders.emplace_back(cylinder);
+	DirectX::XMFLOAT4X4 world;
+	DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixTranslation(position.x, position.y, position.z));
+	AddInstance(SHAPE::CYLINDER, world, { radius, height, radius, 0 }, color);
 }
 
-// 球メッシュ作成
-void DebugPrimitive::CreateSphereMesh(float radius, int slices, int stacks)
+// 箱追加
+void DebugPrimitive::AddBox(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents, const DirectX::XMFLOAT4& color)
+{
+	DirectX::XMFLOAT4X4 world;
+	DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixTranslation(center.x, center.y, center.z));
+	AddInstance(SHAPE::BOX, world, { extents.x, extents.y, extents.z, 0 }, color);
+}
+
+// カプセル追加
+void DebugPrimitive::AddCapsule(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, float radius, const DirectX::XMFLOAT4& color)
+{
+	// 中心に置いて、半球を上下に半分ずつ伸ばす
+	const DirectX::XMFLOAT3 center = { (start.x + end.x) * 0.5f, (start.y + end.y) * 0.5f, (start.z + end.z) * 0.5f };
+	float length = 0;
+	DirectX::XMFLOAT4X4 world = MakeAlignedWorld(start, end, length);
+	world._41 = center.x;
+	world._42 = center.y;
+	world._43 = center.z;
+	AddInstance(SHAPE::CAPSULE, world, { radius, radius, radius, length * 0.5f }, color);
+}
+
+// 矢印追加
+void DebugPrimitive::AddArrow(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, float headSize, const DirectX::XMFLOAT4& color)
+{
+	float length = 0;
+	DirectX::XMFLOAT4X4 world = MakeAlignedWorld(start, end, length);
+	AddInstance(SHAPE::ARROW, world, { headSize, headSize, headSize, length }, color);
+}
+
+// start から end へ向かう回転と平行移動
+DirectX::XMFLOAT4X4 DebugPrimitive::MakeAlignedWorld(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, float& length)
+{
+	DirectX::XMVECTOR Start = DirectX::XMLoadFloat3(&start);
+	DirectX::XMVECTOR Direction = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&end), Start);
+	length = DirectX::XMVectorGetX(DirectX::XMVector3Length(Direction));
+
+	DirectX::XMFLOAT4X4 world;
+	if (length < 1e-6f)
+	{
+		// 長さがなければ向きはそのまま
+		DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixTranslation(start.x, start.y, start.z));
+		return world;
+	}
+
+	// Y 軸を向きに合わせ、残りの 2 軸は向きと平行でない軸から作る
+	DirectX::XMVECTOR AxisY = DirectX::XMVectorScale(Direction, 1.0f / length);
+	DirectX::XMVECTOR Reference = fabsf(DirectX::XMVectorGetY(AxisY)) < 0.999f ? DirectX::XMVectorSet(0, 1, 0, 0) : DirectX::XMVectorSet(1, 0, 0, 0);
+	DirectX::XMVECTOR AxisX = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(Reference, AxisY));
+	DirectX::XMVECTOR AxisZ = DirectX::XMVector3Cross(AxisX, AxisY);
+
+	DirectX::XMMATRIX W;
+	W.r[0] = AxisX;
+	W.r[1] = AxisY;
+	W.r[2] = AxisZ;
+	W.r[3] = DirectX::XMVectorSetW(Start, 1.0f);
+	DirectX::XMStoreFloat4x4(&world, W);
+	return world;
+}
+
+// インスタンス追加
+void DebugPrimitive::AddInstance(SHAPE shape, const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4& scale, const DirectX::XMFLOAT4& color)
+{
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::RENDER);
+
+	Instance instance;
+	instance.world = world;
+	instance.scale = scale;
+	instance.color = color;
+	shapes[static_cast<size_t>(shape)].instances.emplace_back(instance);
+}
+
+// インスタンスバッファの作り直し
+void DebugPrimitive::CreateInstanceBuffer(SHAPE shape, UINT capacity)
 {
 	// --- Graphics 取得 ---
 	Graphics& gfx = Graphics::Instance();
 
-	// --- 頂点データ作成 ---
-	sphereVertexCount = stacks * slices * 2 + slices * stacks * 2;
-	std::unique_ptr<DirectX::XMFLOAT3[]> vertices = std::make_unique<DirectX::XMFLOAT3[]>(sphereVertexCount);
+	Shape& s = shapes[static_cast<size_t>(shape)];
+
+	D3D11_BUFFER_DESC desc = {};
+	desc.ByteWidth = sizeof(Instance) * capacity;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 
+	HRESULT hr = gfx.device->CreateBuffer(&desc, nullptr, s.instanceBuffer.ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	s.capacity = capacity;
+}
+
+// 球メッシュ作成
+void DebugPrimitive::CreateSphereMesh(std::vector<DirectX::XMFLOAT4>& vertices, float radius, int slices, int stacks)
+{
 	float phiStep = DirectX::XM_PI / stacks;
 	float thetaStep = DirectX::XM_2PI / slices;
 
-	DirectX::XMFLOAT3* p = vertices.get();
-
 	for (int i = 0; i < stacks; ++i)
 	{
 		float phi = i * phiStep;
@@ -141,17 +240,11 @@ void DebugPrimitive::CreateSphereMesh(float radius, int slices, int stacks)
 		for (int j = 0; j < slices; ++j)
 		{
 			float theta = j * thetaStep;
-			p->x = r * sinf(theta);
-			p->y = y;
-			p->z = r * cosf(theta);
-			p++;
+			vertices.push_back({ r * sinf(theta), y, r * cosf(theta), 0 });
 
 			theta += thetaStep;
 
-			p->x = r * sinf(theta);
-			p->y = y;
-			p->z = r * cosf(theta);
-			p++;
+			vertices.push_back({ r * sinf(theta), y, r * cosf(theta), 0 });
 		}
 	}
 
@@ -164,47 +257,22 @@ void DebugPrimitive::CreateSphereMesh(float radius, int slices, int stacks)
 			float theta = j * thetaStep;
 			DirectX::XMVECTOR V1 = DirectX::XMVectorSet(radius * sinf(theta), radius * cosf(theta), 0.0f, 1.0f);
 			DirectX::XMVECTOR P1 = DirectX::XMVector3TransformCoord(V1, M);
-			DirectX::XMStoreFloat3(p++, P1);
+			DirectX::XMFLOAT4& p1 = vertices.emplace_back();
+			DirectX::XMStoreFloat4(&p1, DirectX::XMVectorSetW(P1, 0.0f));
 
-			int n = (j + 1) % stacks;
 			theta += thetaStep;
 
 			DirectX::XMVECTOR V2 = DirectX::XMVectorSet(radius * sinf(theta), radius * cosf(theta), 0.0f, 1.0f);
 			DirectX::XMVECTOR P2 = DirectX::XMVector3TransformCoord(V2, M);
-			DirectX::XMStoreFloat3(p++, P2);
+			DirectX::XMFLOAT4& p2 = vertices.emplace_back();
+			DirectX::XMStoreFloat4(&p2, DirectX::XMVectorSetW(P2, 0.0f));
 		}
 	}
-
-	// --- 頂点バッファ作成 ---
-	D3D11_BUFFER_DESC bufferDesc = {};
-	D3D11_SUBRESOURCE_DATA subresourceData = {};
-
-	bufferDesc.ByteWidth = static_cast<UINT>(sizeof(DirectX::XMFLOAT3) * sphereVertexCount);
-	bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;	// D3D11_USAGE_DEFAULT;
-	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	bufferDesc.CPUAccessFlags = 0;
-	bufferDesc.MiscFlags = 0;
-	bufferDesc.StructureByteStride = 0;
-	subresourceData.pSysMem = vertices.get();
-	subresourceData.SysMemPitch = 0;
-	subresourceData.SysMemSlicePitch = 0;
-
-	HRESULT hr = gfx.device->CreateBuffer(&bufferDesc, &subresourceData, sphereVertexBuffer.GetAddressOf());
-	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 }
 
 // 円柱メッシュ作成
-void DebugPrimitive::CreateCylinderMesh(float radius1, float radius2, float start, float height, int slices, int stacks)
+void DebugPrimitive::CreateCylinderMesh(std::vector<DirectX::XMFLOAT4>& vertices, float radius1, float radius2, float start, float height, int slices, int stacks)
 {
-	// --- Graphics 取得 ---
-	Graphics& gfx = Graphics::Instance();
-
-	// --- 頂点データ作成 ---
-	cylinderVertexCount = 2 * slices * (stacks + 1) + 2 * slices;
-	std::unique_ptr<DirectX::XMFLOAT3[]> vertices = std::make_unique<DirectX::XMFLOAT3[]>(cylinderVertexCount);
-
-	DirectX::XMFLOAT3* p = vertices.get();
-
 	float stackHeight = height / stacks;
 	float radiusStep = (radius2 - radius1) / stacks;
 
@@ -226,44 +294,105 @@ void DebugPrimitive::CreateCylinderMesh(float radius1, float radius2, float star
 			float y = start + j * stackHeight;
 			float r = radius1 + j * radiusStep;
 
-			p->x = r * c1;
-			p->y = y;
-			p->z = r * s1;
-			p++;
+			vertices.push_back({ r * c1, y, r * s1, 0 });
+			vertices.push_back({ r * c2, y, r * s2, 0 });
+		}
+
+		vertices.push_back({ radius1 * c1, start, radius1 * s1, 0 });
+		vertices.push_back({ radius2 * c1, start + height, radius2 * s1, 0 });
+	}
+}
 
-			p->x = r * c2;
-			p->y = y;
-			p->z = r * s2;
-			p++;
+// 箱メッシュ作成 (-1 ~ +1 の立方体の 12 辺)
+void DebugPrimitive::CreateBoxMesh(std::vector<DirectX::XMFLOAT4>& vertices)
+{
+	const DirectX::XMFLOAT4 corners[8] =
+	{
+		{ -1, -1, -1, 0 }, { +1, -1, -1, 0 }, { +1, -1, +1, 0 }, { -1, -1, +1, 0 },
+		{ -1, +1, -1, 0 }, { +1, +1, -1, 0 }, { +1, +1, +1, 0 }, { -1, +1, +1, 0 },
+	};
+	const int edges[12][2] =
+	{
+		{ 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 },		// 下
+		{ 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 },		// 上
+		{ 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },		// 縦
+	};
+	for (const int* edge : edges)
+	{
+		vertices.push_back(corners[edge[0]]);
+		vertices.push_back(corners[edge[1]]);
+	}
+}
+
+// カプセルメッシュ作成 (半径 1 の半球を w = ±1 で上下に伸ばす)
+void DebugPrimitive::CreateCapsuleMesh(std::vector<DirectX::XMFLOAT4>& vertices, int slices, int stacks)
+{
+	float phiStep = DirectX::XM_PIDIV2 / stacks;
+	float thetaStep = DirectX::XM_2PI / slices;
+
+	// 緯線 (赤道を含む)
+	for (int i = 1; i <= stacks; ++i)
+	{
+		float phi = i * phiStep;
+		float y = cosf(phi);
+		float r = sinf(phi);
+
+		for (int j = 0; j < slices; ++j)
+		{
+			float theta1 = j * thetaStep;
+			float theta2 = theta1 + thetaStep;
+			for (float side : { 1.0f, -1.0f })
+			{
+				vertices.push_back({ r * sinf(theta1), y * side, r * cosf(theta1), side });
+				vertices.push_back({ r * sinf(theta2), y * side, r * cosf(theta2), side });
+			}
 		}
+	}
+
+	// 経線 (4 方向) と、上下の半球をつなぐ縦線
+	for (int k = 0; k < 4; ++k)
+	{
+		float theta = k * DirectX::XM_PIDIV2;
+		float s = sinf(theta);
+		float c = cosf(theta);
 
-		p->x = radius1 * c1;
-		p->y = start;
-		p->z = radius1 * s1;
-		p++;
+		for (int i = 0; i < stacks; ++i)
+		{
+			float phi1 = i * phiStep;
+			float phi2 = phi1 + phiStep;
+			for (float side : { 1.0f, -1.0f })
+			{
+				vertices.push_back({ sinf(phi1) * s, cosf(phi1) * side, sinf(phi1) * c, side });
+				vertices.push_back({ sinf(phi2) * s, cosf(phi2) * side, sinf(phi2) * c, side });
+			}
+		}
 
-		p->x = radius2 * c1;
-		p->y = start + height;
-		p->z = radius2 * s1;
-		p++;
+		vertices.push_back({ s, 0, c, +1 });
+		vertices.push_back({ s, 0, c, -1 });
 	}
+}
 
-	// 頂点バッファ
+// 矢印メッシュ作成 (軸は w で長さまで伸ばし、先端は大きさ 1 の円錐)
+void DebugPrimitive::CreateArrowMesh(std::vector<DirectX::XMFLOAT4>& vertices, int slices)
+{
+	// 軸
+	vertices.push_back({ 0, 0, 0, 0 });
+	vertices.push_back({ 0, 0, 0, 1 });
+
+	// 先端の円錐
+	const float headLength = 2.0f;
+	const float headRadius = 0.5f;
+	float thetaStep = DirectX::XM_2PI / slices;
+	for (int i = 0; i < slices; ++i)
 	{
-		D3D11_BUFFER_DESC desc = {};
-		D3D11_SUBRESOURCE_DATA subresourceData = {};
-
-		desc.ByteWidth = static_cast<UINT>(sizeof(DirectX::XMFLOAT3) * cylinderVertexCount);
-		desc.Usage = D3D11_USAGE_IMMUTABLE;	// D3D11_USAGE_DEFAULT;
-		desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		desc.CPUAccessFlags = 0;
-		desc.MiscFlags = 0;
-		desc.StructureByteStride = 0;
-		subresourceData.pSysMem = vertices.get();
-		subresourceData.SysMemPitch = 0;
-		subresourceData.SysMemSlicePitch = 0;
-
-		HRESULT hr = gfx.device->CreateBuffer(&desc, &subresourceData, cylinderVertexBuffer.GetAddressOf());
-		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+		float theta1 = i * thetaStep;
+		float theta2 = theta1 + thetaStep;
+		DirectX::XMFLOAT4 base1 = { headRadius * sinf(theta1), -headLength, headRadius * cosf(theta1), 1 };
+		DirectX::XMFLOAT4 base2 = { headRadius * sinf(theta2), -headLength, headRadius * cosf(theta2), 1 };
+
+		vertices.push_back({ 0, 0, 0, 1 });
+		vertices.push_back(base1);
+		vertices.push_back(base1);
+		vertices.push_back(base2);
 	}
 }
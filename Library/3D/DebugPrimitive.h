@@ -4,6 +4,9 @@
 #include <DirectXMath.h>
 #include <wrl.h>
 
+// デバッグ用の図形 (線) をまとめて描く
+// 図形ごとに 1 つのインスタンスバッファへ積み、Render で図形の種類ごとに DrawInstanced 1 回で描く
+// (積んだ数に関係なく描画は図形の種類の数まで)
 class DebugPrimitive
 {
 private:
@@ -17,6 +20,18 @@ public:
 		return instance;
 	}
 
+	// 図形の種類
+	enum class SHAPE
+	{
+		SPHERE,
+		CYLINDER,
+		BOX,
+		CAPSULE,
+		ARROW,
+
+		SHAPE_COUNT
+	};
+
 	// 初期化
 	void Initialize();
 
@@ -26,48 +41,74 @@ public:
 	// 球追加
 	void AddSphere(const DirectX::XMFLOAT3& center, float radius, const DirectX::XMFLOAT4& color);
 
-	// 円柱追加
+	// 円柱追加 (position は底面の中心)
 	void AddCylinder(const DirectX::XMFLOAT3& position, float radius, float height, const DirectX::XMFLOAT4& color);
 
+	// 箱追加 (軸に沿った箱、extents は中心からの半分の大きさ)
+	void AddBox(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents, const DirectX::XMFLOAT4& color);
+
+	// カプセル追加 (start と end は両端の半球の中心)
+	void AddCapsule(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, float radius, const DirectX::XMFLOAT4& color);
+
+	// 矢印追加 (headSize は先端の大きさ)
+	void AddArrow(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, float headSize, const DirectX::XMFLOAT4& color);
+
+	// 前回の Render で描いた図形の数
+	UINT GetLastInstanceCount() const { return lastInstanceCount; }
+
 private:
 	// 球メッシュ作成
-	void CreateSphereMesh(float radius, int slices, int stacks);
+	void CreateSphereMesh(std::vector<DirectX::XMFLOAT4>& vertices, float radius, int slices, int stacks);
 
 	// 円柱メッシュ作成
-	void CreateCylinderMesh(float radius1, float radius2, float start, float height, int slices, int stacks);
+	void CreateCylinderMesh(std::vector<DirectX::XMFLOAT4>& vertices, float radius1, float radius2, float start, float height, int slices, int stacks);
+
+	// 箱メッシュ作成
+	void CreateBoxMesh(std::vector<DirectX::XMFLOAT4>& vertices);
+
+	// カプセルメッシュ作成
+	void CreateCapsuleMesh(std::vector<DirectX::XMFLOAT4>& vertices, int slices, int stacks);
+
+	// 矢印メッシュ作成
+	void CreateArrowMesh(std::vector<DirectX::XMFLOAT4>& vertices, int slices);
+
+	// start から end へ向かう回転と平行移動 (Y 軸を向きに合わせる)
+	static DirectX::XMFLOAT4X4 MakeAlignedWorld(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, float& length);
+
+	// インスタンス追加
+	void AddInstance(SHAPE shape, const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4& scale, const DirectX::XMFLOAT4& color);
+
+	// インスタンスバッファの作り直し
+	void CreateInstanceBuffer(SHAPE shape, UINT capacity);
 
 private:
-	struct Sphere
+	// 図形 1 つ分 (DebugPrimitive.hlsli の VS_IN と合わせる)
+	struct Instance
 	{
+		DirectX::XMFLOAT4X4	world;		// 回転と平行移動
+		DirectX::XMFLOAT4	scale;		// xyz : 拡大, w : 伸ばす量
 		DirectX::XMFLOAT4	color;
-		DirectX::XMFLOAT3	center;
-		float				radius;
 	};
 
-	struct Cylinder
+	// 図形の種類ごとのメッシュの範囲とインスタンス
+	struct Shape
 	{
-		DirectX::XMFLOAT4	color;
-		DirectX::XMFLOAT3	position;
-		float				radius;
-		float				height;
-	};
-	struct Constants
-	{
-		DirectX::XMFLOAT4X4 world;
-		DirectX::XMFLOAT4	materialColor;
+		UINT startVertex = 0;
+		UINT vertexCount = 0;
+
+		std::vector<Instance> instances;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> instanceBuffer;
+		UINT capacity = 0;
 	};
 
-	Microsoft::WRL::ComPtr<ID3D11Buffer> sphereVertexBuffer;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> cylinderVertexBuffer;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
+	// 全図形のメッシュ (w は伸ばす量に掛ける割合)
+	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
 
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
 	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
 
-	std::vector<Sphere>		spheres;
-	std::vector<Cylinder>	cylinders;
+	Shape shapes[static_cast<size_t>(SHAPE::SHAPE_COUNT)];
 
-	UINT	sphereVertexCount = 0;
-	UINT	cylinderVertexCount = 0;
-};
\ No newline at end of file
+	UINT lastInstanceCount = 0;
+};
@@ -0,0 +1,176 @@
+#include "Frustum.h"
+
+using namespace DirectX;
+
+// ビュー・プロジェクション行列から平面を取り出す
+void Frustum::Set(const XMFLOAT4X4& view, const XMFLOAT4X4& projection)
+{
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, XMLoadFloat4x4(&view) * XMLoadFloat4x4(&projection));
+
+	// 行ベクトル (v * M) なので、クリップ座標の各成分は M の列
+	planes[LEFT_PLANE]	= { m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41 };
+	planes[RIGHT_PLANE]	= { m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41 };
+	planes[BOTTOM_PLANE]	= { m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42 };
+	planes[TOP_PLANE]	= { m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42 };
+	planes[NEAR_PLANE]	= { m._13, m._23, m._33, m._43 };
+	planes[FAR_PLANE]	= { m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43 };
+
+	// 距離を比較できるように正規化しておく
+	for (XMFLOAT4& plane : planes)
+	{
+		XMStoreFloat4(&plane, XMPlaneNormalize(XMLoadFloat4(&plane)));
+	}
+}
+
+// 球が視錐台に (一部でも) 入っているか
+bool Frustum::IntersectSphere(const XMFLOAT3& center, float radius) const
+{
+	const XMVECTOR C = XMLoadFloat3(&center);
+	for (const XMFLOAT4& plane : planes)
+	{
+		if (XMVectorGetX(XMPlaneDotCoord(XMLoadFloat4(&plane), C)) < -radius) return false;
+	}
+	return true;
+}
+
+// 登録数を 0 にする
+void FrustumCullingBatch::Clear()
+{
+	count = 0;
+	visibleCount = 0;
+}
+
+// AABB の登録
+size_t FrustumCullingBatch::Add(const XMFLOAT3& center, const XMFLOAT3& extents)
+{
+	const size_t index = count++;
+	const size_t block = index / 4;
+	const size_t lane = index % 4;
+
+	if (block >= centerX.size())
+	{
+		centerX.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+		centerY.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+		centerZ.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+		extentsX.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+		extentsY.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+		extentsZ.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+	if (index >= visible.size())
+	{
+		visible.resize(centerX.size() * 4);
+		alwaysVisible.resize(centerX.size() * 4);
+	}
+
+	(&centerX[block].x)[lane] = center.x;
+	(&centerY[block].x)[lane] = center.y;
+	(&centerZ[block].x)[lane] = center.z;
+	(&extentsX[block].x)[lane] = extents.x;
+	(&extentsY[block].x)[lane] = extents.y;
+	(&extentsZ[block].x)[lane] = extents.z;
+	alwaysVisible[index] = 0;
+	visible[index] = 1;
+	return index;
+}
+
+// 常に見えるものとして登録
+size_t FrustumCullingBatch::AddAlwaysVisible()
+{
+	const size_t index = Add({ 0,0,0 }, { 0,0,0 });
+	alwaysVisible[index] = 1;
+	return index;
+}
+
+// 判定
+void FrustumCullingBatch::Cull(const Frustum& frustum)
+{
+	// 平面の各成分を 4 レーンに展開しておく
+	XMVECTOR planeX[Frustum::PLANE_COUNT], planeY[Frustum::PLANE_COUNT], planeZ[Frustum::PLANE_COUNT], planeW[Frustum::PLANE_COUNT];
+	XMVECTOR absX[Frustum::PLANE_COUNT], absY[Frustum::PLANE_COUNT], absZ[Frustum::PLANE_COUNT];
+	for (int i = 0; i < Frustum::PLANE_COUNT; i++)
+	{
+		const XMVECTOR P = XMLoadFloat4(&frustum.planes[i]);
+		planeX[i] = XMVectorSplatX(P);
+		planeY[i] = XMVectorSplatY(P);
+		planeZ[i] = XMVectorSplatZ(P);
+		planeW[i] = XMVectorSplatW(P);
+		absX[i] = XMVectorAbs(planeX[i]);
+		absY[i] = XMVectorAbs(planeY[i]);
+		absZ[i] = XMVectorAbs(planeZ[i]);
+	}
+
+	visibleCount = 0;
+	const size_t blockCount = (count + 3) / 4;
+	for (size_t block = 0; block < blockCount; block++)
+	{
+		const XMVECTOR CX = XMLoadFloat4A(&centerX[block]);
+		const XMVECTOR CY = XMLoadFloat4A(&centerY[block]);
+		const XMVECTOR CZ = XMLoadFloat4A(&centerZ[block]);
+		const XMVECTOR EX = XMLoadFloat4A(&extentsX[block]);
+		const XMVECTOR EY = XMLoadFloat4A(&extentsY[block]);
+		const XMVECTOR EZ = XMLoadFloat4A(&extentsZ[block]);
+
+		// どれかの平面の完全に外側なら見えない
+		// 中心の距離 < -(平面法線に投影した半分の大きさ) で判定する
+		XMVECTOR outside = XMVectorFalseInt();
+		for (int i = 0; i < Frustum::PLANE_COUNT; i++)
+		{
+			XMVECTOR distance = XMVectorMultiplyAdd(planeX[i], CX, planeW[i]);
+			distance = XMVectorMultiplyAdd(planeY[i], CY, distance);
+			distance = XMVectorMultiplyAdd(planeZ[i], CZ, distance);
+
+			XMVECTOR radius = XMVectorMultiply(absX[i], EX);
+			radius = XMVectorMultiplyAdd(absY[i], EY, radius);
+			radius = XMVectorMultiplyAdd(absZ[i], EZ, radius);
+
+			outside = XMVectorOrInt(outside, XMVectorLess(distance, XMVectorNegate(radius)));
+		}
+
+		XMUINT4 result;
+		XMStoreUInt4(&result, outside);
+		const uint32_t lanes[4] = { result.x, result.y, result.z, result.w };
+		for (size_t lane = 0; lane < 4; lane++)
+		{
+			const size_t index = block * 4 + lane;
+			if (index >= count) break;
+
+			visible[index] = (lanes[lane] == 0 || alwaysVisible[index]) ? 1 : 0;
+			visibleCount += visible[index];
+		}
+	}
+}
+
+// 見えない扱いにする
+void FrustumCullingBatch::Hide(size_t index)
+{
+	if (!visible[index]) return;
+
+	visible[index] = 0;
+	visibleCount--;
+}
+
+// 登録した AABB の取得
+XMFLOAT3 FrustumCullingBatch::GetCenter(size_t index) const
+{
+	const size_t block = index / 4;
+	const size_t lane = index % 4;
+	return { (&centerX[block].x)[lane], (&centerY[block].x)[lane], (&centerZ[block].x)[lane] };
+}
+
+XMFLOAT3 FrustumCullingBatch::GetExtents(size_t index) const
+{
+	const size_t block = index / 4;
+	const size_t lane = index % 4;
+	return { (&extentsX[block].x)[lane], (&extentsY[block].x)[lane], (&extentsZ[block].x)[lane] };
+}
+
+// 全て見えていることにする
+void FrustumCullingBatch::SetAllVisible()
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		visible[i] = 1;
+	}
+	visibleCount = count;
+}
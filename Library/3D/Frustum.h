@@ -0,0 +1,82 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// Frustum
+//--------------------------------------------------------------
+// ビュー・プロジェクション行列から取り出した視錐台 (6 平面、法線は内向き)
+class Frustum
+{
+public:
+	enum PLANE
+	{
+		LEFT_PLANE,
+		RIGHT_PLANE,
+		BOTTOM_PLANE,
+		TOP_PLANE,
+		NEAR_PLANE,
+		FAR_PLANE,
+		PLANE_COUNT,
+	};
+
+public:
+	Frustum() {}
+	~Frustum() {}
+
+	// ビュー・プロジェクション行列から平面を取り出す
+	void Set(const DirectX::XMFLOAT4X4& view, const DirectX::XMFLOAT4X4& projection);
+
+	// 球が視錐台に (一部でも) 入っているか
+	bool IntersectSphere(const DirectX::XMFLOAT3& center, float radius) const;
+
+public:
+	// 平面 (xyz : 法線, w : 距離)
+	DirectX::XMFLOAT4 planes[PLANE_COUNT] = {};
+};
+
+//--------------------------------------------------------------
+// FrustumCullingBatch
+//--------------------------------------------------------------
+// AABB をまとめて登録し、視錐台との判定を 4 個ずつ SIMD で行う
+// 管理クラスのメンバーとして持ち、毎フレーム Clear → Add → Camera::Cull → IsVisible の順で使う
+class FrustumCullingBatch
+{
+public:
+	FrustumCullingBatch() {}
+	~FrustumCullingBatch() {}
+
+	// 登録数を 0 にする (確保済みの配列はそのまま使い回す)
+	void Clear();
+
+	// AABB の登録 (戻り値は登録番号)
+	size_t Add(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents);
+	// 常に見えるものとして登録 (バウンディングボックスのないもの)
+	size_t AddAlwaysVisible();
+
+	// 判定
+	void Cull(const Frustum& frustum);
+	// 全て見えていることにする (カリング無効時)
+	void SetAllVisible();
+
+	bool IsVisible(size_t index) const { return visible[index] != 0; }
+	bool IsAlwaysVisible(size_t index) const { return alwaysVisible[index] != 0; }
+	// 見えない扱いにする (遮蔽判定など、視錐台の後の判定用)
+	void Hide(size_t index);
+
+	// 登録した AABB の取得
+	DirectX::XMFLOAT3 GetCenter(size_t index) const;
+	DirectX::XMFLOAT3 GetExtents(size_t index) const;
+	size_t GetCount() const { return count; }
+	size_t GetVisibleCount() const { return visibleCount; }
+
+private:
+	// 成分ごとの配列 (1 要素 = 4 個)
+	std::vector<DirectX::XMFLOAT4A> centerX, centerY, centerZ;
+	std::vector<DirectX::XMFLOAT4A> extentsX, extentsY, extentsZ;
+	std::vector<uint8_t> alwaysVisible;
+	std::vector<uint8_t> visible;
+	size_t count = 0;
+	size_t visibleCount = 0;
+};
@@ -39,18 +39,18 @@ void GeometricPrimitive::Render(const DirectX::XMFLOAT4X4& world, const DirectX:
 	uint32_t stride = sizeof(Vertex);
 	uint32_t offset = 0;
 
-	gfx.deviceContext->IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
+	gfx.stateCache.IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
 
-	gfx.deviceContext->IASetInputLayout(inputLayout.Get());
+	gfx.stateCache.IASetInputLayout(inputLayout.Get());
 
-	gfx.deviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
-	gfx.deviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+	gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
 
 	Constants data = { world, materialColor };
-	gfx.deviceContext->UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
-	gfx.deviceContext->VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+	gfx.stateCache.UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
+	gfx.stateCache.VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
 
-	gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
 
-	gfx.deviceContext->Draw(vertexCount, 0);
+	gfx.stateCache.Draw(vertexCount, 0);
 }
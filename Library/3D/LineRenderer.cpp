@@ -2,6 +2,7 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Shader.h"
 #include "../ErrorLogger.h"
+#include "../MemoryTracker.h"
 
 // 初期化
 void LineRenderer::Initialize()
@@ -73,77 +74,93 @@ void LineRenderer::Initialize()
 		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 	}
 
-	// 頂点バッファ
-	{
-		D3D11_BUFFER_DESC desc;
-		desc.ByteWidth = sizeof(Vertex) * capacity;
-		desc.Usage = D3D11_USAGE_DYNAMIC;
-		desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-		desc.MiscFlags = 0;
-		desc.StructureByteStride = 0;
-
-		HRESULT hr = gfx.device->CreateBuffer(&desc, nullptr, vertexBuffer.GetAddressOf());
-		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
-	}
+	// 頂点バッファ (足りなくなったら Render で倍にする)
+	CreateVertexBuffer(capacity);
 }
 
 // 描画実行
 void LineRenderer::Render()
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::RENDER);
+
 	// --- Graphics 取得 ---
 	Graphics& gfx = Graphics::Instance();
 
 	// シェーダー設定
-	gfx.deviceContext->IASetInputLayout(inputLayout.Get());
+	gfx.stateCache.IASetInputLayout(inputLayout.Get());
 
-	gfx.deviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
-	//gfx.deviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+	gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
 
 	// レンダーステート設定
 	const float blendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	gfx.deviceContext->OMSetBlendState(blendState.Get(), blendFactor, 0xFFFFFFFF);
-	gfx.deviceContext->OMSetDepthStencilState(depthStencilState.Get(), 0);
-	gfx.deviceContext->RSSetState(rasterizerState.Get());
+	gfx.stateCache.OMSetBlendState(blendState.Get(), blendFactor, 0xFFFFFFFF);
+	gfx.stateCache.OMSetDepthStencilState(depthStencilState.Get(), 0);
+	gfx.stateCache.RSSetState(rasterizerState.Get());
 
 
 	// プリミティブ設定
 	UINT stride = sizeof(Vertex);
 	UINT offset = 0;
-	gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
-	gfx.deviceContext->IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+	gfx.stateCache.IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
 
-	// 描画
+	// 描画 (全ての線を 1 回で描く)
 	UINT totalVertexCount = static_cast<UINT>(vertices.size());
-	UINT start = 0;
-	UINT count = (totalVertexCount < capacity) ? totalVertexCount : capacity;
-
-	while (start < totalVertexCount)
+	if (totalVertexCount > 0)
 	{
+		// 足りなければ倍々に広げる
+		if (totalVertexCount > capacity)
+		{
+			UINT newCapacity = capacity;
+			while (newCapacity < totalVertexCount) newCapacity *= 2;
+			CreateVertexBuffer(newCapacity);
+			gfx.stateCache.IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
+		}
+
 		D3D11_MAPPED_SUBRESOURCE mappedVB;
-		HRESULT hr = gfx.deviceContext->Map(vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedVB);
+		HRESULT hr = gfx.stateCache.Map(vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedVB);
 		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 
-		memcpy(mappedVB.pData, &vertices[start], sizeof(Vertex) * count);
-
-		gfx.deviceContext->Unmap(vertexBuffer.Get(), 0);
+		memcpy(mappedVB.pData, vertices.data(), sizeof(Vertex) * totalVertexCount);
 
-		gfx.deviceContext->Draw(count, 0);
+		gfx.stateCache.Unmap(vertexBuffer.Get(), 0, sizeof(Vertex) * totalVertexCount);
 
-		start += count;
-		if ((start + count) > totalVertexCount)
-		{
-			count = totalVertexCount - start;
-		}
+		gfx.stateCache.Draw(totalVertexCount, 0);
 	}
 	vertices.clear();
+
+	// 専用のラスタライザを使ったので、Graphics が覚えているものに戻す
+	gfx.SetRasterizer(gfx.GetRasterizer());
 }
 
 // 頂点追加
 void LineRenderer::AddVertex(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT4& color)
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::RENDER);
+
 	Vertex v;
 	v.position = position;
 	v.color = color;
 	vertices.emplace_back(v);
 }
+
+// 頂点バッファの作り直し
+void LineRenderer::CreateVertexBuffer(UINT newCapacity)
+{
+	// --- Graphics 取得 ---
+	Graphics& gfx = Graphics::Instance();
+
+	D3D11_BUFFER_DESC desc;
+	desc.ByteWidth = sizeof(Vertex) * newCapacity;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.MiscFlags = 0;
+	desc.StructureByteStride = 0;
+
+	HRESULT hr = gfx.device->CreateBuffer(&desc, nullptr, vertexBuffer.ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	capacity = newCapacity;
+}
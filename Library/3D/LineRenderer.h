@@ -26,6 +26,10 @@ public:
 	// 頂点追加
 	void AddVertex(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT4& color);
 
+private:
+	// 頂点バッファの作り直し
+	void CreateVertexBuffer(UINT newCapacity);
+
 private:
 	struct Vertex
 	{
@@ -45,5 +49,5 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11DepthStencilState>	depthStencilState;
 
 	std::vector<Vertex>			vertices;
-	UINT						capacity = 1024;
+	UINT						capacity = 1024;	// 頂点バッファに入る頂点数 (足りなければ倍にする)
 };
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include "OcclusionCuller.h"
+#include "CollisionMesh.h"
+#include "Frustum.h"
+
+using namespace DirectX;
+
+OcclusionCuller::OcclusionCuller()
+{
+	// 16:9 の低解像度
+	Resize(320, 180);
+}
+
+// 深度バッファの解像度設定
+void OcclusionCuller::Resize(int width, int height)
+{
+	this->width = (std::max)((width + 3) & ~3, 4);
+	this->height = (std::max)(height, 1);
+
+	// 1x1 になるまで半分ずつの段を作る
+	hiZ.clear();
+	hiZWidth.clear();
+	hiZHeight.clear();
+	int w = this->width;
+	int h = this->height;
+	while (true)
+	{
+		hiZ.emplace_back(static_cast<size_t>(w) * h, 1.0f);
+		hiZWidth.emplace_back(w);
+		hiZHeight.emplace_back(h);
+		if (w == 1 && h == 1) break;
+		w = (std::max)((w + 1) / 2, 1);
+		h = (std::max)((h + 1) / 2, 1);
+	}
+	ready = false;
+}
+
+// 遮蔽物の登録
+void OcclusionCuller::AddOccluder(const CollisionMesh& mesh, const XMFLOAT4X4& world, float minArea)
+{
+	const XMMATRIX World = XMLoadFloat4x4(&world);
+	for (const CollisionMesh::Triangle& triangle : mesh.GetTriangles())
+	{
+		const XMVECTOR A = XMLoadFloat3(&triangle.a);
+		const XMVECTOR B = XMVectorAdd(A, XMLoadFloat3(&triangle.ab));
+		const XMVECTOR C = XMVectorAdd(B, XMLoadFloat3(&triangle.bc));
+
+		const XMVECTOR WorldA = XMVector3TransformCoord(A, World);
+		const XMVECTOR WorldB = XMVector3TransformCoord(B, World);
+		const XMVECTOR WorldC = XMVector3TransformCoord(C, World);
+
+		// 小さい三角形は隠す量に対してコストが高いので使わない
+		const XMVECTOR N = XMVector3Cross(XMVectorSubtract(WorldB, WorldA), XMVectorSubtract(WorldC, WorldA));
+		if (XMVectorGetX(XMVector3Length(N)) * 0.5f < minArea) continue;
+
+		XMFLOAT3 a, b, c;
+		XMStoreFloat3(&a, WorldA);
+		XMStoreFloat3(&b, WorldB);
+		XMStoreFloat3(&c, WorldC);
+		AddOccluder(a, b, c);
+	}
+}
+
+void OcclusionCuller::AddOccluder(const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c)
+{
+	occluderVertices.emplace_back(a);
+	occluderVertices.emplace_back(b);
+	occluderVertices.emplace_back(c);
+}
+
+// 遮蔽物の全削除
+void OcclusionCuller::ClearOccluders()
+{
+	occluderVertices.clear();
+	ready = false;
+}
+
+// 毎フレームの更新
+void OcclusionCuller::Update(const XMFLOAT4X4& view, const XMFLOAT4X4& projection)
+{
+	// カウンターを前フレームの値に移す
+	lastTestedCount = testedCount;
+	lastOccludedCount = occludedCount;
+	testedCount = 0;
+	occludedCount = 0;
+
+	ready = false;
+	if (!enable || occluderVertices.empty()) return;
+
+	const XMMATRIX ViewProjection = XMLoadFloat4x4(&view) * XMLoadFloat4x4(&projection);
+	XMStoreFloat4x4(&viewProjection, ViewProjection);
+
+	// 深度バッファを最も奥でクリア
+	std::fill(hiZ.front().begin(), hiZ.front().end(), 1.0f);
+
+	// 遮蔽物の描画
+	const size_t vertexCount = occluderVertices.size();
+	for (size_t i = 0; i + 2 < vertexCount; i += 3)
+	{
+		const XMVECTOR clip[3] =
+		{
+			XMVector3Transform(XMLoadFloat3(&occluderVertices[i + 0]), ViewProjection),
+			XMVector3Transform(XMLoadFloat3(&occluderVertices[i + 1]), ViewProjection),
+			XMVector3Transform(XMLoadFloat3(&occluderVertices[i + 2]), ViewProjection),
+		};
+		ClipAndRasterize(clip);
+	}
+
+	BuildHiZ();
+	ready = true;
+}
+
+// クリップ空間の三角形を描く
+void OcclusionCuller::ClipAndRasterize(const XMVECTOR clip[3])
+{
+	// near 平面 (z >= 0) で切る、三角形ひとつから最大で四角形になる
+	XMVECTOR polygon[4];
+	int polygonCount = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		const XMVECTOR& P = clip[i];
+		const XMVECTOR& Q = clip[(i + 1) % 3];
+		const float zp = XMVectorGetZ(P);
+		const float zq = XMVectorGetZ(Q);
+
+		if (zp >= 0.0f) polygon[polygonCount++] = P;
+		if ((zp >= 0.0f) != (zq >= 0.0f))
+		{
+			polygon[polygonCount++] = XMVectorLerp(P, Q, zp / (zp - zq));
+		}
+	}
+	if (polygonCount < 3) return;
+
+	// スクリーン座標に変換 (z は 0 ~ 1 の深度)
+	XMFLOAT3 screen[4];
+	for (int i = 0; i < polygonCount; i++)
+	{
+		XMFLOAT4 p;
+		XMStoreFloat4(&p, polygon[i]);
+		const float w = (std::max)(p.w, 1.0e-6f);
+		screen[i].x = (p.x / w * 0.5f + 0.5f) * width;
+		screen[i].y = (0.5f - p.y / w * 0.5f) * height;
+		screen[i].z = p.z / w;
+	}
+
+	// 扇状に分割して描く
+	for (int i = 1; i + 1 < polygonCount; i++)
+	{
+		RasterizeTriangle(screen[0], screen[i], screen[i + 1]);
+	}
+}
+
+// スクリーン空間の三角形を 4 ピクセルずつ描く
+void OcclusionCuller::RasterizeTriangle(const XMFLOAT3& v0, const XMFLOAT3& v1, const XMFLOAT3& v2)
+{
+	// 向きを揃える (表裏どちらの面も遮蔽物として扱う)
+	XMFLOAT3 p0 = v0, p1 = v1, p2 = v2;
+	float area = (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x);
+	if (std::fabs(area) < 1.0e-6f) return;
+	if (area < 0.0f)
+	{
+		std::swap(p1, p2);
+		area = -area;
+	}
+
+	// 描画範囲 (x は 4 ピクセル単位に揃える)
+	const float minXf = (std::max)((std::min)({ p0.x, p1.x, p2.x }), 0.0f);
+	const float maxXf = (std::min)((std::max)({ p0.x, p1.x, p2.x }), static_cast<float>(width - 1));
+	const float minYf = (std::max)((std::min)({ p0.y, p1.y, p2.y }), 0.0f);
+	const float maxYf = (std::min)((std::max)({ p0.y, p1.y, p2.y }), static_cast<float>(height - 1));
+	if (minXf > maxXf || minYf > maxYf) return;
+
+	const int minX = static_cast<int>(minXf) & ~3;
+	const int maxX = static_cast<int>(maxXf);
+	const int minY = static_cast<int>(minYf);
+	const int maxY = static_cast<int>(maxYf);
+
+	// 辺関数 E(p) = a * px + b * py + c (三角形の内側で 0 以上)
+	const XMFLOAT3* edgeFrom[3] = { &p1, &p2, &p0 };
+	const XMFLOAT3* edgeTo[3] = { &p2, &p0, &p1 };
+	float a[3], b[3], c[3];
+	for (int i = 0; i < 3; i++)
+	{
+		a[i] = edgeFrom[i]->y - edgeTo[i]->y;
+		b[i] = edgeTo[i]->x - edgeFrom[i]->x;
+		c[i] = -a[i] * edgeFrom[i]->x - b[i] * edgeFrom[i]->y;
+	}
+
+	// 深度も画面上で線形 (z = za * px + zb * py + zc)
+	const float invArea = 1.0f / area;
+	const float za = (a[0] * p0.z + a[1] * p1.z + a[2] * p2.z) * invArea;
+	const float zb = (b[0] * p0.z + b[1] * p1.z + b[2] * p2.z) * invArea;
+	const float zc = (c[0] * p0.z + c[1] * p1.z + c[2] * p2.z) * invArea;
+
+	const XMVECTOR LaneOffset = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+	const XMVECTOR A0 = XMVectorReplicate(a[0]);
+	const XMVECTOR A1 = XMVectorReplicate(a[1]);
+	const XMVECTOR A2 = XMVectorReplicate(a[2]);
+	const XMVECTOR ZA = XMVectorReplicate(za);
+	const XMVECTOR Zero = XMVectorZero();
+
+	float* depth = hiZ.front().data();
+	for (int y = minY; y <= maxY; y++)
+	{
+		const float py = y + 0.5f;
+		const XMVECTOR Row0 = XMVectorReplicate(b[0] * py + c[0]);
+		const XMVECTOR Row1 = XMVectorReplicate(b[1] * py + c[1]);
+		const XMVECTOR Row2 = XMVectorReplicate(b[2] * py + c[2]);
+		const XMVECTOR RowZ = XMVectorReplicate(zb * py + zc);
+
+		float* row = depth + static_cast<size_t>(y) * width;
+		for (int x = minX; x <= maxX; x += 4)
+		{
+			const XMVECTOR PX = XMVectorAdd(XMVectorReplicate(static_cast<float>(x)), LaneOffset);
+
+			const XMVECTOR E0 = XMVectorMultiplyAdd(A0, PX, Row0);
+			const XMVECTOR E1 = XMVectorMultiplyAdd(A1, PX, Row1);
+			const XMVECTOR E2 = XMVectorMultiplyAdd(A2, PX, Row2);
+			XMVECTOR Inside = XMVectorGreaterOrEqual(E0, Zero);
+			Inside = XMVectorAndInt(Inside, XMVectorGreaterOrEqual(E1, Zero));
+			Inside = XMVectorAndInt(Inside, XMVectorGreaterOrEqual(E2, Zero));
+			if (XMVector4EqualInt(Inside, XMVectorFalseInt())) continue;
+
+			// 手前の深度だけ残す
+			const XMVECTOR Z = XMVectorMultiplyAdd(ZA, PX, RowZ);
+			XMFLOAT4* pixels = reinterpret_cast<XMFLOAT4*>(row + x);
+			const XMVECTOR D = XMLoadFloat4(pixels);
+			XMStoreFloat4(pixels, XMVectorSelect(D, XMVectorMin(D, Z), Inside));
+		}
+	}
+}
+
+// HiZ 作成
+void OcclusionCuller::BuildHiZ()
+{
+	for (size_t level = 1; level < hiZ.size(); level++)
+	{
+		const std::vector<float>& source = hiZ[level - 1];
+		const int sourceWidth = hiZWidth[level - 1];
+		const int sourceHeight = hiZHeight[level - 1];
+
+		std::vector<float>& destination = hiZ[level];
+		const int destinationWidth = hiZWidth[level];
+		const int destinationHeight = hiZHeight[level];
+
+		// 2x2 のうち最も奥の深度 (端は同じ texel を使う)
+		for (int y = 0; y < destinationHeight; y++)
+		{
+			const int y0 = (std::min)(y * 2, sourceHeight - 1);
+			const int y1 = (std::min)(y * 2 + 1, sourceHeight - 1);
+			for (int x = 0; x < destinationWidth; x++)
+			{
+				const int x0 = (std::min)(x * 2, sourceWidth - 1);
+				const int x1 = (std::min)(x * 2 + 1, sourceWidth - 1);
+				destination[static_cast<size_t>(y) * destinationWidth + x] = (std::max)({
+					source[static_cast<size_t>(y0) * sourceWidth + x0],
+					source[static_cast<size_t>(y0) * sourceWidth + x1],
+					source[static_cast<size_t>(y1) * sourceWidth + x0],
+					source[static_cast<size_t>(y1) * sourceWidth + x1],
+				});
+			}
+		}
+	}
+}
+
+// AABB が (一部でも) 見えているか
+bool OcclusionCuller::IsVisible(const XMFLOAT3& center, const XMFLOAT3& extents) const
+{
+	if (!ready) return true;
+
+	const XMMATRIX ViewProjection = XMLoadFloat4x4(&viewProjection);
+	const XMVECTOR C = XMLoadFloat3(&center);
+	const XMVECTOR E = XMLoadFloat3(&extents);
+
+	// 8 頂点を投影して画面上の矩形と最も手前の深度を求める
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX;
+	for (int i = 0; i < 8; i++)
+	{
+		const XMVECTOR Sign = XMVectorSet((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 0.0f);
+		XMFLOAT4 p;
+		XMStoreFloat4(&p, XMVector3Transform(XMVectorMultiplyAdd(E, Sign, C), ViewProjection));
+
+		// near 平面をまたぐものはカメラに近すぎるので見える扱い
+		if (p.z < 0.0f || p.w < 1.0e-6f) return true;
+
+		const float x = (p.x / p.w * 0.5f + 0.5f) * width;
+		const float y = (0.5f - p.y / p.w * 0.5f) * height;
+		minX = (std::min)(minX, x);
+		maxX = (std::max)(maxX, x);
+		minY = (std::min)(minY, y);
+		maxY = (std::max)(maxY, y);
+		minZ = (std::min)(minZ, p.z / p.w);
+	}
+
+	// 画面外 (視錐台カリングに任せる)
+	if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height) return true;
+
+	const int x0 = static_cast<int>((std::max)(minX, 0.0f));
+	const int y0 = static_cast<int>((std::max)(minY, 0.0f));
+	const int x1 = static_cast<int>((std::min)(maxX, static_cast<float>(width - 1)));
+	const int y1 = static_cast<int>((std::min)(maxY, static_cast<float>(height - 1)));
+
+	// 矩形が 3x3 texel 以内に収まる段を選ぶ
+	size_t level = 0;
+	while (level + 1 < hiZ.size() && ((x1 >> level) - (x0 >> level) > 2 || (y1 >> level) - (y0 >> level) > 2))
+	{
+		level++;
+	}
+
+	// どこか 1 texel でも遮蔽物がボックスより奥にあれば見える
+	const std::vector<float>& buffer = hiZ[level];
+	const int levelWidth = hiZWidth[level];
+	for (int y = y0 >> level; y <= (y1 >> level); y++)
+	{
+		for (int x = x0 >> level; x <= (x1 >> level); x++)
+		{
+			if (buffer[static_cast<size_t>(y) * levelWidth + x] >= minZ) return true;
+		}
+	}
+	return false;
+}
+
+// 視錐台カリング済みの batch のうち、隠れているものを見えない扱いにする
+void OcclusionCuller::Cull(FrustumCullingBatch& batch)
+{
+	if (!ready) return;
+
+	const size_t count = batch.GetCount();
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!batch.IsVisible(i) || batch.IsAlwaysVisible(i)) continue;
+
+		testedCount++;
+		if (!IsVisible(batch.GetCenter(i), batch.GetExtents(i)))
+		{
+			batch.Hide(i);
+			occludedCount++;
+		}
+	}
+}
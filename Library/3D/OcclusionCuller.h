@@ -0,0 +1,93 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+
+class CollisionMesh;
+class FrustumCullingBatch;
+
+//--------------------------------------------------------------
+// OcclusionCuller
+//--------------------------------------------------------------
+// CPU で遮蔽物 (ステージの壁など) を低解像度の深度バッファに描き、
+// 階層 Z (HiZ) を作ってバウンディングボックスが隠れているかを判定する
+// GPU を使わない (DirectXMath のみ) ので、結果は実行環境によらず同じになる
+class OcclusionCuller
+{
+private:
+	OcclusionCuller();
+	~OcclusionCuller() {}
+
+public:
+	static OcclusionCuller& Instance()
+	{
+		static OcclusionCuller instance;
+		return instance;
+	}
+
+	// 深度バッファの解像度設定 (幅は 4 の倍数に切り上げる)
+	void Resize(int width, int height);
+
+	// 遮蔽物の登録 (ワールド空間に変換して保持する、面積が minArea 未満の三角形は使わない)
+	void AddOccluder(const CollisionMesh& mesh, const DirectX::XMFLOAT4X4& world, float minArea = 1.0f);
+	void AddOccluder(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, const DirectX::XMFLOAT3& c);
+	// 遮蔽物の全削除
+	void ClearOccluders();
+
+	// 毎フレームの更新 (遮蔽物を描いて HiZ を作る、遮蔽物がなければ判定は全て見える扱い)
+	void Update(const DirectX::XMFLOAT4X4& view, const DirectX::XMFLOAT4X4& projection);
+
+	// AABB が (一部でも) 見えているか
+	bool IsVisible(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents) const;
+
+	// 視錐台カリング済みの batch のうち、隠れているものを見えない扱いにする
+	void Cull(FrustumCullingBatch& batch);
+
+	// --- 取得 ---
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+	size_t GetOccluderTriangleCount() const { return occluderVertices.size() / 3; }
+	// 深度バッファ (0 : 手前 ~ 1 : 奥)
+	const std::vector<float>& GetDepthBuffer() const { return hiZ.front(); }
+	// HiZ の段 (0 段目が深度バッファ、上の段ほど粗い)
+	size_t GetHiZLevelCount() const { return hiZ.size(); }
+	const std::vector<float>& GetHiZ(size_t level) const { return hiZ.at(level); }
+	int GetHiZWidth(size_t level) const { return hiZWidth.at(level); }
+	int GetHiZHeight(size_t level) const { return hiZHeight.at(level); }
+	// 前フレームの判定数 / 隠れていた数
+	size_t GetTestedCount() const { return lastTestedCount; }
+	size_t GetOccludedCount() const { return lastOccludedCount; }
+
+public:
+	// 判定を行うか
+	bool enable = true;
+
+private:
+	// クリップ空間の三角形を描く (near 平面で切ってから RasterizeTriangle へ)
+	void ClipAndRasterize(const DirectX::XMVECTOR clip[3]);
+	// スクリーン空間の三角形を 4 ピクセルずつ描く
+	void RasterizeTriangle(const DirectX::XMFLOAT3& v0, const DirectX::XMFLOAT3& v1, const DirectX::XMFLOAT3& v2);
+	// HiZ 作成
+	void BuildHiZ();
+
+private:
+	int width = 0;
+	int height = 0;
+
+	// 階層 Z (0 番は深度バッファそのもの、上の段は 2x2 の最も奥の深度)
+	std::vector<std::vector<float>> hiZ;
+	std::vector<int> hiZWidth;
+	std::vector<int> hiZHeight;
+
+	// ワールド空間の遮蔽物 (3 頂点で三角形ひとつ)
+	std::vector<DirectX::XMFLOAT3> occluderVertices;
+
+	DirectX::XMFLOAT4X4 viewProjection = {};
+	bool ready = false;
+
+	// カウンター
+	size_t testedCount = 0;
+	size_t occludedCount = 0;
+	size_t lastTestedCount = 0;
+	size_t lastOccludedCount = 0;
+};
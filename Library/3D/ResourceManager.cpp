@@ -1,25 +1,199 @@
+#include <cstring>
 #include "ResourceManager.h"
+#include "../Graphics/Texture.h"
+#include "../ImGui/Include/imgui.h"
+
+// 読み込みの設定ごとに別のモデルとして扱う
+std::string ResourceManager::MakeKey(const char* filename, bool triangulate, bool keepVertices, bool staticMesh)
+{
+	std::string key = filename;
+	if (triangulate) key += "|triangulate";
+	if (keepVertices) key += "|keepVertices";
+	if (staticMesh) key += "|staticMesh";
+	return key;
+}
 
 // モデルリソース読み込み
-std::shared_ptr<SkinnedMesh> ResourceManager::LoadModelResource(const char* filename)
+std::shared_ptr<SkinnedMesh> ResourceManager::LoadModelResource(const char* filename, bool triangulate, bool keepVertices)
 {
-	// モデルを検索
-	ModelMap::iterator it = models.find(filename);
+	// 先読みと同じく AsyncLoader で読み込む (GPU リソースの作成と登録は必ずメインスレッドの upload で行う)
+	bool started = false;
+	AsyncLoader::Handle handle;
+	std::shared_ptr<SkinnedMesh> model = RequestModel(MakeKey(filename, triangulate, keepVertices), filename, triangulate, keepVertices, started, handle);
+
+	// 読み込み中なら終わるまで待つ (メインスレッドなら upload を自分で回す)
+	if (handle) AsyncLoader::Instance().Wait(handle);
+
+	// 読み込み済みのモデルリソースを返す
+	return model;
+}
+
+// モデルリソースの先読み
+std::shared_ptr<SkinnedMesh> ResourceManager::PreloadModelResource(const char* filename, bool triangulate, bool keepVertices)
+{
+	bool started = false;
+	AsyncLoader::Handle handle;
+	return RequestModel(MakeKey(filename, triangulate, keepVertices), filename, triangulate, keepVertices, started, handle);
+}
+
+// 先読み
+std::shared_ptr<SkinnedMesh> ResourceManager::RequestModel(const std::string& key, const char* filename, bool triangulate, bool keepVertices, bool& started, AsyncLoader::Handle& handle)
+{
+	// ここではモデルを作って積むだけ (読み込みはワーカーで行うのでロック中に重い処理はしない)
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// 読み込み済み (または先読み中) ならそれを返す
+	ModelMap::iterator it = models.find(key);
 	if (it != models.end())
 	{
-		// リンク(寿命)が切れていないか確認
-		if (!it->second.expired())
+		if (std::shared_ptr<SkinnedMesh> model = it->second.model.lock())
 		{
-			// 読み込み済みのモデルリソースを返す
-			return it->second.lock();
+			started = false;
+			handle = it->second.handle;
+			return model;
 		}
 	}
 
-	// 新規モデルリソース作成＆読み込み
-	auto model = std::make_shared<SkinnedMesh>(filename);
+	// 読み込みは分けて行う
+	std::shared_ptr<SkinnedMesh> model = std::make_shared<SkinnedMesh>(filename, triangulate, 0.0f, keepVertices, true);
+	handle = AsyncLoader::Instance().Request(
+		[model, triangulate]() { model->LoadResources(triangulate, 0.0f); },
+		[model]() { model->CreateResources(); });
 
-	// マップに登録
-	models[filename] = model;
+	models[key] = { model, handle };
+	started = true;
+	return model;
+}
 
+// 動かないモデルの焼き込み元の読み込み
+std::shared_ptr<SkinnedMesh> ResourceManager::LoadStaticModelResource(const char* filename, bool triangulate)
+{
+	// 焼き込みには CPU 側の頂点が必要
+	// (焼き込んだ後に頂点を捨てるので、LoadModelResource の keepVertices のモデルとは共有しない)
+	bool started = false;
+	AsyncLoader::Handle handle;
+	std::shared_ptr<SkinnedMesh> model = RequestModel(MakeKey(filename, triangulate, true, true), filename, triangulate, true, started, handle);
+
+	if (handle) AsyncLoader::Instance().Wait(handle);
 	return model;
 }
+
+// 動かないモデルの読み込み
+std::shared_ptr<StaticMesh> ResourceManager::LoadStaticMeshResource(const char* filename, bool triangulate, const DirectX::XMFLOAT4X4& world)
+{
+	std::shared_ptr<SkinnedMesh> model = LoadStaticModelResource(filename, triangulate);
+	const std::string key = MakeKey(filename, triangulate, true, true);
+
+	AsyncLoader::Handle handle;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// 同じモデルから焼き込み済み (または焼き込み中) ならそれを待つ
+		std::map<std::string, StaticMeshEntry>::iterator it = staticMeshes.find(key);
+		if (it != staticMeshes.end() && it->second.model.lock() == model)
+		{
+			_ASSERT_EXPR(std::memcmp(&it->second.world, &world, sizeof(DirectX::XMFLOAT4X4)) == 0, L"StaticMesh of the same model must be baked with the same world.");
+			handle = it->second.handle;
+		}
+		else
+		{
+			// 焼き込みはワーカーで、バッファの作成と登録はメインスレッドで行う
+			// (焼き込んだ後は StaticMesh が残るので、モデルの CPU 側の頂点は捨てる)
+			handle = AsyncLoader::Instance().Request(
+				[model, world]()
+				{
+					model->staticMesh = std::make_shared<StaticMesh>(*model, world);
+					model->ReleaseVertices();
+				},
+				[model]() { model->staticMesh->CreateResources(); });
+
+			staticMeshes[key] = { model, world, handle };
+		}
+	}
+
+	AsyncLoader::Instance().Wait(handle);
+	return model->staticMesh;
+}
+
+// テクスチャの先読み
+void ResourceManager::PreloadTexture(const wchar_t* filename)
+{
+	if (!requestedTextures.insert(filename).second) return;
+	++statistics.requestedTextures;
+
+	std::wstring path = filename;
+	AsyncLoader::Instance().Request(
+		[path]()
+		{
+			// キャッシュが参照を持つのでここでは捨てて良い
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceView;
+			D3D11_TEXTURE2D_DESC texture2dDesc{};
+			LoadTextureFromFile(path.c_str(), shaderResourceView.GetAddressOf(), &texture2dDesc);
+		},
+		nullptr);
+}
+
+// 一覧のモデルを常駐させる
+void ResourceManager::SetResident(const AssetManifest& manifest)
+{
+	statistics.keptModels = 0;
+	statistics.requestedModels = 0;
+	statistics.requestedTextures = 0;
+
+	std::map<std::string, std::shared_ptr<SkinnedMesh>> nextModels;
+	auto addModel = [&](const AssetManifest::Model& entry)
+		{
+			const std::string key = MakeKey(entry.filename.c_str(), entry.triangulate, entry.keepVertices, entry.staticMesh);
+			if (nextModels.count(key) > 0) return;
+
+			bool started = false;
+			AsyncLoader::Handle handle;
+			nextModels[key] = RequestModel(key, entry.filename.c_str(), entry.triangulate, entry.keepVertices, started, handle);
+			started ? ++statistics.requestedModels : ++statistics.keptModels;
+		};
+
+	// 使うものを先に積み、先読みはその後ろに積む
+	for (const AssetManifest::Model& entry : manifest.models) addModel(entry);
+	for (const std::wstring& texture : manifest.textures) PreloadTexture(texture.c_str());
+	if (enablePrefetch)
+	{
+		for (const AssetManifest::Model& entry : manifest.prefetchModels) addModel(entry);
+		for (const std::wstring& texture : manifest.prefetchTextures) PreloadTexture(texture.c_str());
+	}
+
+	// 前の一覧にしかないものを手放す (前のシーンが消えた時に解放される)
+	statistics.releasedModels = 0;
+	for (const auto& resident : residentModels)
+	{
+		if (nextModels.count(resident.first) == 0) ++statistics.releasedModels;
+	}
+	residentModels.swap(nextModels);
+	statistics.residentModels = static_cast<uint32_t>(residentModels.size());
+}
+
+// 常駐させているものを全て手放す
+void ResourceManager::Clear()
+{
+	residentModels.clear();
+	statistics.residentModels = 0;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	models.clear();
+	staticMeshes.clear();
+}
+
+// ImGui 描画
+void ResourceManager::DrawDebugGui()
+{
+	if (ImGui::CollapsingHeader("ResourceManager", ImGuiTreeNodeFlags_None))
+	{
+		ImGui::Checkbox("Prefetch", &enablePrefetch);
+		ImGui::Text("Resident : %u", statistics.residentModels);
+		ImGui::Text("Kept : %u  Requested : %u  Released : %u", statistics.keptModels, statistics.requestedModels, statistics.releasedModels);
+		ImGui::Text("Textures : %u", static_cast<uint32_t>(requestedTextures.size()));
+		for (const auto& resident : residentModels)
+		{
+			ImGui::BulletText("%s%s", resident.first.c_str(), resident.second->IsCreated() ? "" : " (loading)");
+		}
+	}
+}
@@ -1,10 +1,16 @@
 #pragma once
 #include <map>
+#include <set>
 #include <memory>
+#include <mutex>
 #include <string>
 #include "SkinnedMesh.h"
+#include "StaticMesh.h"
+#include "AssetManifest.h"
+#include "../AsyncLoader.h"
 
 // リソースマネージャー
+// シーンの AssetManifest に載ったモデルは SetResident で常駐させ、シーンを跨いで使い回す
 class ResourceManager
 {
 private:
@@ -18,11 +24,80 @@ public:
 		return instance;
 	}
 
-	// モデルリソース読み込み
-	std::shared_ptr<SkinnedMesh> LoadModelResource(const char* filename);
+	// 前回の SetResident の統計
+	struct Statistics
+	{
+		uint32_t keptModels = 0;		// 前のシーンから残したもの
+		uint32_t requestedModels = 0;	// 新しく読み込みを始めたもの
+		uint32_t releasedModels = 0;	// 手放したもの
+		uint32_t residentModels = 0;
+		uint32_t requestedTextures = 0;
+	};
+
+	// モデルリソース読み込み (読み込みは AsyncLoader で行い、終わるまで待つ)
+	// ローディングスレッドから呼んだ場合は GPU リソースの作成をメインスレッドの ProcessUploads が行うのを待つ
+	std::shared_ptr<SkinnedMesh> LoadModelResource(const char* filename, bool triangulate = false, bool keepVertices = false);
+
+	// モデルリソースの先読み (AsyncLoader のワーカーで読み込み、メインスレッドで GPU リソースを作る)
+	// 読み込み済みならそれを返す (参照を持っている間は LoadModelResource で同じものが返る)
+	std::shared_ptr<SkinnedMesh> PreloadModelResource(const char* filename, bool triangulate = false, bool keepVertices = false);
+	// 動かないモデル (ステージなど) の焼き込み元の読み込み
+	// LoadModelResource の keepVertices とは別のモデルとして扱う (LoadStaticMeshResource で焼き込んだ後は CPU 側の頂点を捨てるので、頂点は当てにしないこと)
+	std::shared_ptr<SkinnedMesh> LoadStaticModelResource(const char* filename, bool triangulate = false);
+	// 動かないモデル (ステージなど) の読み込み
+	// LoadStaticModelResource のモデルを world で変換した StaticMesh を返す (GPU リソースの作成はメインスレッドの upload で行い、終わるまで待つ)
+	// 焼き込んだものはモデルが持つので、モデルが残っている間は作り直さない (焼き込み後はモデルの CPU 側の頂点を捨てる)
+	std::shared_ptr<StaticMesh> LoadStaticMeshResource(const char* filename, bool triangulate, const DirectX::XMFLOAT4X4& world);
+
+	// テクスチャの先読み (LoadTextureFromFile のキャッシュに載せる、キャッシュが保持するので解放はしない)
+	void PreloadTexture(const wchar_t* filename);
+
+	// 一覧のモデルを常駐させる (SceneManager がシーン切り替え時、前のシーンを消す前に呼ぶ)
+	// 前の一覧と共通のものはそのまま残し、足りないものは先読みを始め、前の一覧にしかないものは手放す
+	void SetResident(const AssetManifest& manifest);
+
+	// 常駐させているものを全て手放す (終了時)
+	void Clear();
+
+	const Statistics& GetStatistics() const { return statistics; }
+
+	// ImGui 描画
+	void DrawDebugGui();
+
+public:
+	// false にすると AssetManifest の prefetch を読み込まない (メモリを抑えたい時)
+	bool enablePrefetch = true;
 
 private:
-	using ModelMap = std::map<std::string, std::weak_ptr<SkinnedMesh>>;
+	struct ModelEntry
+	{
+		std::weak_ptr<SkinnedMesh> model;
+		AsyncLoader::Handle handle;		// 先読み中の読み込み
+	};
+	using ModelMap = std::map<std::string, ModelEntry>;
+
+	struct StaticMeshEntry
+	{
+		std::weak_ptr<SkinnedMesh> model;	// 焼き込み元
+		DirectX::XMFLOAT4X4 world;			// 焼き込んだ行列 (モデルの頂点は捨てるので別の行列では作り直せない)
+		AsyncLoader::Handle handle;			// 焼き込みと GPU リソースの作成
+	};
+
+	// 読み込みの設定ごとに別のモデルとして扱う (StaticMesh の焼き込み元も別)
+	static std::string MakeKey(const char* filename, bool triangulate, bool keepVertices, bool staticMesh = false);
 
+	// 先読み (started には新しく読み込みを始めたかが、handle には読み込みの Handle が入る)
+	std::shared_ptr<SkinnedMesh> RequestModel(const std::string& key, const char* filename, bool triangulate, bool keepVertices, bool& started, AsyncLoader::Handle& handle);
+
+private:
 	ModelMap models;
-};
\ No newline at end of file
+	std::map<std::string, StaticMeshEntry> staticMeshes;
+	std::mutex mutex;
+
+	// SetResident で常駐させているモデル
+	std::map<std::string, std::shared_ptr<SkinnedMesh>> residentModels;
+	// 先読みを積んだテクスチャ (キャッシュに残るので 2 回は積まない)
+	std::set<std::wstring> requestedTextures;
+
+	Statistics statistics;
+};
@@ -6,8 +6,11 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Shader.h"
 #include "../Graphics/Texture.h"
+#include "../Graphics/RenderQueue.h"
+#include "../Graphics/D3D11RenderBackend.h"
 #include "../ImGui/ConsoleData.h"	
 #include "../ErrorLogger.h"
+#include "../MemoryTracker.h"
 
 
 //--------------------------------------------------------------
@@ -96,8 +99,11 @@ inline XMFLOAT4 toXmfloat4(const FbxDouble4& fbxdouble4)
 //--------------------------------------------------------------
 // SkinnedMesh
 //--------------------------------------------------------------
-SkinnedMesh::SkinnedMesh(const char* fbxFilename, bool triangulate, float samplingRate)
+SkinnedMesh::SkinnedMesh(const char* fbxFilename, bool triangulate, float samplingRate, bool keepVertices, bool deferCreate)
+	: keepVertices(keepVertices)
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::MESH);
+
 	// fbxPath の保存
 	fbxPath = fbxFilename;
 
@@ -105,26 +111,76 @@ SkinnedMesh::SkinnedMesh(const char* fbxFilename, bool triangulate, float sampli
 	std::filesystem::path fbxFilePath(fbxFilename);
 	parentPath = fbxFilePath.parent_path().string();
 
+	// 分けて読み込む場合は LoadResources と CreateResources を呼んでもらう
+	if (deferCreate) return;
+
+	LoadResources(triangulate, samplingRate);
+	CreateResources();
+}
+
+// ファイルの読み込みとテクスチャの作成 (ワーカースレッドから呼べる)
+void SkinnedMesh::LoadResources(bool triangulate, float samplingRate)
+{
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::MESH);
+
+	LoadGeometry(triangulate, samplingRate);
+
+	// 当たり判定球のボーン名をノード番号に解決しておく
+	BindCollisionNodes();
+	// イベントを開始フレーム順に並べておく
+	BuildAnimationEventTracks();
+
+	// テクスチャはデコードが重いのでこちらで作る (ID3D11Device はスレッドセーフ)
+	LoadTextures(fbxPath.c_str());
+}
+
+// 形状と当たり判定メッシュだけの読み込み (GPU は一切触らない)
+void SkinnedMesh::LoadGeometry(bool triangulate, float samplingRate)
+{
+	const char* fbxFilename = fbxPath.c_str();
+
 	// model Path作成
 	std::filesystem::path path(fbxPath);
 	std::string modelFilePath = parentPath + "/" + path.stem().string() + ".model";
 
 
+	// 当たり判定メッシュのパス作成
+	std::string collisionFilePath = CollisionMesh::MakeCollisionPath(fbxFilename);
+
 	if (std::filesystem::exists(modelFilePath.c_str()))
 	{
 		LoadModel();
+
+		// 焼き込み済みの当たり判定メッシュがない (fbx の方が新しい) なら作成する
+		if (!CollisionMesh::IsCacheUpToDate(fbxFilename) || !collisionMesh.Load(collisionFilePath))
+		{
+			BuildCollisionMesh();
+			collisionMesh.Save(collisionFilePath);
+		}
 	}
 	else
 	{
 		LoadFbx(fbxFilename, triangulate, samplingRate);
+
+		// fbx から読み込んだ場合は必ず焼き直す
+		BuildCollisionMesh();
+		collisionMesh.Save(collisionFilePath);
 	}
+}
 
-	
-	CreateComObjects(fbxFilename);
+// バッファ・シェーダーの作成と RenderQueue への登録 (メインスレッドから呼ぶ)
+void SkinnedMesh::CreateResources()
+{
+	CreateComObjects(fbxPath.c_str());
 
-	
-	std::string message = "create " + fbxFilePath.stem().string() + " finish";
-	ConsoleData::Instance().logs.push_back(message);
+	// 使用した 頂点情報とインデックス情報をクリアする
+	// (当たり判定は collisionMesh を使うので CPU 側のコピーは不要)
+	if (!keepVertices) ReleaseVertices();
+
+	created = true;
+
+	std::string message = "create " + std::filesystem::path(fbxPath).stem().string() + " finish";
+	ConsoleData::Instance().Log(message);
 }
 
 
@@ -147,6 +203,16 @@ void SkinnedMesh::LoadModel()
 #endif
 	deserialization(sceneView, coordinateSystemIndex, fbxUnit, skeletonSpheres);
 
+	// LOD 設定は後から足したので、書き出していない .model では既定値のまま
+	try
+	{
+		deserialization(animationLodPolicy);
+	}
+	catch (const cereal::Exception&)
+	{
+		animationLodPolicy = {};
+	}
+
 	// --- メッシュ作成 ---
 	std::string meshPath = parentPath + "/Mesh/";
 	pathExtension = ".mesh";
@@ -263,7 +329,7 @@ void SkinnedMesh::LoadFbx(const char* fbxFilename, bool triangulate, float sampl
 	traverse(fbxScene->GetRootNode());
 
 #if 1
-	ConsoleData::Instance().logs.push_back("Load Fbx : " + static_cast<std::string>(fbxFilename));
+	ConsoleData::Instance().Log("Load Fbx : " + static_cast<std::string>(fbxFilename));
 	for (const SkinnedScene::Node& node : sceneView.nodes)
 	{
 		FbxNode* fbxNode{ fbxScene->FindNodeByName(node.name.c_str()) };
@@ -274,7 +340,7 @@ void SkinnedMesh::LoadFbx(const char* fbxFilename, bool triangulate, float sampl
 		int32_t type = fbxNode->GetNodeAttribute() ? fbxNode->GetNodeAttribute()->GetAttributeType() : 0;		std::stringstream debugString;
 		debugString << " : nodeName -" << nodeName << ": uId -" << uid << " : parentUid - " << parentUid << " : type - " << type << "\n";
 		OutputDebugStringA(debugString.str().c_str());
-		ConsoleData::Instance().logs.push_back(debugString.str());
+		ConsoleData::Instance().Log(debugString.str());
 	}
 #endif
 
@@ -305,12 +371,38 @@ void SkinnedMesh::LoadFbx(const char* fbxFilename, bool triangulate, float sampl
 	std::ofstream ofs(modelFilePath.c_str(), std::ios::out);
 	cereal::JSONOutputArchive  serialization(ofs);
 #endif
-	serialization(sceneView, coordinateSystemIndex, fbxUnit, skeletonSpheres);
+	serialization(sceneView, coordinateSystemIndex, fbxUnit, skeletonSpheres, animationLodPolicy);
+}
+
+// デストラクタ
+SkinnedMesh::~SkinnedMesh()
+{
+	if (!renderResourcesRegistered) return;
+
+	D3D11RenderBackend& backend = D3D11RenderBackend::Instance();
+	backend.ReleasePipeline(renderPipelineId);
+	for (const Mesh& mesh : meshes)
+	{
+		backend.ReleaseGeometry(mesh.renderGeometryId);
+	}
+	for (const auto& material : materials)
+	{
+		backend.ReleaseMaterial(material.second.renderMaterialId);
+		backend.ReleaseTextureSet(material.second.renderTextureSetId);
+	}
 }
 
 // 描画
 void SkinnedMesh::Render(const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4& materialColor, const Animation::KeyFrame* keyFrame)
 {
+	// 記録中ならキューに積んで、まとめて並べ替えてから描く
+	RenderQueue& renderQueue = RenderQueue::Instance();
+	if (renderQueue.IsRecording())
+	{
+		Submit(renderQueue, world, materialColor, keyFrame);
+		return;
+	}
+
 	// --- Graphics 取得 ---
 	Graphics& gfx = Graphics::Instance();
 
@@ -320,73 +412,155 @@ void SkinnedMesh::Render(const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOA
 		uint32_t stride = sizeof(Vertex);
 		uint32_t offset = 0;
 
-		gfx.deviceContext->IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
-		gfx.deviceContext->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-		gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		gfx.deviceContext->IASetInputLayout(inputLayout.Get());
+		gfx.stateCache.IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
+		gfx.stateCache.IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+		gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		gfx.stateCache.IASetInputLayout(inputLayout.Get());
 
 		
-		gfx.deviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
-		gfx.deviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+		gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+		gfx.stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
 		
 		
-		Constants data;
-
-		// アニメーションのキーフレームがあるならその姿勢を適用する
-		if (keyFrame && keyFrame->nodes.size() > 0)
+		// オブジェクト定数とボーン行列はメッシュごとに 1 回だけ書き込む
+		ObjectConstants object;
+		XMFLOAT4X4 boneTransforms[MAX_BONES];
+		const UINT boneCount = MakeMeshConstants(mesh, world, keyFrame, object, boneTransforms);
+		object.materialColor = materialColor;
+		object.objectType = isBloomConstants.objectType;
+
+		// 2 つは 1 回の Map でまとめて書く (途中で一周して、先に設定した方が無効にならないように)
+		const ConstantRingBuffer::Block blocks[2] =
 		{
-			const Animation::KeyFrame::Node& meshNode = keyFrame->nodes.at(mesh.nodeIndex);
-			XMStoreFloat4x4(&data.world, XMLoadFloat4x4(&meshNode.globalTransform) * XMLoadFloat4x4(&world));
+			{ &object, sizeof(ObjectConstants) },
+			{ boneTransforms, static_cast<UINT>(sizeof(XMFLOAT4X4) * boneCount) },
+		};
+		ConstantRingBuffer::Allocation allocations[2];
+		gfx.constantRingBuffer.UploadBlocks(blocks, 2, allocations);
 
-			const size_t boneCount = mesh.bindPose.bones.size();
-			_ASSERT_EXPR(boneCount < MAX_BONES, L"The value of the 'boneCount' has exceeded MAX_BONES.");
+		const ConstantRingBuffer::Allocation& objectAllocation = allocations[0];
+		gfx.stateCache.VSSetConstantBuffers1(OBJECT_CONSTANT_SLOT, 1, &objectAllocation.buffer, &objectAllocation.firstConstant, &objectAllocation.numConstants);
+		gfx.stateCache.PSSetConstantBuffers1(OBJECT_CONSTANT_SLOT, 1, &objectAllocation.buffer, &objectAllocation.firstConstant, &objectAllocation.numConstants);
 
-			for (size_t boneIndex = 0; boneIndex < boneCount; boneIndex++)
-			{
-				const Skeleton::Bone& bone = mesh.bindPose.bones.at(boneIndex);
-				const Animation::KeyFrame::Node& boneNode = keyFrame->nodes.at(bone.nodeIndex);
-				XMStoreFloat4x4(
-					&data.boneTransforms[boneIndex],
-					XMLoadFloat4x4(&bone.offsetTransform) *
-					XMLoadFloat4x4(&boneNode.globalTransform) *
-					XMMatrixInverse(nullptr, XMLoadFloat4x4(&mesh.defaultGlobalTransform))
-				);
-			}
-		}
-		else
+		const ConstantRingBuffer::Allocation& skeletonAllocation = allocations[1];
+		gfx.stateCache.VSSetConstantBuffers1(SKELETON_CONSTANT_SLOT, 1, &skeletonAllocation.buffer, &skeletonAllocation.firstConstant, &skeletonAllocation.numConstants);
+
+		for (const Mesh::Subset& subset : mesh.subsets)
 		{
-			XMStoreFloat4x4(&data.world, XMLoadFloat4x4(&mesh.defaultGlobalTransform) * XMLoadFloat4x4(&world));
-			for (size_t boneIndex = 0; boneIndex < MAX_BONES; boneIndex++)
+			const Material& material = materials.at(subset.materialUniqueId);
+
+			// マテリアル定数は読み込み時に作ったものを設定するだけ
+			gfx.stateCache.VSSetConstantBuffers(MATERIAL_CONSTANT_SLOT, 1, material.constantBuffer.GetAddressOf());
+			gfx.stateCache.PSSetConstantBuffers(MATERIAL_CONSTANT_SLOT, 1, material.constantBuffer.GetAddressOf());
+
+			// テクスチャ 4 枚はまとめて設定する
+			ID3D11ShaderResourceView* shaderResourceViews[4] =
 			{
-				data.boneTransforms[boneIndex] =
-				{
-					1,0,0,0,
-					0,1,0,0,
-					0,0,1,0,
-					0,0,0,1
-				};
-			}
+				material.shaderResourceViews[0].Get(),
+				material.shaderResourceViews[1].Get(),
+				material.shaderResourceViews[2].Get(),
+				material.shaderResourceViews[3].Get(),
+			};
+			gfx.stateCache.PSSetShaderResources(0, 4, shaderResourceViews);
+
+			gfx.stateCache.DrawIndexed(subset.indexCount, subset.startIndexLocation, 0);
 		}
+	}
+}
+
+// RenderQueue にパケットを積む
+void SkinnedMesh::Submit(RenderQueue& queue, const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4& materialColor, const Animation::KeyFrame* keyFrame)
+{
+	// --- Graphics 取得 ---
+	Graphics& gfx = Graphics::Instance();
+
+	// 現在のラスタライザをパケットのステートにする
+	const uint32_t renderState = static_cast<uint32_t>(gfx.GetRasterizer());
+
+	// 並べ替え用の距離はモデルの原点で測る
+	const float distance = queue.GetDistanceFromEye(world._41, world._42, world._43);
+
+	for (const Mesh& mesh : meshes)
+	{
+		// オブジェクト定数とボーン行列はメッシュ単位で積み、サブセットからは同じ位置を指す
+		ObjectConstants object;
+		XMFLOAT4X4 boneTransforms[MAX_BONES];
+		const UINT boneCount = MakeMeshConstants(mesh, world, keyFrame, object, boneTransforms);
+		object.materialColor = materialColor;
+		object.objectType = isBloomConstants.objectType;
+
+		const uint32_t objectOffset = queue.PushConstants(&object, sizeof(ObjectConstants));
+		const uint32_t skeletonSize = static_cast<uint32_t>(sizeof(XMFLOAT4X4) * boneCount);
+		const uint32_t skeletonOffset = queue.PushConstants(boneTransforms, skeletonSize);
+
 		for (const Mesh::Subset& subset : mesh.subsets)
 		{
 			const Material& material = materials.at(subset.materialUniqueId);
-			XMStoreFloat4(&data.materialColor, XMLoadFloat4(&materialColor) * XMLoadFloat4(&material.Kd));
 
-			gfx.deviceContext->UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
-			gfx.deviceContext->VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+			const RenderKey::PASS pass = (materialColor.w * material.Kd.w < 1.0f) ? RenderKey::TRANSLUCENT_PASS : RenderKey::SOLID_PASS;
+
+			RenderQueue::Packet packet;
+			packet.pipeline = renderPipelineId;
+			packet.renderState = renderState;
+			packet.material = material.renderMaterialId;
+			packet.textureSet = material.renderTextureSetId;
+			packet.geometry = mesh.renderGeometryId;
+			packet.indexCount = subset.indexCount;
+			packet.startIndexLocation = subset.startIndexLocation;
+			packet.constantsOffset[RenderBackend::OBJECT_CONSTANTS] = objectOffset;
+			packet.constantsSize[RenderBackend::OBJECT_CONSTANTS] = sizeof(ObjectConstants);
+			packet.constantsOffset[RenderBackend::SKELETON_CONSTANTS] = skeletonOffset;
+			packet.constantsSize[RenderBackend::SKELETON_CONSTANTS] = skeletonSize;
+			packet.key = RenderKey::Make(pass, packet.pipeline, packet.renderState, packet.material, packet.textureSet, RenderKey::QuantizeDepth(pass, distance, queue.farDistance));
+			queue.Push(packet);
+		}
+	}
+}
 
-			// isBloom
-			gfx.deviceContext->UpdateSubresource(isBloomConstantBuffer.Get(), 0, 0, &isBloomConstants, 0, 0);
-			gfx.deviceContext->PSSetConstantBuffers(2, 1, isBloomConstantBuffer.GetAddressOf());
+// メッシュごとの定数作成
+UINT SkinnedMesh::MakeMeshConstants(const Mesh& mesh, const DirectX::XMFLOAT4X4& world, const Animation::KeyFrame* keyFrame, ObjectConstants& object, DirectX::XMFLOAT4X4 boneTransforms[MAX_BONES]) const
+{
+	const size_t boneCount = mesh.bindPose.bones.size();
+	_ASSERT_EXPR(boneCount < MAX_BONES, L"The value of the 'boneCount' has exceeded MAX_BONES.");
 
-			gfx.deviceContext->PSSetShaderResources(0, 1, material.shaderResourceViews[0].GetAddressOf());
-			gfx.deviceContext->PSSetShaderResources(1, 1, material.shaderResourceViews[1].GetAddressOf());
-			gfx.deviceContext->PSSetShaderResources(2, 1, material.shaderResourceViews[2].GetAddressOf());
-			gfx.deviceContext->PSSetShaderResources(3, 1, material.shaderResourceViews[3].GetAddressOf());
+	// アニメーションのキーフレームがあるならその姿勢を適用する
+	if (keyFrame && keyFrame->nodes.size() > 0 && boneCount > 0)
+	{
+		const Animation::KeyFrame::Node& meshNode = keyFrame->nodes.at(mesh.nodeIndex);
+		XMStoreFloat4x4(&object.world, XMLoadFloat4x4(&meshNode.globalTransform) * XMLoadFloat4x4(&world));
 
-			gfx.deviceContext->DrawIndexed(subset.indexCount, subset.startIndexLocation, 0);
+		const XMMATRIX inverseDefaultGlobalTransform = XMMatrixInverse(nullptr, XMLoadFloat4x4(&mesh.defaultGlobalTransform));
+		for (size_t boneIndex = 0; boneIndex < boneCount; boneIndex++)
+		{
+			const Skeleton::Bone& bone = mesh.bindPose.bones.at(boneIndex);
+			const Animation::KeyFrame::Node& boneNode = keyFrame->nodes.at(bone.nodeIndex);
+			XMStoreFloat4x4(
+				&boneTransforms[boneIndex],
+				XMLoadFloat4x4(&bone.offsetTransform) *
+				XMLoadFloat4x4(&boneNode.globalTransform) *
+				inverseDefaultGlobalTransform
+			);
 		}
+		return static_cast<UINT>(boneCount);
 	}
+
+	// ボーンのないメッシュの頂点は 0 番のボーンを参照するので、少なくとも 1 つは単位行列を入れる
+	if (keyFrame && keyFrame->nodes.size() > 0)
+	{
+		const Animation::KeyFrame::Node& meshNode = keyFrame->nodes.at(mesh.nodeIndex);
+		XMStoreFloat4x4(&object.world, XMLoadFloat4x4(&meshNode.globalTransform) * XMLoadFloat4x4(&world));
+	}
+	else
+	{
+		XMStoreFloat4x4(&object.world, XMLoadFloat4x4(&mesh.defaultGlobalTransform) * XMLoadFloat4x4(&world));
+	}
+
+	const size_t identityCount = (std::max)(boneCount, static_cast<size_t>(1));
+	for (size_t boneIndex = 0; boneIndex < identityCount; boneIndex++)
+	{
+		XMStoreFloat4x4(&boneTransforms[boneIndex], XMMatrixIdentity());
+	}
+	return static_cast<UINT>(identityCount);
 }
 
 // mesh 取得
@@ -557,9 +731,9 @@ void SkinnedMesh::FetchMeshes(const char* fbxFilename, FbxScene* fbxScene, std::
 			mesh.boundingBox[0].x = std::min<float>(mesh.boundingBox[0].x, v.position.x);
 			mesh.boundingBox[0].y = std::min<float>(mesh.boundingBox[0].y, v.position.y);
 			mesh.boundingBox[0].z = std::min<float>(mesh.boundingBox[0].z, v.position.z);
-			mesh.boundingBox[1].x = std::min<float>(mesh.boundingBox[1].x, v.position.x);
-			mesh.boundingBox[1].y = std::min<float>(mesh.boundingBox[1].y, v.position.y);
-			mesh.boundingBox[1].z = std::min<float>(mesh.boundingBox[1].z, v.position.z);
+			mesh.boundingBox[1].x = std::max<float>(mesh.boundingBox[1].x, v.position.x);
+			mesh.boundingBox[1].y = std::max<float>(mesh.boundingBox[1].y, v.position.y);
+			mesh.boundingBox[1].z = std::max<float>(mesh.boundingBox[1].z, v.position.z);
 		}
 
 		// ------- cereal処理 -------
@@ -837,6 +1011,8 @@ void SkinnedMesh::FetchAnimations(const char* fbxFilename, FbxScene* fbxScene, s
 // アニメーションの更新(アニメーションのもつ node の変換行列の更新)
 void SkinnedMesh::UpdateAnimation(Animation::KeyFrame& keyFrame)
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::ANIMATION);
+
 	// node の数だけ繰り返す
 	size_t nodeCount = keyFrame.nodes.size();
 	for (size_t nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
@@ -878,6 +1054,10 @@ bool SkinnedMesh::AppendAnimations(const char* animationFileName, float sampling
 
 	fbxManager->Destroy();
 
+	// 追加したアニメーションの当たり判定球も解決する
+	BindCollisionNodes();
+	BuildAnimationEventTracks();
+
 	return true;
 }
 
@@ -919,6 +1099,109 @@ void SkinnedMesh::BlendAnimations(const Animation::KeyFrame* keyFrames[2], float
 
 
 
+// 当たり判定メッシュの焼き込み
+void SkinnedMesh::BuildCollisionMesh()
+{
+	collisionMesh.Clear();
+
+	// 軸・単位の補正行列を保存しておく
+	if (coordinateSystemIndex >= 0 && coordinateSystemIndex < _countof(coordinateSystemTransform) && fbxUnit >= 0 && fbxUnit < _countof(scaleFactors))
+	{
+		const float scaleFactor = scaleFactors[fbxUnit];
+		XMStoreFloat4x4(&collisionMesh.systemTransform, XMLoadFloat4x4(&coordinateSystemTransform[coordinateSystemIndex]) * XMMatrixScaling(scaleFactor, scaleFactor, scaleFactor));
+	}
+
+	// 全メッシュの三角形を座標だけにしてモデル空間で溶接する
+	for (const Mesh& mesh : meshes)
+	{
+		if (mesh.vertices.empty()) continue;
+
+		for (const Mesh::Subset& subset : mesh.subsets)
+		{
+			collisionMesh.AppendMesh(
+				mesh.defaultGlobalTransform,
+				&mesh.vertices.at(0).position,
+				sizeof(Vertex),
+				mesh.indices.data() + subset.startIndexLocation,
+				subset.indexCount,
+				static_cast<int>(subset.materialUniqueId)
+			);
+		}
+	}
+	collisionMesh.Build();
+}
+// ボックス (min, max) を行列で変換した AABB を取得
+void SkinnedMesh::TransformBounds(const DirectX::XMFLOAT3 box[2], const DirectX::XMFLOAT4X4& transform, DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents)
+{
+	using namespace DirectX;
+
+	const XMVECTOR Min = XMLoadFloat3(&box[0]);
+	const XMVECTOR Max = XMLoadFloat3(&box[1]);
+	const XMVECTOR C = XMVectorScale(XMVectorAdd(Min, Max), 0.5f);
+	const XMVECTOR E = XMVectorScale(XMVectorSubtract(Max, Min), 0.5f);
+
+	// 中心はそのまま変換、半分の大きさは行列の各成分の絶対値で変換する (Arvo の方法)
+	const XMMATRIX M = XMLoadFloat4x4(&transform);
+	XMVECTOR WorldE = XMVectorMultiply(XMVectorSplatX(E), XMVectorAbs(M.r[0]));
+	WorldE = XMVectorMultiplyAdd(XMVectorSplatY(E), XMVectorAbs(M.r[1]), WorldE);
+	WorldE = XMVectorMultiplyAdd(XMVectorSplatZ(E), XMVectorAbs(M.r[2]), WorldE);
+
+	XMStoreFloat3(&center, XMVector3TransformCoord(C, M));
+	XMStoreFloat3(&extents, WorldE);
+}
+
+// ワールド空間の AABB 取得
+bool SkinnedMesh::GetWorldBounds(const DirectX::XMFLOAT4X4& world, DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const
+{
+	if (boundingBox[0].x > boundingBox[1].x) return false;
+
+	TransformBounds(boundingBox, world, center, extents);
+	return true;
+}
+
+// ノード名からノード番号を取得
+int64_t SkinnedMesh::FindNodeIndex(const std::string& nodeName) const
+{
+	if (nodeName.empty()) return -1;
+
+	int64_t index = 0;
+	for (const SkinnedScene::Node& node : sceneView.nodes)
+	{
+		if (node.name == nodeName)
+		{
+			return index;
+		}
+		index++;
+	}
+	return -1;
+}
+
+// 当たり判定球のボーン名をノード番号に解決する
+void SkinnedMesh::BindCollisionNodes()
+{
+	for (SkeletonSphere& skeletonSphere : skeletonSpheres)
+	{
+		skeletonSphere.nodeIndex = FindNodeIndex(skeletonSphere.name);
+	}
+
+	for (Animation& animation : animationClips)
+	{
+		for (CollisionSphere& sphere : animation.spheres)
+		{
+			sphere.bindNodeIndex = FindNodeIndex(sphere.bindBoneName);
+		}
+	}
+}
+
+// 全クリップのイベントトラック生成
+void SkinnedMesh::BuildAnimationEventTracks()
+{
+	for (Animation& animation : animationClips)
+	{
+		animation.BuildEventTracks();
+	}
+}
+
 void SkinnedMesh::CreateComObjects(const char* fbxFilename)
 {
 	// --- Graphics 取得 ----
@@ -926,8 +1209,37 @@ void SkinnedMesh::CreateComObjects(const char* fbxFilename)
 
 
 	//---  vertexBuffer と indexBuffer の作成 ---
+	boundingBox[0] = { +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX };
+	boundingBox[1] = { -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX };
 	for (Mesh& mesh : meshes)
 	{
+		// バウンディングボックスを頂点から計算し直す
+		// (以前の .mesh は最大値を std::min で焼き込んでいたので、保存された値は使わない)
+		mesh.boundingBox[0] = { +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX };
+		mesh.boundingBox[1] = { -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX };
+		for (const Vertex& v : mesh.vertices)
+		{
+			mesh.boundingBox[0].x = std::min<float>(mesh.boundingBox[0].x, v.position.x);
+			mesh.boundingBox[0].y = std::min<float>(mesh.boundingBox[0].y, v.position.y);
+			mesh.boundingBox[0].z = std::min<float>(mesh.boundingBox[0].z, v.position.z);
+			mesh.boundingBox[1].x = std::max<float>(mesh.boundingBox[1].x, v.position.x);
+			mesh.boundingBox[1].y = std::max<float>(mesh.boundingBox[1].y, v.position.y);
+			mesh.boundingBox[1].z = std::max<float>(mesh.boundingBox[1].z, v.position.z);
+		}
+
+		// モデル全体のバウンディングボックスに合成 (バインドポーズのメッシュ行列でモデル空間へ)
+		if (!mesh.vertices.empty())
+		{
+			DirectX::XMFLOAT3 center, extents;
+			TransformBounds(mesh.boundingBox, mesh.defaultGlobalTransform, center, extents);
+			boundingBox[0].x = std::min<float>(boundingBox[0].x, center.x - extents.x);
+			boundingBox[0].y = std::min<float>(boundingBox[0].y, center.y - extents.y);
+			boundingBox[0].z = std::min<float>(boundingBox[0].z, center.z - extents.z);
+			boundingBox[1].x = std::max<float>(boundingBox[1].x, center.x + extents.x);
+			boundingBox[1].y = std::max<float>(boundingBox[1].y, center.y + extents.y);
+			boundingBox[1].z = std::max<float>(boundingBox[1].z, center.z + extents.z);
+		}
+
 		HRESULT hr{ S_OK };
 		D3D11_BUFFER_DESC bufferDesc{};
 		D3D11_SUBRESOURCE_DATA subresourceData{};
@@ -949,12 +1261,6 @@ void SkinnedMesh::CreateComObjects(const char* fbxFilename)
 		subresourceData.pSysMem = mesh.indices.data();
 		hr = gfx.device->CreateBuffer(&bufferDesc, &subresourceData, mesh.indexBuffer.ReleaseAndGetAddressOf());
 		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
-
-#if 1
-		// 使用した 頂点情報とインデックス情報をクリアする
-		//mesh.vertices.clear();
-		//mesh.indices.clear();
-#endif
 	}
 
 	//--- inputLayout と vertexShader の作成 ---
@@ -972,23 +1278,30 @@ void SkinnedMesh::CreateComObjects(const char* fbxFilename)
 	//--- pixelShader の作成 ---
 	CreatePsFromCso("Data/Shader/SkinnedMesh_PS.cso", pixelShader.ReleaseAndGetAddressOf());
 
-	//--- constantBuffer の作成 ---
-	D3D11_BUFFER_DESC bufferDesc{};
-	bufferDesc.ByteWidth = sizeof(Constants);
-	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	hr = gfx.device->CreateBuffer(&bufferDesc, nullptr, constantBuffer.ReleaseAndGetAddressOf());
-	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	// マテリアル定数バッファ (テクスチャは LoadTextures で作成済み)
+	for (std::unordered_map<uint64_t, Material>::iterator iterator = materials.begin(); iterator != materials.end(); ++iterator)
+	{
+		//--- マテリアル定数バッファの作成 (描画中に変わらないので IMMUTABLE) ---
+		MaterialConstants materialConstants;
+		materialConstants.Kd = iterator->second.Kd;
 
-	//--- isBloomConstantBuffer の作成 ---
-	D3D11_BUFFER_DESC isBloombBufferDesc{};
-	isBloombBufferDesc.ByteWidth = sizeof(IsBloomConstants);
-	isBloombBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	isBloombBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	hr = gfx.device->CreateBuffer(&isBloombBufferDesc, nullptr, isBloomConstantBuffer.ReleaseAndGetAddressOf());
-	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+		D3D11_BUFFER_DESC bufferDesc{};
+		bufferDesc.ByteWidth = sizeof(MaterialConstants);
+		bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		D3D11_SUBRESOURCE_DATA subresourceData{};
+		subresourceData.pSysMem = &materialConstants;
+		hr = gfx.device->CreateBuffer(&bufferDesc, &subresourceData, iterator->second.constantBuffer.ReleaseAndGetAddressOf());
+		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	}
+
+	// RenderQueue 用の登録
+	RegisterRenderResources();
+}
 
-	// material の名前に対応する テクスチャからshaderResourceViewの生成
+// material の名前に対応する テクスチャからshaderResourceViewの生成
+void SkinnedMesh::LoadTextures(const char* fbxFilename)
+{
 	for (std::unordered_map<uint64_t, Material>::iterator iterator = materials.begin(); iterator != materials.end(); ++iterator)
 	{
 		for (size_t textureIndex = 0; textureIndex < 4; textureIndex++)
@@ -1008,6 +1321,47 @@ void SkinnedMesh::CreateComObjects(const char* fbxFilename)
 	}
 }
 
+// CPU 側の頂点・インデックスの解放
+void SkinnedMesh::ReleaseVertices()
+{
+	for (Mesh& mesh : meshes)
+	{
+		mesh.vertices.clear();
+		mesh.vertices.shrink_to_fit();
+		mesh.indices.clear();
+		mesh.indices.shrink_to_fit();
+	}
+}
+
+// RenderQueue 用に D3D11RenderBackend へ登録する
+void SkinnedMesh::RegisterRenderResources()
+{
+	D3D11RenderBackend& backend = D3D11RenderBackend::Instance();
+
+	renderPipelineId = backend.RegisterPipeline(vertexShader.Get(), pixelShader.Get(), inputLayout.Get(), OBJECT_CONSTANT_SLOT, SKELETON_CONSTANT_SLOT);
+
+	for (Mesh& mesh : meshes)
+	{
+		mesh.renderGeometryId = backend.RegisterGeometry(mesh.vertexBuffer.Get(), sizeof(Vertex), mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT);
+	}
+
+	// 同じテクスチャを使うマテリアルは同じ id になる
+	for (auto& material : materials)
+	{
+		ID3D11ShaderResourceView* shaderResourceViews[4] =
+		{
+			material.second.shaderResourceViews[0].Get(),
+			material.second.shaderResourceViews[1].Get(),
+			material.second.shaderResourceViews[2].Get(),
+			material.second.shaderResourceViews[3].Get(),
+		};
+		material.second.renderTextureSetId = backend.RegisterTextureSet(shaderResourceViews);
+		material.second.renderMaterialId = backend.RegisterMaterial(material.second.constantBuffer.Get(), MATERIAL_CONSTANT_SLOT);
+	}
+
+	renderResourcesRegistered = true;
+}
+
 // ダミーテクスチャの生成
 HRESULT SkinnedMesh::MakeDummyTexture(ID3D11ShaderResourceView** shaderResourceView, DWORD value, UINT dimension)
 {
@@ -1084,7 +1438,7 @@ void SkinnedMesh::SetCoordinateSystemTransform(CoordinateSystemTransform coordin
 	std::ofstream ofs(modelFilePath.c_str(), std::ios::out);
 	cereal::JSONOutputArchive  serialization(ofs);
 #endif
-	serialization(sceneView, this->coordinateSystemIndex, this->fbxUnit, skeletonSpheres);
+	serialization(sceneView, this->coordinateSystemIndex, this->fbxUnit, skeletonSpheres, animationLodPolicy);
 }
 
 // fbx の単位設定
@@ -1105,5 +1459,25 @@ void SkinnedMesh::SetFbxUnit(FbxUnit fbxUnit)
 	std::ofstream ofs(modelFilePath.c_str(), std::ios::out);
 	cereal::JSONOutputArchive  serialization(ofs);
 #endif
-	serialization(sceneView, this->coordinateSystemIndex, this->fbxUnit, skeletonSpheres);
+	serialization(sceneView, this->coordinateSystemIndex, this->fbxUnit, skeletonSpheres, animationLodPolicy);
+}
+
+// アニメーションの LOD 設定
+void SkinnedMesh::SetAnimationLodPolicy(const AnimationLodPolicy& animationLodPolicy)
+{
+	this->animationLodPolicy = animationLodPolicy;
+
+	// modelの出力ファイル作成
+	std::filesystem::path path(fbxPath);
+	std::string modelFilePath = parentPath + "/" + path.stem().string() + ".model";
+
+	// 出力
+#if 0
+	std::ofstream ofs(modelFilePath.c_str(), std::ios::binary);
+	cereal::BinaryOutputArchive serialization(ofs);
+#else
+	std::ofstream ofs(modelFilePath.c_str(), std::ios::out);
+	cereal::JSONOutputArchive  serialization(ofs);
+#endif
+	serialization(sceneView, coordinateSystemIndex, fbxUnit, skeletonSpheres, this->animationLodPolicy);
 }
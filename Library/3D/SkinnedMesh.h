@@ -4,10 +4,16 @@
 #include <DirectXMath.h>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <fbxsdk.h>
 #include <unordered_map>
+#include <atomic>
 #include "../Effekseer/Effect.h"
 #include "../Audio/AudioManager.h"
+#include "CollisionMesh.h"
+
+class RenderQueue;
+class StaticMesh;
 
 //--------------------------------------------------------------
 // Cereal
@@ -175,6 +181,8 @@ struct SkeletonSphere
 	std::string name;		// ノードの名前
 	float radius = 1.0f;	// 当たり判定の半径
 
+	int64_t nodeIndex = -1;	// name から解決したノード番号 (読み込み時・編集時に設定、保存しない)
+
 	// cereal
 	template<class SkeletonSphere>
 	void serialize(SkeletonSphere& archive)
@@ -197,6 +205,8 @@ struct CollisionSphere
 
 	// ボーンにバインドする場合はここにボーンの名前を保存する
 	std::string bindBoneName;
+	// bindBoneName から解決したノード番号 (読み込み時・編集時に設定、保存しない)
+	int64_t bindNodeIndex = -1;
 
 	// cereal
 	template<class CollisionSphere>
@@ -218,7 +228,6 @@ struct AnimEffect
 	float scale = 1;
 	DirectX::XMFLOAT3 position = { 0,0,0 };
 	DirectX::XMFLOAT3 angle = { 0,0,0 };
-	bool isPlay = false;	// 再生されたかどうか
 
 	// cereal
 	template<class AnimSE>
@@ -238,7 +247,6 @@ struct AnimSE
 	std::string name;
 	int startFrame;
 	int endFrame;
-	bool isPlay = false;	// 再生されたかどうか
 
 	// cereal
 	template<class AnimEffect>
@@ -248,6 +256,65 @@ struct AnimSE
 	}
 };
 
+//--------------------------------------------------------------
+// AnimationEventTrack
+//--------------------------------------------------------------
+// クリップ内のイベント(エフェクト・効果音・当たり判定球)を開始フレーム順に並べたもの
+// 読み込み時に Animation::BuildEventTracks で生成する (保存しない)
+struct AnimationEventTrack
+{
+	struct Event
+	{
+		int startFrame;
+		int endFrame;
+		uint32_t index;		// 元の配列 (animEffects / animSEs / spheres) の番号
+	};
+	std::vector<Event> events;	// startFrame 昇順
+	int maxLength = 0;			// endFrame - startFrame の最大 (有効区間の検索範囲)
+
+	// 生成
+	template<class T>
+	void Build(const std::vector<T>& items)
+	{
+		events.clear();
+		events.reserve(items.size());
+		maxLength = 0;
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			events.push_back({ items[i].startFrame, items[i].endFrame, static_cast<uint32_t>(i) });
+			maxLength = (std::max)(maxLength, items[i].endFrame - items[i].startFrame);
+		}
+		std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.startFrame < b.startFrame; });
+	}
+
+	// startFrame が frame より大きい最初のイベント番号
+	size_t UpperBound(int frame) const
+	{
+		return std::upper_bound(events.begin(), events.end(), frame, [](int f, const Event& e) { return f < e.startFrame; }) - events.begin();
+	}
+
+	// (frame0, frame1] の間に開始したイベント (frame0 から frame1 へ進んだときに通過したもの)
+	template<class Func>
+	void ForEachCrossed(int frame0, int frame1, Func func) const
+	{
+		for (size_t i = UpperBound(frame0), end = UpperBound(frame1); i < end; i++)
+		{
+			func(events[i]);
+		}
+	}
+
+	// frame で有効 (startFrame <= frame <= endFrame) なイベント
+	template<class Func>
+	void ForEachActive(int frame, Func func) const
+	{
+		for (size_t i = UpperBound(frame - maxLength - 1), end = UpperBound(frame); i < end; i++)
+		{
+			if (events[i].endFrame < frame) continue;
+			func(events[i]);
+		}
+	}
+};
+
 //--------------------------------------------------------------
 // Animation
 //--------------------------------------------------------------
@@ -299,6 +366,19 @@ struct Animation
 	std::vector<AnimEffect> animEffects;
 	std::vector<AnimSE> animSEs;
 
+	// 開始フレーム順のイベント (保存しない)
+	AnimationEventTrack effectTrack;
+	AnimationEventTrack seTrack;
+	AnimationEventTrack sphereTrack;
+
+	// イベントトラックの生成 (イベントを追加・編集したら呼び直す)
+	void BuildEventTracks()
+	{
+		effectTrack.Build(animEffects);
+		seTrack.Build(animSEs);
+		sphereTrack.Build(spheres);
+	}
+
 	// cereal
 	template<class Animation>
 	void serialize(Animation& archive)
@@ -307,6 +387,81 @@ struct Animation
 	}
 };
 
+//--------------------------------------------------------------
+// AnimationEventCursor
+//--------------------------------------------------------------
+// インスタンスごとのイベント再生位置 (トラックひとつ分)
+// モデルは ResourceManager で共有されるので、再生済みフラグはモデルではなくこちらに持つ
+struct AnimationEventCursor
+{
+	int animationIndex = -1;		// 対象のアニメーション番号
+	int frame = -1;					// 前回処理したフレーム
+	std::vector<uint64_t> fired;	// 再生済みのイベント (元の配列の番号のビット)
+
+	// 先頭に戻す (アニメーション切り替え・ループ時)
+	void Reset()
+	{
+		animationIndex = -1;
+		frame = -1;
+		fired.clear();
+	}
+
+	// 再生位置を frame に合わせる (frame 以前に開始したイベントは再生しない)
+	void Seek(int animationIndex, const AnimationEventTrack& track, int frame)
+	{
+		this->animationIndex = animationIndex;
+		this->frame = frame;
+		fired.assign((track.events.size() + 63) / 64, 0);
+	}
+
+	// 前回のフレームから frame までに開始したイベントのうち、未再生のものを再生済みにして func(index) を呼ぶ
+	template<class Func>
+	void Advance(int animationIndex, const AnimationEventTrack& track, int frame, Func func)
+	{
+		// アニメーションが変わった・イベント数が変わった (エディタでの編集) なら先頭から
+		const size_t wordCount = (track.events.size() + 63) / 64;
+		if (this->animationIndex != animationIndex || fired.size() != wordCount)
+		{
+			this->animationIndex = animationIndex;
+			this->frame = -1;
+			fired.assign(wordCount, 0);
+		}
+
+		// 巻き戻った場合は現在フレームだけ判定する (再生済みビットで二重再生を防ぐ)
+		const int from = (frame < this->frame) ? frame - 1 : this->frame;
+		this->frame = frame;
+
+		track.ForEachCrossed(from, frame, [&](const AnimationEventTrack::Event& e)
+			{
+				uint64_t& word = fired[e.index >> 6];
+				const uint64_t mask = 1ull << (e.index & 63);
+				if (word & mask) return;
+				word |= mask;
+				func(e.index);
+			});
+	}
+};
+
+
+//--------------------------------------------------------------
+// AnimationLodPolicy
+//--------------------------------------------------------------
+// カメラからの距離によるアニメーション更新の間引き設定 (モデルごと)
+// 時間とイベントは毎フレーム進め、ポーズの更新だけを間引く
+struct AnimationLodPolicy
+{
+	float reducedDistance = 15.0f;	// これより遠いと Reduced
+	float farDistance = 40.0f;		// これより遠いと Far
+	int reducedInterval = 2;		// Reduced で何フレームに一度ポーズを更新するか
+	int farInterval = 4;			// Far で何フレームに一度ポーズを更新するか
+	bool blendOnFar = false;		// Far でも遷移ブレンドをするか (しない場合は遷移後のポーズに切り替える)
+
+	template<class AnimationLodPolicy>
+	void serialize(AnimationLodPolicy& archive)
+	{
+		archive(CEREAL_NVP(reducedDistance), CEREAL_NVP(farDistance), CEREAL_NVP(reducedInterval), CEREAL_NVP(farInterval), CEREAL_NVP(blendOnFar));
+	}
+};
 
 //--------------------------------------------------------------
 // CoordinateSystemTransform
@@ -357,19 +512,25 @@ public:
 			archive(position, normal, tangent, texcoord, boneWeights, boneIndices);
 		}
 	};
-	struct Constants
+	// --- 定数バッファ (シェーダーの b0 / b2 / b3、b1 はシーン定数) ---
+	// オブジェクトごと (メッシュ単位で ConstantRingBuffer に書き込む)
+	struct ObjectConstants
 	{
 		DirectX::XMFLOAT4X4 world;
 		DirectX::XMFLOAT4 materialColor;
-		DirectX::XMFLOAT4X4 boneTransforms[MAX_BONES] = { 
-			{ 
-				1, 0, 0, 0, 
-				0, 1, 0, 0, 
-				0, 0, 1, 0, 
-				0, 0, 0, 1 
-			} 
-		};
+		float objectType = 0;
+		DirectX::XMFLOAT3 pad;
+	};
+	// マテリアルごと (読み込み時に作って変更しない)
+	struct MaterialConstants
+	{
+		DirectX::XMFLOAT4 Kd;
 	};
+	// スケルトンごとのボーン行列は、メッシュのボーン数分だけ ConstantRingBuffer に書き込む
+	static const UINT OBJECT_CONSTANT_SLOT = 0;
+	static const UINT MATERIAL_CONSTANT_SLOT = 2;
+	static const UINT SKELETON_CONSTANT_SLOT = 3;
+
 	struct IsBloomConstants
 	{
 
@@ -431,6 +592,8 @@ public:
 	private:
 		Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
+		// RenderQueue 用の id (D3D11RenderBackend に登録)
+		uint32_t renderGeometryId = 0;
 		friend class SkinnedMesh;
 	};
 
@@ -446,6 +609,13 @@ public:
 		std::string textureFilenames[4];
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceViews[4];
 
+		// マテリアル定数 (Kd)
+		Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
+
+		// RenderQueue 用の id (D3D11RenderBackend に登録、保存はしない)
+		uint32_t renderTextureSetId = 0;
+		uint32_t renderMaterialId = 0;
+
 		// cereal
 		template<class Material>
 		void serialize(Material& archive)
@@ -462,6 +632,22 @@ public:
 	// 球の当たり判定
 	std::vector<SkeletonSphere> skeletonSpheres;
 
+	// レイキャスト用の当たり判定メッシュ
+	CollisionMesh collisionMesh;
+
+	// このモデルを焼き込んだ StaticMesh (ResourceManager::LoadStaticMeshResource が作り、モデルと同じだけ残す)
+	std::shared_ptr<StaticMesh> staticMesh;
+
+	// アニメーションの LOD 設定 (.model に書き出す)
+	AnimationLodPolicy animationLodPolicy;
+
+	// モデル空間でのバウンディングボックス (バインドポーズ、CreateComObjects で頂点から計算)
+	DirectX::XMFLOAT3 boundingBox[2] =
+	{
+		{ +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX },
+		{ -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX },
+	};
+
 	std::string fbxPath;
 	std::string parentPath;
 
@@ -487,12 +673,28 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
 	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> isBloomConstantBuffer;
+
+	// RenderQueue 用の id (D3D11RenderBackend に登録)
+	uint32_t renderPipelineId = 0;
+	bool renderResourcesRegistered = false;
+
+	bool keepVertices = false;
+	std::atomic<bool> created = false;
 
 public:
-	SkinnedMesh(const char* fbxFilename, bool triangulate = false, float samplingRate = 0);
-	virtual ~SkinnedMesh() = default;
+	// keepVertices : 頂点・インデックスを CPU 側にも残す (StaticMesh の作成などに使う、使い終わったら ReleaseVertices)
+	// deferCreate : 読み込みを行わない (LoadResources をワーカーで、CreateResources をメインスレッドで呼んでもらう)
+	SkinnedMesh(const char* fbxFilename, bool triangulate = false, float samplingRate = 0, bool keepVertices = false, bool deferCreate = false);
+	virtual ~SkinnedMesh();
+
+	// ファイルの読み込みとテクスチャの作成 (ワーカースレッドから呼べる)
+	void LoadResources(bool triangulate, float samplingRate);
+	// 形状と当たり判定メッシュだけの読み込み (テクスチャも GPU リソースも作らない)
+	void LoadGeometry(bool triangulate, float samplingRate);
+	// バッファ・シェーダーの作成と RenderQueue への登録 (メインスレッドから呼ぶ)
+	void CreateResources();
+	// CreateResources まで済んでいるか
+	bool IsCreated() const { return created; }
 
 	// FbxLoad処理
 	void LoadFbx(const char* fbxFilename, bool triangulate, float samplingRate);
@@ -502,8 +704,10 @@ public:
 
 
 
-	// 描画
+	// 描画 (RenderQueue の記録中ならパケットを積むだけ)
 	void Render(const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4& materialColor, const Animation::KeyFrame* keyFrame);
+	// RenderQueue にパケットを積む
+	void Submit(RenderQueue& queue, const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4& materialColor, const Animation::KeyFrame* keyFrame);
 
 	// mesh 取得
 	void FetchMeshes(const char* fbxFilename, FbxScene* fbxScene, std::vector<Mesh>& meshes);
@@ -521,8 +725,33 @@ public:
 	// アニメーションブレンド
 	void BlendAnimations(const Animation::KeyFrame* keyFrames[2], float factor, Animation::KeyFrame& keyFrame);
 
+	// ノード名からノード番号を取得 (見つからなければ -1)
+	int64_t FindNodeIndex(const std::string& nodeName) const;
+	// 当たり判定球のボーン名をノード番号に解決する
+	void BindCollisionNodes();
+	// 全クリップのイベントトラック生成
+	void BuildAnimationEventTracks();
+
+	// 当たり判定メッシュの焼き込み
+	void BuildCollisionMesh();
+
+	// ボックス (min, max) を行列で変換した AABB を中心と半分の大きさで取得
+	static void TransformBounds(const DirectX::XMFLOAT3 box[2], const DirectX::XMFLOAT4X4& transform, DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents);
+	// ワールド空間の AABB 取得 (頂点がなければ false)
+	bool GetWorldBounds(const DirectX::XMFLOAT4X4& world, DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const;
+
+	// CPU 側の頂点・インデックスの解放 (keepVertices で残した場合に使う)
+	void ReleaseVertices();
+
 	// オブジェクト生成
 	void CreateComObjects(const char* fbxFilename);
+	// マテリアルのテクスチャ生成
+	void LoadTextures(const char* fbxFilename);
+	// RenderQueue 用に D3D11RenderBackend へ登録する
+	void RegisterRenderResources();
+	// メッシュごとの定数 (world と boneTransforms) 作成
+	// 戻り値は書き込んだボーン行列の数 (ボーンのないメッシュも 0 番に単位行列を入れるので 1 以上)
+	UINT MakeMeshConstants(const Mesh& mesh, const DirectX::XMFLOAT4X4& world, const Animation::KeyFrame* keyFrame, ObjectConstants& object, DirectX::XMFLOAT4X4 boneTransforms[MAX_BONES]) const;
 	// ダミーテクスチャの生成
 	HRESULT MakeDummyTexture(ID3D11ShaderResourceView** shaderResourceView, DWORD value/*0xAABBGGRR*/, UINT dimension);
 	// ダミーマテリアルの作成
@@ -533,6 +762,9 @@ public:
 
 	// fbx の単位設定
 	void SetFbxUnit(FbxUnit fbxUnit);
+
+	// アニメーションの LOD 設定
+	void SetAnimationLodPolicy(const AnimationLodPolicy& animationLodPolicy);
 public:
 	SkinnedScene sceneView;
 };
\ No newline at end of file
@@ -47,24 +47,24 @@ void SkyMap::Render()
 
     Constants data;
     DirectX::XMStoreFloat4x4(&data.inverseViewProjection, DirectX::XMMatrixInverse(NULL, DirectX::XMLoadFloat4x4(&viewProjection)));
-    gfx.deviceContext->UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
-    gfx.deviceContext->VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
-    gfx.deviceContext->PSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+    gfx.stateCache.UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
+    gfx.stateCache.VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+    gfx.stateCache.PSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
 
     //--- < ラスタライザのバインド > ---
     gfx.SetRasterizer(RASTERIZER_STATE::CLOCK_FALSE_CULL_NONE);
     gfx.SetDepthStencil(DEPTHSTENCIL_STATE::ZT_OFF_ZW_OFF);
 
-    gfx.deviceContext->IASetVertexBuffers(0, 0, NULL, NULL, NULL);
-    gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-    gfx.deviceContext->IASetInputLayout(NULL);
+    gfx.stateCache.IASetVertexBuffers(0, 0, NULL, NULL, NULL);
+    gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    gfx.stateCache.IASetInputLayout(NULL);
 
-    gfx.deviceContext->VSSetShader(vertexShader.Get(), 0, 0);
-    gfx.deviceContext->PSSetShader(pixelShader.Get(), 0, 0);
+    gfx.stateCache.VSSetShader(vertexShader.Get(), 0, 0);
+    gfx.stateCache.PSSetShader(pixelShader.Get(), 0, 0);
 
     //--- < シェーダーリソースのバインド > ---
-    gfx.deviceContext->PSSetShaderResources(0, 1, shaderResourceView.GetAddressOf());
+    gfx.stateCache.PSSetShaderResources(0, 1, shaderResourceView.GetAddressOf());
 
-    gfx.deviceContext->Draw(4, 0);
+    gfx.stateCache.Draw(4, 0);
 }
 
@@ -147,7 +147,7 @@ void Sprite3D::Render(const DirectX::XMFLOAT4X4& world, DirectX::XMFLOAT4 color,
 	//--- < 計算結果で頂点バッファオブジェクトを更新する > ---
 	HRESULT hr{ S_OK };
 	D3D11_MAPPED_SUBRESOURCE mappedSubresource{};
-	hr = gfx->deviceContext->Map(vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+	hr = gfx->stateCache.Map(vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
 	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 
 	Vertex* vertices{ reinterpret_cast<Vertex*>(mappedSubresource.pData) };
@@ -164,7 +164,7 @@ void Sprite3D::Render(const DirectX::XMFLOAT4X4& world, DirectX::XMFLOAT4 color,
 		vertices[2].texcoord = { u0,v1 };
 		vertices[3].texcoord = { u1,v1 };
 	}
-	gfx->deviceContext->Unmap(vertexBuffer.Get(), 0);
+	gfx->stateCache.Unmap(vertexBuffer.Get(), 0, sizeof(Vertex) * 4);
 
 	//--- < ラスタライザのバインド > ---
 	gfx->SetRasterizer(RASTERIZER_STATE::CLOCK_FALSE_CULL_NONE);
@@ -172,26 +172,26 @@ void Sprite3D::Render(const DirectX::XMFLOAT4X4& world, DirectX::XMFLOAT4 color,
 	//--- < 頂点バッファーのバインド > ---
 	UINT stride{ sizeof(Vertex) };
 	UINT offset{ 0 };
-	gfx->deviceContext->IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
-	gfx->deviceContext->IASetIndexBuffer(indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+	gfx->stateCache.IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
+	gfx->stateCache.IASetIndexBuffer(indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
 	//--- < プリミティブタイプおよにデータ順序に関する情報のバインド > ---
-	gfx->deviceContext->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	gfx->stateCache.IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	//--- < 入力レイアウトオブジェクトのバインド > ---
-	gfx->deviceContext->IASetInputLayout(inputLayout.Get());
+	gfx->stateCache.IASetInputLayout(inputLayout.Get());
 
 	//--- < シェーダーのバインド > ---
-	gfx->deviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
-	gfx->deviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+	gfx->stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx->stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
 
 	Constants data = { world };
-	gfx->deviceContext->UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
-	gfx->deviceContext->VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
+	gfx->stateCache.UpdateSubresource(constantBuffer.Get(), 0, 0, &data, 0, 0);
+	gfx->stateCache.VSSetConstantBuffers(0, 1, constantBuffer.GetAddressOf());
 
 	//--- < シェーダーリソースのバインド > ---
-	gfx->deviceContext->PSSetShaderResources(0, 1, shaderResourceView.GetAddressOf());
+	gfx->stateCache.PSSetShaderResources(0, 1, shaderResourceView.GetAddressOf());
 
 	//--- < プリミティブの描画 > ---
-	gfx->deviceContext->DrawIndexed(6, 0, 0);
+	gfx->stateCache.DrawIndexed(6, 0, 0);
 }
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include "StaticMesh.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/Shader.h"
+#include "../Graphics/RenderQueue.h"
+#include "../Graphics/D3D11RenderBackend.h"
+#include "../ErrorLogger.h"
+
+using namespace DirectX;
+
+// コンストラクタ (CPU 側の変換だけを行う、ワーカースレッドから呼べる)
+StaticMesh::StaticMesh(const SkinnedMesh& model, const DirectX::XMFLOAT4X4& world)
+{
+	// --- 頂点をワールド空間へ変換して 1 つにまとめる ---
+	std::vector<uint32_t> baseVertices;
+	baseVertices.reserve(model.meshes.size());
+	for (const SkinnedMesh::Mesh& mesh : model.meshes)
+	{
+		_ASSERT_EXPR(!mesh.vertices.empty() || mesh.subsets.empty(), L"StaticMesh requires SkinnedMesh loaded with keepVertices.");
+
+		baseVertices.emplace_back(static_cast<uint32_t>(vertices.size()));
+
+		// スキンの VS と同じく、バインドポーズのメッシュ行列 * world で変換する (法線・接線も同じ行列で正規化)
+		const XMMATRIX transform = XMLoadFloat4x4(&mesh.defaultGlobalTransform) * XMLoadFloat4x4(&world);
+		for (const SkinnedMesh::Vertex& source : mesh.vertices)
+		{
+			Vertex vertex;
+			XMStoreFloat3(&vertex.position, XMVector3TransformCoord(XMLoadFloat3(&source.position), transform));
+			XMStoreFloat3(&vertex.normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&source.normal), transform)));
+			const XMFLOAT3 tangent = { source.tangent.x, source.tangent.y, source.tangent.z };
+			XMStoreFloat4(&vertex.tangent, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&tangent), transform)));
+			vertex.tangent.w = source.tangent.w;
+			vertex.texcoord = source.texcoord;
+
+			boundingBox[0].x = (std::min)(boundingBox[0].x, vertex.position.x);
+			boundingBox[0].y = (std::min)(boundingBox[0].y, vertex.position.y);
+			boundingBox[0].z = (std::min)(boundingBox[0].z, vertex.position.z);
+			boundingBox[1].x = (std::max)(boundingBox[1].x, vertex.position.x);
+			boundingBox[1].y = (std::max)(boundingBox[1].y, vertex.position.y);
+			boundingBox[1].z = (std::max)(boundingBox[1].z, vertex.position.z);
+
+			vertices.emplace_back(vertex);
+		}
+	}
+	vertexCount = vertices.size();
+
+	// --- インデックスをマテリアルごとに並べ直す ---
+	// マテリアルの順番は最初に出てきた順 (毎回同じ順番で描かれるように)
+	std::vector<uint64_t> materialOrder;
+	std::unordered_map<uint64_t, std::vector<uint32_t>> materialIndices;
+	for (size_t meshIndex = 0; meshIndex < model.meshes.size(); meshIndex++)
+	{
+		const SkinnedMesh::Mesh& mesh = model.meshes.at(meshIndex);
+		const uint32_t baseVertex = baseVertices.at(meshIndex);
+		for (const SkinnedMesh::Mesh::Subset& subset : mesh.subsets)
+		{
+			if (subset.indexCount == 0) continue;
+			sourceSubsetCount++;
+
+			auto found = materialIndices.find(subset.materialUniqueId);
+			if (found == materialIndices.end())
+			{
+				materialOrder.emplace_back(subset.materialUniqueId);
+				found = materialIndices.emplace(subset.materialUniqueId, std::vector<uint32_t>()).first;
+			}
+
+			std::vector<uint32_t>& destination = found->second;
+			for (uint32_t i = 0; i < subset.indexCount; i++)
+			{
+				destination.emplace_back(mesh.indices.at(static_cast<size_t>(subset.startIndexLocation) + i) + baseVertex);
+			}
+		}
+	}
+
+	for (uint64_t materialUniqueId : materialOrder)
+	{
+		const std::vector<uint32_t>& source = materialIndices.at(materialUniqueId);
+		const SkinnedMesh::Material& material = model.materials.at(materialUniqueId);
+
+		Batch batch;
+		batch.startIndexLocation = static_cast<uint32_t>(indices.size());
+		batch.indexCount = static_cast<uint32_t>(source.size());
+		batch.materialConstantBuffer = material.constantBuffer;
+		for (int i = 0; i < 4; i++) batch.shaderResourceViews[i] = material.shaderResourceViews[i];
+		batch.alpha = material.Kd.w;
+
+		// 並べ替え用の中心
+		XMFLOAT3 minimum = { +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX };
+		XMFLOAT3 maximum = { -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX };
+		for (uint32_t index : source)
+		{
+			const XMFLOAT3& p = vertices.at(index).position;
+			minimum = { (std::min)(minimum.x, p.x), (std::min)(minimum.y, p.y), (std::min)(minimum.z, p.z) };
+			maximum = { (std::max)(maximum.x, p.x), (std::max)(maximum.y, p.y), (std::max)(maximum.z, p.z) };
+		}
+		batch.center = { (minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f };
+
+		indices.insert(indices.end(), source.begin(), source.end());
+		batches.emplace_back(batch);
+	}
+}
+
+// バッファ・シェーダーの作成と RenderQueue への登録 (メインスレッドから呼ぶ)
+void StaticMesh::CreateResources()
+{
+	// --- Graphics 取得 ---
+	Graphics& gfx = Graphics::Instance();
+
+	// --- バッファの作成 (変更しないので IMMUTABLE) ---
+	HRESULT hr = S_OK;
+	if (!vertices.empty() && !indices.empty())
+	{
+		D3D11_BUFFER_DESC bufferDesc{};
+		D3D11_SUBRESOURCE_DATA subresourceData{};
+		bufferDesc.ByteWidth = static_cast<UINT>(sizeof(Vertex) * vertices.size());
+		bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		subresourceData.pSysMem = vertices.data();
+		hr = gfx.device->CreateBuffer(&bufferDesc, &subresourceData, vertexBuffer.ReleaseAndGetAddressOf());
+		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+		bufferDesc.ByteWidth = static_cast<UINT>(sizeof(uint32_t) * indices.size());
+		bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+		subresourceData.pSysMem = indices.data();
+		hr = gfx.device->CreateBuffer(&bufferDesc, &subresourceData, indexBuffer.ReleaseAndGetAddressOf());
+		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	}
+
+	// オブジェクト定数 (ワールド行列は単位行列のまま、色などが変わった時だけ書き換える)
+	{
+		D3D11_BUFFER_DESC bufferDesc{};
+		bufferDesc.ByteWidth = sizeof(SkinnedMesh::ObjectConstants);
+		bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		hr = gfx.device->CreateBuffer(&bufferDesc, nullptr, objectConstantBuffer.ReleaseAndGetAddressOf());
+		_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	}
+	XMStoreFloat4x4(&objectConstants.world, XMMatrixIdentity());
+
+	//--- inputLayout と vertexShader の作成 (ピクセルシェーダーは SkinnedMesh と同じもの) ---
+	D3D11_INPUT_ELEMENT_DESC inputElementDesc[]
+	{
+		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT},
+		{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT},
+		{"TANGENT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT},
+		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT},
+	};
+	CreateVsFromCso("Data/Shader/StaticMesh_VS.cso", vertexShader.ReleaseAndGetAddressOf(), inputLayout.ReleaseAndGetAddressOf(), inputElementDesc, ARRAYSIZE(inputElementDesc));
+	CreatePsFromCso("Data/Shader/SkinnedMesh_PS.cso", pixelShader.ReleaseAndGetAddressOf());
+
+	// --- RenderQueue 用の登録 ---
+	D3D11RenderBackend& backend = D3D11RenderBackend::Instance();
+	renderPipelineId = backend.RegisterPipeline(vertexShader.Get(), pixelShader.Get(), inputLayout.Get(), SkinnedMesh::OBJECT_CONSTANT_SLOT, SkinnedMesh::SKELETON_CONSTANT_SLOT);
+	renderGeometryId = backend.RegisterGeometry(vertexBuffer.Get(), sizeof(Vertex), indexBuffer.Get(), DXGI_FORMAT_R32_UINT);
+	for (Batch& batch : batches)
+	{
+		ID3D11ShaderResourceView* shaderResourceViews[4] =
+		{
+			batch.shaderResourceViews[0].Get(),
+			batch.shaderResourceViews[1].Get(),
+			batch.shaderResourceViews[2].Get(),
+			batch.shaderResourceViews[3].Get(),
+		};
+		batch.renderTextureSetId = backend.RegisterTextureSet(shaderResourceViews);
+		batch.renderMaterialId = backend.RegisterMaterial(batch.materialConstantBuffer.Get(), SkinnedMesh::MATERIAL_CONSTANT_SLOT);
+	}
+
+	// バッファに入れたので CPU 側は捨てる
+	std::vector<Vertex>().swap(vertices);
+	std::vector<uint32_t>().swap(indices);
+
+	created = true;
+}
+
+// デストラクタ
+StaticMesh::~StaticMesh()
+{
+	// CreateResources 前なら何も登録していない
+	if (!created) return;
+
+	D3D11RenderBackend& backend = D3D11RenderBackend::Instance();
+	backend.ReleasePipeline(renderPipelineId);
+	backend.ReleaseGeometry(renderGeometryId);
+	for (const Batch& batch : batches)
+	{
+		backend.ReleaseMaterial(batch.renderMaterialId);
+		backend.ReleaseTextureSet(batch.renderTextureSetId);
+	}
+}
+
+// 描画
+void StaticMesh::Render(const DirectX::XMFLOAT4& materialColor)
+{
+	if (!created || batches.empty()) return;
+
+	// 記録中ならキューに積んで、まとめて並べ替えてから描く
+	RenderQueue& renderQueue = RenderQueue::Instance();
+	if (renderQueue.IsRecording())
+	{
+		Submit(renderQueue, materialColor);
+		return;
+	}
+
+	// --- Graphics 取得 ---
+	Graphics& gfx = Graphics::Instance();
+
+	UpdateObjectConstants(materialColor);
+
+	uint32_t stride = sizeof(Vertex);
+	uint32_t offset = 0;
+	gfx.stateCache.IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
+	gfx.stateCache.IASetIndexBuffer(indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	gfx.stateCache.IASetInputLayout(inputLayout.Get());
+
+	gfx.stateCache.VSSetShader(vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.PSSetShader(pixelShader.Get(), nullptr, 0);
+
+	// オブジェクト定数は作っておいたバッファを設定するだけ
+	gfx.stateCache.VSSetConstantBuffers(SkinnedMesh::OBJECT_CONSTANT_SLOT, 1, objectConstantBuffer.GetAddressOf());
+	gfx.stateCache.PSSetConstantBuffers(SkinnedMesh::OBJECT_CONSTANT_SLOT, 1, objectConstantBuffer.GetAddressOf());
+
+	for (const Batch& batch : batches)
+	{
+		gfx.stateCache.VSSetConstantBuffers(SkinnedMesh::MATERIAL_CONSTANT_SLOT, 1, batch.materialConstantBuffer.GetAddressOf());
+		gfx.stateCache.PSSetConstantBuffers(SkinnedMesh::MATERIAL_CONSTANT_SLOT, 1, batch.materialConstantBuffer.GetAddressOf());
+
+		ID3D11ShaderResourceView* shaderResourceViews[4] =
+		{
+			batch.shaderResourceViews[0].Get(),
+			batch.shaderResourceViews[1].Get(),
+			batch.shaderResourceViews[2].Get(),
+			batch.shaderResourceViews[3].Get(),
+		};
+		gfx.stateCache.PSSetShaderResources(0, 4, shaderResourceViews);
+
+		gfx.stateCache.DrawIndexed(batch.indexCount, batch.startIndexLocation, 0);
+	}
+}
+
+// RenderQueue にパケットを積む
+void StaticMesh::Submit(RenderQueue& queue, const DirectX::XMFLOAT4& materialColor)
+{
+	// --- Graphics 取得 ---
+	Graphics& gfx = Graphics::Instance();
+
+	// 現在のラスタライザをパケットのステートにする
+	const uint32_t renderState = static_cast<uint32_t>(gfx.GetRasterizer());
+
+	// オブジェクト定数は 1 回だけ積み、全てのバッチから同じ位置を指す
+	// (キュー経由ではリングバッファへの書き込みになるが、続けて描かれれば 1 回で済む)
+	SkinnedMesh::ObjectConstants object = objectConstants;
+	object.materialColor = materialColor;
+	object.objectType = objectType;
+	const uint32_t objectOffset = queue.PushConstants(&object, sizeof(SkinnedMesh::ObjectConstants));
+
+	for (const Batch& batch : batches)
+	{
+		const RenderKey::PASS pass = (materialColor.w * batch.alpha < 1.0f) ? RenderKey::TRANSLUCENT_PASS : RenderKey::SOLID_PASS;
+		const float distance = queue.GetDistanceFromEye(batch.center.x, batch.center.y, batch.center.z);
+
+		RenderQueue::Packet packet;
+		packet.pipeline = renderPipelineId;
+		packet.renderState = renderState;
+		packet.material = batch.renderMaterialId;
+		packet.textureSet = batch.renderTextureSetId;
+		packet.geometry = renderGeometryId;
+		packet.indexCount = batch.indexCount;
+		packet.startIndexLocation = batch.startIndexLocation;
+		packet.constantsOffset[RenderBackend::OBJECT_CONSTANTS] = objectOffset;
+		packet.constantsSize[RenderBackend::OBJECT_CONSTANTS] = sizeof(SkinnedMesh::ObjectConstants);
+		packet.key = RenderKey::Make(pass, packet.pipeline, packet.renderState, packet.material, packet.textureSet, RenderKey::QuantizeDepth(pass, distance, queue.farDistance));
+		queue.Push(packet);
+	}
+}
+
+// オブジェクト定数の更新
+void StaticMesh::UpdateObjectConstants(const DirectX::XMFLOAT4& materialColor)
+{
+	if (objectConstantsValid &&
+		std::memcmp(&objectConstants.materialColor, &materialColor, sizeof(XMFLOAT4)) == 0 &&
+		objectConstants.objectType == objectType)
+	{
+		return;
+	}
+
+	objectConstants.materialColor = materialColor;
+	objectConstants.objectType = objectType;
+	Graphics::Instance().stateCache.UpdateSubresource(objectConstantBuffer.Get(), 0, 0, &objectConstants, 0, 0);
+	objectConstantsValid = true;
+}
+
+// ワールド空間の AABB 取得
+bool StaticMesh::GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const
+{
+	if (vertexCount == 0) return false;
+
+	center = { (boundingBox[0].x + boundingBox[1].x) * 0.5f, (boundingBox[0].y + boundingBox[1].y) * 0.5f, (boundingBox[0].z + boundingBox[1].z) * 0.5f };
+	extents = { (boundingBox[1].x - boundingBox[0].x) * 0.5f, (boundingBox[1].y - boundingBox[0].y) * 0.5f, (boundingBox[1].z - boundingBox[0].z) * 0.5f };
+	return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include "SkinnedMesh.h"
+
+class RenderQueue;
+
+//--------------------------------------------------------------
+// StaticMesh
+//--------------------------------------------------------------
+// 動かないモデル (ステージなど) 用の描画メッシュ
+// 読み込み時に全メッシュの頂点をワールド空間へ変換して 1 つの頂点バッファにまとめ、
+// インデックスはマテリアルごとに並べ直して 1 つのインデックスバッファにする
+// ボーン計算のない頂点シェーダーで描き、オブジェクト定数は変わった時だけ書き換える
+//
+// 元の SkinnedMesh は keepVertices を true にして読み込んでおくこと
+// (ResourceManager::LoadStaticMeshResource で作れば、LoadStaticModelResource のモデルに焼き込んだものを持たせて CPU 側の頂点は捨てる)
+//
+// SkinnedMesh と同じく、変換 (コンストラクタ) はどのスレッドからでも良いが、
+// GPU リソースの作成と RenderQueue への登録 (CreateResources) はメインスレッドで行う
+class StaticMesh
+{
+public:
+	// 頂点 (ボーン情報を持たない 48byte)
+	struct Vertex
+	{
+		DirectX::XMFLOAT3 position = { 0,0,0 };
+		DirectX::XMFLOAT3 normal = { 0,1,0 };
+		DirectX::XMFLOAT4 tangent = { 1,0,0,1 };
+		DirectX::XMFLOAT2 texcoord = { 0,0 };
+	};
+
+	// マテリアルごとの描画範囲
+	struct Batch
+	{
+		uint32_t startIndexLocation = 0;
+		uint32_t indexCount = 0;
+
+		// マテリアル (SkinnedMesh のものを共有する)
+		Microsoft::WRL::ComPtr<ID3D11Buffer> materialConstantBuffer;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceViews[4];
+		float alpha = 1.0f;		// Kd.w (半透明の判定用)
+
+		// ワールド空間の AABB の中心 (半透明の並べ替え用)
+		DirectX::XMFLOAT3 center = { 0,0,0 };
+
+		// RenderQueue 用の id (D3D11RenderBackend に登録)
+		uint32_t renderMaterialId = 0;
+		uint32_t renderTextureSetId = 0;
+	};
+
+public:
+	// model の全メッシュを world で変換してまとめる (CPU 側の処理だけ、ワーカースレッドから呼べる)
+	StaticMesh(const SkinnedMesh& model, const DirectX::XMFLOAT4X4& world);
+	~StaticMesh();
+
+	// バッファ・シェーダーの作成と RenderQueue への登録 (メインスレッドから呼ぶ)
+	void CreateResources();
+	// CreateResources まで済んでいるか
+	bool IsCreated() const { return created; }
+
+	// 描画 (RenderQueue が記録中ならパケットを積む)
+	void Render(const DirectX::XMFLOAT4& materialColor);
+
+	// ワールド空間の AABB 取得 (頂点がなければ false)
+	bool GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const;
+
+	// 取得
+	size_t GetBatchCount() const { return batches.size(); }
+	size_t GetSourceSubsetCount() const { return sourceSubsetCount; }
+	size_t GetVertexCount() const { return vertexCount; }
+
+public:
+	// ブルームの対象にするか (SkinnedMesh::isBloomConstants.objectType と同じ)
+	float objectType = 0;
+
+private:
+	// RenderQueue にパケットを積む
+	void Submit(RenderQueue& queue, const DirectX::XMFLOAT4& materialColor);
+
+	// オブジェクト定数の更新 (前回と同じなら何もしない)
+	void UpdateObjectConstants(const DirectX::XMFLOAT4& materialColor);
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> objectConstantBuffer;
+
+	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
+	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
+	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
+
+	std::vector<Batch> batches;
+
+	// CreateResources までの CPU 側の頂点とインデックス
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+
+	// objectConstantBuffer に入っている内容
+	SkinnedMesh::ObjectConstants objectConstants;
+	bool objectConstantsValid = false;
+
+	DirectX::XMFLOAT3 boundingBox[2] =
+	{
+		{ +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX, +D3D11_FLOAT32_MAX },
+		{ -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX, -D3D11_FLOAT32_MAX },
+	};
+
+	size_t sourceSubsetCount = 0;
+	size_t vertexCount = 0;
+
+	// RenderQueue 用の id (D3D11RenderBackend に登録)
+	uint32_t renderPipelineId = 0;
+	uint32_t renderGeometryId = 0;
+
+	std::atomic<bool> created = false;
+};
@@ -0,0 +1,205 @@
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+#include "AsyncLoader.h"
+#include "ImGui/Include/imgui.h"
+
+// 初期化
+void AsyncLoader::Initialize(unsigned int workerCount)
+{
+	mainThreadId = std::this_thread::get_id();
+	quit = false;
+
+	if (workerCount == 0)
+	{
+		const unsigned int hardwareCount = std::thread::hardware_concurrency();
+		workerCount = (std::max)(1u, (std::min)(hardwareCount > 1 ? hardwareCount - 1 : 1u, 4u));
+	}
+
+	for (unsigned int i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back(&AsyncLoader::WorkerThread, this);
+	}
+}
+
+// 終了化
+void AsyncLoader::Finalize()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+		loadQueue.clear();
+	}
+	loadCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		if (worker.joinable()) worker.join();
+	}
+	workers.clear();
+
+	// ワーカーが最後に積んだ upload も捨てる (GPU リソースはもう作らない)
+	std::lock_guard<std::mutex> lock(mutex);
+	uploadQueue.clear();
+	activeJobs = 0;
+	completeCondition.notify_all();
+}
+
+// 読み込みを積む
+AsyncLoader::Handle AsyncLoader::Request(std::function<void()> load, std::function<void()> upload)
+{
+	Handle job = std::make_shared<Job>();
+	job->load = std::move(load);
+	job->upload = std::move(upload);
+
+	batchSteps += 2;
+	++activeJobs;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (job->load) loadQueue.push_back(job);
+		else uploadQueue.push_back(job);
+	}
+	if (job->load) loadCondition.notify_one();
+	else CompleteStep(job, false);
+
+	return job;
+}
+
+// 終わるまで待つ
+void AsyncLoader::Wait(const Handle& handle)
+{
+	if (!handle) return;
+
+	if (IsMainThread())
+	{
+		// upload はメインスレッドでしか進まないので自分で回す
+		while (!handle->IsCompleted())
+		{
+			if (!RunUpload()) std::this_thread::yield();
+		}
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	completeCondition.wait(lock, [&]() { return handle->IsCompleted() || quit; });
+}
+
+// 1 フレーム分の upload を実行する
+void AsyncLoader::ProcessUploads()
+{
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point start = Clock::now();
+
+	statistics.uploads = 0;
+	do
+	{
+		if (!RunUpload()) break;
+		++statistics.uploads;
+	} while (std::chrono::duration<float, std::milli>(Clock::now() - start).count() < uploadBudget);
+
+	statistics.uploadMilliseconds = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	statistics.pendingLoads = static_cast<uint32_t>(loadQueue.size());
+	statistics.pendingUploads = static_cast<uint32_t>(uploadQueue.size());
+}
+
+// 進捗の数え始め
+void AsyncLoader::BeginBatch()
+{
+	// 終わっていない分は新しいバッチに含める
+	batchSteps = activeJobs * 2;
+	batchCompletedSteps = 0;
+}
+
+// BeginBatch からの進捗
+float AsyncLoader::GetProgress() const
+{
+	const uint32_t steps = batchSteps;
+	if (steps == 0) return 1.0f;
+	return (std::min)(1.0f, static_cast<float>(batchCompletedSteps) / static_cast<float>(steps));
+}
+
+// 積まれた読み込みが全て終わっているか
+bool AsyncLoader::IsIdle() const
+{
+	return activeJobs == 0;
+}
+
+// ワーカースレッド
+void AsyncLoader::WorkerThread()
+{
+	// WIC (テクスチャのデコード) を使うのでスレッドごとに COM を初期化する
+	CoInitialize(nullptr);
+
+	while (true)
+	{
+		Handle job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			loadCondition.wait(lock, [this]() { return quit || !loadQueue.empty(); });
+			if (quit) break;
+
+			job = std::move(loadQueue.front());
+			loadQueue.pop_front();
+		}
+
+		job->load();
+		job->load = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			uploadQueue.push_back(job);
+		}
+		CompleteStep(job, false);
+	}
+
+	CoUninitialize();
+}
+
+// upload を 1 件実行する
+bool AsyncLoader::RunUpload()
+{
+	Handle job;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (uploadQueue.empty()) return false;
+
+		job = std::move(uploadQueue.front());
+		uploadQueue.pop_front();
+	}
+
+	if (job->upload) job->upload();
+	job->upload = nullptr;
+
+	CompleteStep(job, true);
+	return true;
+}
+
+// 1 段終わった
+void AsyncLoader::CompleteStep(const Handle& job, bool finished)
+{
+	++batchCompletedSteps;
+	if (!finished) return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job->completed = true;
+		if (activeJobs > 0) --activeJobs;
+	}
+	completeCondition.notify_all();
+}
+
+// ImGui 描画
+void AsyncLoader::DrawDebugGui()
+{
+	if (ImGui::CollapsingHeader("AsyncLoader", ImGuiTreeNodeFlags_None))
+	{
+		ImGui::Text("Workers : %u", static_cast<uint32_t>(workers.size()));
+		ImGui::SliderFloat("UploadBudget(ms)", &uploadBudget, 0.5f, 16.0f);
+		ImGui::Text("PendingLoads : %u  PendingUploads : %u", statistics.pendingLoads, statistics.pendingUploads);
+		ImGui::Text("Uploads : %u  Time : %.2fms", statistics.uploads, statistics.uploadMilliseconds);
+		ImGui::Text("Progress : %.0f%%", GetProgress() * 100.0f);
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// AsyncLoader
+//--------------------------------------------------------------
+// 読み込みを 2 段に分けて流す
+//  1. load   : ワーカースレッド (複数) でファイル読み込み・デコードを行う
+//  2. upload : メインスレッドの ProcessUploads で GPU リソースの作成・登録を行う
+//              1 フレームに使う時間は uploadBudget まで (超えた分は次のフレームへ回す)
+//
+// 進捗は BeginBatch からの段の完了数で数える (1 件 = load と upload の 2 段)
+class AsyncLoader
+{
+public:
+	// 1 件分の状態 (Request の戻り値、Wait / IsCompleted に渡す)
+	class Job
+	{
+	public:
+		bool IsCompleted() const { return completed; }
+
+	private:
+		friend class AsyncLoader;
+		std::function<void()> load;
+		std::function<void()> upload;
+		std::atomic<bool> completed = false;
+	};
+	using Handle = std::shared_ptr<Job>;
+
+	// 統計
+	struct Statistics
+	{
+		uint32_t uploads = 0;			// 前フレームに実行した upload
+		uint32_t pendingLoads = 0;		// ワーカー待ち
+		uint32_t pendingUploads = 0;	// メインスレッド待ち
+		float uploadMilliseconds = 0;	// 前フレームに upload に使った時間
+	};
+
+private:
+	AsyncLoader() {}
+	~AsyncLoader() {}
+
+public:
+	static AsyncLoader& Instance()
+	{
+		static AsyncLoader instance;
+		return instance;
+	}
+
+	// 初期化 (呼んだスレッドをメインスレッドとする、workerCount が 0 なら論理コア数 - 1)
+	void Initialize(unsigned int workerCount = 0);
+
+	// 終了化 (残っている読み込みは捨てる)
+	void Finalize();
+
+	// 読み込みを積む (load, upload はどちらか nullptr でも良い)
+	Handle Request(std::function<void()> load, std::function<void()> upload);
+
+	// 終わるまで待つ (メインスレッドから呼んだ場合は upload を予算なしで進めながら待つ)
+	void Wait(const Handle& handle);
+
+	// メインスレッドで 1 フレーム分の upload を実行する (Framework から毎フレーム呼ぶ)
+	void ProcessUploads();
+
+	// 進捗の数え始め (ローディング画面の開始時に呼ぶ)
+	void BeginBatch();
+	// BeginBatch からの進捗 (0 ~ 1、積まれていなければ 1)
+	float GetProgress() const;
+	// 積まれた読み込みが全て終わっているか
+	bool IsIdle() const;
+
+	const Statistics& GetStatistics() const { return statistics; }
+
+	// ImGui 描画
+	void DrawDebugGui();
+
+public:
+	// 1 フレームに upload に使う時間 (ミリ秒、最低 1 件は実行する)
+	float uploadBudget = 4.0f;
+
+private:
+	// ワーカースレッド
+	void WorkerThread();
+	// upload を 1 件実行する (なければ false)
+	bool RunUpload();
+	// 1 段終わった
+	void CompleteStep(const Handle& job, bool finished);
+
+	bool IsMainThread() const { return std::this_thread::get_id() == mainThreadId; }
+
+private:
+	std::vector<std::thread> workers;
+	std::thread::id mainThreadId;
+
+	std::mutex mutex;
+	std::condition_variable loadCondition;		// ワーカーを起こす
+	std::condition_variable completeCondition;	// Wait を起こす
+	std::deque<Handle> loadQueue;
+	std::deque<Handle> uploadQueue;
+	bool quit = false;
+
+	std::atomic<uint32_t> batchSteps = 0;
+	std::atomic<uint32_t> batchCompletedSteps = 0;
+	std::atomic<uint32_t> activeJobs = 0;
+
+	Statistics statistics;
+};
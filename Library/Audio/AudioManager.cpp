@@ -1,5 +1,10 @@
 #include "AudioManager.h"
 #include "../ErrorLogger.h"
+#include "../ImGui/Include/imgui.h"
+#include "../Timer.h"
+#include "../MemoryTracker.h"
+#include <algorithm>
+#include <cmath>
 
 // 初期化処理
 void AudioManager::Initialize()
@@ -17,7 +22,167 @@ void AudioManager::Initialize()
 	// audioEngine 生成
 	audioEngine = std::make_unique<DirectX::AudioEngine>(eflags);
 
+	voiceManager.SetBackend(&backend);
 
-	LoadMusic(static_cast<int>(MUSIC_LABEL::WEAPON), L"Data/Audio/Impact.wav");
+	// 武器の音は連打されるので多めに用意する
+	LoadMusic(static_cast<int>(MUSIC_LABEL::WEAPON), L"Data/Audio/Impact.wav", 1.0f, 8, 0);
+}
+
+// 更新処理
+void AudioManager::Update()
+{
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::AUDIO);
+
+	// ストリーミングのバッファ要求もここから呼ばれる
+	audioEngine->Update();
+	voiceManager.Update();
+
+	const float elapsedTime = Timer::Instance().DeltaTime();
+	for (StreamDeck& deck : streamDecks)
+	{
+		UpdateStreamDeck(deck, elapsedTime);
+	}
+}
+
+// ストリーミング BGM の登録
+void AudioManager::LoadStreamMusic(int trackNo, const wchar_t* waveFilename, float volume)
+{
+	if (trackNo >= static_cast<int>(streamTracks.size())) streamTracks.resize(trackNo + 1);
+	streamTracks[trackNo].filename = waveFilename;
+	streamTracks[trackNo].volume = volume;
+}
+
+// ストリーミング BGM 再生
+bool AudioManager::PlayStreamMusic(int trackNo, bool isLoop, float fadeTime)
+{
+	if (trackNo < 0 || trackNo >= static_cast<int>(streamTracks.size()) || streamTracks[trackNo].filename.empty()) return false;
+	const StreamTrack& track = streamTracks[trackNo];
+
+	// 使っていない方で開く (フェードアウト中ならすぐ止める)
+	const int nextDeck = 1 - currentDeck;
+	StreamDeck& deck = streamDecks[nextDeck];
+	ReleaseStreamDeck(deck);
+
+	deck.stream = std::make_unique<MusicStream>();
+	if (!deck.stream->Open(track.filename.c_str(), isLoop))
+	{
+		deck.stream.reset();
+		return false;
+	}
+
+	// バッファが足りなくなると呼ばれるので、読み込み済みの分を渡す
+	MusicStream* stream = deck.stream.get();
+	const WaveStream::Format& format = stream->GetFormat();
+	deck.instance = std::make_unique<DirectX::DynamicSoundEffectInstance>(audioEngine.get(),
+		[stream](DirectX::DynamicSoundEffectInstance* instance)
+		{
+			stream->Retire(static_cast<uint32_t>(instance->GetPendingBufferCount()));
+
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			while (stream->Acquire(data, size))
+			{
+				instance->SubmitBuffer(data, size);
+			}
+		},
+		static_cast<int>(format.sampleRate), static_cast<int>(format.channels), static_cast<int>(format.bitsPerSample));
+
+	// 鳴っている方はフェードアウトして、新しい方をフェードインする
+	FadeStreamDeck(streamDecks[currentDeck], 0.0f, fadeTime);
+
+	deck.trackNo = trackNo;
+	deck.volume = (fadeTime > 0.0f) ? 0.0f : track.volume;
+	FadeStreamDeck(deck, track.volume, fadeTime);
+	deck.instance->SetVolume(deck.volume);
+	deck.instance->Play();
+
+	currentDeck = nextDeck;
+	return true;
+}
+
+// ストリーミング BGM 停止
+void AudioManager::StopStreamMusic(float fadeTime)
+{
+	for (StreamDeck& deck : streamDecks)
+	{
+		FadeStreamDeck(deck, 0.0f, fadeTime);
+	}
+	streamDecks[currentDeck].trackNo = -1;
+}
+
+// フェードの設定
+void AudioManager::FadeStreamDeck(StreamDeck& deck, float targetVolume, float fadeTime)
+{
+	if (!deck.instance) return;
+
+	deck.targetVolume = targetVolume;
+	if (fadeTime > 0.0f)
+	{
+		deck.fadeSpeed = (std::max)(std::abs(targetVolume - deck.volume), 0.01f) / fadeTime;
+	}
+	else
+	{
+		deck.volume = targetVolume;
+		deck.instance->SetVolume(deck.volume);
+	}
+}
+
+// フェードを進め、終わったものを止める
+void AudioManager::UpdateStreamDeck(StreamDeck& deck, float elapsedTime)
+{
+	if (!deck.instance) return;
+
+	if (deck.volume != deck.targetVolume)
+	{
+		const float step = deck.fadeSpeed * elapsedTime;
+		deck.volume = (deck.volume < deck.targetVolume) ?
+			(std::min)(deck.volume + step, deck.targetVolume) :
+			(std::max)(deck.volume - step, deck.targetVolume);
+		deck.instance->SetVolume(deck.volume);
+	}
+
+	// フェードアウトし終わった・ループせずに最後まで鳴った
+	const bool fadedOut = deck.targetVolume <= 0.0f && deck.volume <= 0.0f;
+	const bool finished = deck.stream->IsFinished() && deck.instance->GetPendingBufferCount() == 0;
+	if (fadedOut || finished)
+	{
+		ReleaseStreamDeck(deck);
+	}
+}
+
+// 止めて閉じる
+void AudioManager::ReleaseStreamDeck(StreamDeck& deck)
+{
+	if (deck.instance)
+	{
+		deck.instance->Stop(true);
+		deck.instance.reset();
+	}
+	// 読み込みスレッドも止まる
+	deck.stream.reset();
+
+	deck.trackNo = -1;
+	deck.volume = deck.targetVolume = deck.fadeSpeed = 0.0f;
+}
+
+// デバッグ用GUI描画
+void AudioManager::DrawDebugGui()
+{
+	if (ImGui::CollapsingHeader("Audio", ImGuiTreeNodeFlags_None))
+	{
+		const VoiceManager::Statistics& statistics = voiceManager.GetStatistics();
+		ImGui::SliderInt("Max Voices", &voiceManager.maxVoices, 1, 64);
+		ImGui::Text("Voices : %d / %d", voiceManager.GetTotalActiveCount(), voiceManager.maxVoices);
+		ImGui::Text("Played : %u  Merged : %u", statistics.played, statistics.merged);
+		ImGui::Text("Stolen : %u  Rejected : %u", statistics.stolen, statistics.rejected);
+
+		ImGui::Separator();
+		for (int i = 0; i < 2; ++i)
+		{
+			const StreamDeck& deck = streamDecks[i];
+			ImGui::Text("Stream %d%s : track %d  volume %.2f  %zu KB", i, (i == currentDeck) ? "*" : "",
+				deck.trackNo, deck.volume, deck.stream ? MusicStream::GetResidentBytes() / 1024 : 0);
+		}
+	}
 }
 
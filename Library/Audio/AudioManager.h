@@ -1,6 +1,11 @@
 #pragma once
 #include <Windows.h>
 #include <Audio.h>
+#include "DirectXAudioBackend.h"
+#include "VoiceManager.h"
+#include "MusicStream.h"
+#include <string>
+#include <vector>
 
 
 enum class MUSIC_LABEL
@@ -26,89 +31,132 @@ private:
 	// AudioEngine
 	std::unique_ptr<DirectX::AudioEngine> audioEngine;
 
-	static const int MUSIC_FILE_MAX = 32;
-	static const int XWB_FILE_MAX = 16;
+	// 再生は VoiceManager を通す (音ごとのインスタンスのプール・同時再生数・止める順番の管理)
+	DirectXAudioBackend	backend;
+	VoiceManager		voiceManager;
 
-	// Music
-	struct Music
+	// ストリーミング BGM (ファイル名だけ覚えておき、再生する時に開く)
+	struct StreamTrack
 	{
-		std::unique_ptr<DirectX::SoundEffect>			music = nullptr;
-		std::unique_ptr<DirectX::SoundEffectInstance>	musicInst = nullptr;
-		float											volume = 1.0f;
-	} musicData[MUSIC_FILE_MAX];
+		std::wstring	filename;
+		float			volume = 1.0f;
+	};
+	std::vector<StreamTrack> streamTracks;
+
+	// ストリーミング再生 1 本分 (クロスフェード用に 2 本持つ)
+	struct StreamDeck
+	{
+		std::unique_ptr<MusicStream>							stream;
+		std::unique_ptr<DirectX::DynamicSoundEffectInstance>	instance;	// stream のバッファを使うので先に破棄する
+		int		trackNo = -1;
+		float	volume = 0.0f;
+		float	targetVolume = 0.0f;
+		float	fadeSpeed = 0.0f;		// 1 秒あたりの音量の変化
+	};
+	StreamDeck streamDecks[2];
+	int currentDeck = 0;
 
 public:
 	// 初期化処理
 	void Initialize();
 
-	// 音楽の読み込み
-	void LoadMusic(int trackNo, const wchar_t* waveFilename, float volume = 1.0f)
+	// 更新処理 (鳴り終わった声を空きに戻す)
+	void Update();
+
+	// 音楽の読み込み (poolSize : 同時に鳴らせる数, priority : 大きいほど他の音に止められにくい)
+	void LoadMusic(int trackNo, const wchar_t* waveFilename, float volume = 1.0f, int poolSize = 4, int priority = 0)
 	{
-		if (musicData[trackNo].musicInst) musicData[trackNo].musicInst.reset();
-		musicData[trackNo].music.reset(new DirectX::SoundEffect(audioEngine.get(), waveFilename));
-		musicData[trackNo].volume = volume;
+		UnLoadMusic(trackNo);
+		backend.LoadSound(audioEngine.get(), trackNo, waveFilename);
+		voiceManager.RegisterSound(trackNo, { poolSize, priority, volume });
 	}
 
 	// 音楽の解放
 	void UnLoadMusic(int trackNo)
 	{
-		if (musicData[trackNo].musicInst)  musicData[trackNo].musicInst.reset();
-		if (musicData[trackNo].music)  musicData[trackNo].music.reset(nullptr);
+		// 声を先に破棄してから SoundEffect を解放する
+		voiceManager.UnregisterSound(trackNo);
+		backend.UnloadSound(trackNo);
 	}
 
-	// 音楽再生
-	void PlayMusic(int trackNo, bool isLoop = false)
+	// 音楽再生 (distance は聞いている位置からの距離、同時再生数を超えた時に遠いものから止める)
+	void PlayMusic(int trackNo, bool isLoop = false, float distance = 0.0f)
 	{
-		if (!musicData[trackNo].music) return;
-		musicData[trackNo].musicInst = musicData[trackNo].music->CreateInstance();
-		musicData[trackNo].musicInst->Play(isLoop);
-		musicData[trackNo].musicInst->SetVolume(musicData[trackNo].volume);
+		voiceManager.Play(trackNo, isLoop, distance);
 	}
 
 	// 音楽停止
 	void StopMusic(int trackNo)
 	{
-		if (!musicData[trackNo].musicInst) return;
-		musicData[trackNo].musicInst->Stop();
+		voiceManager.Stop(trackNo);
 	}
 
 	// 音楽ポーズ
 	void PauseMusic(int trackNo)
 	{
-		if (!musicData[trackNo].musicInst) return;
-		musicData[trackNo].musicInst->Pause();
+		voiceManager.Pause(trackNo);
 	}
 
 	// 音楽レジューム
 	void ResumeMusic(int trackNo)
 	{
-		if (!musicData[trackNo].musicInst) return;
-		musicData[trackNo].musicInst->Resume();
+		voiceManager.Resume(trackNo);
 	}
 
 	// 音楽ボリューム設定
-	void SetMusicVolume(int trackNo, int volume)
+	void SetMusicVolume(int trackNo, float volume)
 	{
-		if (!musicData[trackNo].musicInst) return;
-		musicData[trackNo].musicInst->SetVolume(volume);
-		musicData[trackNo].volume = volume;
+		voiceManager.SetVolume(trackNo, volume);
 	}
 
 	// 音楽状態取得
 	DirectX::SoundState GetSoundState(int trackNo)
 	{
-		return musicData[trackNo].musicInst->GetState();
+		switch (voiceManager.GetState(trackNo))
+		{
+		case AudioBackend::VOICE_STATE::PLAYING: return DirectX::PLAYING;
+		case AudioBackend::VOICE_STATE::PAUSED: return DirectX::PAUSED;
+		default: return DirectX::STOPPED;
+		}
 	}
 
 	// 音楽ループ状態取得
 	bool IsLoopMusic(int trackNo)
 	{
-		return musicData[trackNo].musicInst->IsLooped();
+		return voiceManager.IsLooped(trackNo);
 	}
 
 	// 音楽使用中かどうか
 	bool IsInUseMusic(int trackNo)
 	{
-		return musicData[trackNo].music->IsInUse();
+		return voiceManager.IsInUse(trackNo);
 	}
+
+	// ストリーミング BGM の登録 (全体を読み込まず、再生中に少しずつ読む)
+	void LoadStreamMusic(int trackNo, const wchar_t* waveFilename, float volume = 1.0f);
+
+	// ストリーミング BGM 再生 (鳴っている BGM からは fadeTime 秒でクロスフェードする)
+	bool PlayStreamMusic(int trackNo, bool isLoop = true, float fadeTime = 1.0f);
+
+	// ストリーミング BGM 停止 (fadeTime 秒でフェードアウト)
+	void StopStreamMusic(float fadeTime = 1.0f);
+
+	// 再生中のストリーミング BGM (なければ -1)
+	int GetStreamMusicTrack() const { return streamDecks[currentDeck].trackNo; }
+
+	// 同時再生の管理
+	VoiceManager& GetVoiceManager() { return voiceManager; }
+
+	// デバッグ用GUI描画
+	void DrawDebugGui();
+
+private:
+	// フェードの設定 (fadeTime が 0 ならすぐに変える)
+	static void FadeStreamDeck(StreamDeck& deck, float targetVolume, float fadeTime);
+
+	// フェードを進め、終わったものを止める
+	void UpdateStreamDeck(StreamDeck& deck, float elapsedTime);
+
+	// 止めて閉じる
+	static void ReleaseStreamDeck(StreamDeck& deck);
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "DirectXAudioBackend.h"
+
+// 音の読み込み
+void DirectXAudioBackend::LoadSound(DirectX::AudioEngine* audioEngine, uint32_t sound, const wchar_t* waveFilename)
+{
+	if (sound >= sounds.size()) sounds.resize(sound + 1);
+	sounds[sound] = std::make_unique<DirectX::SoundEffect>(audioEngine, waveFilename);
+}
+
+// 音の解放
+void DirectXAudioBackend::UnloadSound(uint32_t sound)
+{
+	if (sound < sounds.size()) sounds[sound].reset();
+}
+
+// 再生用インスタンスの作成
+uint32_t DirectXAudioBackend::CreateVoice(uint32_t sound)
+{
+	uint32_t voice = static_cast<uint32_t>(voices.size());
+	if (!freeVoices.empty())
+	{
+		voice = freeVoices.back();
+		freeVoices.pop_back();
+	}
+	else
+	{
+		voices.emplace_back();
+	}
+
+	voices[voice] = sounds.at(sound)->CreateInstance();
+	return voice;
+}
+
+// 再生用インスタンスの破棄
+void DirectXAudioBackend::DestroyVoice(uint32_t voice)
+{
+	voices[voice].reset();
+	freeVoices.push_back(voice);
+}
+
+// 再生 (止まっていなければ頭から)
+void DirectXAudioBackend::Play(uint32_t voice, bool loop)
+{
+	voices[voice]->Stop();
+	voices[voice]->Play(loop);
+}
+
+void DirectXAudioBackend::Stop(uint32_t voice)
+{
+	voices[voice]->Stop();
+}
+
+void DirectXAudioBackend::Pause(uint32_t voice)
+{
+	voices[voice]->Pause();
+}
+
+void DirectXAudioBackend::Resume(uint32_t voice)
+{
+	voices[voice]->Resume();
+}
+
+void DirectXAudioBackend::SetVolume(uint32_t voice, float volume)
+{
+	voices[voice]->SetVolume(volume);
+}
+
+AudioBackend::VOICE_STATE DirectXAudioBackend::GetState(uint32_t voice) const
+{
+	switch (voices[voice]->GetState())
+	{
+	case DirectX::PLAYING: return VOICE_STATE::PLAYING;
+	case DirectX::PAUSED: return VOICE_STATE::PAUSED;
+	default: return VOICE_STATE::STOPPED;
+	}
+}
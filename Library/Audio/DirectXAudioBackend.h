@@ -0,0 +1,37 @@
+#pragma once
+#include <Windows.h>
+#include <Audio.h>
+#include <memory>
+#include <vector>
+#include "VoiceManager.h"
+
+//--------------------------------------------------------------
+// DirectXAudioBackend
+//--------------------------------------------------------------
+// VoiceManager の呼び出しを DirectXTK Audio (SoundEffect / SoundEffectInstance) に変換する
+// 音は LoadSound で sound 番号の所へ読み込み、声は SoundEffectInstance 1 つに対応する
+class DirectXAudioBackend : public AudioBackend
+{
+public:
+	DirectXAudioBackend() {}
+	~DirectXAudioBackend() override {}
+
+	// 音の読み込み・解放 (解放の前にその音の声を全て DestroyVoice しておくこと)
+	void LoadSound(DirectX::AudioEngine* audioEngine, uint32_t sound, const wchar_t* waveFilename);
+	void UnloadSound(uint32_t sound);
+
+	// --- AudioBackend ---
+	uint32_t CreateVoice(uint32_t sound) override;
+	void DestroyVoice(uint32_t voice) override;
+	void Play(uint32_t voice, bool loop) override;
+	void Stop(uint32_t voice) override;
+	void Pause(uint32_t voice) override;
+	void Resume(uint32_t voice) override;
+	void SetVolume(uint32_t voice, float volume) override;
+	VOICE_STATE GetState(uint32_t voice) const override;
+
+private:
+	std::vector<std::unique_ptr<DirectX::SoundEffect>> sounds;
+	std::vector<std::unique_ptr<DirectX::SoundEffectInstance>> voices;
+	std::vector<uint32_t> freeVoices;		// DestroyVoice で空いた番号
+};
@@ -0,0 +1,135 @@
+#include "MusicStream.h"
+
+// 開く
+bool MusicStream::Open(const wchar_t* filename, bool loop, bool useThread)
+{
+	Close();
+
+	if (!reader.Open(filename)) return false;
+	this->loop = loop;
+
+	for (Buffer& buffer : buffers)
+	{
+		buffer.data.resize(BufferSize);
+		buffer.size = 0;
+		buffer.state = BUFFER_STATE::FREE;
+	}
+	fillIndex = acquireIndex = retireIndex = 0;
+	queuedCount = 0;
+	endOfStream = false;
+	stopRequested = false;
+
+	if (useThread) thread = std::thread(&MusicStream::ThreadMain, this);
+	return true;
+}
+
+// 閉じる
+void MusicStream::Close()
+{
+	if (thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopRequested = true;
+		}
+		condition.notify_all();
+		thread.join();
+	}
+
+	reader.Close();
+	for (Buffer& buffer : buffers)
+	{
+		// メモリも返す
+		std::vector<uint8_t>().swap(buffer.data);
+		buffer.size = 0;
+		buffer.state = BUFFER_STATE::FREE;
+	}
+}
+
+// 空いているバッファを 1 つ埋める
+bool MusicStream::Fill()
+{
+	size_t index;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!CanFill()) return false;
+		index = fillIndex;
+	}
+
+	// FREE のバッファは読み込み側しか触らないので、ロックせずに読む
+	Buffer& buffer = buffers[index];
+	buffer.size = reader.Read(buffer.data.data(), BufferSize, loop);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (buffer.size < BufferSize) endOfStream = true;
+	if (buffer.size == 0) return false;
+
+	buffer.state = BUFFER_STATE::FILLED;
+	fillIndex = (fillIndex + 1) % BufferCount;
+	return true;
+}
+
+// 読み込み済みのバッファを取り出す
+bool MusicStream::Acquire(const uint8_t*& data, size_t& size)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Buffer& buffer = buffers[acquireIndex];
+	if (buffer.state != BUFFER_STATE::FILLED) return false;
+
+	buffer.state = BUFFER_STATE::QUEUED;
+	data = buffer.data.data();
+	size = buffer.size;
+
+	acquireIndex = (acquireIndex + 1) % BufferCount;
+	++queuedCount;
+	return true;
+}
+
+// 再生の終わったバッファを空きに戻す
+void MusicStream::Retire(uint32_t pendingCount)
+{
+	bool retired = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		while (queuedCount > pendingCount)
+		{
+			buffers[retireIndex].state = BUFFER_STATE::FREE;
+			retireIndex = (retireIndex + 1) % BufferCount;
+			--queuedCount;
+			retired = true;
+		}
+	}
+
+	// 読み込みスレッドを起こす
+	if (retired) condition.notify_one();
+}
+
+// 最後まで読んで、全てのバッファを渡し終えたか
+bool MusicStream::IsFinished() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!endOfStream || queuedCount > 0) return false;
+
+	for (const Buffer& buffer : buffers)
+	{
+		if (buffer.state != BUFFER_STATE::FREE) return false;
+	}
+	return true;
+}
+
+// 読み込みスレッド
+void MusicStream::ThreadMain()
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]() { return stopRequested || CanFill(); });
+			if (stopRequested) break;
+		}
+
+		// 空いている分を全て埋める
+		while (Fill()) {}
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "WaveStream.h"
+
+//--------------------------------------------------------------
+// MusicStream
+//--------------------------------------------------------------
+// WaveStream から読んだ PCM を小さなバッファのリングに溜め、音声 API に少しずつ渡す
+// 読み込みは別スレッドで行い、空いたバッファを先に埋めておく (呼び出し側は読み込みを待たない)
+// バッファは FREE → FILLED (読み込み済み) → QUEUED (音声 API に渡した) → FREE の順に回る
+// 音声 API には依存しないので、useThread = false で開いて Fill を呼べばスレッドなしで確認できる
+class MusicStream
+{
+public:
+	static constexpr size_t BufferCount = 4;
+	static constexpr size_t BufferSize = 32 * 1024;	// 44.1kHz ステレオ 16bit で約 0.19 秒
+
+public:
+	MusicStream() {}
+	~MusicStream() { Close(); }
+
+	MusicStream(const MusicStream&) = delete;
+	MusicStream& operator=(const MusicStream&) = delete;
+
+	// 開く (loop なら最後まで来たら先頭からつなげて読む)
+	bool Open(const wchar_t* filename, bool loop, bool useThread = true);
+	void Close();
+
+	// 空いているバッファを 1 つ埋める (埋めたら true)
+	bool Fill();
+
+	// 読み込み済みのバッファを取り出す (QUEUED になり、Retire まで中身はそのまま)
+	bool Acquire(const uint8_t*& data, size_t& size);
+
+	// 音声 API がまだ持っている数 pendingCount を残して、古い QUEUED のバッファを空きに戻す
+	void Retire(uint32_t pendingCount);
+
+	// 最後まで読んで、全てのバッファを渡し終えたか (ループ時は終わらない)
+	bool IsFinished() const;
+
+	const WaveStream::Format& GetFormat() const { return reader.GetFormat(); }
+
+	// 常に持っているメモリ (バッファのリング分)
+	static constexpr size_t GetResidentBytes() { return BufferCount * BufferSize; }
+
+private:
+	enum class BUFFER_STATE : uint8_t
+	{
+		FREE,
+		FILLED,
+		QUEUED,
+	};
+
+	struct Buffer
+	{
+		std::vector<uint8_t> data;
+		size_t size = 0;
+		BUFFER_STATE state = BUFFER_STATE::FREE;
+	};
+
+	// 読み込みスレッド
+	void ThreadMain();
+
+	// 埋められるバッファがあるか (mutex をロックして呼ぶ)
+	bool CanFill() const { return !endOfStream && buffers[fillIndex].state == BUFFER_STATE::FREE; }
+
+private:
+	WaveStream reader;
+	bool loop = false;
+
+	Buffer buffers[BufferCount];
+	size_t fillIndex = 0;		// 次に埋める
+	size_t acquireIndex = 0;	// 次に取り出す
+	size_t retireIndex = 0;		// 次に空きに戻す
+	uint32_t queuedCount = 0;
+	bool endOfStream = false;	// 最後まで読んだ (ループしない時だけ)
+
+	std::thread thread;
+	mutable std::mutex mutex;
+	std::condition_variable condition;
+	bool stopRequested = false;
+};
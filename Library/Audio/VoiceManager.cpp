@@ -0,0 +1,253 @@
+#include "VoiceManager.h"
+#include "../MemoryTracker.h"
+
+// 音の登録
+void VoiceManager::RegisterSound(uint32_t sound, const SoundSetting& setting)
+{
+	if (IsRegistered(sound)) UnregisterSound(sound);
+	if (sound >= sounds.size()) sounds.resize(sound + 1);
+
+	Sound& s = sounds[sound];
+	s.registered = true;
+	s.setting = setting;
+	s.voices.resize(setting.poolSize > 0 ? setting.poolSize : 1);
+
+	// プール分のインスタンスを先に作る (Play では作らない)
+	for (Voice& voice : s.voices)
+	{
+		voice = {};
+		voice.backendVoice = backend->CreateVoice(sound);
+		backend->SetVolume(voice.backendVoice, setting.volume);
+	}
+}
+
+// 音の登録解除
+void VoiceManager::UnregisterSound(uint32_t sound)
+{
+	if (!IsRegistered(sound)) return;
+
+	Sound& s = sounds[sound];
+	for (Voice& voice : s.voices)
+	{
+		if (voice.active) Release(voice);
+		backend->DestroyVoice(voice.backendVoice);
+	}
+	s.voices.clear();
+	s.registered = false;
+}
+
+// 再生
+uint32_t VoiceManager::Play(uint32_t sound, bool loop, float distance)
+{
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::AUDIO);
+
+	if (!IsRegistered(sound)) return InvalidVoice;
+
+	Sound& s = sounds[sound];
+	const int priority = s.setting.priority;
+
+	// --- 同じフレームに鳴らしたものがあればまとめる (近い方の距離を残す) ---
+	for (uint32_t i = 0; i < s.voices.size(); ++i)
+	{
+		Voice& voice = s.voices[i];
+		if (voice.active && voice.frame == frame)
+		{
+			if (distance < voice.distance) voice.distance = distance;
+			++statistics.merged;
+			return i;
+		}
+	}
+
+	// 新しく鳴らす声 (比較用)
+	Voice incoming;
+	incoming.distance = distance;
+	incoming.frame = frame;
+
+	// --- 音のプールから空きを探す (なければその音の一番弱いもの) ---
+	Voice* target = nullptr;
+	for (Voice& voice : s.voices)
+	{
+		if (!voice.active)
+		{
+			target = &voice;
+			break;
+		}
+		if (!target || IsWeaker(priority, voice, priority, *target)) target = &voice;
+	}
+
+	if (target->active)
+	{
+		// 同じ音の中では新しい方を鳴らす (遠すぎるものは鳴らさない)
+		if (IsWeaker(priority, incoming, priority, *target))
+		{
+			++statistics.rejected;
+			return InvalidVoice;
+		}
+		Release(*target);
+		++statistics.stolen;
+	}
+	// --- 全体の上限 (全ての音の中で一番弱いものを止める) ---
+	else if (activeCount >= maxVoices)
+	{
+		Voice* victim = nullptr;
+		int victimPriority = 0;
+		for (Sound& other : sounds)
+		{
+			if (!other.registered) continue;
+			for (Voice& voice : other.voices)
+			{
+				if (!voice.active) continue;
+				if (!victim || IsWeaker(other.setting.priority, voice, victimPriority, *victim))
+				{
+					victim = &voice;
+					victimPriority = other.setting.priority;
+				}
+			}
+		}
+
+		if (!victim || IsWeaker(priority, incoming, victimPriority, *victim))
+		{
+			++statistics.rejected;
+			return InvalidVoice;
+		}
+		Release(*victim);
+		++statistics.stolen;
+	}
+
+	// --- 鳴らす ---
+	target->active = true;
+	target->loop = loop;
+	target->distance = distance;
+	target->frame = frame;
+	backend->SetVolume(target->backendVoice, s.setting.volume);
+	backend->Play(target->backendVoice, loop);
+
+	++activeCount;
+	++statistics.played;
+	return static_cast<uint32_t>(target - s.voices.data());
+}
+
+// 音の声を全て止める
+void VoiceManager::Stop(uint32_t sound)
+{
+	if (!IsRegistered(sound)) return;
+
+	for (Voice& voice : sounds[sound].voices)
+	{
+		if (voice.active) Release(voice);
+	}
+}
+
+// 一時停止
+void VoiceManager::Pause(uint32_t sound)
+{
+	if (!IsRegistered(sound)) return;
+
+	for (Voice& voice : sounds[sound].voices)
+	{
+		if (voice.active) backend->Pause(voice.backendVoice);
+	}
+}
+
+// 再開
+void VoiceManager::Resume(uint32_t sound)
+{
+	if (!IsRegistered(sound)) return;
+
+	for (Voice& voice : sounds[sound].voices)
+	{
+		if (voice.active) backend->Resume(voice.backendVoice);
+	}
+}
+
+// 音量
+void VoiceManager::SetVolume(uint32_t sound, float volume)
+{
+	if (!IsRegistered(sound)) return;
+
+	Sound& s = sounds[sound];
+	s.setting.volume = volume;
+	for (Voice& voice : s.voices)
+	{
+		if (voice.active) backend->SetVolume(voice.backendVoice, volume);
+	}
+}
+
+// 鳴り終わった声を空きに戻し、フレームを進める
+void VoiceManager::Update()
+{
+	for (Sound& s : sounds)
+	{
+		if (!s.registered) continue;
+		for (Voice& voice : s.voices)
+		{
+			if (voice.active && backend->GetState(voice.backendVoice) == AudioBackend::VOICE_STATE::STOPPED)
+			{
+				voice.active = false;
+				--activeCount;
+			}
+		}
+	}
+
+	lastStatistics = statistics;
+	statistics = {};
+	++frame;
+}
+
+// 音の状態
+AudioBackend::VOICE_STATE VoiceManager::GetState(uint32_t sound) const
+{
+	AudioBackend::VOICE_STATE state = AudioBackend::VOICE_STATE::STOPPED;
+	if (!IsRegistered(sound)) return state;
+
+	for (const Voice& voice : sounds[sound].voices)
+	{
+		if (!voice.active) continue;
+
+		const AudioBackend::VOICE_STATE voiceState = backend->GetState(voice.backendVoice);
+		if (voiceState == AudioBackend::VOICE_STATE::PLAYING) return voiceState;
+		if (voiceState == AudioBackend::VOICE_STATE::PAUSED) state = voiceState;
+	}
+	return state;
+}
+
+// ループで鳴っている声があるか
+bool VoiceManager::IsLooped(uint32_t sound) const
+{
+	if (!IsRegistered(sound)) return false;
+
+	for (const Voice& voice : sounds[sound].voices)
+	{
+		if (voice.active && voice.loop) return true;
+	}
+	return false;
+}
+
+// 鳴っている (一時停止を含む) 声の数
+int VoiceManager::GetActiveCount(uint32_t sound) const
+{
+	if (!IsRegistered(sound)) return 0;
+
+	int count = 0;
+	for (const Voice& voice : sounds[sound].voices)
+	{
+		if (voice.active) ++count;
+	}
+	return count;
+}
+
+// a の方が b より止めやすいか
+bool VoiceManager::IsWeaker(int priorityA, const Voice& a, int priorityB, const Voice& b)
+{
+	if (priorityA != priorityB) return priorityA < priorityB;
+	if (a.distance != b.distance) return a.distance > b.distance;
+	return a.frame < b.frame;
+}
+
+// 声を止めて空きにする
+void VoiceManager::Release(Voice& voice)
+{
+	backend->Stop(voice.backendVoice);
+	voice.active = false;
+	--activeCount;
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//--------------------------------------------------------------
+// AudioBackend
+//--------------------------------------------------------------
+// VoiceManager が実際の音声 API を呼ぶためのインターフェース
+// sound は backend 側で読み込んだ音の番号、voice は CreateVoice で払い出した再生用インスタンスの番号
+class AudioBackend
+{
+public:
+	enum class VOICE_STATE
+	{
+		STOPPED,
+		PLAYING,
+		PAUSED,
+	};
+
+public:
+	virtual ~AudioBackend() {}
+
+	// 再生用インスタンスの作成・破棄
+	virtual uint32_t CreateVoice(uint32_t sound) = 0;
+	virtual void DestroyVoice(uint32_t voice) = 0;
+
+	virtual void Play(uint32_t voice, bool loop) = 0;
+	virtual void Stop(uint32_t voice) = 0;
+	virtual void Pause(uint32_t voice) = 0;
+	virtual void Resume(uint32_t voice) = 0;
+	virtual void SetVolume(uint32_t voice, float volume) = 0;
+
+	virtual VOICE_STATE GetState(uint32_t voice) const = 0;
+};
+
+//--------------------------------------------------------------
+// VoiceManager
+//--------------------------------------------------------------
+// 音ごとに再生用インスタンスを先に作っておき (プール)、Play ではそこから空きを使う
+//  ・同じフレームに同じ音を何度 Play しても 1 つにまとめる
+//  ・音のプールが埋まっていたら、その音の中で一番弱いものを止めて使う
+//  ・全体の同時再生数を超えたら、全ての音の中で一番弱いものを止めて使う (新しい方が弱ければ鳴らさない)
+// 強さは priority が大きいほど強く、同じなら近い (distance が小さい) ほど、さらに同じなら新しいほど強い
+// 音声 API に依存しないので、NullAudioBackend を使えば音を出さずに確認できる
+class VoiceManager
+{
+public:
+	// 音ごとの設定
+	struct SoundSetting
+	{
+		int poolSize = 4;		// 同時に鳴らせる数 (先に作っておくインスタンス数)
+		int priority = 0;		// 大きいほど止められにくい
+		float volume = 1.0f;
+	};
+
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		uint32_t played = 0;
+		uint32_t merged = 0;		// 同じフレームの同じ音をまとめた
+		uint32_t stolen = 0;		// 他の声を止めて鳴らした
+		uint32_t rejected = 0;		// 鳴らさなかった
+	};
+
+	static constexpr uint32_t InvalidVoice = UINT32_MAX;
+
+public:
+	VoiceManager() {}
+	~VoiceManager() {}
+
+	// 使う backend (登録済みの音がある時に変えてはいけない)
+	void SetBackend(AudioBackend* backend) { this->backend = backend; }
+
+	// 音の登録 (プール分のインスタンスを作る)・解除
+	void RegisterSound(uint32_t sound, const SoundSetting& setting);
+	void UnregisterSound(uint32_t sound);
+	bool IsRegistered(uint32_t sound) const { return sound < sounds.size() && sounds[sound].registered; }
+
+	// 再生 (distance は聞いている位置からの距離、戻り値は声の番号か InvalidVoice)
+	uint32_t Play(uint32_t sound, bool loop = false, float distance = 0.0f);
+
+	// 音の声を全て止める・一時停止・再開
+	void Stop(uint32_t sound);
+	void Pause(uint32_t sound);
+	void Resume(uint32_t sound);
+
+	// 音量 (鳴っている声にも反映する)
+	void SetVolume(uint32_t sound, float volume);
+
+	// 鳴り終わった声を空きに戻し、フレームを進める
+	void Update();
+
+	// 音の状態 (鳴っているものがあれば PLAYING、一時停止中のものだけなら PAUSED)
+	AudioBackend::VOICE_STATE GetState(uint32_t sound) const;
+	bool IsLooped(uint32_t sound) const;
+	bool IsInUse(uint32_t sound) const { return GetActiveCount(sound) > 0; }
+
+	// 鳴っている (一時停止を含む) 声の数
+	int GetActiveCount(uint32_t sound) const;
+	int GetTotalActiveCount() const { return activeCount; }
+
+	const SoundSetting& GetSetting(uint32_t sound) const { return sounds[sound].setting; }
+
+	// 前フレームの統計
+	const Statistics& GetStatistics() const { return lastStatistics; }
+
+public:
+	// 全体で同時に鳴らせる数
+	int maxVoices = 32;
+
+private:
+	struct Voice
+	{
+		uint32_t backendVoice = InvalidVoice;
+		bool active = false;
+		bool loop = false;
+		float distance = 0.0f;
+		uint32_t frame = 0;		// 再生したフレーム
+	};
+
+	struct Sound
+	{
+		bool registered = false;
+		SoundSetting setting;
+		std::vector<Voice> voices;
+	};
+
+	// a の方が b より止めやすいか
+	static bool IsWeaker(int priorityA, const Voice& a, int priorityB, const Voice& b);
+
+	// 声を止めて空きにする
+	void Release(Voice& voice);
+
+private:
+	AudioBackend* backend = nullptr;
+
+	std::vector<Sound> sounds;
+	int activeCount = 0;
+
+	uint32_t frame = 0;
+
+	Statistics statistics;
+	Statistics lastStatistics;
+};
+
+//--------------------------------------------------------------
+// NullAudioBackend
+//--------------------------------------------------------------
+// 音を出さずに呼び出しを記録する (VoiceManager の確認用)
+// 声は Stop されるか Finish を呼ぶまで鳴っている扱いになる
+class NullAudioBackend : public AudioBackend
+{
+public:
+	enum class COMMAND
+	{
+		CREATE_VOICE,
+		DESTROY_VOICE,
+		PLAY,
+		STOP,
+		PAUSE,
+		RESUME,
+		SET_VOLUME,
+	};
+
+	struct Command
+	{
+		COMMAND type;
+		uint32_t voice;
+	};
+
+public:
+	uint32_t CreateVoice(uint32_t sound) override
+	{
+		const uint32_t voice = static_cast<uint32_t>(states.size());
+		states.push_back(VOICE_STATE::STOPPED);
+		commands.push_back({ COMMAND::CREATE_VOICE, voice });
+		return voice;
+	}
+	void DestroyVoice(uint32_t voice) override { commands.push_back({ COMMAND::DESTROY_VOICE, voice }); }
+
+	void Play(uint32_t voice, bool loop) override { states[voice] = VOICE_STATE::PLAYING; commands.push_back({ COMMAND::PLAY, voice }); }
+	void Stop(uint32_t voice) override { states[voice] = VOICE_STATE::STOPPED; commands.push_back({ COMMAND::STOP, voice }); }
+	void Pause(uint32_t voice) override { if (states[voice] == VOICE_STATE::PLAYING) states[voice] = VOICE_STATE::PAUSED; commands.push_back({ COMMAND::PAUSE, voice }); }
+	void Resume(uint32_t voice) override { if (states[voice] == VOICE_STATE::PAUSED) states[voice] = VOICE_STATE::PLAYING; commands.push_back({ COMMAND::RESUME, voice }); }
+	void SetVolume(uint32_t voice, float volume) override { commands.push_back({ COMMAND::SET_VOLUME, voice }); }
+
+	VOICE_STATE GetState(uint32_t voice) const override { return states[voice]; }
+
+	// 鳴り終わったことにする
+	void Finish(uint32_t voice) { states[voice] = VOICE_STATE::STOPPED; }
+
+public:
+	std::vector<Command> commands;
+	std::vector<VOICE_STATE> states;
+};
@@ -0,0 +1,297 @@
+#include "WaveStream.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+	// リトルエンディアンの読み出し
+	uint16_t ReadU16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+	uint32_t ReadU32(const uint8_t* p) { return static_cast<uint32_t>(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24)); }
+
+	// MS-ADPCM の量子化幅の更新表
+	const int adaptationTable[16] =
+	{
+		230, 230, 230, 230, 307, 409, 512, 614,
+		768, 614, 512, 409, 307, 230, 230, 230,
+	};
+
+	// MS-ADPCM のチャンネルごとの状態
+	struct AdpcmChannel
+	{
+		int coefficient1;
+		int coefficient2;
+		int delta;
+		int sample1;
+		int sample2;
+
+		int16_t Decode(uint8_t nibble)
+		{
+			const int predicted = (sample1 * coefficient1 + sample2 * coefficient2) / 256;
+			const int signedNibble = (nibble & 0x08) ? static_cast<int>(nibble) - 16 : static_cast<int>(nibble);
+			const int sample = std::clamp(predicted + signedNibble * delta, -32768, 32767);
+
+			sample2 = sample1;
+			sample1 = sample;
+			delta = (std::max)((adaptationTable[nibble] * delta) / 256, 16);
+			return static_cast<int16_t>(sample);
+		}
+	};
+}
+
+// 開く
+bool WaveStream::Open(const wchar_t* filename)
+{
+	Close();
+
+	file.open(std::filesystem::path(filename), std::ios::binary);
+	if (!file.is_open()) return false;
+
+	if (!ReadHeader())
+	{
+		Close();
+		return false;
+	}
+
+	Rewind();
+	return true;
+}
+
+// 閉じる
+void WaveStream::Close()
+{
+	if (file.is_open()) file.close();
+	file.clear();
+
+	format = {};
+	formatTag = 0;
+	dataOffset = dataSize = dataRead = 0;
+	block.clear();
+	decoded.clear();
+	decodedCursor = 0;
+}
+
+// PCM を最大 size バイト読む
+size_t WaveStream::Read(uint8_t* buffer, size_t size, bool loop)
+{
+	if (!file.is_open() || format.blockAlign == 0) return 0;
+
+	// サンプルの途中で切らない
+	size -= size % format.blockAlign;
+
+	size_t total = 0;
+	bool rewound = false;	// 先頭に戻してからまだ何も読めていない
+	while (total < size)
+	{
+		const size_t read = (formatTag == FORMAT_ADPCM) ? ReadAdpcm(buffer + total, size - total) : ReadPcm(buffer + total, size - total);
+		total += read;
+		if (read > 0) rewound = false;
+
+		if (total < size && IsEnd())
+		{
+			// 先頭に戻しても読めないもの (データが空など) はループしない
+			if (!loop || rewound) break;
+			Rewind();
+			rewound = true;
+		}
+		else if (read == 0)
+		{
+			// 壊れたファイルなどで読めなくなった
+			break;
+		}
+	}
+	return total;
+}
+
+// 先頭に戻す
+void WaveStream::Rewind()
+{
+	file.clear();
+	file.seekg(static_cast<std::streamoff>(dataOffset), std::ios::beg);
+	dataRead = 0;
+	decoded.clear();
+	decodedCursor = 0;
+}
+
+// 最後まで読んだか
+bool WaveStream::IsEnd() const
+{
+	return dataRead >= dataSize && decodedCursor * format.channels >= decoded.size();
+}
+
+// RIFF ヘッダーを読んで fmt と data の位置を取り出す
+bool WaveStream::ReadHeader()
+{
+	uint8_t riff[12];
+	if (!file.read(reinterpret_cast<char*>(riff), sizeof(riff))) return false;
+	if (std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) return false;
+
+	bool foundFormat = false;
+	uint8_t chunkHeader[8];
+	while (file.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader)))
+	{
+		const uint32_t chunkSize = ReadU32(chunkHeader + 4);
+
+		if (std::memcmp(chunkHeader, "fmt ", 4) == 0)
+		{
+			std::vector<uint8_t> fmt(chunkSize);
+			if (chunkSize < 16 || !file.read(reinterpret_cast<char*>(fmt.data()), chunkSize)) return false;
+
+			formatTag = ReadU16(&fmt[0]);
+			format.channels = ReadU16(&fmt[2]);
+			format.sampleRate = ReadU32(&fmt[4]);
+			fileBlockAlign = ReadU16(&fmt[12]);
+			const uint16_t fileBitsPerSample = ReadU16(&fmt[14]);
+
+			if (format.channels == 0 || fileBlockAlign == 0) return false;
+
+			if (formatTag == FORMAT_PCM)
+			{
+				// DynamicSoundEffectInstance が扱えるのは 8bit と 16bit
+				if (fileBitsPerSample != 8 && fileBitsPerSample != 16) return false;
+				format.bitsPerSample = fileBitsPerSample;
+			}
+			else if (formatTag == FORMAT_ADPCM)
+			{
+				// cbSize, wSamplesPerBlock, wNumCoef, aCoef[]
+				if (chunkSize < 22) return false;
+				samplesPerBlock = ReadU16(&fmt[18]);
+				const uint16_t coefficientCount = ReadU16(&fmt[20]);
+				if (chunkSize < 22u + coefficientCount * 4u || samplesPerBlock < 2) return false;
+
+				coefficients.resize(coefficientCount * 2);
+				for (size_t i = 0; i < coefficients.size(); ++i)
+				{
+					coefficients[i] = static_cast<int16_t>(ReadU16(&fmt[22 + i * 2]));
+				}
+				format.bitsPerSample = 16;
+			}
+			else
+			{
+				return false;
+			}
+
+			format.blockAlign = static_cast<uint16_t>(format.channels * format.bitsPerSample / 8);
+			foundFormat = true;
+		}
+		else if (std::memcmp(chunkHeader, "data", 4) == 0)
+		{
+			if (!foundFormat) return false;
+			dataOffset = static_cast<uint64_t>(file.tellg());
+			dataSize = chunkSize;
+			return true;
+		}
+		else
+		{
+			// 使わないチャンク (奇数サイズは 1 バイト詰められている)
+			file.seekg(chunkSize + (chunkSize & 1), std::ios::cur);
+		}
+	}
+	return false;
+}
+
+// PCM をそのまま読む
+size_t WaveStream::ReadPcm(uint8_t* buffer, size_t size)
+{
+	uint64_t remaining = dataSize - dataRead;
+	size_t readSize = static_cast<size_t>((std::min)(static_cast<uint64_t>(size), remaining));
+	readSize -= readSize % format.blockAlign;
+	if (readSize == 0)
+	{
+		// 端数しか残っていなければ最後まで読んだことにする
+		dataRead = dataSize;
+		return 0;
+	}
+
+	file.read(reinterpret_cast<char*>(buffer), readSize);
+	const size_t read = static_cast<size_t>(file.gcount());
+	dataRead += read;
+	if (read < readSize) dataRead = dataSize;	// ヘッダーより短いファイル
+	return read - read % format.blockAlign;
+}
+
+// ADPCM を展開しながら読む
+size_t WaveStream::ReadAdpcm(uint8_t* buffer, size_t size)
+{
+	size_t written = 0;
+	while (written < size)
+	{
+		// 展開済みのものがなければ次のブロックを展開する
+		if (decodedCursor * format.channels >= decoded.size())
+		{
+			if (!DecodeAdpcmBlock()) break;
+		}
+
+		const size_t availableSamples = decoded.size() / format.channels - decodedCursor;
+		const size_t samples = (std::min)(availableSamples, (size - written) / format.blockAlign);
+		if (samples == 0) break;
+
+		std::memcpy(buffer + written, decoded.data() + decodedCursor * format.channels, samples * format.blockAlign);
+		decodedCursor += samples;
+		written += samples * format.blockAlign;
+	}
+	return written;
+}
+
+// ADPCM の 1 ブロックを読んで decoded へ展開する
+bool WaveStream::DecodeAdpcmBlock()
+{
+	decoded.clear();
+	decodedCursor = 0;
+
+	const uint16_t channels = format.channels;
+	const size_t headerSize = 7u * channels;
+
+	const uint64_t remaining = dataSize - dataRead;
+	const size_t blockSize = static_cast<size_t>((std::min)(static_cast<uint64_t>(fileBlockAlign), remaining));
+	if (blockSize < headerSize || channels > 2)
+	{
+		dataRead = dataSize;
+		return false;
+	}
+
+	block.resize(blockSize);
+	file.read(reinterpret_cast<char*>(block.data()), blockSize);
+	if (static_cast<size_t>(file.gcount()) < blockSize)
+	{
+		dataRead = dataSize;
+		return false;
+	}
+	dataRead += blockSize;
+
+	// --- ブロックヘッダー (予測係数の番号, delta, sample1, sample2 をチャンネルの数だけ並べたもの) ---
+	AdpcmChannel state[2] = {};
+	const size_t coefficientCount = coefficients.size() / 2;
+	for (uint16_t c = 0; c < channels; ++c)
+	{
+		const size_t predictor = (std::min)(static_cast<size_t>(block[c]), coefficientCount - 1);
+		state[c].coefficient1 = coefficients[predictor * 2 + 0];
+		state[c].coefficient2 = coefficients[predictor * 2 + 1];
+		state[c].delta = static_cast<int16_t>(ReadU16(&block[channels + c * 2]));
+		state[c].sample1 = static_cast<int16_t>(ReadU16(&block[channels * 3 + c * 2]));
+		state[c].sample2 = static_cast<int16_t>(ReadU16(&block[channels * 5 + c * 2]));
+	}
+
+	// ブロックの最初の 2 サンプルはヘッダーに入っている (古い方から)
+	const size_t nibbleSamples = (blockSize - headerSize) * 2 / channels;
+	const size_t sampleCount = (std::min)(static_cast<size_t>(samplesPerBlock), nibbleSamples + 2);
+	decoded.reserve(sampleCount * channels);
+	for (uint16_t c = 0; c < channels; ++c) decoded.push_back(static_cast<int16_t>(state[c].sample2));
+	for (uint16_t c = 0; c < channels; ++c) decoded.push_back(static_cast<int16_t>(state[c].sample1));
+
+	// 残りは 4bit ずつ (上位から、ステレオなら左右交互)
+	size_t channel = 0;
+	for (size_t i = headerSize; i < blockSize && decoded.size() < sampleCount * channels; ++i)
+	{
+		const uint8_t byte = block[i];
+
+		decoded.push_back(state[channel].Decode(byte >> 4));
+		channel = (channel + 1) % channels;
+
+		if (decoded.size() >= sampleCount * channels) break;
+		decoded.push_back(state[channel].Decode(byte & 0x0F));
+		channel = (channel + 1) % channels;
+	}
+
+	return !decoded.empty();
+}
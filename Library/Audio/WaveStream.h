@@ -0,0 +1,79 @@
+#pragma once
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// WaveStream
+//--------------------------------------------------------------
+// WAV ファイル (PCM / MS-ADPCM) を先頭から少しずつ読み、PCM にして返す
+// ファイル全体は読み込まないので、長い BGM でもメモリは ADPCM 1 ブロック分しか使わない
+// Windows の音声 API には依存しない
+class WaveStream
+{
+public:
+	// 出力する PCM の形式 (ADPCM は 16bit にする)
+	struct Format
+	{
+		uint32_t sampleRate = 0;
+		uint16_t channels = 0;
+		uint16_t bitsPerSample = 0;
+		uint16_t blockAlign = 0;		// 1 サンプル (全チャンネル分) のバイト数
+	};
+
+	enum FORMAT_TAG : uint16_t
+	{
+		FORMAT_PCM = 1,
+		FORMAT_ADPCM = 2,
+	};
+
+public:
+	WaveStream() {}
+	~WaveStream() {}
+
+	// 開く (対応していない形式なら false)
+	bool Open(const wchar_t* filename);
+	void Close();
+	bool IsOpen() const { return file.is_open(); }
+
+	// PCM を最大 size バイト読む (戻り値は読んだバイト数)
+	// loop なら最後まで来たら先頭に戻って続けるので、つなぎ目に隙間ができない
+	size_t Read(uint8_t* buffer, size_t size, bool loop);
+
+	// 先頭に戻す
+	void Rewind();
+
+	// 最後まで読んだか
+	bool IsEnd() const;
+
+	const Format& GetFormat() const { return format; }
+	uint16_t GetFormatTag() const { return formatTag; }
+
+private:
+	// RIFF ヘッダーを読んで fmt と data の位置を取り出す
+	bool ReadHeader();
+
+	size_t ReadPcm(uint8_t* buffer, size_t size);
+	size_t ReadAdpcm(uint8_t* buffer, size_t size);
+
+	// ADPCM の 1 ブロックを読んで decoded へ展開する
+	bool DecodeAdpcmBlock();
+
+private:
+	std::ifstream file;
+
+	Format format;
+	uint16_t formatTag = 0;
+	uint16_t fileBlockAlign = 0;	// ファイル上の 1 ブロックのバイト数
+	uint16_t samplesPerBlock = 0;	// ADPCM の 1 ブロックのサンプル数 (1 チャンネル分)
+	std::vector<int16_t> coefficients;	// ADPCM の予測係数 (2 つで 1 組)
+
+	uint64_t dataOffset = 0;
+	uint64_t dataSize = 0;
+	uint64_t dataRead = 0;
+
+	// ADPCM の展開用
+	std::vector<uint8_t> block;
+	std::vector<int16_t> decoded;
+	size_t decodedCursor = 0;		// decoded の次に返す位置 (サンプル数、全チャンネル分)
+};
@@ -1,6 +1,30 @@
 #include "../Graphics/Graphics.h"
+#include "../3D/Camera.h"
+#include "../ImGui/Include/imgui.h"
 #include "Effect.h"
 #include "EffectManager.h"
+#include "../MemoryTracker.h"
+
+using namespace DirectX;
+
+namespace
+{
+	// デバッグ表示用の名前 (EffectType と合わせる)
+	const char* effectTypeNames[] =
+	{
+		"Hit1",
+		"Move",
+		"PowerUp",
+		"Sleep",
+		"Test1",
+	};
+	static_assert(_countof(effectTypeNames) == static_cast<int>(EffectType::LAST));
+
+	float DistanceSq(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(XMLoadFloat3(&a), XMLoadFloat3(&b))));
+	}
+}
 
 
 // 初期化
@@ -11,6 +35,32 @@ void Effect::Initialize()
 	CreateEffect(EffectType::PowerUp, "Data/Effect/PowerUp.efk");
 	CreateEffect(EffectType::Sleep, "Data/Effect/Sleep.efk");
 	CreateEffect(EffectType::Test1, "Data/Effect/Test1.efk");
+
+	// 再生設定 (ヒットは数が出るので上限を絞ってまとめやすくする)
+	//                                budget priority radius cullDistance coalesceDistance
+	SetSetting(EffectType::Hit1,	{ 48,	1,	1.5f,	60.0f,	0.5f });
+	SetSetting(EffectType::Move,	{ 16,	0,	2.0f,	40.0f,	0.5f });
+	SetSetting(EffectType::PowerUp,	{ 8,	2,	3.0f,	80.0f,	1.0f });
+	SetSetting(EffectType::Sleep,	{ 16,	0,	2.0f,	40.0f,	0.5f });
+	SetSetting(EffectType::Test1,	{ 8,	1,	3.0f,	80.0f,	0.5f });
+}
+
+// 更新処理
+void Effect::Update()
+{
+	Effekseer::ManagerRef effekseerManager = EffectManager::Instance().GetEffekseerManager();
+
+	// 終わったインスタンスを外す
+	totalLiveCount = 0;
+	for (std::vector<Live>& live : lives)
+	{
+		std::erase_if(live, [&](const Live& l) { return !effekseerManager->Exists(l.handle); });
+		totalLiveCount += static_cast<int>(live.size());
+	}
+
+	lastStatistics = statistics;
+	statistics = {};
+	++frame;
 }
 
 // データ作成
@@ -35,7 +85,63 @@ void Effect::CreateEffect(EffectType index, const char* filename)
 // 再生
 Effekseer::Handle Effect::Play(EffectType index, const DirectX::XMFLOAT3& position, DirectX::XMFLOAT3 angle, float scale)
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::EFFECT);
+
 	int effectIndex = static_cast<int>(index);
+	const Setting& setting = settings[effectIndex];
+
+	// --- 遠いもの・見えないものは出さない ---
+	if (enableCulling)
+	{
+		const Camera& camera = Camera::Instance();
+		if (DistanceSq(position, camera.GetEye()) > setting.cullDistance * setting.cullDistance ||
+			!camera.GetFrustum().IntersectSphere(position, setting.radius * scale))
+		{
+			++statistics.culled;
+			return -1;
+		}
+	}
+
+	// --- 同じフレームに近くで出したものがあればそれを返す ---
+	std::vector<Live>& live = lives[effectIndex];
+	const float coalesceDistanceSq = setting.coalesceDistance * setting.coalesceDistance;
+	for (auto it = live.rbegin(); it != live.rend() && it->frame == frame; ++it)
+	{
+		if (DistanceSq(position, it->position) <= coalesceDistanceSq)
+		{
+			++statistics.coalesced;
+			return it->handle;
+		}
+	}
+
+	// --- 種類ごとの上限 (その種類の一番古いものを止める) ---
+	if (static_cast<int>(live.size()) >= setting.budget)
+	{
+		if (live.empty())
+		{
+			++statistics.rejected;
+			return -1;
+		}
+		StopOldest(effectIndex);
+		++statistics.stolen;
+	}
+	// --- 全体の上限 (優先度の一番低い種類の一番古いものを止める) ---
+	else if (totalLiveCount >= globalBudget)
+	{
+		int victim = -1;
+		for (int i = 0; i < static_cast<int>(EffectType::LAST); ++i)
+		{
+			if (lives[i].empty()) continue;
+			if (victim < 0 || settings[i].priority < settings[victim].priority) victim = i;
+		}
+		if (victim < 0 || settings[victim].priority > setting.priority)
+		{
+			++statistics.rejected;
+			return -1;
+		}
+		StopOldest(victim);
+		++statistics.stolen;
+	}
 
 	Effekseer::ManagerRef effekseerManager = EffectManager::Instance().GetEffekseerManager();
 
@@ -47,6 +153,10 @@ Effekseer::Handle Effect::Play(EffectType index, const DirectX::XMFLOAT3& positi
 		DirectX::XMConvertToRadians(angle.z),
 	};
 	effekseerManager->SetRotation(handle, radians.x, radians.y, radians.z);
+
+	live.push_back({ handle, frame, position });
+	++totalLiveCount;
+	++statistics.played;
 	return handle;
 }
 
@@ -82,3 +192,35 @@ void Effect::SetAngle(Effekseer::Handle handle, const DirectX::XMFLOAT3& angle)
 	effekseerManager->SetRotation(handle, angle.x, angle.y, angle.z);
 }
 
+// デバッグ用GUI描画
+void Effect::DrawDebugGui()
+{
+	if (ImGui::CollapsingHeader("Effect", ImGuiTreeNodeFlags_None))
+	{
+		ImGui::Checkbox("Culling", &enableCulling);
+		ImGui::SliderInt("Global Budget", &globalBudget, 1, 1024);
+		ImGui::Text("Live : %d / %d", totalLiveCount, globalBudget);
+		ImGui::Text("Played : %d  Culled : %d  Coalesced : %d", lastStatistics.played, lastStatistics.culled, lastStatistics.coalesced);
+		ImGui::Text("Stolen : %d  Rejected : %d", lastStatistics.stolen, lastStatistics.rejected);
+
+		for (int i = 0; i < static_cast<int>(EffectType::LAST); ++i)
+		{
+			ImGui::PushID(i);
+			ImGui::Text("%-8s %3d / %3d", effectTypeNames[i], static_cast<int>(lives[i].size()), settings[i].budget);
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(100);
+			ImGui::SliderInt("Budget", &settings[i].budget, 1, 256);
+			ImGui::PopID();
+		}
+	}
+}
+
+// 一番古いインスタンスを止める
+void Effect::StopOldest(int effectIndex)
+{
+	std::vector<Live>& live = lives[effectIndex];
+
+	EffectManager::Instance().GetEffekseerManager()->StopEffect(live.front().handle);
+	live.erase(live.begin());
+	--totalLiveCount;
+}
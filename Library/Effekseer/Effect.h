@@ -2,6 +2,8 @@
 
 #include <DirectXMath.h>
 #include <Effekseer.h>
+#include <vector>
+#include <cstdint>
 
 enum class EffectType
 {
@@ -14,6 +16,12 @@ enum class EffectType
 };
 
 // エフェクト
+// Play は呼び出し元と Effekseer::Manager の間で再生するかを決める
+//  ・カメラから遠いもの、視錐台の外のものは出さない
+//  ・同じフレームにほぼ同じ場所で出された同じエフェクトは 1 つにまとめる
+//  ・種類ごとの上限を超えたらその種類の一番古いものを止める
+//  ・全体の上限を超えたら優先度の一番低い種類の一番古いものを止める (新しい方が低ければ出さない)
+// 出さなかった時は -1 (無効なハンドル) を返す
 class Effect
 {
 private:
@@ -21,6 +29,27 @@ private:
 	~Effect() {}
 
 
+public:
+	// 種類ごとの再生設定
+	struct Setting
+	{
+		int budget = 32;				// 同時に出せる数
+		int priority = 0;				// 大きいほど優先 (全体の上限で他の種類の枠を奪える)
+		float radius = 2.0f;			// 視錐台判定に使う大きさ (scale を掛ける)
+		float cullDistance = 60.0f;		// カメラからこれより遠ければ出さない
+		float coalesceDistance = 0.5f;	// 同じフレームにこの距離内で出された同じエフェクトはまとめる
+	};
+
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		int played = 0;
+		int culled = 0;			// 距離・視錐台で出さなかった
+		int coalesced = 0;		// まとめた
+		int stolen = 0;			// 上限で止めた
+		int rejected = 0;		// 上限で出さなかった
+	};
+
 public:
 	static Effect& Instance()
 	{
@@ -32,9 +61,20 @@ public:
 	// 初期化
 	void Initialize();
 
+	// 更新処理 (終わったインスタンスを外し、フレームを進める)
+	void Update();
+
 	// データ作成
 	void CreateEffect(EffectType index, const char* filename);
 
+	// 再生設定
+	void SetSetting(EffectType index, const Setting& setting) { settings[static_cast<int>(index)] = setting; }
+	const Setting& GetSetting(EffectType index) const { return settings[static_cast<int>(index)]; }
+
+	// 生きているインスタンス数
+	int GetLiveCount(EffectType index) const { return static_cast<int>(lives[static_cast<int>(index)].size()); }
+	int GetTotalLiveCount() const { return totalLiveCount; }
+
 	// 再生
 	Effekseer::Handle Play(EffectType index, const DirectX::XMFLOAT3& position, DirectX::XMFLOAT3 angle, float scale = 1.0f);
 
@@ -50,6 +90,34 @@ public:
 	// 角度設定
 	void SetAngle(Effekseer::Handle handle, const DirectX::XMFLOAT3& angle);
 
+	// デバッグ用GUI描画
+	void DrawDebugGui();
+
+public:
+	int globalBudget = 256;			// 全体で同時に出せる数
+	bool enableCulling = true;
+
+private:
+	// 生きているインスタンス
+	struct Live
+	{
+		Effekseer::Handle handle;
+		uint32_t frame;					// 再生したフレーム
+		DirectX::XMFLOAT3 position;		// 再生した場所
+	};
+
+	// 一番古いインスタンスを止める
+	void StopOldest(int effectIndex);
+
 private:
 	Effekseer::EffectRef effekseerEffects[static_cast<int>(EffectType::LAST)];
+
+	Setting settings[static_cast<int>(EffectType::LAST)];
+	std::vector<Live> lives[static_cast<int>(EffectType::LAST)];	// 古い順
+	int totalLiveCount = 0;
+
+	uint32_t frame = 0;
+
+	Statistics statistics;
+	Statistics lastStatistics;
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "EffectManager.h"
+#include "Effect.h"
 #include "../Graphics/Graphics.h"
 #include "../Timer.h"
+#include "../MemoryTracker.h"
 
 
 // 初期化
@@ -39,13 +41,20 @@ void EffectManager::Finalize()
 // 更新処理
 void EffectManager::Update()
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::EFFECT);
+
 	// エフェクト更新処理
 	effekseerManager->Update(Timer::Instance().DeltaTime() * 60.0f);
+
+	// 終わったインスタンスを再生の管理から外す
+	Effect::Instance().Update();
 }
 
 // 描画処理
 void EffectManager::Render(const DirectX::XMFLOAT4X4& view, const DirectX::XMFLOAT4X4& projection)
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::EFFECT);
+
 	// ビュー＆プロジェクション行列をEffekseerレンダラに設定
 	effekseerRenderer->SetCameraMatrix(*reinterpret_cast<const Effekseer::Matrix44*>(&view));
 	effekseerRenderer->SetProjectionMatrix(*reinterpret_cast<const Effekseer::Matrix44*>(&projection));
@@ -59,4 +68,7 @@ void EffectManager::Render(const DirectX::XMFLOAT4X4& view, const DirectX::XMFLO
 
 	// Effekseer 描画終了
 	effekseerRenderer->EndRendering();
+
+	// Effekseer が deviceContext を直接触っているのでステートキャッシュの記憶を捨てる
+	Graphics::Instance().stateCache.Invalidate();
 }
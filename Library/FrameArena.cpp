@@ -0,0 +1,128 @@
+#include <cstdarg>
+#include <cstdio>
+#include <new>
+#include <sstream>
+#include "FrameArena.h"
+#include "ImGui/ConsoleData.h"
+#include "ImGui/Include/imgui.h"
+
+// 初期化
+void FrameArena::Initialize(size_t capacity)
+{
+	this->capacity = capacity;
+	for (Buffer& buffer : buffers)
+	{
+		Reset(buffer);
+		buffer.memory = std::make_unique<uint8_t[]>(capacity);
+	}
+	current = 0;
+
+	statistics = {};
+	lastStatistics = {};
+}
+
+// フレームの開始
+void FrameArena::BeginFrame()
+{
+	if (statistics.usedBytes > statistics.peakBytes) statistics.peakBytes = statistics.usedBytes;
+	lastStatistics = statistics;
+
+	// 2 つ前のフレームのバッファを捨てて使う (前のフレームのバッファはまだ残す)
+	current = 1 - current;
+	Reset(buffers[current]);
+
+	statistics = {};
+	statistics.peakBytes = lastStatistics.peakBytes;
+	overflowLogged = false;
+}
+
+// 確保
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	Buffer& buffer = buffers[current];
+	++statistics.allocations;
+
+	//--- < 揃えた位置から入れば、ポインタを進めるだけ > ---
+	if (buffer.memory)
+	{
+		const uintptr_t base = reinterpret_cast<uintptr_t>(buffer.memory.get());
+		const uintptr_t address = (base + buffer.offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+		const size_t end = static_cast<size_t>(address - base) + size;
+		if (end <= capacity)
+		{
+			statistics.usedBytes += end - buffer.offset;
+			buffer.offset = end;
+			return reinterpret_cast<void*>(address);
+		}
+	}
+
+	//--- < 入らなければヒープから取り、このバッファを捨てる時に解放する > ---
+	++statistics.overflowCount;
+	statistics.overflowBytes += size;
+	if (!overflowLogged)
+	{
+		std::ostringstream message;
+		message << "FrameArena overflow : " << size << " bytes (capacity " << capacity << " bytes)";
+		ConsoleData::Instance().Log(message.str());
+		overflowLogged = true;
+	}
+
+	void* memory = ::operator new(size, std::align_val_t(alignment));
+	buffer.overflowBlocks.push_back({ memory, alignment });
+	return memory;
+}
+
+// 書式付き文字列を作る
+const char* FrameArena::Format(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	const int length = _vscprintf(format, args);
+	va_end(args);
+	if (length < 0) return "";
+
+	char* text = AllocateArray<char>(length + 1);
+	va_start(args, format);
+	vsprintf_s(text, length + 1, format, args);
+	va_end(args);
+	return text;
+}
+
+const wchar_t* FrameArena::Format(const wchar_t* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	const int length = _vscwprintf(format, args);
+	va_end(args);
+	if (length < 0) return L"";
+
+	wchar_t* text = AllocateArray<wchar_t>(length + 1);
+	va_start(args, format);
+	vswprintf_s(text, length + 1, format, args);
+	va_end(args);
+	return text;
+}
+
+// バッファを空にする
+void FrameArena::Reset(Buffer& buffer)
+{
+	buffer.offset = 0;
+	for (const OverflowBlock& block : buffer.overflowBlocks)
+	{
+		::operator delete(block.memory, std::align_val_t(block.alignment));
+	}
+	buffer.overflowBlocks.clear();
+}
+
+// ImGui 描画
+void FrameArena::DrawDebugGui()
+{
+	if (ImGui::CollapsingHeader("FrameArena", ImGuiTreeNodeFlags_None))
+	{
+		const Statistics& s = lastStatistics;
+		ImGui::Text("Used : %.1f / %.1f KB", s.usedBytes / 1024.0, capacity / 1024.0);
+		ImGui::Text("Peak : %.1f KB", s.peakBytes / 1024.0);
+		ImGui::Text("Allocations : %u", s.allocations);
+		ImGui::Text("Overflow : %u (%.1f KB)", s.overflowCount, s.overflowBytes / 1024.0);
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------
+// FrameArena
+//--------------------------------------------------------------
+// フレームの中で使い捨てる一時データ用の線形アロケーター
+// 確保はポインタを進めるだけで、個別の解放はしない (バッファごとまとめて捨てる)
+//
+// バッファは 2 つあり、Graphics::Begin で交互に切り替える
+// 切り替えた時に捨てるのは 2 つ前のフレームのバッファなので、
+// Update (Graphics::Begin より前) で確保したものも、そのフレームの Render までは有効
+// (確保してから 2 回目の Graphics::Begin で無効になる)
+//
+// バッファに入らなかった確保はヒープから取り、そのバッファを捨てる時に一緒に解放する
+// (溢れた回数とバイト数は統計に出るので、容量を見直す目安にする)
+//
+// メインスレッド専用 (ワーカースレッドからは使わない)
+class FrameArena
+{
+public:
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		size_t usedBytes = 0;			// バッファから確保したバイト数
+		size_t peakBytes = 0;			// usedBytes の最大
+		uint32_t allocations = 0;
+		uint32_t overflowCount = 0;		// 入らずにヒープから取った回数
+		size_t overflowBytes = 0;
+	};
+
+	// バッファ 1 つの大きさ
+	static constexpr size_t DefaultCapacity = 1024 * 1024;
+
+private:
+	FrameArena() {}
+	~FrameArena() {}
+
+public:
+	static FrameArena& Instance()
+	{
+		static FrameArena instance;
+		return instance;
+	}
+
+	// 初期化
+	void Initialize(size_t capacity = DefaultCapacity);
+
+	// フレームの開始 (Graphics::Begin から呼ぶ、2 つ前のフレームのバッファを捨てて使う)
+	void BeginFrame();
+
+	// 確保 (解放は不要)
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	template<class T>
+	T* AllocateArray(size_t count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	// 書式付き文字列を作る (ImGui のラベルや表示用の文字列に使う)
+	const char* Format(const char* format, ...);
+	const wchar_t* Format(const wchar_t* format, ...);
+
+	// 前フレームの統計
+	const Statistics& GetStatistics() const { return lastStatistics; }
+	size_t GetCapacity() const { return capacity; }
+
+	// ImGui 描画
+	void DrawDebugGui();
+
+private:
+	// 入らずにヒープから取ったもの
+	struct OverflowBlock
+	{
+		void* memory;
+		size_t alignment;
+	};
+
+	struct Buffer
+	{
+		std::unique_ptr<uint8_t[]> memory;
+		size_t offset = 0;
+		std::vector<OverflowBlock> overflowBlocks;		// 捨てる時に解放する
+	};
+
+	// バッファを空にする
+	void Reset(Buffer& buffer);
+
+private:
+	Buffer buffers[2];
+	int current = 0;
+	size_t capacity = 0;
+
+	Statistics statistics;
+	Statistics lastStatistics;
+	bool overflowLogged = false;		// 溢れをログに出したか (1 フレームに 1 回だけ出す)
+};
+
+// FrameArena から確保する STL 用のアロケーター
+// deallocate は何もしないので、コンテナはフレームを跨いで持たないこと
+template<class T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	FrameAllocator() noexcept {}
+	template<class U>
+	FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+	T* allocate(size_t count)
+	{
+		return FrameArena::Instance().AllocateArray<T>(count);
+	}
+	void deallocate(T*, size_t) noexcept {}
+
+	template<class U>
+	bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+	template<class U>
+	bool operator!=(const FrameAllocator<U>&) const noexcept { return false; }
+};
+
+template<class T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+using FrameWString = std::basic_string<wchar_t, std::char_traits<wchar_t>, FrameAllocator<wchar_t>>;
@@ -11,8 +11,13 @@
 #include "Effekseer/Effect.h"
 #include "3D/DebugPrimitive.h"
 #include "3D/LineRenderer.h"
+#include "2D/Renderer2D.h"
 #include "../SceneManager.h"
 #include "Timer.h"
+#include "AsyncLoader.h"
+#include "MemoryTracker.h"
+#include "FrameArena.h"
+#include "3D/ResourceManager.h"
 
 // 初期化
 bool Framework::Initialize(HINSTANCE hInstance)
@@ -23,6 +28,9 @@ bool Framework::Initialize(HINSTANCE hInstance)
 	// --- Graphics初期化 ---
 	Graphics::Instance().Initialize(hwnd, screenWidth, screenHeight);
 
+	// --- FrameArena初期化 ---
+	FrameArena::Instance().Initialize();
+
 	// --- ImGui初期化 ---
 	ImGuiManager::Instance().Initialize(hwnd);
 
@@ -42,6 +50,12 @@ bool Framework::Initialize(HINSTANCE hInstance)
 	// --- LineRenderer 初期化 ---
 	LineRenderer::Instance().Initialize();
 
+	// --- Renderer2D 初期化 ---
+	Renderer2D::Instance().Initialize();
+
+	// --- AsyncLoader 初期化 ---
+	AsyncLoader::Instance().Initialize();
+
 	// --- シーン初期化 ---
 	SceneManager::Instance().ChangeScene(new SceneTitle);
 
@@ -78,6 +92,9 @@ void Framework::Update()
 			Timer::Instance().Tick();
 			CalculateFrame();
 
+			// --- 確保の集計をフレームで区切る ---
+			MemoryTracker::Instance().BeginFrame();
+
 			// --- inputManager処理 ---
 			InputManager::Instance().Update();
 
@@ -85,12 +102,18 @@ void Framework::Update()
 			ImGuiManager::Instance().Update();
 			SceneManager::Instance().Update();
 			EffectManager::Instance().Update();
+			AudioManager::Instance().Update();
+			// 読み込みの終わった GPU リソースの作成 (1 フレームの予算内)
+			AsyncLoader::Instance().ProcessUploads();
 
 			// --- シーン描画 ---
 			std::lock_guard<std::mutex>	lock(Graphics::Instance().GetMutex());	// 排他制御
 
 			Graphics::Instance().Begin();
+			Renderer2D::Instance().BeginFrame();
 			SceneManager::Instance().Render();
+			// シーンが Flush していない 2D 描画を描く
+			Renderer2D::Instance().Flush();
 			ImGuiManager::Instance().Render();
 			Graphics::Instance().End();
 		}
@@ -100,6 +123,9 @@ void Framework::Update()
 // 終了化
 void Framework::Finalize()
 {
+	// --- AsyncLoader終了化 (シーンより先にワーカーを止める) ---
+	AsyncLoader::Instance().Finalize();
+
 	// --- EffectManager終了化 ---
 	EffectManager::Instance().Finalize();
 
@@ -108,6 +134,9 @@ void Framework::Finalize()
 
 	// --- SceneManager終了化 ---
 	SceneManager::Instance().Clear();
+
+	// --- 常駐させているモデルの解放 ---
+	ResourceManager::Instance().Clear();
 }
 
 // ウィンドウ作成
@@ -0,0 +1,90 @@
+#include <cstring>
+#include "ConstantRingBuffer.h"
+#include "StateCache.h"
+#include "../ErrorLogger.h"
+
+// 初期化
+void ConstantRingBuffer::Initialize(ID3D11Device* device, StateCache* stateCache, UINT capacity)
+{
+	this->stateCache = stateCache;
+	this->capacity = (capacity + Alignment - 1) & ~(Alignment - 1);
+
+	// オフセット指定の設定 (D3D11.1) が必要
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+	HRESULT hr = device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	_ASSERT_EXPR(options.ConstantBufferOffsetting, L"ConstantBufferOffsetting is not supported.");
+	noOverwriteSupported = options.MapNoOverwriteOnDynamicConstantBuffer != FALSE;
+
+	D3D11_BUFFER_DESC bufferDesc{};
+	bufferDesc.ByteWidth = this->capacity;
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = 0;
+	bufferDesc.StructureByteStride = 0;
+	hr = device->CreateBuffer(&bufferDesc, nullptr, buffer.ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	// 最初の書き込みは DISCARD にしたいので、端にいることにしておく
+	offset = this->capacity;
+}
+
+// 定数を書き込んで範囲を返す
+ConstantRingBuffer::Allocation ConstantRingBuffer::Upload(const void* data, UINT size)
+{
+	const Block block = { data, size };
+	Allocation allocation;
+	UploadBlocks(&block, 1, &allocation);
+	return allocation;
+}
+
+// 1 回の描画で使う定数をまとめて書き込む
+void ConstantRingBuffer::UploadBlocks(const Block* blocks, UINT count, Allocation* allocations)
+{
+	// 全てのブロックの合計 (ブロックごとに 256 バイト境界に揃える)
+	UINT totalSize = 0;
+	for (UINT i = 0; i < count; ++i)
+	{
+		totalSize += (blocks[i].size + Alignment - 1) & ~(Alignment - 1);
+	}
+	_ASSERT_EXPR(totalSize <= capacity, L"ConstantRingBuffer capacity exceeded.");
+
+	// 入りきらなければ、どれを書くよりも先に先頭へ戻る (GPU が使用中の古い内容はドライバが別に保持する)
+	D3D11_MAP mapType = noOverwriteSupported ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD;
+	if (offset + totalSize > capacity)
+	{
+		offset = 0;
+		mapType = D3D11_MAP_WRITE_DISCARD;
+		statistics.wrapCount++;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mappedSubresource{};
+	HRESULT hr = stateCache->Map(buffer.Get(), 0, mapType, 0, &mappedSubresource);
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	UINT writtenBytes = 0;
+	for (UINT i = 0; i < count; ++i)
+	{
+		const UINT alignedSize = (blocks[i].size + Alignment - 1) & ~(Alignment - 1);
+		std::memcpy(static_cast<uint8_t*>(mappedSubresource.pData) + offset, blocks[i].data, blocks[i].size);
+
+		allocations[i].buffer = buffer.Get();
+		allocations[i].firstConstant = offset / 16;
+		allocations[i].numConstants = alignedSize / 16;
+
+		offset += alignedSize;
+		writtenBytes += blocks[i].size;
+	}
+	stateCache->Unmap(buffer.Get(), 0, writtenBytes);
+
+	statistics.uploadCount += count;
+	statistics.uploadedBytes += totalSize;
+}
+
+// フレームの開始
+void ConstantRingBuffer::BeginFrame()
+{
+	lastStatistics = statistics;
+	statistics = {};
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <cstdint>
+
+class StateCache;
+
+//--------------------------------------------------------------
+// ConstantRingBuffer
+//--------------------------------------------------------------
+// 描画ごとに変わる定数をひとつの大きな動的バッファへ詰めていく
+// 書き込みは MAP_WRITE_NO_OVERWRITE で末尾に追記し、端まで来たら DISCARD して先頭へ戻る
+// 設定は *SSetConstantBuffers1 のオフセット指定で行う (StateCache::VSSetConstantBuffers1 など)
+//
+// 書き込んだ範囲は次の周回で上書きされるまで有効なので、Upload してから描画までの間に
+// 他の Upload で一周しないこと (容量は 1 フレーム分の定数より十分大きくしておく)
+//
+// DISCARD (先頭へ戻った時、NO_OVERWRITE が使えない環境では毎回) するとそれまでに設定した範囲は無効になるので、
+// 1 回の描画で使う定数が複数ある時は UploadBlocks でまとめて書き込む (1 回の Map で全て書くので、途中で無効にならない)
+class ConstantRingBuffer
+{
+public:
+	// 割り当てた範囲 (*SSetConstantBuffers1 にそのまま渡す)
+	struct Allocation
+	{
+		ID3D11Buffer* buffer = nullptr;
+		UINT firstConstant = 0;		// 16 バイト単位
+		UINT numConstants = 0;		// 16 バイト単位 (16 の倍数)
+	};
+
+	// UploadBlocks に渡す定数 1 つ分
+	struct Block
+	{
+		const void* data = nullptr;
+		UINT size = 0;
+	};
+
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		uint32_t uploadCount = 0;
+		uint32_t uploadedBytes = 0;		// 256 バイト境界に揃えた後のサイズ
+		uint32_t wrapCount = 0;
+	};
+
+	// *SSetConstantBuffers1 のオフセットは 256 バイト (16 定数) 単位
+	static constexpr UINT Alignment = 256;
+
+public:
+	ConstantRingBuffer() {}
+	~ConstantRingBuffer() {}
+
+	// 初期化 (capacity は Alignment の倍数に切り上げる)
+	void Initialize(ID3D11Device* device, StateCache* stateCache, UINT capacity);
+
+	// 定数を書き込んで範囲を返す
+	Allocation Upload(const void* data, UINT size);
+
+	// 1 回の描画で使う定数をまとめて書き込む (全体が入る位置を先に決めてから 1 回の Map で書く)
+	void UploadBlocks(const Block* blocks, UINT count, Allocation* allocations);
+
+	// フレームの開始 (統計を前フレーム分へ移す)
+	void BeginFrame();
+
+	// 前フレームの統計
+	const Statistics& GetStatistics() const { return lastStatistics; }
+	UINT GetCapacity() const { return capacity; }
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+	StateCache* stateCache = nullptr;	// 書き込みはここを通す (流し先の差し替えに従う)
+
+	UINT capacity = 0;
+	UINT offset = 0;
+
+	// NO_OVERWRITE での Map ができない環境では毎回 DISCARD する
+	bool noOverwriteSupported = false;
+
+	Statistics statistics;
+	Statistics lastStatistics;
+};
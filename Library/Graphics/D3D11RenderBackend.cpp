@@ -0,0 +1,140 @@
+#include "D3D11RenderBackend.h"
+#include "Graphics.h"
+
+// パイプラインの登録
+uint32_t D3D11RenderBackend::RegisterPipeline(ID3D11VertexShader* vertexShader, ID3D11PixelShader* pixelShader, ID3D11InputLayout* inputLayout, UINT objectSlot, UINT skeletonSlot)
+{
+	Pipeline pipeline;
+	pipeline.vertexShader = vertexShader;
+	pipeline.pixelShader = pixelShader;
+	pipeline.inputLayout = inputLayout;
+	pipeline.objectSlot = objectSlot;
+	pipeline.skeletonSlot = skeletonSlot;
+	return pipelines.Register(pipeline);
+}
+
+// マテリアルの登録
+uint32_t D3D11RenderBackend::RegisterMaterial(ID3D11Buffer* constantBuffer, UINT constantBufferSlot)
+{
+	Material material;
+	material.constantBuffer = constantBuffer;
+	material.constantBufferSlot = constantBufferSlot;
+	return materials.Register(material);
+}
+
+// テクスチャセットの登録
+uint32_t D3D11RenderBackend::RegisterTextureSet(ID3D11ShaderResourceView* const shaderResourceViews[4])
+{
+	TextureSet textureSet;
+	for (int i = 0; i < 4; i++)
+	{
+		textureSet.shaderResourceViews[i] = shaderResourceViews[i];
+	}
+	return textureSets.Register(textureSet);
+}
+
+// ジオメトリの登録
+uint32_t D3D11RenderBackend::RegisterGeometry(ID3D11Buffer* vertexBuffer, UINT stride, ID3D11Buffer* indexBuffer, DXGI_FORMAT indexFormat)
+{
+	Geometry geometry;
+	geometry.vertexBuffer = vertexBuffer;
+	geometry.indexBuffer = indexBuffer;
+	geometry.stride = stride;
+	geometry.indexFormat = indexFormat;
+	return geometries.Register(geometry);
+}
+
+void D3D11RenderBackend::BindPipeline(uint32_t pipeline)
+{
+	Graphics& gfx = Graphics::Instance();
+	const Pipeline& item = pipelines.items.at(pipeline);
+
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	gfx.stateCache.IASetInputLayout(item.inputLayout.Get());
+	gfx.stateCache.VSSetShader(item.vertexShader.Get(), nullptr, 0);
+	gfx.stateCache.PSSetShader(item.pixelShader.Get(), nullptr, 0);
+
+	currentPipeline = pipeline;
+}
+
+void D3D11RenderBackend::BindRenderState(uint32_t renderState)
+{
+	Graphics::Instance().SetRasterizer(static_cast<RASTERIZER_STATE>(renderState));
+}
+
+void D3D11RenderBackend::BindMaterial(uint32_t material)
+{
+	Graphics& gfx = Graphics::Instance();
+	const Material& item = materials.items.at(material);
+
+	gfx.stateCache.VSSetConstantBuffers(item.constantBufferSlot, 1, item.constantBuffer.GetAddressOf());
+	gfx.stateCache.PSSetConstantBuffers(item.constantBufferSlot, 1, item.constantBuffer.GetAddressOf());
+}
+
+void D3D11RenderBackend::BindTextureSet(uint32_t textureSet)
+{
+	const TextureSet& item = textureSets.items.at(textureSet);
+
+	ID3D11ShaderResourceView* shaderResourceViews[4];
+	for (int i = 0; i < 4; i++)
+	{
+		shaderResourceViews[i] = item.shaderResourceViews[i].Get();
+	}
+	Graphics::Instance().stateCache.PSSetShaderResources(0, 4, shaderResourceViews);
+}
+
+void D3D11RenderBackend::BindGeometry(uint32_t geometry)
+{
+	Graphics& gfx = Graphics::Instance();
+	const Geometry& item = geometries.items.at(geometry);
+
+	const UINT offset = 0;
+	gfx.stateCache.IASetVertexBuffers(0, 1, item.vertexBuffer.GetAddressOf(), &item.stride, &offset);
+	gfx.stateCache.IASetIndexBuffer(item.indexBuffer.Get(), item.indexFormat, 0);
+}
+
+void D3D11RenderBackend::UpdateConstants(const void* const data[CONSTANTS_COUNT], const uint32_t size[CONSTANTS_COUNT])
+{
+	Graphics& gfx = Graphics::Instance();
+	const Pipeline& item = pipelines.items.at(currentPipeline);
+
+	// この描画で使う定数をまとめてリングバッファに書き込む
+	// (1 回の Map で書くので、一周して DISCARD しても先に書いた方が無効にならない)
+	ConstantRingBuffer::Block blocks[CONSTANTS_COUNT];
+	CONSTANTS types[CONSTANTS_COUNT];
+	UINT count = 0;
+	for (uint32_t i = 0; i < CONSTANTS_COUNT; i++)
+	{
+		if (size[i] == 0) continue;
+		blocks[count] = { data[i], size[i] };
+		types[count] = static_cast<CONSTANTS>(i);
+		count++;
+	}
+	if (count == 0) return;
+
+	ConstantRingBuffer::Allocation allocations[CONSTANTS_COUNT];
+	gfx.constantRingBuffer.UploadBlocks(blocks, count, allocations);
+
+	// その範囲を設定する
+	for (UINT i = 0; i < count; i++)
+	{
+		const ConstantRingBuffer::Allocation& allocation = allocations[i];
+		switch (types[i])
+		{
+		case OBJECT_CONSTANTS:
+			gfx.stateCache.VSSetConstantBuffers1(item.objectSlot, 1, &allocation.buffer, &allocation.firstConstant, &allocation.numConstants);
+			gfx.stateCache.PSSetConstantBuffers1(item.objectSlot, 1, &allocation.buffer, &allocation.firstConstant, &allocation.numConstants);
+			break;
+		case SKELETON_CONSTANTS:
+			gfx.stateCache.VSSetConstantBuffers1(item.skeletonSlot, 1, &allocation.buffer, &allocation.firstConstant, &allocation.numConstants);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void D3D11RenderBackend::DrawIndexed(uint32_t indexCount, uint32_t startIndexLocation, int32_t baseVertexLocation)
+{
+	Graphics::Instance().stateCache.DrawIndexed(indexCount, startIndexLocation, baseVertexLocation);
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <vector>
+#include "RenderQueue.h"
+
+//--------------------------------------------------------------
+// D3D11RenderBackend
+//--------------------------------------------------------------
+// RenderQueue のパケットを D3D11 の呼び出しに変換する
+// リソースは登録時に id を払い出し、同じオブジェクトの組み合わせは同じ id を返す
+class D3D11RenderBackend : public RenderBackend
+{
+private:
+	D3D11RenderBackend() {}
+	~D3D11RenderBackend() override {}
+
+public:
+	static D3D11RenderBackend& Instance()
+	{
+		static D3D11RenderBackend instance;
+		return instance;
+	}
+
+	// --- 登録 (戻り値は RenderQueue::Packet に入れる id) ---
+
+	// シェーダー・入力レイアウトと描画ごとの定数の設定先
+	// (オブジェクト定数は VS・PS の objectSlot 番、ボーン行列は VS の skeletonSlot 番)
+	uint32_t RegisterPipeline(ID3D11VertexShader* vertexShader, ID3D11PixelShader* pixelShader, ID3D11InputLayout* inputLayout, UINT objectSlot, UINT skeletonSlot);
+	// マテリアル定数バッファ (VS・PS の slot 番)
+	uint32_t RegisterMaterial(ID3D11Buffer* constantBuffer, UINT constantBufferSlot);
+	// テクスチャ 4 枚 (PS の 0 ~ 3 番)
+	uint32_t RegisterTextureSet(ID3D11ShaderResourceView* const shaderResourceViews[4]);
+	// 頂点・インデックスバッファ
+	uint32_t RegisterGeometry(ID3D11Buffer* vertexBuffer, UINT stride, ID3D11Buffer* indexBuffer, DXGI_FORMAT indexFormat);
+
+	// --- 解放 (参照数が 0 になった id は再利用される) ---
+	void ReleasePipeline(uint32_t id) { pipelines.Release(id); }
+	void ReleaseMaterial(uint32_t id) { materials.Release(id); }
+	void ReleaseTextureSet(uint32_t id) { textureSets.Release(id); }
+	void ReleaseGeometry(uint32_t id) { geometries.Release(id); }
+
+	// --- RenderBackend ---
+	void BindPipeline(uint32_t pipeline) override;
+	void BindRenderState(uint32_t renderState) override;
+	void BindMaterial(uint32_t material) override;
+	void BindTextureSet(uint32_t textureSet) override;
+	void BindGeometry(uint32_t geometry) override;
+	void UpdateConstants(const void* const data[CONSTANTS_COUNT], const uint32_t size[CONSTANTS_COUNT]) override;
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndexLocation, int32_t baseVertexLocation) override;
+
+private:
+	struct Pipeline
+	{
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
+		UINT objectSlot = 0;
+		UINT skeletonSlot = 0;
+
+		bool operator==(const Pipeline& other) const
+		{
+			return vertexShader == other.vertexShader && pixelShader == other.pixelShader && inputLayout == other.inputLayout &&
+				objectSlot == other.objectSlot && skeletonSlot == other.skeletonSlot;
+		}
+	};
+
+	struct Material
+	{
+		Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
+		UINT constantBufferSlot = 0;
+
+		bool operator==(const Material& other) const { return constantBuffer == other.constantBuffer && constantBufferSlot == other.constantBufferSlot; }
+	};
+
+	struct TextureSet
+	{
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceViews[4];
+
+		bool operator==(const TextureSet& other) const
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				if (shaderResourceViews[i] != other.shaderResourceViews[i]) return false;
+			}
+			return true;
+		}
+	};
+
+	struct Geometry
+	{
+		Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
+		UINT stride = 0;
+		DXGI_FORMAT indexFormat = DXGI_FORMAT_R32_UINT;
+
+		bool operator==(const Geometry& other) const
+		{
+			return vertexBuffer == other.vertexBuffer && indexBuffer == other.indexBuffer && stride == other.stride && indexFormat == other.indexFormat;
+		}
+	};
+
+	// 参照数付きの登録表
+	template<class T>
+	struct Table
+	{
+		std::vector<T> items;
+		std::vector<uint32_t> referenceCounts;
+
+		uint32_t Register(const T& item)
+		{
+			// 同じものがあれば共有する
+			uint32_t freeId = static_cast<uint32_t>(items.size());
+			for (uint32_t id = 0; id < items.size(); id++)
+			{
+				if (referenceCounts[id] == 0)
+				{
+					if (freeId == items.size()) freeId = id;
+					continue;
+				}
+				if (items[id] == item)
+				{
+					referenceCounts[id]++;
+					return id;
+				}
+			}
+
+			if (freeId == items.size())
+			{
+				items.emplace_back(item);
+				referenceCounts.emplace_back(1);
+			}
+			else
+			{
+				items[freeId] = item;
+				referenceCounts[freeId] = 1;
+			}
+			return freeId;
+		}
+
+		void Release(uint32_t id)
+		{
+			if (id >= items.size() || referenceCounts[id] == 0) return;
+
+			if (--referenceCounts[id] == 0) items[id] = T();
+		}
+	};
+
+	Table<Pipeline> pipelines;
+	Table<Material> materials;
+	Table<TextureSet> textureSets;
+	Table<Geometry> geometries;
+
+	// 現在のパイプライン (UpdateConstants の設定先)
+	uint32_t currentPipeline = 0;
+};
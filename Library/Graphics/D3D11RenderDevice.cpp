@@ -0,0 +1,24 @@
+#include <crtdbg.h>
+#include "D3D11RenderDevice.h"
+
+// 対象の deviceContext 設定
+void D3D11RenderDevice::SetContext(ID3D11DeviceContext* context)
+{
+	this->context = context;
+
+	// 範囲指定の定数バッファ設定用 (D3D11.1)
+	context1.Reset();
+	if (context) context->QueryInterface(IID_PPV_ARGS(context1.GetAddressOf()));
+}
+
+void D3D11RenderDevice::VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	_ASSERT_EXPR(context1 != nullptr, L"ID3D11DeviceContext1 is not available.");
+	context1->VSSetConstantBuffers1(startSlot, numBuffers, buffers, firstConstants, numConstants);
+}
+
+void D3D11RenderDevice::PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	_ASSERT_EXPR(context1 != nullptr, L"ID3D11DeviceContext1 is not available.");
+	context1->PSSetConstantBuffers1(startSlot, numBuffers, buffers, firstConstants, numConstants);
+}
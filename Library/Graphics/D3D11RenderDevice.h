@@ -0,0 +1,55 @@
+#pragma once
+#include <d3d11_1.h>
+#include <wrl/client.h>
+#include "RenderDevice.h"
+
+//--------------------------------------------------------------
+// D3D11RenderDevice
+//--------------------------------------------------------------
+// RenderDevice の呼び出しをそのまま immediate context へ流す
+// 範囲指定の定数バッファは ID3D11DeviceContext1 を使う
+class D3D11RenderDevice : public RenderDevice
+{
+public:
+	D3D11RenderDevice() {}
+	~D3D11RenderDevice() override {}
+
+	void SetContext(ID3D11DeviceContext* context);
+
+	// --- RenderDevice ---
+	void VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) override { context->VSSetShader(shader, classInstances, numClassInstances); }
+	void PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) override { context->PSSetShader(shader, classInstances, numClassInstances); }
+	void IASetInputLayout(ID3D11InputLayout* inputLayout) override { context->IASetInputLayout(inputLayout); }
+	void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) override { context->IASetPrimitiveTopology(topology); }
+	void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets) override { context->IASetVertexBuffers(startSlot, numBuffers, buffers, strides, offsets); }
+	void IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset) override { context->IASetIndexBuffer(buffer, format, offset); }
+	void VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) override { context->VSSetConstantBuffers(startSlot, numBuffers, buffers); }
+	void PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) override { context->PSSetConstantBuffers(startSlot, numBuffers, buffers); }
+	void VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants) override;
+	void PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants) override;
+	void VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) override { context->VSSetShaderResources(startSlot, numViews, views); }
+	void PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) override { context->PSSetShaderResources(startSlot, numViews, views); }
+	void VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) override { context->VSSetSamplers(startSlot, numSamplers, samplers); }
+	void PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) override { context->PSSetSamplers(startSlot, numSamplers, samplers); }
+	void RSSetState(ID3D11RasterizerState* state) override { context->RSSetState(state); }
+	void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) override { context->RSSetViewports(numViewports, viewports); }
+	void RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports) override { context->RSGetViewports(numViewports, viewports); }
+	void OMSetBlendState(ID3D11BlendState* state, const FLOAT blendFactor[4], UINT sampleMask) override { context->OMSetBlendState(state, blendFactor, sampleMask); }
+	void OMSetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef) override { context->OMSetDepthStencilState(state, stencilRef); }
+	void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) override { context->OMSetRenderTargets(numViews, renderTargetViews, depthStencilView); }
+	void OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView) override { context->OMGetRenderTargets(numViews, renderTargetViews, depthStencilView); }
+	void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4]) override { context->ClearRenderTargetView(renderTargetView, color); }
+	void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) override { context->ClearDepthStencilView(depthStencilView, clearFlags, depth, stencil); }
+	HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) override { return context->Map(resource, subresource, mapType, mapFlags, mappedResource); }
+	void Unmap(ID3D11Resource* resource, UINT subresource, UINT writtenBytes) override { context->Unmap(resource, subresource); }
+	void UpdateSubresource(ID3D11Resource* resource, UINT subresource, const D3D11_BOX* box, const void* data, UINT rowPitch, UINT depthPitch) override { context->UpdateSubresource(resource, subresource, box, data, rowPitch, depthPitch); }
+	void CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT x, UINT y, UINT z, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox) override { context->CopySubresourceRegion(destination, destinationSubresource, x, y, z, source, sourceSubresource, sourceBox); }
+	void Draw(UINT vertexCount, UINT startVertexLocation) override { context->Draw(vertexCount, startVertexLocation); }
+	void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) override { context->DrawIndexed(indexCount, startIndexLocation, baseVertexLocation); }
+	void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) override { context->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation); }
+	void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) override { context->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation); }
+
+private:
+	ID3D11DeviceContext* context = nullptr;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1;
+};
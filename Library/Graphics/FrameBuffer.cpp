@@ -146,8 +146,8 @@ void FrameBuffer::Clear(float r, float g, float b, float a, float depth)
 
 	float color[4] = { r,g,b,a };
 	for (int i = 0; i < 2; i++) {
-		gfx.deviceContext->ClearRenderTargetView(renderTargetViews[i].Get(), color);
-		gfx.deviceContext->ClearDepthStencilView(depthStencilViews[i].Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depth, 0);
+		gfx.stateCache.ClearRenderTargetView(renderTargetViews[i].Get(), color);
+		gfx.stateCache.ClearDepthStencilView(depthStencilViews[i].Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depth, 0);
 	}
 	//gfx.deviceContext->ClearRenderTargetView(renderTargetViews->Get(), color);
 }
@@ -157,24 +157,24 @@ void FrameBuffer::Activate()
 	Graphics& gfx = Graphics::Instance();
 
 	viewportCount = D3D10_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
-	gfx.deviceContext->RSGetViewports(&viewportCount, cachedViewports);
-	gfx.deviceContext->OMGetRenderTargets(1, cachedRenderTargetView.ReleaseAndGetAddressOf(), cachedDepthStencilView.ReleaseAndGetAddressOf());
-	gfx.deviceContext->RSSetViewports(1, &viewport);
+	gfx.stateCache.RSGetViewports(&viewportCount, cachedViewports);
+	gfx.stateCache.OMGetRenderTargets(1, cachedRenderTargetView.ReleaseAndGetAddressOf(), cachedDepthStencilView.ReleaseAndGetAddressOf());
+	gfx.stateCache.RSSetViewports(1, &viewport);
 
 	ID3D11RenderTargetView* rtv[2] = {
 		renderTargetViews[0].Get(),
 		renderTargetViews[1].Get(),
 	};
 
-	gfx.deviceContext->OMSetRenderTargets(2, rtv, depthStencilViews[0].Get());
+	gfx.stateCache.OMSetRenderTargets(2, rtv, depthStencilViews[0].Get());
 }
 
 void FrameBuffer::DeActivate()
 {
 	Graphics& gfx = Graphics::Instance();
 
-	gfx.deviceContext->RSSetViewports(viewportCount, cachedViewports);
-	gfx.deviceContext->OMSetRenderTargets(1, cachedRenderTargetView.GetAddressOf(), cachedDepthStencilView.Get());
+	gfx.stateCache.RSSetViewports(viewportCount, cachedViewports);
+	gfx.stateCache.OMSetRenderTargets(1, cachedRenderTargetView.GetAddressOf(), cachedDepthStencilView.Get());
 }
 
 void FrameBuffer::ShadowActivate()
@@ -182,18 +182,18 @@ void FrameBuffer::ShadowActivate()
 	Graphics& gfx = Graphics::Instance();
 
 	viewportCount = D3D10_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
-	gfx.deviceContext->RSGetViewports(&viewportCount, cachedViewports);
-	gfx.deviceContext->OMGetRenderTargets(1, cachedRenderTargetView.ReleaseAndGetAddressOf(), cachedDepthStencilView.ReleaseAndGetAddressOf());
-	gfx.deviceContext->RSSetViewports(1, &viewport);
+	gfx.stateCache.RSGetViewports(&viewportCount, cachedViewports);
+	gfx.stateCache.OMGetRenderTargets(1, cachedRenderTargetView.ReleaseAndGetAddressOf(), cachedDepthStencilView.ReleaseAndGetAddressOf());
+	gfx.stateCache.RSSetViewports(1, &viewport);
 
-	gfx.deviceContext->OMSetRenderTargets(0, nullptr, depthStencilViews[1].Get());
+	gfx.stateCache.OMSetRenderTargets(0, nullptr, depthStencilViews[1].Get());
 }
 
 void FrameBuffer::ShadowDeActivate()
 {
 	Graphics& gfx = Graphics::Instance();
 
-	gfx.deviceContext->RSSetViewports(viewportCount, cachedViewports);
-	gfx.deviceContext->OMSetRenderTargets(1, cachedRenderTargetView.GetAddressOf(), cachedDepthStencilView.Get());
+	gfx.stateCache.RSSetViewports(viewportCount, cachedViewports);
+	gfx.stateCache.OMSetRenderTargets(1, cachedRenderTargetView.GetAddressOf(), cachedDepthStencilView.Get());
 }
 
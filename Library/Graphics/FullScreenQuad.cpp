@@ -13,34 +13,34 @@ void FullScreenQuad::blit(ID3D11ShaderResourceView** shaderResourceView, uint32_
 {
 	Graphics& gfx = Graphics::Instance();
 
-	gfx.deviceContext->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
-	gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-	gfx.deviceContext->IASetInputLayout(nullptr);
+	gfx.stateCache.IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	gfx.stateCache.IASetInputLayout(nullptr);
 
-	replacedVertexShader ? gfx.deviceContext->VSSetShader(replacedVertexShader, 0, 0) : gfx.deviceContext->VSSetShader(embeddedVertexShader.Get(), 0, 0);
-	replacedPixelShader ? gfx.deviceContext->PSSetShader(replacedPixelShader, 0, 0) : gfx.deviceContext->PSSetShader(embeddedPixelShader.Get(), 0, 0);
+	replacedVertexShader ? gfx.stateCache.VSSetShader(replacedVertexShader, 0, 0) : gfx.stateCache.VSSetShader(embeddedVertexShader.Get(), 0, 0);
+	replacedPixelShader ? gfx.stateCache.PSSetShader(replacedPixelShader, 0, 0) : gfx.stateCache.PSSetShader(embeddedPixelShader.Get(), 0, 0);
 
-	gfx.deviceContext->PSSetShaderResources(startSlot, numViews, shaderResourceView);
-	gfx.deviceContext->VSSetShaderResources(startSlot, numViews, shaderResourceView);
-	gfx.deviceContext->Draw(4, 0);
+	gfx.stateCache.PSSetShaderResources(startSlot, numViews, shaderResourceView);
+	gfx.stateCache.VSSetShaderResources(startSlot, numViews, shaderResourceView);
+	gfx.stateCache.Draw(4, 0);
 }
 
 void FullScreenQuad::blit(ID3D11ShaderResourceView** shaderResourceView, ID3D11ShaderResourceView** bloomFilterViews, uint32_t startSlot, uint32_t numViews, ID3D11PixelShader* replacedPixelShader, ID3D11VertexShader* replacedVertexShader)
 {
 	Graphics& gfx = Graphics::Instance();
 
-	gfx.deviceContext->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
-	gfx.deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-	gfx.deviceContext->IASetInputLayout(nullptr);
+	gfx.stateCache.IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
+	gfx.stateCache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	gfx.stateCache.IASetInputLayout(nullptr);
 
-	replacedVertexShader ? gfx.deviceContext->VSSetShader(replacedVertexShader, 0, 0) : gfx.deviceContext->VSSetShader(embeddedVertexShader.Get(), 0, 0);
-	replacedPixelShader ? gfx.deviceContext->PSSetShader(replacedPixelShader, 0, 0) : gfx.deviceContext->PSSetShader(embeddedPixelShader.Get(), 0, 0);
+	replacedVertexShader ? gfx.stateCache.VSSetShader(replacedVertexShader, 0, 0) : gfx.stateCache.VSSetShader(embeddedVertexShader.Get(), 0, 0);
+	replacedPixelShader ? gfx.stateCache.PSSetShader(replacedPixelShader, 0, 0) : gfx.stateCache.PSSetShader(embeddedPixelShader.Get(), 0, 0);
 
-	gfx.deviceContext->PSSetShaderResources(startSlot, numViews, shaderResourceView);
-	gfx.deviceContext->VSSetShaderResources(startSlot, numViews, shaderResourceView);
+	gfx.stateCache.PSSetShaderResources(startSlot, numViews, shaderResourceView);
+	gfx.stateCache.VSSetShaderResources(startSlot, numViews, shaderResourceView);
 
 
-	gfx.deviceContext->Draw(4, 0);
+	gfx.stateCache.Draw(4, 0);
 }
 
 
@@ -4,6 +4,7 @@
 #include "../ErrorLogger.h"
 #include "../AdapterReader.h"
 #include "Shader.h"
+#include "../FrameArena.h"
 
 
 
@@ -86,7 +87,7 @@ void Graphics::CreateSwapchain(HWND hwnd, int windowWidth, int windowHeight)
 	CD3D11_VIEWPORT viewport(0.0f, 0.0f, static_cast<float>(windowWidth), static_cast<float>(windowHeight));
 
 	// viewportの設定(Rasterizerの設定)
-	this->deviceContext->RSSetViewports(1, &viewport);
+	stateCache.RSSetViewports(1, &viewport);
 }
 
 // 初期化
@@ -153,6 +154,11 @@ void Graphics::Initialize(HWND hwnd, int windowWidth, int windowHeight)
 	);
 	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 
+	d3d11RenderDevice.SetContext(this->deviceContext.Get());
+	stateCache.SetDevice(&d3d11RenderDevice);
+	constantRingBuffer.Initialize(this->device.Get(), &stateCache, 4 * 1024 * 1024);
+	lightClusterBuffer.Initialize(this->device.Get());
+
 	// ---------------------------- renderTargetView の作成 -----------------------------
 
 	// renderTargetのバッファーを取得
@@ -222,7 +228,7 @@ void Graphics::Initialize(HWND hwnd, int windowWidth, int windowHeight)
 	CD3D11_VIEWPORT viewport(0.0f, 0.0f, static_cast<float>(windowWidth), static_cast<float>(windowHeight));
 
 	// viewportの設定(Rasterizerの設定)
-	this->deviceContext->RSSetViewports(1, &viewport);
+	stateCache.RSSetViewports(1, &viewport);
 
 
 	// ------------------------------- rasterizer の作成 --------------------------------
@@ -464,37 +470,62 @@ void Graphics::Initialize(HWND hwnd, int windowWidth, int windowHeight)
 }
 
 
+// 描画の流し先の差し替え
+void Graphics::SetRenderDevice(RenderDevice* renderDevice)
+{
+	stateCache.SetDevice(renderDevice ? renderDevice : &d3d11RenderDevice);
+}
+
+// 描画の呼び出しを数える
+void Graphics::SetRecording(bool enable, bool headless)
+{
+	this->headless = enable && headless;
+	recordingRenderDevice.SetNext(this->headless ? nullptr : &d3d11RenderDevice);
+	SetRenderDevice(enable ? &recordingRenderDevice : nullptr);
+}
+
 // 描画開始
 void Graphics::Begin()
 {
+	// ステートキャッシュの統計を締めて、覚えている内容を捨てる
+	stateCache.BeginFrame();
+	constantRingBuffer.BeginFrame();
+	recordingRenderDevice.BeginFrame();
+
+	// フレームの一時データ用のバッファを切り替える
+	FrameArena::Instance().BeginFrame();
+
 	// 画面クリア＆レンダーターゲット設定
 	float bgcolor[] = { 0.5f, 0.5f, 0.5f, 1.0f };	// 背景色
 	// renderTargetのクリア
-	deviceContext->ClearRenderTargetView(renderTargetView.Get(), bgcolor);
+	stateCache.ClearRenderTargetView(renderTargetView.Get(), bgcolor);
 	// depthStencilViewのクリア
-	deviceContext->ClearDepthStencilView(depthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+	stateCache.ClearDepthStencilView(depthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 	// renderTargetの設定
-	deviceContext->OMSetRenderTargets(1, renderTargetView.GetAddressOf(), depthStencilView.Get());
+	stateCache.OMSetRenderTargets(1, renderTargetView.GetAddressOf(), depthStencilView.Get());
 
-	// rasterizerStateの設定
-	deviceContext->RSSetState(rasterizerStates[static_cast<size_t>(RASTERIZER_STATE::CLOCK_FALSE_SOLID)].Get());
+	// rasterizerStateの設定 (GetRasterizer で返す値も合わせる)
+	SetRasterizer(RASTERIZER_STATE::CLOCK_FALSE_SOLID);
 	// samplerStateの設定
-	deviceContext->PSSetSamplers(0, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::POINT)].GetAddressOf());
-	deviceContext->PSSetSamplers(1, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::LINEAR)].GetAddressOf());
-	deviceContext->PSSetSamplers(2, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::ANISOTROPIC)].GetAddressOf());
-	deviceContext->PSSetSamplers(3, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::TEXT_LINEAR)].GetAddressOf());
-	deviceContext->PSSetSamplers(4, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::LINEAR_BORDER_BLACK)].GetAddressOf());
-	deviceContext->PSSetSamplers(5, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::LINEAR_BORDER_WHITE)].GetAddressOf());
+	stateCache.PSSetSamplers(0, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::POINT)].GetAddressOf());
+	stateCache.PSSetSamplers(1, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::LINEAR)].GetAddressOf());
+	stateCache.PSSetSamplers(2, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::ANISOTROPIC)].GetAddressOf());
+	stateCache.PSSetSamplers(3, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::TEXT_LINEAR)].GetAddressOf());
+	stateCache.PSSetSamplers(4, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::LINEAR_BORDER_BLACK)].GetAddressOf());
+	stateCache.PSSetSamplers(5, 1, samplerStates[static_cast<size_t>(SAMPLER_STATE::LINEAR_BORDER_WHITE)].GetAddressOf());
 	// depthStencilStateの設定
-	deviceContext->OMSetDepthStencilState(depthStencilStates[static_cast<size_t>(DEPTHSTENCIL_STATE::ZT_ON_ZW_ON)].Get(), 1);
+	stateCache.OMSetDepthStencilState(depthStencilStates[static_cast<size_t>(DEPTHSTENCIL_STATE::ZT_ON_ZW_ON)].Get(), 1);
 	// blendStateの設定
-	deviceContext->OMSetBlendState(blendStates[static_cast<size_t>(BLEND_STATE::ALPHA)].Get(), NULL, 0xFFFFFFFF);
+	stateCache.OMSetBlendState(blendStates[static_cast<size_t>(BLEND_STATE::ALPHA)].Get(), NULL, 0xFFFFFFFF);
 
 }
 
 // 描画終了
 void Graphics::End()
 {
+	// ヘッドレス時は何も描いていないので表示しない
+	if (headless) return;
+
 	swapchain->Present(0, NULL);
 }
 
@@ -507,17 +538,18 @@ void Graphics::End()
 // depthStencilの設定
 void Graphics::SetDepthStencil(DEPTHSTENCIL_STATE state)
 {
-	deviceContext->OMSetDepthStencilState(depthStencilStates[static_cast<size_t>(state)].Get(), 1);
+	stateCache.OMSetDepthStencilState(depthStencilStates[static_cast<size_t>(state)].Get(), 1);
 }
 // rasterizerの設定
 void Graphics::SetRasterizer(RASTERIZER_STATE state)
 {
-	deviceContext->RSSetState(rasterizerStates[static_cast<size_t>(state)].Get());
+	stateCache.RSSetState(rasterizerStates[static_cast<size_t>(state)].Get());
+	rasterizerState = state;
 }
 // blendの設定
 void Graphics::SetBlend(BLEND_STATE state)
 {
-	deviceContext->OMSetBlendState(blendStates[static_cast<size_t>(state)].Get(), NULL, 0xFFFFFFFF);
+	stateCache.OMSetBlendState(blendStates[static_cast<size_t>(state)].Get(), NULL, 0xFFFFFFFF);
 }
 
 /// <summary>
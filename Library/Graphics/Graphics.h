@@ -5,6 +5,10 @@
 #include <mutex>
 #include "FrameBuffer.h"
 #include "FullScreenQuad.h"
+#include "StateCache.h"
+#include "D3D11RenderDevice.h"
+#include "ConstantRingBuffer.h"
+#include "LightClusterBuffer.h"
 
 enum class SAMPLER_STATE
 {
@@ -106,6 +110,15 @@ public:
 	// 初期化
 	void Initialize(HWND hwnd, int windowWidth, int windowHeight);
 
+	// 描画の流し先の差し替え (RecordingRenderDevice など、nullptr で deviceContext へ戻す)
+	// リソースの作成は差し替えに関係なく device で行う
+	void SetRenderDevice(RenderDevice* renderDevice);
+	// 描画の呼び出しを recordingRenderDevice で数える
+	// headless なら deviceContext へ流さず Present もしない (更新と描画の発行だけを計測する)
+	void SetRecording(bool enable, bool headless);
+	bool IsRecording() const { return stateCache.GetDevice() == &recordingRenderDevice; }
+	bool IsHeadless() const { return headless; }
+
 	// 描画開始
 	void Begin();
 	// 描画終了
@@ -115,6 +128,8 @@ public:
 	void SetDepthStencil(DEPTHSTENCIL_STATE state);
 	// rasterizerの設定
 	void SetRasterizer(RASTERIZER_STATE state);
+	// 現在の rasterizer 取得
+	RASTERIZER_STATE GetRasterizer() const { return rasterizerState; }
 	// blendの設定
 	void SetBlend(BLEND_STATE state);
 
@@ -125,29 +140,7 @@ public:
 		DirectX::XMFLOAT4 direction;	// 向き
 		DirectX::XMFLOAT4 color;		// 色
 	};
-	// 点光源情報
-	struct PointLightData
-	{
-		DirectX::XMFLOAT4 position;		// 座標
-		DirectX::XMFLOAT4 color;		// 色
-		float range;					// 範囲
-		DirectX::XMFLOAT3 pad;
-	};
-	// 点光源の最大数
-	static constexpr int PointLightMax = 8;
-	// スポットライト情報
-	struct SpotLightData
-	{
-		DirectX::XMFLOAT4 position;		// 座標
-		DirectX::XMFLOAT4 direction;	// 向き
-		DirectX::XMFLOAT4 color;		// 色
-		float range;					// 範囲
-		float innerCorn;				// インナー角度範囲
-		float outerCorn;				// アウター角度範囲
-		float pad;
-	};
-	// スポットライトの最大数
-	static constexpr int SpotLightMax = 8;
+	// 点光源・スポットライトは LightCluster で StructuredBuffer に積む
 
 	// ガウスフィルター計算情報
 	//struct GaussianFilterData
@@ -188,11 +181,9 @@ public:
 	{
 		DirectX::XMFLOAT4X4 viewProjection;
 		DirectionalLightData directionalLightData;
-		PointLightData pointLightData[PointLightMax];
-		SpotLightData spotLightData[SpotLightMax];
 		int pointLightCount = 0;
 		int spotLightCount = 0;
-		DirectX::XMFLOAT2 pad;
+		DirectX::XMFLOAT2 clusterDepthScale;	// ビュー空間の深度からクラスターのスライス番号を求める係数 (LightCluster::GetDepthSliceScale)
 		DirectX::XMFLOAT4 ambientLightColor;
 		DirectX::XMFLOAT4 cameraPosition;
 		//GaussianFilterData gaussianFilterData;
@@ -201,6 +192,16 @@ public:
 
 	Microsoft::WRL::ComPtr<ID3D11Device> device;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> deviceContext;
+	// ステート設定と描画は deviceContext ではなくこちらを通す (同じステートの再設定を省く)
+	StateCache stateCache;
+	// stateCache の既定の流し先 (deviceContext へそのまま流す)
+	D3D11RenderDevice d3d11RenderDevice;
+	// SetRecording で差し込む流し先 (描画・書き込みバイト数・ステート変更を数える)
+	RecordingRenderDevice recordingRenderDevice;
+	// 描画ごとに変わる定数の書き込み先 (SkinnedMesh のオブジェクト定数・ボーン行列など)
+	ConstantRingBuffer constantRingBuffer;
+	// クラスターに割り当てた点光源・スポットライト (ピクセルシェーダーの t8 ~ t11)
+	LightClusterBuffer lightClusterBuffer;
 	Microsoft::WRL::ComPtr<IDXGISwapChain> swapchain;
 	Microsoft::WRL::ComPtr<ID3D11RenderTargetView> renderTargetView;
 	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> depthStencilView;
@@ -222,4 +223,9 @@ public:
 
 private:
 	std::mutex mutex;
+
+	// 現在の rasterizer
+	RASTERIZER_STATE rasterizerState = RASTERIZER_STATE::CLOCK_FALSE_SOLID;
+
+	bool headless = false;
 };
\ No newline at end of file
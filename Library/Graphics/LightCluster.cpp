@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <cmath>
+#include "LightCluster.h"
+
+using namespace DirectX;
+
+// コンストラクタ
+LightCluster::LightCluster()
+{
+	clusters.resize(ClusterCount);
+	pointCounts.resize(ClusterCount);
+	spotCounts.resize(ClusterCount);
+	writeCursors.resize(ClusterCount);
+
+	boundsMinX.resize(ClusterCount);
+	boundsMinY.resize(ClusterCount);
+	boundsMinZ.resize(ClusterCount);
+	boundsMaxX.resize(ClusterCount);
+	boundsMaxY.resize(ClusterCount);
+	boundsMaxZ.resize(ClusterCount);
+	sphereX.resize(ClusterCount);
+	sphereY.resize(ClusterCount);
+	sphereZ.resize(ClusterCount);
+	sphereRadius.resize(ClusterCount);
+}
+
+// 光源の全削除
+void LightCluster::Clear()
+{
+	pointLights.clear();
+	spotLights.clear();
+	statistics = {};
+}
+
+// 点光源の追加
+bool LightCluster::AddPointLight(const PointLightData& light)
+{
+	if (pointLights.size() >= PointLightMax)
+	{
+		statistics.droppedLightCount++;
+		return false;
+	}
+	pointLights.emplace_back(light);
+	return true;
+}
+
+// スポットライトの追加
+bool LightCluster::AddSpotLight(const SpotLightData& light)
+{
+	if (spotLights.size() >= SpotLightMax)
+	{
+		statistics.droppedLightCount++;
+		return false;
+	}
+	spotLights.emplace_back(light);
+	return true;
+}
+
+// クラスターへの割り当て
+void LightCluster::Build(const DirectX::XMFLOAT4X4& view, const DirectX::XMFLOAT4X4& projection)
+{
+	this->view = view;
+	BuildClusterBounds(projection);
+
+	assignments.clear();
+	std::fill(pointCounts.begin(), pointCounts.end(), static_cast<uint16_t>(0));
+	std::fill(spotCounts.begin(), spotCounts.end(), static_cast<uint16_t>(0));
+	statistics.lightIndexCount = 0;
+	statistics.clippedLightIndexCount = 0;
+	statistics.occupiedClusterCount = 0;
+	statistics.maxLightsPerCluster = 0;
+
+	const XMMATRIX View = XMLoadFloat4x4(&view);
+
+	// --- 点光源 (スポットライトより先に割り当てて、上限に達した時に優先されるようにする) ---
+	for (size_t i = 0; i < pointLights.size(); i++)
+	{
+		const PointLightData& light = pointLights[i];
+
+		XMFLOAT3 center;
+		XMStoreFloat3(&center, XMVector3TransformCoord(XMVectorSet(light.position.x, light.position.y, light.position.z, 1.0f), View));
+		AssignLight(center, light.range, nullptr, static_cast<uint16_t>(i));
+	}
+
+	// --- スポットライト (外接球で範囲を絞ってからコーンで判定する) ---
+	for (size_t i = 0; i < spotLights.size(); i++)
+	{
+		const SpotLightData& light = spotLights[i];
+		const uint16_t index = static_cast<uint16_t>(i) | SpotLightFlag;
+
+		Cone cone;
+		XMStoreFloat3(&cone.apex, XMVector3TransformCoord(XMVectorSet(light.position.x, light.position.y, light.position.z, 1.0f), View));
+		XMStoreFloat3(&cone.direction, XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(light.direction.x, light.direction.y, light.direction.z, 0.0f), View)));
+		cone.range = light.range;
+		cone.cosAngle = light.outerCorn;
+		cone.sinAngle = std::sqrt((std::max)(1.0f - light.outerCorn * light.outerCorn, 0.0f));
+
+		// 半球より広いコーンは球として扱う
+		AssignLight(cone.apex, light.range, light.outerCorn > 0.0f ? &cone : nullptr, index);
+	}
+
+	// --- クラスターごとの開始位置 ---
+	uint32_t offset = 0;
+	for (int i = 0; i < ClusterCount; i++)
+	{
+		const uint32_t count = pointCounts[i] + spotCounts[i];
+
+		clusters[i].offset = offset;
+		clusters[i].counts = static_cast<uint32_t>(pointCounts[i]) | (static_cast<uint32_t>(spotCounts[i]) << 16);
+		writeCursors[i] = offset;
+		offset += count;
+
+		if (count > 0) statistics.occupiedClusterCount++;
+		statistics.maxLightsPerCluster = (std::max)(statistics.maxLightsPerCluster, count);
+	}
+
+	// --- 光源番号を詰める (点光源を先に割り当てているので、各クラスター内も点光源が先に並ぶ) ---
+	lightIndices.resize(offset);
+	for (const Assignment& assignment : assignments)
+	{
+		lightIndices[writeCursors[assignment.cluster]++] = assignment.light & ~SpotLightFlag;
+	}
+
+	statistics.pointLightCount = static_cast<uint32_t>(pointLights.size());
+	statistics.spotLightCount = static_cast<uint32_t>(spotLights.size());
+	statistics.lightIndexCount = offset;
+}
+
+// ワールド座標が入るクラスター番号
+int LightCluster::FindCluster(const DirectX::XMFLOAT3& worldPosition) const
+{
+	XMFLOAT3 p;
+	XMStoreFloat3(&p, XMVector3TransformCoord(XMLoadFloat3(&worldPosition), XMLoadFloat4x4(&view)));
+
+	const float depth = (std::max)(p.z, 1.0e-4f);
+	const float ndcX = p.x * projectionX / depth;
+	const float ndcY = p.y * projectionY / depth;
+
+	const int x = static_cast<int>(std::clamp((ndcX * 0.5f + 0.5f) * ClusterCountX, 0.0f, ClusterCountX - 1.0f));
+	const int y = static_cast<int>(std::clamp((ndcY * 0.5f + 0.5f) * ClusterCountY, 0.0f, ClusterCountY - 1.0f));
+	const int z = static_cast<int>(std::clamp(std::log(depth) * depthSliceScale.x + depthSliceScale.y, 0.0f, ClusterCountZ - 1.0f));
+	return GetClusterIndex(x, y, z);
+}
+
+// クラスターの境界の作り直し
+void LightCluster::BuildClusterBounds(const DirectX::XMFLOAT4X4& projection)
+{
+	// 透視投影行列 (左手系) から近・遠平面を取り出す
+	const float n = -projection._43 / projection._33;
+	const float f = projection._43 / (1.0f - projection._33);
+	const float sliceFar = (std::max)((std::min)(f, maxSliceDistance), n * 1.001f);
+
+	if (projectionX == projection._11 && projectionY == projection._22 && nearZ == n && farZ == f && sliceFarZ == sliceFar) return;
+
+	projectionX = projection._11;
+	projectionY = projection._22;
+	nearZ = n;
+	farZ = f;
+	sliceFarZ = sliceFar;
+
+	// 深度は指数で区切る (slice = log(depth / n) / log(sliceFar / n) * ClusterCountZ)
+	const float logRatio = std::log(sliceFar / n);
+	depthSliceScale.x = ClusterCountZ / logRatio;
+	depthSliceScale.y = -std::log(n) * depthSliceScale.x;
+
+	for (int z = 0; z <= ClusterCountZ; z++)
+	{
+		sliceDepths[z] = n * std::exp(logRatio * z / ClusterCountZ);
+	}
+	// 最後のスライスは遠平面まで
+	sliceDepths[ClusterCountZ] = (std::max)(f, sliceFar);
+
+	for (int z = 0; z < ClusterCountZ; z++)
+	{
+		const float depthNear = sliceDepths[z];
+		const float depthFar = sliceDepths[z + 1];
+
+		for (int y = 0; y < ClusterCountY; y++)
+		{
+			// タイルの NDC 範囲 (y = 0 が画面下)
+			const float ndcMinY = -1.0f + 2.0f * y / ClusterCountY;
+			const float ndcMaxY = -1.0f + 2.0f * (y + 1) / ClusterCountY;
+
+			for (int x = 0; x < ClusterCountX; x++)
+			{
+				const float ndcMinX = -1.0f + 2.0f * x / ClusterCountX;
+				const float ndcMaxX = -1.0f + 2.0f * (x + 1) / ClusterCountX;
+
+				// 錐台の一部なので、手前と奥の断面の両方を含む箱にする
+				const int i = GetClusterIndex(x, y, z);
+				boundsMinX[i] = (std::min)(ndcMinX * depthNear, ndcMinX * depthFar) / projectionX;
+				boundsMaxX[i] = (std::max)(ndcMaxX * depthNear, ndcMaxX * depthFar) / projectionX;
+				boundsMinY[i] = (std::min)(ndcMinY * depthNear, ndcMinY * depthFar) / projectionY;
+				boundsMaxY[i] = (std::max)(ndcMaxY * depthNear, ndcMaxY * depthFar) / projectionY;
+				boundsMinZ[i] = depthNear;
+				boundsMaxZ[i] = depthFar;
+
+				const float extentX = (boundsMaxX[i] - boundsMinX[i]) * 0.5f;
+				const float extentY = (boundsMaxY[i] - boundsMinY[i]) * 0.5f;
+				const float extentZ = (boundsMaxZ[i] - boundsMinZ[i]) * 0.5f;
+				sphereX[i] = boundsMinX[i] + extentX;
+				sphereY[i] = boundsMinY[i] + extentY;
+				sphereZ[i] = boundsMinZ[i] + extentZ;
+				sphereRadius[i] = std::sqrt(extentX * extentX + extentY * extentY + extentZ * extentZ);
+			}
+		}
+	}
+}
+
+// ビュー空間の球が重なるクラスターの範囲
+bool LightCluster::GetClusterRange(const DirectX::XMFLOAT3& center, float radius, int minimum[3], int maximum[3]) const
+{
+	const float depthMax = center.z + radius;
+	const float depthMin = (std::max)(center.z - radius, nearZ);
+	if (depthMax < nearZ || depthMin > farZ) return false;
+
+	// 球を囲む箱の角を投影した範囲 (x / z は x と z それぞれについて単調なので角だけ見れば足りる)
+	const float ndcX[4] =
+	{
+		(center.x - radius) * projectionX / depthMin, (center.x - radius) * projectionX / depthMax,
+		(center.x + radius) * projectionX / depthMin, (center.x + radius) * projectionX / depthMax,
+	};
+	const float ndcY[4] =
+	{
+		(center.y - radius) * projectionY / depthMin, (center.y - radius) * projectionY / depthMax,
+		(center.y + radius) * projectionY / depthMin, (center.y + radius) * projectionY / depthMax,
+	};
+	const float ndcMinX = (std::min)((std::min)(ndcX[0], ndcX[1]), (std::min)(ndcX[2], ndcX[3]));
+	const float ndcMaxX = (std::max)((std::max)(ndcX[0], ndcX[1]), (std::max)(ndcX[2], ndcX[3]));
+	const float ndcMinY = (std::min)((std::min)(ndcY[0], ndcY[1]), (std::min)(ndcY[2], ndcY[3]));
+	const float ndcMaxY = (std::max)((std::max)(ndcY[0], ndcY[1]), (std::max)(ndcY[2], ndcY[3]));
+	if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f) return false;
+
+	minimum[0] = static_cast<int>(std::clamp((ndcMinX * 0.5f + 0.5f) * ClusterCountX, 0.0f, ClusterCountX - 1.0f));
+	maximum[0] = static_cast<int>(std::clamp((ndcMaxX * 0.5f + 0.5f) * ClusterCountX, 0.0f, ClusterCountX - 1.0f));
+	minimum[1] = static_cast<int>(std::clamp((ndcMinY * 0.5f + 0.5f) * ClusterCountY, 0.0f, ClusterCountY - 1.0f));
+	maximum[1] = static_cast<int>(std::clamp((ndcMaxY * 0.5f + 0.5f) * ClusterCountY, 0.0f, ClusterCountY - 1.0f));
+	minimum[2] = static_cast<int>(std::clamp(std::log(depthMin) * depthSliceScale.x + depthSliceScale.y, 0.0f, ClusterCountZ - 1.0f));
+	maximum[2] = static_cast<int>(std::clamp(std::log(depthMax) * depthSliceScale.x + depthSliceScale.y, 0.0f, ClusterCountZ - 1.0f));
+	return true;
+}
+
+// 球 (とコーン) と重なるクラスターに割り当てる
+void LightCluster::AssignLight(const DirectX::XMFLOAT3& center, float radius, const Cone* cone, uint16_t light)
+{
+	int minimum[3], maximum[3];
+	if (!GetClusterRange(center, radius, minimum, maximum)) return;
+
+	const XMVECTOR Zero = XMVectorZero();
+	const XMVECTOR CenterX = XMVectorReplicate(center.x);
+	const XMVECTOR CenterY = XMVectorReplicate(center.y);
+	const XMVECTOR CenterZ = XMVectorReplicate(center.z);
+	const XMVECTOR RadiusSq = XMVectorReplicate(radius * radius);
+
+	// コーンの判定用 (クラスターの外接球との判定)
+	XMVECTOR ApexX = Zero, ApexY = Zero, ApexZ = Zero;
+	XMVECTOR DirectionX = Zero, DirectionY = Zero, DirectionZ = Zero;
+	XMVECTOR CosAngle = Zero, SinAngle = Zero, Range = Zero;
+	if (cone)
+	{
+		ApexX = XMVectorReplicate(cone->apex.x);
+		ApexY = XMVectorReplicate(cone->apex.y);
+		ApexZ = XMVectorReplicate(cone->apex.z);
+		DirectionX = XMVectorReplicate(cone->direction.x);
+		DirectionY = XMVectorReplicate(cone->direction.y);
+		DirectionZ = XMVectorReplicate(cone->direction.z);
+		CosAngle = XMVectorReplicate(cone->cosAngle);
+		SinAngle = XMVectorReplicate(cone->sinAngle);
+		Range = XMVectorReplicate(cone->range);
+	}
+
+	for (int z = minimum[2]; z <= maximum[2]; z++)
+	{
+		for (int y = minimum[1]; y <= maximum[1]; y++)
+		{
+			const int row = GetClusterIndex(0, y, z);
+
+			// x 方向に並んだ 4 クラスターずつ判定する
+			for (int x = minimum[0] & ~3; x <= maximum[0]; x += 4)
+			{
+				const int base = row + x;
+
+				// 球 vs AABB (最近点までの距離の 2 乗)
+				const XMVECTOR MinX = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&boundsMinX[base]));
+				const XMVECTOR MinY = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&boundsMinY[base]));
+				const XMVECTOR MinZ = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&boundsMinZ[base]));
+				const XMVECTOR MaxX = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&boundsMaxX[base]));
+				const XMVECTOR MaxY = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&boundsMaxY[base]));
+				const XMVECTOR MaxZ = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&boundsMaxZ[base]));
+
+				const XMVECTOR DX = XMVectorAdd(XMVectorMax(XMVectorSubtract(MinX, CenterX), Zero), XMVectorMax(XMVectorSubtract(CenterX, MaxX), Zero));
+				const XMVECTOR DY = XMVectorAdd(XMVectorMax(XMVectorSubtract(MinY, CenterY), Zero), XMVectorMax(XMVectorSubtract(CenterY, MaxY), Zero));
+				const XMVECTOR DZ = XMVectorAdd(XMVectorMax(XMVectorSubtract(MinZ, CenterZ), Zero), XMVectorMax(XMVectorSubtract(CenterZ, MaxZ), Zero));
+				const XMVECTOR DistanceSq = XMVectorMultiplyAdd(DX, DX, XMVectorMultiplyAdd(DY, DY, XMVectorMultiply(DZ, DZ)));
+
+				XMVECTOR Hit = XMVectorLessOrEqual(DistanceSq, RadiusSq);
+
+				// コーン vs 球
+				if (cone)
+				{
+					const XMVECTOR SphereRadius = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&sphereRadius[base]));
+					const XMVECTOR VX = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&sphereX[base])), ApexX);
+					const XMVECTOR VY = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&sphereY[base])), ApexY);
+					const XMVECTOR VZ = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&sphereZ[base])), ApexZ);
+
+					const XMVECTOR LengthSq = XMVectorMultiplyAdd(VX, VX, XMVectorMultiplyAdd(VY, VY, XMVectorMultiply(VZ, VZ)));
+					const XMVECTOR AxisLength = XMVectorMultiplyAdd(VX, DirectionX, XMVectorMultiplyAdd(VY, DirectionY, XMVectorMultiply(VZ, DirectionZ)));
+					const XMVECTOR SideLength = XMVectorSqrt(XMVectorMax(XMVectorSubtract(LengthSq, XMVectorMultiply(AxisLength, AxisLength)), Zero));
+					// 球の中心からコーンの側面までの距離
+					const XMVECTOR ConeDistance = XMVectorSubtract(XMVectorMultiply(CosAngle, SideLength), XMVectorMultiply(AxisLength, SinAngle));
+
+					Hit = XMVectorAndInt(Hit, XMVectorLessOrEqual(ConeDistance, SphereRadius));
+					Hit = XMVectorAndInt(Hit, XMVectorLessOrEqual(AxisLength, XMVectorAdd(SphereRadius, Range)));
+					Hit = XMVectorAndInt(Hit, XMVectorGreaterOrEqual(AxisLength, XMVectorNegate(SphereRadius)));
+				}
+
+				XMUINT4 mask;
+				XMStoreUInt4(&mask, Hit);
+				const uint32_t lanes[4] = { mask.x, mask.y, mask.z, mask.w };
+				for (int lane = 0; lane < 4; lane++)
+				{
+					if (lanes[lane] == 0 || x + lane < minimum[0] || x + lane > maximum[0]) continue;
+					Assign(base + lane, light);
+				}
+			}
+		}
+	}
+}
+
+// 割り当て 1 件の追加
+void LightCluster::Assign(int cluster, uint16_t light)
+{
+	if (pointCounts[cluster] + spotCounts[cluster] >= LightsPerClusterMax)
+	{
+		statistics.clippedLightIndexCount++;
+		return;
+	}
+
+	if (light & SpotLightFlag)
+	{
+		spotCounts[cluster]++;
+	}
+	else
+	{
+		pointCounts[cluster]++;
+	}
+	assignments.push_back({ static_cast<uint16_t>(cluster), light });
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// LightCluster
+//--------------------------------------------------------------
+// 視錐台を画面 X x Y のタイルと、深度方向に指数で区切った Z スライスに分割し (クラスター)
+// 点光源・スポットライトがどのクラスターに届くかを CPU で調べて光源番号のリストを作る
+// ピクセルシェーダーは自分のクラスターのリストにある光源だけを計算する
+//
+// 判定は x 方向に並んだ 4 クラスターずつ DirectXMath でまとめて行う
+// 描画 API に依存しないので、GPU なしで割り当て結果を確認できる (GPU への書き込みは LightClusterBuffer)
+class LightCluster
+{
+public:
+	// 分割数 (シェーダーの Light.hlsli と合わせる、X は 4 の倍数)
+	static constexpr int ClusterCountX = 16;
+	static constexpr int ClusterCountY = 9;
+	static constexpr int ClusterCountZ = 24;
+	static constexpr int ClusterCount = ClusterCountX * ClusterCountY * ClusterCountZ;
+
+	// 光源の最大数 (これを超えた光源は登録されない)
+	static constexpr int PointLightMax = 1024;
+	static constexpr int SpotLightMax = 256;
+	// 1 クラスターに入る光源の最大数 (ピクセルあたりの計算量の上限、点光源が優先される)
+	static constexpr int LightsPerClusterMax = 32;
+	// 光源番号リストの最大数
+	static constexpr int LightIndexMax = ClusterCount * LightsPerClusterMax;
+
+	// 点光源情報 (StructuredBuffer の要素)
+	struct PointLightData
+	{
+		DirectX::XMFLOAT4 position;		// 座標
+		DirectX::XMFLOAT4 color;		// 色
+		float range;					// 範囲
+		DirectX::XMFLOAT3 pad;
+	};
+	// スポットライト情報 (StructuredBuffer の要素)
+	struct SpotLightData
+	{
+		DirectX::XMFLOAT4 position;		// 座標
+		DirectX::XMFLOAT4 direction;	// 向き
+		DirectX::XMFLOAT4 color;		// 色
+		float range;					// 範囲
+		float innerCorn;				// インナー角度範囲 (cos)
+		float outerCorn;				// アウター角度範囲 (cos)
+		float pad;
+	};
+
+	// クラスター (lightIndices[offset] から点光源、続けてスポットライトの番号が並ぶ)
+	struct Cluster
+	{
+		uint32_t offset = 0;
+		uint32_t counts = 0;	// 点光源の数 (下位 16bit) | スポットライトの数 (上位 16bit)
+
+		uint32_t GetPointLightCount() const { return counts & 0xFFFF; }
+		uint32_t GetSpotLightCount() const { return counts >> 16; }
+	};
+
+	// Build 1 回分の統計
+	struct Statistics
+	{
+		uint32_t pointLightCount = 0;
+		uint32_t spotLightCount = 0;
+		uint32_t droppedLightCount = 0;		// 最大数を超えて登録されなかった光源
+		uint32_t lightIndexCount = 0;
+		uint32_t clippedLightIndexCount = 0;	// LightsPerClusterMax を超えて入らなかった割り当て
+		uint32_t occupiedClusterCount = 0;	// 光源が 1 つ以上あるクラスター
+		uint32_t maxLightsPerCluster = 0;
+	};
+
+public:
+	LightCluster();
+	~LightCluster() {}
+
+	// 光源の全削除 (毎フレーム積み直す)
+	void Clear();
+	// 光源の追加 (最大数を超えたら false)
+	bool AddPointLight(const PointLightData& light);
+	bool AddSpotLight(const SpotLightData& light);
+
+	// クラスターへの割り当て (projection は透視投影)
+	void Build(const DirectX::XMFLOAT4X4& view, const DirectX::XMFLOAT4X4& projection);
+
+	// ビュー空間の深度からスライス番号を求める係数 (slice = log(depth) * x + y)
+	DirectX::XMFLOAT2 GetDepthSliceScale() const { return depthSliceScale; }
+
+	// ワールド座標が入るクラスター番号 (シェーダーと同じ計算、Build 後に使う)
+	int FindCluster(const DirectX::XMFLOAT3& worldPosition) const;
+
+	static int GetClusterIndex(int x, int y, int z) { return (z * ClusterCountY + y) * ClusterCountX + x; }
+
+	// 取得
+	const std::vector<PointLightData>& GetPointLights() const { return pointLights; }
+	const std::vector<SpotLightData>& GetSpotLights() const { return spotLights; }
+	const std::vector<Cluster>& GetClusters() const { return clusters; }
+	const std::vector<uint32_t>& GetLightIndices() const { return lightIndices; }
+	const Statistics& GetStatistics() const { return statistics; }
+
+public:
+	// スライスを作る最も遠い距離 (これより奥は最後のスライスにまとめる)
+	float maxSliceDistance = 300.0f;
+
+private:
+	// 割り当て 1 件
+	struct Assignment
+	{
+		uint16_t cluster;
+		uint16_t light;		// スポットライトは SpotLightFlag を立てる
+	};
+	static constexpr uint16_t SpotLightFlag = 0x8000;
+
+	// クラスターの境界の作り直し (投影が変わった時だけ)
+	void BuildClusterBounds(const DirectX::XMFLOAT4X4& projection);
+
+	// ビュー空間の球が重なるクラスターの範囲
+	bool GetClusterRange(const DirectX::XMFLOAT3& center, float radius, int minimum[3], int maximum[3]) const;
+
+	// スポットライトのコーン (ビュー空間)
+	struct Cone
+	{
+		DirectX::XMFLOAT3 apex;
+		DirectX::XMFLOAT3 direction;	// 正規化済み
+		float range;
+		float cosAngle;
+		float sinAngle;
+	};
+
+	// 球 (cone があればさらにコーン) と重なるクラスターに割り当てる
+	void AssignLight(const DirectX::XMFLOAT3& center, float radius, const Cone* cone, uint16_t light);
+
+	// 割り当て 1 件の追加 (LightsPerClusterMax を超えたら捨てる)
+	void Assign(int cluster, uint16_t light);
+
+private:
+	std::vector<PointLightData> pointLights;
+	std::vector<SpotLightData> spotLights;
+
+	std::vector<Cluster> clusters;
+	std::vector<uint32_t> lightIndices;
+
+	// 割り当て作業用
+	std::vector<Assignment> assignments;
+	std::vector<uint16_t> pointCounts;
+	std::vector<uint16_t> spotCounts;
+	std::vector<uint32_t> writeCursors;
+
+	// クラスターのビュー空間 AABB と外接球 (x 方向に連続して並ぶ SoA)
+	std::vector<float> boundsMinX, boundsMinY, boundsMinZ;
+	std::vector<float> boundsMaxX, boundsMaxY, boundsMaxZ;
+	std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+
+	// スライスの境界の深度 (ClusterCountZ + 1 個)
+	float sliceDepths[ClusterCountZ + 1] = {};
+
+	// 境界を作った時の投影
+	float projectionX = 0;		// _11
+	float projectionY = 0;		// _22
+	float nearZ = 0;
+	float farZ = 0;
+	float sliceFarZ = 0;
+
+	DirectX::XMFLOAT4X4 view = {};
+	DirectX::XMFLOAT2 depthSliceScale = { 0,0 };
+
+	Statistics statistics;
+};
@@ -0,0 +1,68 @@
+#include <cstring>
+#include "LightClusterBuffer.h"
+#include "StateCache.h"
+#include "../ErrorLogger.h"
+
+// 初期化
+void LightClusterBuffer::Initialize(ID3D11Device* device)
+{
+	CreateBuffer(device, POINT_LIGHTS, sizeof(LightCluster::PointLightData), LightCluster::PointLightMax);
+	CreateBuffer(device, SPOT_LIGHTS, sizeof(LightCluster::SpotLightData), LightCluster::SpotLightMax);
+	CreateBuffer(device, CLUSTERS, sizeof(LightCluster::Cluster), LightCluster::ClusterCount);
+	CreateBuffer(device, LIGHT_INDICES, sizeof(uint32_t), LightCluster::LightIndexMax);
+}
+
+// 書き込み
+void LightClusterBuffer::Update(StateCache& stateCache, const LightCluster& cluster)
+{
+	// 光源が 1 つもなければクラスターは全て空なので、光源の中身は書き換えなくてよい
+	if (!cluster.GetPointLights().empty()) Write(stateCache, POINT_LIGHTS, cluster.GetPointLights().data(), sizeof(LightCluster::PointLightData) * cluster.GetPointLights().size());
+	if (!cluster.GetSpotLights().empty()) Write(stateCache, SPOT_LIGHTS, cluster.GetSpotLights().data(), sizeof(LightCluster::SpotLightData) * cluster.GetSpotLights().size());
+	if (!cluster.GetLightIndices().empty()) Write(stateCache, LIGHT_INDICES, cluster.GetLightIndices().data(), sizeof(uint32_t) * cluster.GetLightIndices().size());
+	Write(stateCache, CLUSTERS, cluster.GetClusters().data(), sizeof(LightCluster::Cluster) * cluster.GetClusters().size());
+}
+
+// ピクセルシェーダーへの設定
+void LightClusterBuffer::Bind(StateCache& stateCache) const
+{
+	ID3D11ShaderResourceView* views[BUFFER_COUNT] =
+	{
+		shaderResourceViews[POINT_LIGHTS].Get(),
+		shaderResourceViews[SPOT_LIGHTS].Get(),
+		shaderResourceViews[CLUSTERS].Get(),
+		shaderResourceViews[LIGHT_INDICES].Get(),
+	};
+	stateCache.PSSetShaderResources(StartSlot, BUFFER_COUNT, views);
+}
+
+// StructuredBuffer の作成
+void LightClusterBuffer::CreateBuffer(ID3D11Device* device, BUFFER buffer, UINT stride, UINT count)
+{
+	D3D11_BUFFER_DESC bufferDesc{};
+	bufferDesc.ByteWidth = stride * count;
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	bufferDesc.StructureByteStride = stride;
+	HRESULT hr = device->CreateBuffer(&bufferDesc, nullptr, buffers[buffer].ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
+	shaderResourceViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+	shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	shaderResourceViewDesc.Buffer.FirstElement = 0;
+	shaderResourceViewDesc.Buffer.NumElements = count;
+	hr = device->CreateShaderResourceView(buffers[buffer].Get(), &shaderResourceViewDesc, shaderResourceViews[buffer].ReleaseAndGetAddressOf());
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+}
+
+// 書き込み (毎フレーム全体を書き直すので DISCARD)
+void LightClusterBuffer::Write(StateCache& stateCache, BUFFER buffer, const void* data, size_t size)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedSubresource{};
+	HRESULT hr = stateCache.Map(buffers[buffer].Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+	_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
+	std::memcpy(mappedSubresource.pData, data, size);
+	stateCache.Unmap(buffers[buffer].Get(), 0, static_cast<UINT>(size));
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include "LightCluster.h"
+
+class StateCache;
+
+//--------------------------------------------------------------
+// LightClusterBuffer
+//--------------------------------------------------------------
+// LightCluster の割り当て結果を StructuredBuffer に書き込み、ピクセルシェーダーに設定する
+// (t8 : 点光源, t9 : スポットライト, t10 : クラスター, t11 : 光源番号リスト)
+class LightClusterBuffer
+{
+public:
+	// 設定するスロット (シェーダーの Light.hlsli と合わせる)
+	static constexpr UINT StartSlot = 8;
+
+public:
+	LightClusterBuffer() {}
+	~LightClusterBuffer() {}
+
+	// 初期化 (LightCluster の最大数分の領域を作る)
+	void Initialize(ID3D11Device* device);
+
+	// 書き込み
+	void Update(StateCache& stateCache, const LightCluster& cluster);
+
+	// ピクセルシェーダーへの設定
+	void Bind(StateCache& stateCache) const;
+
+private:
+	enum BUFFER
+	{
+		POINT_LIGHTS,
+		SPOT_LIGHTS,
+		CLUSTERS,
+		LIGHT_INDICES,
+
+		BUFFER_COUNT,
+	};
+
+	void CreateBuffer(ID3D11Device* device, BUFFER buffer, UINT stride, UINT count);
+	void Write(StateCache& stateCache, BUFFER buffer, const void* data, size_t size);
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11Buffer> buffers[BUFFER_COUNT];
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceViews[BUFFER_COUNT];
+};
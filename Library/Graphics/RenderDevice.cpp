@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cstring>
+#include "RenderDevice.h"
+
+//--------------------------------------------------------------
+// RecordingRenderDevice
+//--------------------------------------------------------------
+
+// 書き込み先のバイト数と 1 行のバイト数 (分からなければ 0)
+UINT RecordingRenderDevice::GetResourceSize(ID3D11Resource* resource, UINT& rowPitch)
+{
+	rowPitch = 0;
+	if (!resource) return 0;
+
+	D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+	resource->GetType(&dimension);
+	switch (dimension)
+	{
+	case D3D11_RESOURCE_DIMENSION_BUFFER:
+	{
+		D3D11_BUFFER_DESC desc{};
+		static_cast<ID3D11Buffer*>(resource)->GetDesc(&desc);
+		rowPitch = desc.ByteWidth;
+		return desc.ByteWidth;
+	}
+	case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+	{
+		// フォーマットからは求めず、1 ピクセル最大の 16 バイトで見積もる (書き込みがはみ出さないように)
+		D3D11_TEXTURE2D_DESC desc{};
+		static_cast<ID3D11Texture2D*>(resource)->GetDesc(&desc);
+		rowPitch = desc.Width * 16;
+		return rowPitch * desc.Height;
+	}
+	default:
+		return 0;
+	}
+}
+
+void RecordingRenderDevice::VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances)
+{
+	++statistics.stateChanges;
+	if (next) next->VSSetShader(shader, classInstances, numClassInstances);
+}
+
+void RecordingRenderDevice::PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances)
+{
+	++statistics.stateChanges;
+	if (next) next->PSSetShader(shader, classInstances, numClassInstances);
+}
+
+void RecordingRenderDevice::IASetInputLayout(ID3D11InputLayout* inputLayout)
+{
+	++statistics.stateChanges;
+	if (next) next->IASetInputLayout(inputLayout);
+}
+
+void RecordingRenderDevice::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	++statistics.stateChanges;
+	if (next) next->IASetPrimitiveTopology(topology);
+}
+
+void RecordingRenderDevice::IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets)
+{
+	++statistics.stateChanges;
+	if (next) next->IASetVertexBuffers(startSlot, numBuffers, buffers, strides, offsets);
+}
+
+void RecordingRenderDevice::IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset)
+{
+	++statistics.stateChanges;
+	if (next) next->IASetIndexBuffer(buffer, format, offset);
+}
+
+void RecordingRenderDevice::VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers)
+{
+	++statistics.stateChanges;
+	if (next) next->VSSetConstantBuffers(startSlot, numBuffers, buffers);
+}
+
+void RecordingRenderDevice::PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers)
+{
+	++statistics.stateChanges;
+	if (next) next->PSSetConstantBuffers(startSlot, numBuffers, buffers);
+}
+
+void RecordingRenderDevice::VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	++statistics.stateChanges;
+	if (next) next->VSSetConstantBuffers1(startSlot, numBuffers, buffers, firstConstants, numConstants);
+}
+
+void RecordingRenderDevice::PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	++statistics.stateChanges;
+	if (next) next->PSSetConstantBuffers1(startSlot, numBuffers, buffers, firstConstants, numConstants);
+}
+
+void RecordingRenderDevice::VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views)
+{
+	++statistics.stateChanges;
+	if (next) next->VSSetShaderResources(startSlot, numViews, views);
+}
+
+void RecordingRenderDevice::PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views)
+{
+	++statistics.stateChanges;
+	if (next) next->PSSetShaderResources(startSlot, numViews, views);
+}
+
+void RecordingRenderDevice::VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers)
+{
+	++statistics.stateChanges;
+	if (next) next->VSSetSamplers(startSlot, numSamplers, samplers);
+}
+
+void RecordingRenderDevice::PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers)
+{
+	++statistics.stateChanges;
+	if (next) next->PSSetSamplers(startSlot, numSamplers, samplers);
+}
+
+void RecordingRenderDevice::RSSetState(ID3D11RasterizerState* state)
+{
+	++statistics.stateChanges;
+	if (next) next->RSSetState(state);
+}
+
+void RecordingRenderDevice::RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports)
+{
+	++statistics.stateChanges;
+
+	// next がない時に返せるように覚えておく
+	viewportCount = (std::min)(numViewports, static_cast<UINT>(_countof(this->viewports)));
+	std::memcpy(this->viewports, viewports, sizeof(D3D11_VIEWPORT) * viewportCount);
+
+	if (next) next->RSSetViewports(numViewports, viewports);
+}
+
+void RecordingRenderDevice::RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports)
+{
+	if (next)
+	{
+		next->RSGetViewports(numViewports, viewports);
+		return;
+	}
+
+	if (viewportCount == 0)
+	{
+		if (viewports && *numViewports > 0) viewports[0] = nullViewport;
+		*numViewports = 1;
+		return;
+	}
+
+	if (viewports)
+	{
+		const UINT count = (std::min)(*numViewports, viewportCount);
+		std::memcpy(viewports, this->viewports, sizeof(D3D11_VIEWPORT) * count);
+	}
+	*numViewports = viewportCount;
+}
+
+void RecordingRenderDevice::OMSetBlendState(ID3D11BlendState* state, const FLOAT blendFactor[4], UINT sampleMask)
+{
+	++statistics.stateChanges;
+	if (next) next->OMSetBlendState(state, blendFactor, sampleMask);
+}
+
+void RecordingRenderDevice::OMSetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef)
+{
+	++statistics.stateChanges;
+	if (next) next->OMSetDepthStencilState(state, stencilRef);
+}
+
+void RecordingRenderDevice::OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView)
+{
+	++statistics.stateChanges;
+	if (next) next->OMSetRenderTargets(numViews, renderTargetViews, depthStencilView);
+}
+
+void RecordingRenderDevice::OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView)
+{
+	if (next)
+	{
+		next->OMGetRenderTargets(numViews, renderTargetViews, depthStencilView);
+		return;
+	}
+
+	// 描き先は持っていないので空を返す (呼び出し側は Release するので AddRef は不要)
+	if (renderTargetViews)
+	{
+		for (UINT i = 0; i < numViews; ++i) renderTargetViews[i] = nullptr;
+	}
+	if (depthStencilView) *depthStencilView = nullptr;
+}
+
+void RecordingRenderDevice::ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4])
+{
+	++statistics.clears;
+	if (next) next->ClearRenderTargetView(renderTargetView, color);
+}
+
+void RecordingRenderDevice::ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil)
+{
+	++statistics.clears;
+	if (next) next->ClearDepthStencilView(depthStencilView, clearFlags, depth, stencil);
+}
+
+HRESULT RecordingRenderDevice::Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource)
+{
+	++statistics.uploads;
+
+	if (next) return next->Map(resource, subresource, mapType, mapFlags, mappedResource);
+
+	// 描かないので書き込み先は作業領域で良い
+	UINT rowPitch = 0;
+	const UINT size = GetResourceSize(resource, rowPitch);
+	const size_t required = (std::max)(static_cast<size_t>(size), scratchSize);
+	if (scratch.size() < required) scratch.resize(required);
+
+	mappedResource->pData = scratch.data();
+	mappedResource->RowPitch = rowPitch;
+	mappedResource->DepthPitch = size;
+	return S_OK;
+}
+
+void RecordingRenderDevice::Unmap(ID3D11Resource* resource, UINT subresource, UINT writtenBytes)
+{
+	// 書き込み量は呼び出し側が渡したもので数える (分からなければリソース全体)
+	if (writtenBytes == 0)
+	{
+		UINT rowPitch = 0;
+		writtenBytes = GetResourceSize(resource, rowPitch);
+	}
+	statistics.uploadedBytes += writtenBytes;
+
+	if (next) next->Unmap(resource, subresource, writtenBytes);
+}
+
+void RecordingRenderDevice::UpdateSubresource(ID3D11Resource* resource, UINT subresource, const D3D11_BOX* box, const void* data, UINT rowPitch, UINT depthPitch)
+{
+	++statistics.uploads;
+	if (box)
+	{
+		const UINT depth = box->back - box->front;
+		const UINT height = box->bottom - box->top;
+		statistics.uploadedBytes += depthPitch * (depth > 0 ? depth - 1 : 0) + rowPitch * (height > 0 ? height - 1 : 0) + (box->right - box->left);
+	}
+	else
+	{
+		UINT rowPitch = 0;
+		statistics.uploadedBytes += GetResourceSize(resource, rowPitch);
+	}
+
+	if (next) next->UpdateSubresource(resource, subresource, box, data, rowPitch, depthPitch);
+}
+
+void RecordingRenderDevice::CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT x, UINT y, UINT z, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox)
+{
+	++statistics.uploads;
+	if (next) next->CopySubresourceRegion(destination, destinationSubresource, x, y, z, source, sourceSubresource, sourceBox);
+}
+
+void RecordingRenderDevice::Draw(UINT vertexCount, UINT startVertexLocation)
+{
+	++statistics.drawCalls;
+	statistics.primitiveVertices += vertexCount;
+	if (next) next->Draw(vertexCount, startVertexLocation);
+}
+
+void RecordingRenderDevice::DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
+{
+	++statistics.drawCalls;
+	statistics.primitiveVertices += indexCount;
+	if (next) next->DrawIndexed(indexCount, startIndexLocation, baseVertexLocation);
+}
+
+void RecordingRenderDevice::DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation)
+{
+	++statistics.drawCalls;
+	statistics.primitiveVertices += static_cast<uint64_t>(vertexCountPerInstance) * instanceCount;
+	if (next) next->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+}
+
+void RecordingRenderDevice::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
+{
+	++statistics.drawCalls;
+	statistics.primitiveVertices += static_cast<uint64_t>(indexCountPerInstance) * instanceCount;
+	if (next) next->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+}
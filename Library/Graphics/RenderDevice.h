@@ -0,0 +1,148 @@
+#pragma once
+#include <d3d11.h>
+#include <vector>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// RenderDevice
+//--------------------------------------------------------------
+// StateCache が実際に呼ぶ描画 API (immediate context) のインターフェース
+// ゲーム側は deviceContext を直接触らず StateCache を通すので、ここを差し替えれば
+// 描画 API を呼ばずに更新・描画の発行だけを回せる (RecordingRenderDevice)
+//
+// リソースの作成 (ID3D11Device) はこのインターフェースには含めない
+class RenderDevice
+{
+public:
+	virtual ~RenderDevice() {}
+
+	// --- シェーダー ---
+	virtual void VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+	virtual void PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+
+	// --- 入力アセンブラ ---
+	virtual void IASetInputLayout(ID3D11InputLayout* inputLayout) = 0;
+	virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) = 0;
+	virtual void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets) = 0;
+	virtual void IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset) = 0;
+
+	// --- 定数バッファ・SRV・サンプラー ---
+	virtual void VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) = 0;
+	virtual void PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) = 0;
+	virtual void VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants) = 0;
+	virtual void PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants) = 0;
+	virtual void VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) = 0;
+	virtual void PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) = 0;
+	virtual void VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+	virtual void PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+
+	// --- 固定機能ステート・出力 ---
+	virtual void RSSetState(ID3D11RasterizerState* state) = 0;
+	virtual void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) = 0;
+	virtual void RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports) = 0;
+	virtual void OMSetBlendState(ID3D11BlendState* state, const FLOAT blendFactor[4], UINT sampleMask) = 0;
+	virtual void OMSetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef) = 0;
+	virtual void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) = 0;
+	virtual void OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView) = 0;
+	virtual void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4]) = 0;
+	virtual void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) = 0;
+
+	// --- 書き込み ---
+	virtual HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) = 0;
+	// writtenBytes : Map してから書き込んだバイト数 (統計用、0 ならリソース全体とみなす)
+	virtual void Unmap(ID3D11Resource* resource, UINT subresource, UINT writtenBytes) = 0;
+	virtual void UpdateSubresource(ID3D11Resource* resource, UINT subresource, const D3D11_BOX* box, const void* data, UINT rowPitch, UINT depthPitch) = 0;
+	virtual void CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT x, UINT y, UINT z, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox) = 0;
+
+	// --- 描画 ---
+	virtual void Draw(UINT vertexCount, UINT startVertexLocation) = 0;
+	virtual void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) = 0;
+	virtual void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) = 0;
+	virtual void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) = 0;
+};
+
+//--------------------------------------------------------------
+// RecordingRenderDevice
+//--------------------------------------------------------------
+// 描画・書き込みバイト数・ステート変更を数える
+// next があればそのまま流す (実際の描画を残したまま数える)、なければ何も描かない (ヘッドレスでの計測用)
+// next がない時の Map は数えるだけのための作業領域を返す
+class RecordingRenderDevice : public RenderDevice
+{
+public:
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		uint32_t drawCalls = 0;
+		uint64_t primitiveVertices = 0;		// 描いた頂点・インデックス数 (インスタンス数を掛けたもの)
+		uint32_t stateChanges = 0;			// シェーダー・バッファ・ステート・出力の設定
+		uint32_t uploads = 0;				// Map / UpdateSubresource / Copy の回数
+		uint64_t uploadedBytes = 0;			// Map は Unmap で渡された書き込み量で数える
+		uint32_t clears = 0;
+	};
+
+public:
+	explicit RecordingRenderDevice(RenderDevice* next = nullptr) : next(next) {}
+	~RecordingRenderDevice() override {}
+
+	void SetNext(RenderDevice* next) { this->next = next; }
+
+	// フレームの開始 (統計を前フレーム分へ移す)
+	void BeginFrame() { lastStatistics = statistics; statistics = {}; }
+	const Statistics& GetStatistics() const { return statistics; }
+	const Statistics& GetLastStatistics() const { return lastStatistics; }
+
+	// --- RenderDevice ---
+	void VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) override;
+	void PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) override;
+	void IASetInputLayout(ID3D11InputLayout* inputLayout) override;
+	void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) override;
+	void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets) override;
+	void IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset) override;
+	void VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) override;
+	void PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) override;
+	void VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants) override;
+	void PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants) override;
+	void VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) override;
+	void PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) override;
+	void VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) override;
+	void PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) override;
+	void RSSetState(ID3D11RasterizerState* state) override;
+	void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) override;
+	void RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports) override;
+	void OMSetBlendState(ID3D11BlendState* state, const FLOAT blendFactor[4], UINT sampleMask) override;
+	void OMSetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef) override;
+	void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) override;
+	void OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView) override;
+	void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4]) override;
+	void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) override;
+	HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) override;
+	void Unmap(ID3D11Resource* resource, UINT subresource, UINT writtenBytes) override;
+	void UpdateSubresource(ID3D11Resource* resource, UINT subresource, const D3D11_BOX* box, const void* data, UINT rowPitch, UINT depthPitch) override;
+	void CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT x, UINT y, UINT z, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox) override;
+	void Draw(UINT vertexCount, UINT startVertexLocation) override;
+	void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) override;
+	void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) override;
+	void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) override;
+
+public:
+	// next がない時の Map で返す作業領域の最小サイズ
+	size_t scratchSize = 4 * 1024 * 1024;
+
+	// next がない時に RSGetViewports で返すビューポート
+	D3D11_VIEWPORT nullViewport = { 0, 0, 1280, 720, 0, 1 };
+
+private:
+	// 書き込み先のバイト数と 1 行のバイト数 (分からなければ 0)
+	static UINT GetResourceSize(ID3D11Resource* resource, UINT& rowPitch);
+
+private:
+	RenderDevice* next = nullptr;
+
+	std::vector<uint8_t> scratch;
+	D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE] = {};
+	UINT viewportCount = 0;
+
+	Statistics statistics;
+	Statistics lastStatistics;
+};
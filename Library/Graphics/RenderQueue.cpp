@@ -0,0 +1,194 @@
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include "RenderQueue.h"
+
+// キーの作成
+uint64_t RenderKey::Make(PASS pass, uint32_t pipeline, uint32_t renderState, uint32_t material, uint32_t textureSet, uint16_t depth)
+{
+	// ステート部分 (pipeline 8 | renderState 4 | material 16 | textureSet 16)
+	const uint64_t state =
+		(static_cast<uint64_t>(pipeline & 0xFF) << 36) |
+		(static_cast<uint64_t>(renderState & 0xF) << 32) |
+		(static_cast<uint64_t>(material & 0xFFFF) << 16) |
+		static_cast<uint64_t>(textureSet & 0xFFFF);
+
+	// 半透明は深度を先に比べる (奥から描く)、それ以外はステートでまとめてから手前から描く
+	const uint64_t key = static_cast<uint64_t>(pass & 0xF) << 60;
+	if (pass == TRANSLUCENT_PASS) return key | (static_cast<uint64_t>(depth) << 44) | state;
+	return key | (state << 16) | static_cast<uint64_t>(depth);
+}
+
+// 距離を 16bit に量子化する
+uint16_t RenderKey::QuantizeDepth(PASS pass, float distance, float farDistance)
+{
+	const float rate = (std::clamp)(distance / farDistance, 0.0f, 1.0f);
+	const uint16_t depth = static_cast<uint16_t>(rate * 0xFFFF);
+
+	// 半透明は奥から描く
+	return (pass == TRANSLUCENT_PASS) ? static_cast<uint16_t>(0xFFFF - depth) : depth;
+}
+
+// 記録開始
+void RenderQueue::Begin(float eyeX, float eyeY, float eyeZ)
+{
+	packets.clear();
+	constants.clear();
+	sortItems.clear();
+
+	eye[0] = eyeX;
+	eye[1] = eyeY;
+	eye[2] = eyeZ;
+	recording = true;
+}
+
+// 定数の書き込み
+uint32_t RenderQueue::PushConstants(const void* data, uint32_t size)
+{
+	// 16 バイト境界に揃えておく (定数バッファの単位)
+	const uint32_t offset = static_cast<uint32_t>((constants.size() + 15) & ~static_cast<size_t>(15));
+	constants.resize(static_cast<size_t>(offset) + size);
+	std::memcpy(constants.data() + offset, data, size);
+	return offset;
+}
+
+// パケットの追加
+void RenderQueue::Push(const Packet& packet)
+{
+	packets.emplace_back(packet);
+}
+
+// キーで並べ替え
+void RenderQueue::Sort()
+{
+	const size_t count = packets.size();
+	sortItems.resize(count);
+	sortScratch.resize(count);
+
+	uint64_t allOr = 0;
+	uint64_t allAnd = ~0ull;
+	for (size_t i = 0; i < count; i++)
+	{
+		sortItems[i] = { packets[i].key, static_cast<uint32_t>(i) };
+		allOr |= packets[i].key;
+		allAnd &= packets[i].key;
+	}
+
+	// 8bit ずつの LSD 基数ソート (安定)
+	// 全パケットで同じ値の桁は並びが変わらないので飛ばす
+	const uint64_t differentBits = allOr ^ allAnd;
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		if (((differentBits >> shift) & 0xFF) == 0) continue;
+
+		uint32_t histogram[256] = {};
+		for (const SortItem& item : sortItems)
+		{
+			histogram[(item.key >> shift) & 0xFF]++;
+		}
+
+		uint32_t offset = 0;
+		for (uint32_t& bucket : histogram)
+		{
+			const uint32_t bucketCount = bucket;
+			bucket = offset;
+			offset += bucketCount;
+		}
+
+		for (const SortItem& item : sortItems)
+		{
+			sortScratch[histogram[(item.key >> shift) & 0xFF]++] = item;
+		}
+		sortItems.swap(sortScratch);
+	}
+}
+
+// backend へ流す
+void RenderQueue::Submit(RenderBackend& backend)
+{
+	statistics = {};
+	statistics.packetCount = static_cast<uint32_t>(sortItems.size());
+
+	// 直前に設定した id (最初は必ず設定されるように無効値)
+	constexpr uint32_t INVALID = ~0u;
+	uint32_t pipeline = INVALID;
+	uint32_t renderState = INVALID;
+	uint32_t material = INVALID;
+	uint32_t textureSet = INVALID;
+	uint32_t geometry = INVALID;
+	uint32_t constantsOffset[RenderBackend::CONSTANTS_COUNT];
+	std::fill(std::begin(constantsOffset), std::end(constantsOffset), INVALID);
+
+	for (const SortItem& item : sortItems)
+	{
+		const Packet& packet = packets[item.index];
+
+		if (packet.pipeline != pipeline)
+		{
+			backend.BindPipeline(packet.pipeline);
+			pipeline = packet.pipeline;
+			statistics.pipelineBinds++;
+
+			// 定数の設定先はパイプラインごとなので設定し直す
+			std::fill(std::begin(constantsOffset), std::end(constantsOffset), INVALID);
+		}
+		if (packet.renderState != renderState)
+		{
+			backend.BindRenderState(packet.renderState);
+			renderState = packet.renderState;
+			statistics.renderStateBinds++;
+		}
+		if (packet.material != material)
+		{
+			backend.BindMaterial(packet.material);
+			material = packet.material;
+			statistics.materialBinds++;
+		}
+		if (packet.textureSet != textureSet)
+		{
+			backend.BindTextureSet(packet.textureSet);
+			textureSet = packet.textureSet;
+			statistics.textureSetBinds++;
+		}
+		if (packet.geometry != geometry)
+		{
+			backend.BindGeometry(packet.geometry);
+			geometry = packet.geometry;
+			statistics.geometryBinds++;
+		}
+		// 定数はどれかが変わったら、この描画で使うもの全てをまとめて渡す
+		// (リングバッファが一周した時に、変わっていない方の範囲だけが無効になるのを防ぐ)
+		bool constantsChanged = false;
+		for (uint32_t i = 0; i < RenderBackend::CONSTANTS_COUNT; i++)
+		{
+			if (packet.constantsSize[i] != 0 && packet.constantsOffset[i] != constantsOffset[i]) constantsChanged = true;
+		}
+		if (constantsChanged)
+		{
+			const void* data[RenderBackend::CONSTANTS_COUNT] = {};
+			for (uint32_t i = 0; i < RenderBackend::CONSTANTS_COUNT; i++)
+			{
+				constantsOffset[i] = packet.constantsSize[i] != 0 ? packet.constantsOffset[i] : INVALID;
+				if (packet.constantsSize[i] == 0) continue;
+
+				data[i] = constants.data() + packet.constantsOffset[i];
+				statistics.constantBytes += packet.constantsSize[i];
+			}
+			backend.UpdateConstants(data, packet.constantsSize);
+			statistics.constantUpdates++;
+		}
+
+		backend.DrawIndexed(packet.indexCount, packet.startIndexLocation, packet.baseVertexLocation);
+		statistics.drawCalls++;
+	}
+}
+
+// 視点からの距離
+float RenderQueue::GetDistanceFromEye(float x, float y, float z) const
+{
+	const float dx = x - eye[0];
+	const float dy = y - eye[1];
+	const float dz = z - eye[2];
+	return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
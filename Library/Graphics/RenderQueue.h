@@ -0,0 +1,229 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//--------------------------------------------------------------
+// RenderBackend
+//--------------------------------------------------------------
+// RenderQueue が実際の描画 API を呼ぶためのインターフェース
+// 各 id は backend 側で登録したリソースの番号 (RenderQueue は中身を知らない)
+class RenderBackend
+{
+public:
+	// 描画ごとに書き込む定数の種類
+	enum CONSTANTS : uint32_t
+	{
+		OBJECT_CONSTANTS,		// オブジェクトごと (ワールド行列・色など)
+		SKELETON_CONSTANTS,		// スケルトンごと (ボーン行列、ボーン数分だけ)
+
+		CONSTANTS_COUNT,
+	};
+
+public:
+	virtual ~RenderBackend() {}
+
+	// シェーダー・入力レイアウト
+	virtual void BindPipeline(uint32_t pipeline) = 0;
+	// ラスタライザなどの固定機能ステート
+	virtual void BindRenderState(uint32_t renderState) = 0;
+	// マテリアル定数
+	virtual void BindMaterial(uint32_t material) = 0;
+	// テクスチャのセット
+	virtual void BindTextureSet(uint32_t textureSet) = 0;
+	// 頂点・インデックスバッファ
+	virtual void BindGeometry(uint32_t geometry) = 0;
+	// 描画ごとの定数 (現在のパイプラインの該当スロットへ設定する)
+	// 1 回の描画で使う定数は全てまとめて渡す (size が 0 の種類は使わない)
+	// 定数のどれかが変わった時は、変わっていないものも含めて渡すので、書き込む途中で先に設定した範囲が無効になることはない
+	virtual void UpdateConstants(const void* const data[CONSTANTS_COUNT], const uint32_t size[CONSTANTS_COUNT]) = 0;
+	// 描画
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndexLocation, int32_t baseVertexLocation) = 0;
+};
+
+//--------------------------------------------------------------
+// RenderKey
+//--------------------------------------------------------------
+// 描画順を決める 64bit のキー (上位ビットから比較される)
+// 不透明・影 : | pass 4 | pipeline 8 | renderState 4 | material 16 | textureSet 16 | depth 16 |
+// 半透明     : | pass 4 | depth 16 | pipeline 8 | renderState 4 | material 16 | textureSet 16 |
+// (半透明はマテリアルが違っても奥から描かないと重なりが崩れるので、深度をステートより上に置く)
+namespace RenderKey
+{
+	enum PASS : uint32_t
+	{
+		SHADOW_PASS,
+		SOLID_PASS,
+		TRANSLUCENT_PASS,
+
+		PASS_COUNT,
+	};
+
+	uint64_t Make(PASS pass, uint32_t pipeline, uint32_t renderState, uint32_t material, uint32_t textureSet, uint16_t depth);
+
+	// 距離を 16bit に量子化する (不透明は手前から、半透明は奥から並ぶようにする)
+	uint16_t QuantizeDepth(PASS pass, float distance, float farDistance);
+
+	inline uint32_t GetPass(uint64_t key) { return static_cast<uint32_t>(key >> 60) & 0xF; }
+
+	// ステート部分 (pipeline 以下の 44bit) と深度の位置はパスで変わる
+	inline uint32_t GetStateShift(uint64_t key) { return GetPass(key) == TRANSLUCENT_PASS ? 0 : 16; }
+	inline uint32_t GetDepthShift(uint64_t key) { return GetPass(key) == TRANSLUCENT_PASS ? 44 : 0; }
+
+	inline uint32_t GetPipeline(uint64_t key) { return static_cast<uint32_t>(key >> (GetStateShift(key) + 36)) & 0xFF; }
+	inline uint32_t GetRenderState(uint64_t key) { return static_cast<uint32_t>(key >> (GetStateShift(key) + 32)) & 0xF; }
+	inline uint32_t GetMaterial(uint64_t key) { return static_cast<uint32_t>(key >> (GetStateShift(key) + 16)) & 0xFFFF; }
+	inline uint32_t GetTextureSet(uint64_t key) { return static_cast<uint32_t>(key >> GetStateShift(key)) & 0xFFFF; }
+	inline uint32_t GetDepth(uint64_t key) { return static_cast<uint32_t>(key >> GetDepthShift(key)) & 0xFFFF; }
+}
+
+//--------------------------------------------------------------
+// RenderQueue
+//--------------------------------------------------------------
+// 描画パケットを集めてキーで基数ソートし、同じステートの再設定を省いて backend に流す
+// 描画 API に依存しないので、RecordingRenderBackend を使えば GPU なしで確認できる
+class RenderQueue
+{
+public:
+	// 描画パケット
+	struct Packet
+	{
+		uint64_t key = 0;
+
+		uint32_t pipeline = 0;
+		uint32_t renderState = 0;
+		uint32_t material = 0;
+		uint32_t textureSet = 0;
+		uint32_t geometry = 0;
+
+		uint32_t indexCount = 0;
+		uint32_t startIndexLocation = 0;
+		int32_t baseVertexLocation = 0;
+
+		// 定数 (RenderQueue 内の領域の位置とサイズ、サイズ 0 なら更新しない)
+		// 同じメッシュのサブセットは同じ位置を指すので、続けて描かれれば書き込みは 1 回になる
+		uint32_t constantsOffset[RenderBackend::CONSTANTS_COUNT] = {};
+		uint32_t constantsSize[RenderBackend::CONSTANTS_COUNT] = {};
+	};
+
+	// Submit 1 回分の統計
+	struct Statistics
+	{
+		uint32_t packetCount = 0;
+		uint32_t pipelineBinds = 0;
+		uint32_t renderStateBinds = 0;
+		uint32_t materialBinds = 0;
+		uint32_t textureSetBinds = 0;
+		uint32_t geometryBinds = 0;
+		uint32_t constantUpdates = 0;
+		uint32_t constantBytes = 0;
+		uint32_t drawCalls = 0;
+	};
+
+public:
+	RenderQueue() {}
+	~RenderQueue() {}
+
+	// ゲーム全体で使うキュー
+	static RenderQueue& Instance()
+	{
+		static RenderQueue instance;
+		return instance;
+	}
+
+	// 記録開始 (前フレームのパケットを捨てる)
+	void Begin(float eyeX, float eyeY, float eyeZ);
+	// 記録終了
+	void End() { recording = false; }
+	// 記録中か (記録中は SkinnedMesh::Render などがパケットを積む)
+	bool IsRecording() const { return recording; }
+
+	// 定数の書き込み (戻り値は Packet::constantsOffset に入れる値)
+	uint32_t PushConstants(const void* data, uint32_t size);
+	// パケットの追加
+	void Push(const Packet& packet);
+
+	// キーで並べ替え (同じキーは積んだ順を保つ)
+	void Sort();
+	// backend へ流す (Sort 後に呼ぶ)
+	void Submit(RenderBackend& backend);
+
+	// 視点からの距離
+	float GetDistanceFromEye(float x, float y, float z) const;
+
+	// 取得
+	size_t GetPacketCount() const { return packets.size(); }
+	const Packet& GetSortedPacket(size_t index) const { return packets[sortItems[index].index]; }
+	const Statistics& GetStatistics() const { return statistics; }
+
+public:
+	// depth の量子化に使う距離の上限
+	float farDistance = 1000.0f;
+
+private:
+	struct SortItem
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	std::vector<Packet> packets;
+	std::vector<uint8_t> constants;
+
+	// 基数ソート用
+	std::vector<SortItem> sortItems;
+	std::vector<SortItem> sortScratch;
+
+	Statistics statistics;
+
+	float eye[3] = { 0,0,0 };
+	bool recording = false;
+};
+
+//--------------------------------------------------------------
+// RecordingRenderBackend
+//--------------------------------------------------------------
+// backend に来た呼び出しをそのまま記録する (描画順やステート変更回数の確認用)
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	enum class COMMAND
+	{
+		BIND_PIPELINE,
+		BIND_RENDER_STATE,
+		BIND_MATERIAL,
+		BIND_TEXTURE_SET,
+		BIND_GEOMETRY,
+		UPDATE_CONSTANTS,
+		DRAW_INDEXED,
+	};
+
+	struct Command
+	{
+		COMMAND type;
+		uint32_t value;		// id / 定数サイズの合計 / インデックス数
+		uint32_t start = 0;	// DrawIndexed の startIndexLocation / 定数の種類のビット (1 << CONSTANTS)
+	};
+
+public:
+	void BindPipeline(uint32_t pipeline) override { commands.push_back({ COMMAND::BIND_PIPELINE, pipeline }); }
+	void BindRenderState(uint32_t renderState) override { commands.push_back({ COMMAND::BIND_RENDER_STATE, renderState }); }
+	void BindMaterial(uint32_t material) override { commands.push_back({ COMMAND::BIND_MATERIAL, material }); }
+	void BindTextureSet(uint32_t textureSet) override { commands.push_back({ COMMAND::BIND_TEXTURE_SET, textureSet }); }
+	void BindGeometry(uint32_t geometry) override { commands.push_back({ COMMAND::BIND_GEOMETRY, geometry }); }
+	void UpdateConstants(const void* const data[CONSTANTS_COUNT], const uint32_t size[CONSTANTS_COUNT]) override
+	{
+		Command command = { COMMAND::UPDATE_CONSTANTS, 0, 0 };
+		for (uint32_t i = 0; i < CONSTANTS_COUNT; i++)
+		{
+			if (size[i] == 0) continue;
+			command.value += size[i];
+			command.start |= 1u << i;
+		}
+		commands.push_back(command);
+	}
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndexLocation, int32_t baseVertexLocation) override { commands.push_back({ COMMAND::DRAW_INDEXED, indexCount, startIndexLocation }); }
+
+public:
+	std::vector<Command> commands;
+};
@@ -0,0 +1,524 @@
+#include <cstring>
+#include <crtdbg.h>
+#include "StateCache.h"
+
+namespace
+{
+	// 「何が設定されているか分からない」を表す値 (どのオブジェクトとも一致しない)
+	template<class T>
+	T* Unknown()
+	{
+		return reinterpret_cast<T*>(~static_cast<uintptr_t>(0));
+	}
+
+	template<class T, size_t N>
+	void FillUnknown(T* (&values)[N])
+	{
+		for (T*& value : values) value = Unknown<T>();
+	}
+}
+
+// 流し先の設定
+void StateCache::SetDevice(RenderDevice* device)
+{
+	// 前の流し先に溜まっている SRV を流してから切り替える
+	FlushShaderResources();
+	this->device = device;
+
+	Invalidate();
+}
+
+// 覚えている内容を捨てる
+void StateCache::Invalidate()
+{
+	FlushShaderResources();
+
+	vertexShader = Unknown<ID3D11VertexShader>();
+	pixelShader = Unknown<ID3D11PixelShader>();
+	inputLayout = Unknown<ID3D11InputLayout>();
+	topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+
+	FillUnknown(vertexBuffers);
+	indexBuffer = Unknown<ID3D11Buffer>();
+
+	FillUnknown(vsConstantBuffers.buffers);
+	FillUnknown(psConstantBuffers.buffers);
+	FillUnknown(vsSamplers);
+	FillUnknown(psSamplers);
+	InvalidateShaderResources(vsShaderResources);
+	InvalidateShaderResources(psShaderResources);
+
+	rasterizerState = Unknown<ID3D11RasterizerState>();
+	blendState = Unknown<ID3D11BlendState>();
+	depthStencilState = Unknown<ID3D11DepthStencilState>();
+
+	viewportCount = 0;
+}
+
+// フレームの開始
+void StateCache::BeginFrame()
+{
+	lastStatistics = statistics;
+	statistics = {};
+
+	// 前フレームの最後に外部ライブラリが触っているかもしれないので捨てておく
+	Invalidate();
+}
+
+
+//--------------------------------------------------------------
+//  シェーダー
+//--------------------------------------------------------------
+
+void StateCache::VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances)
+{
+	statistics.requestedCalls++;
+	// クラスインスタンス付きは比較できないので必ず流す
+	if (enable && numClassInstances == 0 && shader == vertexShader) return;
+
+	device->VSSetShader(shader, classInstances, numClassInstances);
+	vertexShader = numClassInstances == 0 ? shader : Unknown<ID3D11VertexShader>();
+	statistics.issuedCalls++;
+}
+
+void StateCache::PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances)
+{
+	statistics.requestedCalls++;
+	if (enable && numClassInstances == 0 && shader == pixelShader) return;
+
+	device->PSSetShader(shader, classInstances, numClassInstances);
+	pixelShader = numClassInstances == 0 ? shader : Unknown<ID3D11PixelShader>();
+	statistics.issuedCalls++;
+}
+
+
+//--------------------------------------------------------------
+//  入力アセンブラ
+//--------------------------------------------------------------
+
+void StateCache::IASetInputLayout(ID3D11InputLayout* inputLayout)
+{
+	statistics.requestedCalls++;
+	if (enable && inputLayout == this->inputLayout) return;
+
+	device->IASetInputLayout(inputLayout);
+	this->inputLayout = inputLayout;
+	statistics.issuedCalls++;
+}
+
+void StateCache::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	statistics.requestedCalls++;
+	if (enable && topology == this->topology) return;
+
+	device->IASetPrimitiveTopology(topology);
+	this->topology = topology;
+	statistics.issuedCalls++;
+}
+
+void StateCache::IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets)
+{
+	statistics.requestedCalls++;
+	// 0 個の設定は何もしない
+	if (enable && numBuffers == 0) return;
+
+	const bool tracked = buffers && strides && offsets && startSlot + numBuffers <= VertexBufferSlotMax;
+	if (enable && tracked)
+	{
+		bool changed = false;
+		for (UINT i = 0; i < numBuffers; i++)
+		{
+			const UINT slot = startSlot + i;
+			if (vertexBuffers[slot] != buffers[i] || vertexStrides[slot] != strides[i] || vertexOffsets[slot] != offsets[i])
+			{
+				changed = true;
+				break;
+			}
+		}
+		if (!changed) return;
+	}
+
+	device->IASetVertexBuffers(startSlot, numBuffers, buffers, strides, offsets);
+	statistics.issuedCalls++;
+
+	for (UINT i = 0; i < numBuffers && startSlot + i < VertexBufferSlotMax; i++)
+	{
+		const UINT slot = startSlot + i;
+		vertexBuffers[slot] = tracked ? buffers[i] : Unknown<ID3D11Buffer>();
+		vertexStrides[slot] = tracked ? strides[i] : 0;
+		vertexOffsets[slot] = tracked ? offsets[i] : 0;
+	}
+}
+
+void StateCache::IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset)
+{
+	statistics.requestedCalls++;
+	if (enable && buffer == indexBuffer && format == indexFormat && offset == indexOffset) return;
+
+	device->IASetIndexBuffer(buffer, format, offset);
+	indexBuffer = buffer;
+	indexFormat = format;
+	indexOffset = offset;
+	statistics.issuedCalls++;
+}
+
+
+//--------------------------------------------------------------
+//  定数バッファ・SRV・サンプラー
+//--------------------------------------------------------------
+
+namespace
+{
+	// 配列ステートの比較と記録 (変更があれば true)
+	template<class T, size_t N>
+	bool UpdateSlots(T* (&cache)[N], UINT startSlot, UINT count, T* const* values, bool enable)
+	{
+		const bool tracked = values && startSlot + count <= N;
+
+		bool changed = !enable || !tracked;
+		for (UINT i = 0; i < count && startSlot + i < N; i++)
+		{
+			T* value = tracked ? values[i] : Unknown<T>();
+			if (cache[startSlot + i] != value) changed = true;
+			cache[startSlot + i] = value;
+		}
+		return changed;
+	}
+}
+
+void StateCache::VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers)
+{
+	SetConstantBuffers(vsConstantBuffers, false, startSlot, numBuffers, buffers, nullptr, nullptr);
+}
+
+void StateCache::PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers)
+{
+	SetConstantBuffers(psConstantBuffers, true, startSlot, numBuffers, buffers, nullptr, nullptr);
+}
+
+void StateCache::VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	SetConstantBuffers(vsConstantBuffers, false, startSlot, numBuffers, buffers, firstConstants, numConstants);
+}
+
+void StateCache::PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	SetConstantBuffers(psConstantBuffers, true, startSlot, numBuffers, buffers, firstConstants, numConstants);
+}
+
+// 定数バッファの設定 (firstConstants が nullptr ならバッファ全体)
+void StateCache::SetConstantBuffers(ConstantBufferSlots& slots, bool pixelShader, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	statistics.requestedCalls++;
+
+	const bool ranged = firstConstants && numConstants;
+	const bool tracked = buffers && startSlot + numBuffers <= ConstantBufferSlotMax;
+
+	bool changed = !enable || !tracked;
+	for (UINT i = 0; i < numBuffers && startSlot + i < ConstantBufferSlotMax; i++)
+	{
+		const UINT slot = startSlot + i;
+		ID3D11Buffer* buffer = tracked ? buffers[i] : Unknown<ID3D11Buffer>();
+		const UINT first = ranged ? firstConstants[i] : 0;
+		const UINT count = ranged ? numConstants[i] : WholeBuffer;
+
+		if (slots.buffers[slot] != buffer || slots.firstConstants[slot] != first || slots.numConstants[slot] != count) changed = true;
+		slots.buffers[slot] = buffer;
+		slots.firstConstants[slot] = first;
+		slots.numConstants[slot] = count;
+	}
+	if (!changed) return;
+
+	if (ranged)
+	{
+		pixelShader ?
+			device->PSSetConstantBuffers1(startSlot, numBuffers, buffers, firstConstants, numConstants) :
+			device->VSSetConstantBuffers1(startSlot, numBuffers, buffers, firstConstants, numConstants);
+	}
+	else
+	{
+		pixelShader ?
+			device->PSSetConstantBuffers(startSlot, numBuffers, buffers) :
+			device->VSSetConstantBuffers(startSlot, numBuffers, buffers);
+	}
+	statistics.issuedCalls++;
+}
+
+void StateCache::VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers)
+{
+	statistics.requestedCalls++;
+	if (!UpdateSlots(vsSamplers, startSlot, numSamplers, samplers, enable)) return;
+
+	device->VSSetSamplers(startSlot, numSamplers, samplers);
+	statistics.issuedCalls++;
+}
+
+void StateCache::PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers)
+{
+	statistics.requestedCalls++;
+	if (!UpdateSlots(psSamplers, startSlot, numSamplers, samplers, enable)) return;
+
+	device->PSSetSamplers(startSlot, numSamplers, samplers);
+	statistics.issuedCalls++;
+}
+
+void StateCache::VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views)
+{
+	SetShaderResources(vsShaderResources, false, startSlot, numViews, views);
+}
+
+void StateCache::PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views)
+{
+	SetShaderResources(psShaderResources, true, startSlot, numViews, views);
+}
+
+// SRV の設定 (描画まで溜めておく)
+void StateCache::SetShaderResources(ShaderResourceSlots& slots, bool pixelShader, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views)
+{
+	statistics.requestedCalls++;
+
+	// 覚えていないスロットはそのまま流す
+	if (!views || startSlot + numViews > ShaderResourceSlotMax)
+	{
+		FlushShaderResources(slots, pixelShader);
+		pixelShader ?
+			device->PSSetShaderResources(startSlot, numViews, views) :
+			device->VSSetShaderResources(startSlot, numViews, views);
+		statistics.issuedCalls++;
+
+		for (UINT slot = startSlot; slot < startSlot + numViews && slot < ShaderResourceSlotMax; slot++)
+		{
+			slots.bound[slot] = slots.pending[slot] = Unknown<ID3D11ShaderResourceView>();
+		}
+		return;
+	}
+
+	for (UINT i = 0; i < numViews; i++)
+	{
+		const UINT slot = startSlot + i;
+		slots.pending[slot] = views[i];
+
+		// 無効時は変わっていなくても流す
+		if (slots.pending[slot] != slots.bound[slot] || !enable)
+		{
+			if (slot < slots.dirtyMin) slots.dirtyMin = slot;
+			if (slot > slots.dirtyMax) slots.dirtyMax = slot;
+		}
+	}
+
+	if (!enable) FlushShaderResources(slots, pixelShader);
+}
+
+// 溜まっている SRV を流す
+void StateCache::FlushShaderResources()
+{
+	if (!device) return;
+
+	FlushShaderResources(vsShaderResources, false);
+	FlushShaderResources(psShaderResources, true);
+}
+
+void StateCache::FlushShaderResources(ShaderResourceSlots& slots, bool pixelShader)
+{
+	if (slots.dirtyMin > slots.dirtyMax) return;
+
+	// 変更のあったスロットを端から端まで 1 回で設定する
+	// 間に挟まった変更のないスロットも同じものを設定し直すだけなので含めてしまう
+	// (何が入っているか分からないスロットだけは含められないのでそこで区切る)
+	UINT slot = slots.dirtyMin;
+	while (slot <= slots.dirtyMax)
+	{
+		if (slots.pending[slot] == slots.bound[slot] && enable)
+		{
+			slot++;
+			continue;
+		}
+
+		UINT end = slot;
+		UINT lastChanged = slot;
+		while (end + 1 <= slots.dirtyMax && slots.pending[end + 1] != Unknown<ID3D11ShaderResourceView>())
+		{
+			end++;
+			if (slots.pending[end] != slots.bound[end] || !enable) lastChanged = end;
+		}
+
+		const UINT count = lastChanged - slot + 1;
+		pixelShader ?
+			device->PSSetShaderResources(slot, count, &slots.pending[slot]) :
+			device->VSSetShaderResources(slot, count, &slots.pending[slot]);
+		statistics.issuedCalls++;
+		statistics.coalescedSlots += count;
+
+		std::memcpy(&slots.bound[slot], &slots.pending[slot], sizeof(ID3D11ShaderResourceView*) * count);
+		slot = lastChanged + 1;
+	}
+
+	slots.dirtyMin = ShaderResourceSlotMax;
+	slots.dirtyMax = 0;
+}
+
+void StateCache::InvalidateShaderResources(ShaderResourceSlots& slots)
+{
+	FillUnknown(slots.bound);
+	FillUnknown(slots.pending);
+	slots.dirtyMin = ShaderResourceSlotMax;
+	slots.dirtyMax = 0;
+}
+
+
+//--------------------------------------------------------------
+//  固定機能ステート
+//--------------------------------------------------------------
+
+void StateCache::RSSetState(ID3D11RasterizerState* state)
+{
+	statistics.requestedCalls++;
+	if (enable && state == rasterizerState) return;
+
+	device->RSSetState(state);
+	rasterizerState = state;
+	statistics.issuedCalls++;
+}
+
+void StateCache::OMSetBlendState(ID3D11BlendState* state, const FLOAT blendFactor[4], UINT sampleMask)
+{
+	statistics.requestedCalls++;
+
+	// NULL は { 1, 1, 1, 1 } と同じ
+	const FLOAT defaultFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	const FLOAT* factor = blendFactor ? blendFactor : defaultFactor;
+
+	if (enable && state == blendState && sampleMask == this->sampleMask &&
+		std::memcmp(factor, this->blendFactor, sizeof(this->blendFactor)) == 0) return;
+
+	device->OMSetBlendState(state, blendFactor, sampleMask);
+	blendState = state;
+	std::memcpy(this->blendFactor, factor, sizeof(this->blendFactor));
+	this->sampleMask = sampleMask;
+	statistics.issuedCalls++;
+}
+
+void StateCache::RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports)
+{
+	statistics.requestedCalls++;
+
+	const bool tracked = viewports && numViewports <= _countof(this->viewports);
+	if (enable && tracked && numViewports == viewportCount &&
+		std::memcmp(viewports, this->viewports, sizeof(D3D11_VIEWPORT) * numViewports) == 0) return;
+
+	device->RSSetViewports(numViewports, viewports);
+	viewportCount = tracked ? numViewports : 0;
+	if (tracked) std::memcpy(this->viewports, viewports, sizeof(D3D11_VIEWPORT) * numViewports);
+	statistics.issuedCalls++;
+}
+
+void StateCache::RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports)
+{
+	// 覚えていれば流し先へ問い合わせない
+	if (viewportCount == 0)
+	{
+		device->RSGetViewports(numViewports, viewports);
+		return;
+	}
+
+	if (viewports)
+	{
+		const UINT count = *numViewports < viewportCount ? *numViewports : viewportCount;
+		std::memcpy(viewports, this->viewports, sizeof(D3D11_VIEWPORT) * count);
+	}
+	*numViewports = viewportCount;
+}
+
+void StateCache::OMSetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef)
+{
+	statistics.requestedCalls++;
+	if (enable && state == depthStencilState && stencilRef == this->stencilRef) return;
+
+	device->OMSetDepthStencilState(state, stencilRef);
+	depthStencilState = state;
+	this->stencilRef = stencilRef;
+	statistics.issuedCalls++;
+}
+
+void StateCache::OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView)
+{
+	statistics.requestedCalls++;
+
+	// 呼び出し順を保つため、溜まっている SRV を先に設定しておく
+	FlushShaderResources();
+	device->OMSetRenderTargets(numViews, renderTargetViews, depthStencilView);
+	statistics.issuedCalls++;
+
+	// 出力に設定されたリソースの SRV は D3D 側で外されるので、SRV の記憶は捨てる
+	InvalidateShaderResources(vsShaderResources);
+	InvalidateShaderResources(psShaderResources);
+}
+
+void StateCache::OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView)
+{
+	device->OMGetRenderTargets(numViews, renderTargetViews, depthStencilView);
+}
+
+void StateCache::ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4])
+{
+	device->ClearRenderTargetView(renderTargetView, color);
+}
+
+void StateCache::ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil)
+{
+	device->ClearDepthStencilView(depthStencilView, clearFlags, depth, stencil);
+}
+
+
+//--------------------------------------------------------------
+//  書き込み
+//--------------------------------------------------------------
+
+HRESULT StateCache::Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource)
+{
+	return device->Map(resource, subresource, mapType, mapFlags, mappedResource);
+}
+
+void StateCache::Unmap(ID3D11Resource* resource, UINT subresource, UINT writtenBytes)
+{
+	device->Unmap(resource, subresource, writtenBytes);
+}
+
+void StateCache::UpdateSubresource(ID3D11Resource* resource, UINT subresource, const D3D11_BOX* box, const void* data, UINT rowPitch, UINT depthPitch)
+{
+	device->UpdateSubresource(resource, subresource, box, data, rowPitch, depthPitch);
+}
+
+void StateCache::CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT x, UINT y, UINT z, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox)
+{
+	device->CopySubresourceRegion(destination, destinationSubresource, x, y, z, source, sourceSubresource, sourceBox);
+}
+
+
+//--------------------------------------------------------------
+//  描画
+//--------------------------------------------------------------
+
+void StateCache::Draw(UINT vertexCount, UINT startVertexLocation)
+{
+	FlushShaderResources();
+	device->Draw(vertexCount, startVertexLocation);
+}
+
+void StateCache::DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
+{
+	FlushShaderResources();
+	device->DrawIndexed(indexCount, startIndexLocation, baseVertexLocation);
+}
+
+void StateCache::DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation)
+{
+	FlushShaderResources();
+	device->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+}
+
+void StateCache::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
+{
+	FlushShaderResources();
+	device->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <d3d11_1.h>
+#include <cstdint>
+#include "RenderDevice.h"
+
+//--------------------------------------------------------------
+// StateCache
+//--------------------------------------------------------------
+// deviceContext の前に置く影ステート
+// 現在バインドされているシェーダー・バッファ・SRV・サンプラー・固定機能ステート・ビューポートを覚えておき、
+// 同じものの再設定は流し先 (RenderDevice) へ流さない
+// 書き込み (Map, UpdateSubresource) やクリアもここを通すので、流し先を差し替えれば描画 API なしで回せる
+// SRV は描画の直前までまとめておき、連続したスロットは 1 回の呼び出しにする
+//
+// 外部ライブラリ (Effekseer, SpriteBatch, ImGui) が deviceContext を直接触った後は
+// Invalidate() を呼んで覚えている内容を捨てること
+class StateCache
+{
+public:
+	// 1 フレーム分の統計
+	struct Statistics
+	{
+		uint32_t requestedCalls = 0;	// StateCache が受けた呼び出し
+		uint32_t issuedCalls = 0;		// deviceContext へ流した呼び出し
+		uint32_t coalescedSlots = 0;	// まとめて設定した SRV スロット数
+
+		uint32_t GetFilteredCalls() const { return requestedCalls > issuedCalls ? requestedCalls - issuedCalls : 0; }
+	};
+
+	// 覚えておくスロット数 (これを超えるスロットはそのまま流す)
+	static constexpr UINT ConstantBufferSlotMax = 14;
+	static constexpr UINT ShaderResourceSlotMax = 16;
+	static constexpr UINT SamplerSlotMax = 16;
+	static constexpr UINT VertexBufferSlotMax = 8;
+
+public:
+	StateCache() { Invalidate(); }
+	~StateCache() {}
+
+	// 流し先の設定 (Graphics::SetRenderDevice から呼ばれる)
+	void SetDevice(RenderDevice* device);
+	RenderDevice* GetDevice() const { return device; }
+
+	// 覚えている内容を捨てる (溜まっている SRV は先に流す)
+	void Invalidate();
+	// フレームの開始 (統計を前フレーム分へ移す)
+	void BeginFrame();
+
+	// --- シェーダー ---
+	void VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances);
+	void PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances);
+
+	// --- 入力アセンブラ ---
+	void IASetInputLayout(ID3D11InputLayout* inputLayout);
+	void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+	void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets);
+	void IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset);
+
+	// --- 定数バッファ・SRV・サンプラー ---
+	void VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers);
+	void PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers);
+	// 範囲指定 (16 定数単位、ConstantRingBuffer の割り当てを設定する時に使う)
+	void VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants);
+	void PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants);
+	void VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views);
+	void PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views);
+	void VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers);
+	void PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers);
+
+	// --- 固定機能ステート ---
+	void RSSetState(ID3D11RasterizerState* state);
+	void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports);
+	// 覚えているビューポートを返す (Invalidate の後は流し先に問い合わせる)
+	void RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports);
+	void OMSetBlendState(ID3D11BlendState* state, const FLOAT blendFactor[4], UINT sampleMask);
+	void OMSetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef);
+	// レンダーターゲットは毎回流す (出力に使われた SRV は D3D 側で外されるので SRV の記憶を捨てる)
+	void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView);
+	void OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView);
+	void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4]);
+	void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil);
+
+	// --- 書き込み (そのまま流す) ---
+	HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource);
+	// writtenBytes : Map してから書き込んだバイト数 (統計用、0 ならリソース全体とみなす)
+	void Unmap(ID3D11Resource* resource, UINT subresource, UINT writtenBytes = 0);
+	void UpdateSubresource(ID3D11Resource* resource, UINT subresource, const D3D11_BOX* box, const void* data, UINT rowPitch, UINT depthPitch);
+	void CopySubresourceRegion(ID3D11Resource* destination, UINT destinationSubresource, UINT x, UINT y, UINT z, ID3D11Resource* source, UINT sourceSubresource, const D3D11_BOX* sourceBox);
+
+	// --- 描画 (溜まっている SRV を流してから描く) ---
+	void Draw(UINT vertexCount, UINT startVertexLocation);
+	void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation);
+	void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation);
+	void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation);
+
+	// 溜まっている SRV を流す
+	void FlushShaderResources();
+
+	// 前フレームの統計
+	const Statistics& GetStatistics() const { return lastStatistics; }
+
+public:
+	// false にすると全ての呼び出しをそのまま流す (比較用)
+	bool enable = true;
+
+private:
+	// ステージごとの SRV (描画まで溜めておく)
+	struct ShaderResourceSlots
+	{
+		ID3D11ShaderResourceView* bound[ShaderResourceSlotMax];		// deviceContext に設定済み
+		ID3D11ShaderResourceView* pending[ShaderResourceSlotMax];	// 次の描画で設定するもの
+		UINT dirtyMin;
+		UINT dirtyMax;	// dirtyMin > dirtyMax なら変更なし
+	};
+
+	// ステージごとの定数バッファ (範囲指定なしは firstConstant = 0, numConstants = WholeBuffer)
+	struct ConstantBufferSlots
+	{
+		ID3D11Buffer* buffers[ConstantBufferSlotMax];
+		UINT firstConstants[ConstantBufferSlotMax];
+		UINT numConstants[ConstantBufferSlotMax];
+	};
+	static constexpr UINT WholeBuffer = ~0u;
+
+	void SetConstantBuffers(ConstantBufferSlots& slots, bool pixelShader, UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants);
+	void SetShaderResources(ShaderResourceSlots& slots, bool pixelShader, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views);
+	void FlushShaderResources(ShaderResourceSlots& slots, bool pixelShader);
+	void InvalidateShaderResources(ShaderResourceSlots& slots);
+
+private:
+	RenderDevice* device = nullptr;
+
+	ID3D11VertexShader* vertexShader;
+	ID3D11PixelShader* pixelShader;
+	ID3D11InputLayout* inputLayout;
+	D3D11_PRIMITIVE_TOPOLOGY topology;
+
+	ID3D11Buffer* vertexBuffers[VertexBufferSlotMax];
+	UINT vertexStrides[VertexBufferSlotMax];
+	UINT vertexOffsets[VertexBufferSlotMax];
+	ID3D11Buffer* indexBuffer;
+	DXGI_FORMAT indexFormat;
+	UINT indexOffset;
+
+	ConstantBufferSlots vsConstantBuffers;
+	ConstantBufferSlots psConstantBuffers;
+	ID3D11SamplerState* vsSamplers[SamplerSlotMax];
+	ID3D11SamplerState* psSamplers[SamplerSlotMax];
+	ShaderResourceSlots vsShaderResources;
+	ShaderResourceSlots psShaderResources;
+
+	ID3D11RasterizerState* rasterizerState;
+	ID3D11BlendState* blendState;
+	FLOAT blendFactor[4];
+	UINT sampleMask;
+	ID3D11DepthStencilState* depthStencilState;
+	UINT stencilRef;
+	D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+	UINT viewportCount;		// 0 なら分からない
+
+	Statistics statistics;
+	Statistics lastStatistics;
+};
@@ -1,10 +1,40 @@
 #include <filesystem>
+#include <mutex>
 #include <DDSTextureLoader.h>
 #include <DirectXTex.h>
 #include "Texture.h"
 #include "../Graphics/Graphics.h"
 #include "../ErrorLogger.h"
 
+// 読み込み済みのテクスチャ (AsyncLoader のワーカーからも読み込むので排他する)
+static map<wstring, ComPtr<ID3D11ShaderResourceView>> resources;
+static std::mutex resourcesMutex;
+
+// 読み込み済みなら参照を増やして返す
+static bool FindTexture(const wchar_t* filename, ID3D11ShaderResourceView** shaderResourceView)
+{
+	std::lock_guard<std::mutex> lock(resourcesMutex);
+	auto it = resources.find(filename);
+	if (it == resources.end()) return false;
+
+	*shaderResourceView = it->second.Get();
+	(*shaderResourceView)->AddRef();
+	return true;
+}
+
+// 登録 (同時に読み込まれて先に登録されていればそちらに差し替える)
+static void RegisterTexture(const wchar_t* filename, ID3D11ShaderResourceView** shaderResourceView)
+{
+	std::lock_guard<std::mutex> lock(resourcesMutex);
+	auto result = resources.insert(make_pair(filename, *shaderResourceView));
+	if (!result.second)
+	{
+		(*shaderResourceView)->Release();
+		*shaderResourceView = result.first->second.Get();
+		(*shaderResourceView)->AddRef();
+	}
+}
+
 HRESULT LoadTextureFromFile(const wchar_t* filename, ID3D11ShaderResourceView** shaderResourceView, D3D11_TEXTURE2D_DESC* texture2dDesc)
 {
 	// Graphics 取得
@@ -17,11 +47,8 @@ HRESULT LoadTextureFromFile(const wchar_t* filename, ID3D11ShaderResourceView**
 	//--- < 画像ファイルのロードとshaderResourceViewの生成 > ---
 	ComPtr<ID3D11Resource> resource;
 
-	auto it = resources.find(filename);
-	if (it != resources.end())
+	if (FindTexture(filename, shaderResourceView))
 	{
-		*shaderResourceView = it->second.Get();
-		(*shaderResourceView)->AddRef();
 		(*shaderResourceView)->GetResource(resource.GetAddressOf());
 	}
 	else
@@ -55,7 +82,7 @@ HRESULT LoadTextureFromFile(const wchar_t* filename, ID3D11ShaderResourceView**
 			hr = CreateWICTextureFromFile(gfx.device.Get(), filename, resource.GetAddressOf(), shaderResourceView);
 			_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 		}
-		resources.insert(make_pair(filename, *shaderResourceView));
+		RegisterTexture(filename, shaderResourceView);
 	}
 
 	//--- < テクスチャ情報の取得 > ---
@@ -85,11 +112,8 @@ HRESULT LoadTextureFromFile(const wchar_t* filename, ID3D11ShaderResourceView**
 	//--- < 画像ファイルのロードとshaderResourceViewの生成 > ---
 	ComPtr<ID3D11Resource> resource;
 
-	auto it = resources.find(filename);
-	if (it != resources.end())
+	if (FindTexture(filename, shaderResourceView))
 	{
-		*shaderResourceView = it->second.Get();
-		(*shaderResourceView)->AddRef();
 		(*shaderResourceView)->GetResource(resource.GetAddressOf());
 	}
 	else
@@ -140,7 +164,7 @@ HRESULT LoadTextureFromFile(const wchar_t* filename, ID3D11ShaderResourceView**
 			hr = CreateWICTextureFromFile(gfx.device.Get(), filename, resource.GetAddressOf(), shaderResourceView);
 			_ASSERT_EXPR(SUCCEEDED(hr), hrTrace(hr));
 		}
-		resources.insert(make_pair(filename, *shaderResourceView));
+		RegisterTexture(filename, shaderResourceView);
 	}
 	
 
@@ -165,5 +189,6 @@ HRESULT LoadTextureFromFile(const wchar_t* filename, ID3D11ShaderResourceView**
 
 void ReleaseAllTextures()
 {
+	std::lock_guard<std::mutex> lock(resourcesMutex);
 	resources.clear();
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <mutex>
 
 
 class ConsoleData
@@ -15,6 +16,17 @@ public:
 		return instance;
 	}
 
+public:
+	// ログの追加 (読み込みスレッドからも呼ばれるので排他する)
+	void Log(const std::string& message)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		logs.push_back(message);
+	}
+
 public:
 	std::vector<std::string> logs;
+
+private:
+	std::mutex mutex;
 };
@@ -61,6 +61,8 @@ void ImGuiManager::Render()
 	Console();
 
 	// --- ImGui描画 ---
+	// ImGui は deviceContext を直接触るので、溜まっているステートを先に流して記憶を捨てる
+	Graphics::Instance().stateCache.Invalidate();
 	ImGui::Render();	// 描画データの組み立て
 	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 
@@ -1,4 +1,5 @@
 #include "InputManager.h"
+#include "InputRecorder.h"
 
 // 初期化処理
 void InputManager::Initialize(HWND hwnd)
@@ -42,19 +43,21 @@ void InputManager::Update()
 	// --- キーボード ---
 	// キーボードの状態取得
 	keyState = keyboard->GetState();
-	// キーボード状態トラッカー更新
-	keyTracker.Update(keyState);
 
 	// --- マウス ---
 	// マウスの状態取得
 	mouseState = mouse->GetState();
-	// マウス状態トラッカー更新
-	mouseTracker.Update(mouseState);
 	
 	// --- ゲームパッド ---
 	// ゲームパッドの状態取得
 	gamepadState = gamepad->GetState(0);
-	// ゲームパッド状態トラッカー更新
+
+	// --- 記録・再生 (再生中は記録した状態に差し替わる) ---
+	InputRecorder::Instance().Process(keyState, mouseState, gamepadState);
+
+	// 状態トラッカー更新
+	keyTracker.Update(keyState);
+	mouseTracker.Update(mouseState);
 	gamepadTracker.Update(gamepadState);
 }
 
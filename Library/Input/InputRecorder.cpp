@@ -0,0 +1,320 @@
+#include "InputRecorder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <numeric>
+#include "../Timer.h"
+
+namespace
+{
+	// ファイルのヘッダー
+	struct ReplayHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t frameCount;
+		uint32_t seed;
+	};
+
+	const char ReplayMagic[4] = { 'H', 'S', 'N', 'R' };
+	const uint32_t ReplayVersion = 1;
+
+	static_assert(sizeof(DirectX::Keyboard::State) >= 32, "Keyboard::State は 256 キー分のビット");
+
+	// 並べ替え済みのフレーム時間から割合 rate の位置の値
+	float Percentile(const std::vector<float>& sorted, float rate)
+	{
+		const size_t index = static_cast<size_t>(rate * static_cast<float>(sorted.size() - 1) + 0.5f);
+		return sorted[(std::min)(index, sorted.size() - 1)];
+	}
+}
+
+// 記録開始
+void InputRecorder::StartRecording()
+{
+	if (mode == MODE::REPLAY) StopReplay();
+
+	log.clear();
+	frame = frameCount = 0;
+	lastKeyboard = {};
+	lastMouse = {};
+	lastGamePad = {};
+
+	// 再生時に同じ乱数になるように種を決めて記録する
+	seed = static_cast<uint32_t>(GetTickCount64());
+	srand(seed);
+
+	mode = MODE::RECORD;
+}
+
+// 記録終了
+bool InputRecorder::StopRecording(const wchar_t* filename)
+{
+	if (mode != MODE::RECORD) return false;
+	mode = MODE::NONE;
+
+	std::ofstream file(std::filesystem::path(filename), std::ios::binary);
+	if (!file) return false;
+
+	ReplayHeader header;
+	std::memcpy(header.magic, ReplayMagic, sizeof(header.magic));
+	header.version = ReplayVersion;
+	header.frameCount = frameCount;
+	header.seed = seed;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(log.data()), log.size());
+	return static_cast<bool>(file);
+}
+
+// 再生開始
+bool InputRecorder::StartReplay(const wchar_t* filename, uint32_t frameLimit, bool quitWhenDone)
+{
+	if (mode == MODE::RECORD) mode = MODE::NONE;
+	if (mode == MODE::REPLAY) StopReplay();
+
+	std::ifstream file(std::filesystem::path(filename), std::ios::binary);
+	if (!file) return false;
+
+	ReplayHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+	if (std::memcmp(header.magic, ReplayMagic, sizeof(header.magic)) != 0 || header.version != ReplayVersion) return false;
+
+	log.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	readCursor = 0;
+	frame = 0;
+	frameCount = header.frameCount;
+	this->frameLimit = (frameLimit > 0) ? (std::min)(frameLimit, frameCount) : frameCount;
+	seed = header.seed;
+	srand(seed);
+
+	lastKeyboard = {};
+	lastMouse = {};
+	lastGamePad = {};
+
+	frameTimes.clear();
+	frameTimes.reserve(this->frameLimit);
+	replayFilename = filename;
+	this->quitWhenDone = quitWhenDone;
+
+	mode = MODE::REPLAY;
+	return true;
+}
+
+// 再生終了
+void InputRecorder::StopReplay()
+{
+	if (mode != MODE::REPLAY) return;
+	FinishReplay();
+}
+
+// 記録・再生
+void InputRecorder::Process(DirectX::Keyboard::State& keyState, DirectX::Mouse::State& mouseState, DirectX::GamePad::State& gamepadState)
+{
+	Timer& timer = Timer::Instance();
+
+	//--- < 記録 > ---
+	if (mode == MODE::RECORD)
+	{
+		const KeyboardRecord keyboard = Encode(keyState);
+		const MouseRecord mouse = Encode(mouseState);
+		const GamePadRecord gamepad = Encode(gamepadState);
+
+		uint8_t flags = 0;
+		if (frame == 0 || std::memcmp(&keyboard, &lastKeyboard, sizeof(keyboard)) != 0) flags |= KEYBOARD_CHANGED;
+		if (frame == 0 || std::memcmp(&mouse, &lastMouse, sizeof(mouse)) != 0) flags |= MOUSE_CHANGED;
+		if (frame == 0 || std::memcmp(&gamepad, &lastGamePad, sizeof(gamepad)) != 0) flags |= GAMEPAD_CHANGED;
+
+		const float deltaTime = timer.DeltaTime();
+		Write(&deltaTime, sizeof(deltaTime));
+		Write(&flags, sizeof(flags));
+		if (flags & KEYBOARD_CHANGED) Write(&keyboard, sizeof(keyboard));
+		if (flags & MOUSE_CHANGED) Write(&mouse, sizeof(mouse));
+		if (flags & GAMEPAD_CHANGED) Write(&gamepad, sizeof(gamepad));
+
+		lastKeyboard = keyboard;
+		lastMouse = mouse;
+		lastGamePad = gamepad;
+		++frame;
+		++frameCount;
+		return;
+	}
+
+	//--- < 再生 > ---
+	if (mode == MODE::REPLAY)
+	{
+		// 前のフレームから実際にかかった時間 (最初のフレームはシーンの読み込みを含むので測らない)
+		if (frame > 0) frameTimes.push_back(timer.DeltaTime());
+
+		float deltaTime = 0.0f;
+		uint8_t flags = 0;
+		if (frame >= frameLimit || !Read(&deltaTime, sizeof(deltaTime)) || !Read(&flags, sizeof(flags)) ||
+			((flags & KEYBOARD_CHANGED) && !Read(&lastKeyboard, sizeof(lastKeyboard))) ||
+			((flags & MOUSE_CHANGED) && !Read(&lastMouse, sizeof(lastMouse))) ||
+			((flags & GAMEPAD_CHANGED) && !Read(&lastGamePad, sizeof(lastGamePad))))
+		{
+			FinishReplay();
+			return;
+		}
+
+		Decode(lastKeyboard, keyState);
+		Decode(lastMouse, mouseState);
+		Decode(lastGamePad, gamepadState);
+
+		// 実際の経過時間の代わりに記録した時間で進める
+		timer.OverrideDeltaTime((fixedDeltaTime > 0.0f) ? fixedDeltaTime : deltaTime);
+		++frame;
+	}
+}
+
+// 統計を求める
+void InputRecorder::FinishReplay()
+{
+	mode = MODE::NONE;
+
+	lastResult = {};
+	if (!frameTimes.empty())
+	{
+		std::vector<float> sorted = frameTimes;
+		std::sort(sorted.begin(), sorted.end());
+
+		const double total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+		lastResult.frameCount = static_cast<uint32_t>(sorted.size());
+		lastResult.totalSeconds = static_cast<float>(total);
+		lastResult.averageMs = static_cast<float>(total / sorted.size() * 1000.0);
+		lastResult.minMs = sorted.front() * 1000.0f;
+		lastResult.maxMs = sorted.back() * 1000.0f;
+		lastResult.p50Ms = Percentile(sorted, 0.50f) * 1000.0f;
+		lastResult.p95Ms = Percentile(sorted, 0.95f) * 1000.0f;
+		lastResult.p99Ms = Percentile(sorted, 0.99f) * 1000.0f;
+	}
+
+	// 出力ウィンドウと、記録ファイルの隣のテキストに書き出す
+	char text[256];
+	sprintf_s(text, "Replay benchmark : frames %u, total %.3f s, avg %.3f ms, min %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+		lastResult.frameCount, lastResult.totalSeconds, lastResult.averageMs, lastResult.minMs,
+		lastResult.p50Ms, lastResult.p95Ms, lastResult.p99Ms, lastResult.maxMs);
+	OutputDebugStringA(text);
+
+	std::filesystem::path resultPath(replayFilename);
+	resultPath += L".benchmark.txt";
+	std::ofstream resultFile(resultPath, std::ios::app);
+	if (resultFile) resultFile << text;
+
+	if (quitWhenDone) PostQuitMessage(0);
+}
+
+// 書き込み
+void InputRecorder::Write(const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	log.insert(log.end(), bytes, bytes + size);
+}
+
+// 読み込み
+bool InputRecorder::Read(void* data, size_t size)
+{
+	if (readCursor + size > log.size()) return false;
+	std::memcpy(data, log.data() + readCursor, size);
+	readCursor += size;
+	return true;
+}
+
+//--------------------------------------------------------------
+//  入力の変換
+//--------------------------------------------------------------
+
+InputRecorder::KeyboardRecord InputRecorder::Encode(const DirectX::Keyboard::State& state)
+{
+	KeyboardRecord record;
+	std::memcpy(record.keys, &state, sizeof(record.keys));
+	return record;
+}
+
+InputRecorder::MouseRecord InputRecorder::Encode(const DirectX::Mouse::State& state)
+{
+	MouseRecord record;
+	record.x = state.x;
+	record.y = state.y;
+	record.scrollWheelValue = state.scrollWheelValue;
+	record.buttons =
+		(state.leftButton ? 1 << 0 : 0) |
+		(state.middleButton ? 1 << 1 : 0) |
+		(state.rightButton ? 1 << 2 : 0) |
+		(state.xButton1 ? 1 << 3 : 0) |
+		(state.xButton2 ? 1 << 4 : 0);
+	return record;
+}
+
+InputRecorder::GamePadRecord InputRecorder::Encode(const DirectX::GamePad::State& state)
+{
+	GamePadRecord record;
+	record.connected = state.connected ? 1 : 0;
+	record.buttons = static_cast<uint16_t>(
+		(state.buttons.a ? 1 << 0 : 0) |
+		(state.buttons.b ? 1 << 1 : 0) |
+		(state.buttons.x ? 1 << 2 : 0) |
+		(state.buttons.y ? 1 << 3 : 0) |
+		(state.buttons.leftStick ? 1 << 4 : 0) |
+		(state.buttons.rightStick ? 1 << 5 : 0) |
+		(state.buttons.leftShoulder ? 1 << 6 : 0) |
+		(state.buttons.rightShoulder ? 1 << 7 : 0) |
+		(state.buttons.back ? 1 << 8 : 0) |
+		(state.buttons.start ? 1 << 9 : 0));
+	record.dpad = static_cast<uint8_t>(
+		(state.dpad.up ? 1 << 0 : 0) |
+		(state.dpad.down ? 1 << 1 : 0) |
+		(state.dpad.right ? 1 << 2 : 0) |
+		(state.dpad.left ? 1 << 3 : 0));
+	record.thumbSticks[0] = state.thumbSticks.leftX;
+	record.thumbSticks[1] = state.thumbSticks.leftY;
+	record.thumbSticks[2] = state.thumbSticks.rightX;
+	record.thumbSticks[3] = state.thumbSticks.rightY;
+	record.triggers[0] = state.triggers.left;
+	record.triggers[1] = state.triggers.right;
+	return record;
+}
+
+void InputRecorder::Decode(const KeyboardRecord& record, DirectX::Keyboard::State& state)
+{
+	std::memcpy(&state, record.keys, sizeof(record.keys));
+}
+
+void InputRecorder::Decode(const MouseRecord& record, DirectX::Mouse::State& state)
+{
+	// positionMode は今の設定のままにする
+	state.x = record.x;
+	state.y = record.y;
+	state.scrollWheelValue = record.scrollWheelValue;
+	state.leftButton = (record.buttons & (1 << 0)) != 0;
+	state.middleButton = (record.buttons & (1 << 1)) != 0;
+	state.rightButton = (record.buttons & (1 << 2)) != 0;
+	state.xButton1 = (record.buttons & (1 << 3)) != 0;
+	state.xButton2 = (record.buttons & (1 << 4)) != 0;
+}
+
+void InputRecorder::Decode(const GamePadRecord& record, DirectX::GamePad::State& state)
+{
+	state.connected = record.connected != 0;
+	state.buttons.a = (record.buttons & (1 << 0)) != 0;
+	state.buttons.b = (record.buttons & (1 << 1)) != 0;
+	state.buttons.x = (record.buttons & (1 << 2)) != 0;
+	state.buttons.y = (record.buttons & (1 << 3)) != 0;
+	state.buttons.leftStick = (record.buttons & (1 << 4)) != 0;
+	state.buttons.rightStick = (record.buttons & (1 << 5)) != 0;
+	state.buttons.leftShoulder = (record.buttons & (1 << 6)) != 0;
+	state.buttons.rightShoulder = (record.buttons & (1 << 7)) != 0;
+	state.buttons.back = (record.buttons & (1 << 8)) != 0;
+	state.buttons.start = (record.buttons & (1 << 9)) != 0;
+	state.dpad.up = (record.dpad & (1 << 0)) != 0;
+	state.dpad.down = (record.dpad & (1 << 1)) != 0;
+	state.dpad.right = (record.dpad & (1 << 2)) != 0;
+	state.dpad.left = (record.dpad & (1 << 3)) != 0;
+	state.thumbSticks.leftX = record.thumbSticks[0];
+	state.thumbSticks.leftY = record.thumbSticks[1];
+	state.thumbSticks.rightX = record.thumbSticks[2];
+	state.thumbSticks.rightY = record.thumbSticks[3];
+	state.triggers.left = record.triggers[0];
+	state.triggers.right = record.triggers[1];
+}
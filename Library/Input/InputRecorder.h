@@ -0,0 +1,144 @@
+#pragma once
+
+#include <Windows.h>
+#include <Keyboard.h>
+#include <Mouse.h>
+#include <GamePad.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+//--------------------------------------------------------------
+// InputRecorder
+//--------------------------------------------------------------
+// InputManager が読んだフレームごとの入力と経過時間を記録し、同じ順番で再生する
+// 再生中はデバイスの入力と実際の経過時間の代わりに記録した値を使うので、毎回同じゲームプレイになる
+// (開始時に rand の種も記録して戻す)
+// 再生中は実際にかかったフレーム時間を測り、終わったら統計を出す (ビルド間の比較用ベンチマーク)
+//
+// 記録の形式 : ヘッダー + フレームごとに [経過時間][変化フラグ][変わった入力だけ]
+class InputRecorder
+{
+private:
+	InputRecorder() {}
+	~InputRecorder() {}
+
+public:
+	static InputRecorder& Instance()
+	{
+		static InputRecorder instance;
+		return instance;
+	}
+
+	enum class MODE
+	{
+		NONE,
+		RECORD,
+		REPLAY,
+	};
+
+	// 再生 1 回分のフレーム時間の統計 (ミリ秒)
+	struct BenchmarkResult
+	{
+		uint32_t frameCount = 0;
+		float totalSeconds = 0.0f;
+		float averageMs = 0.0f;
+		float minMs = 0.0f;
+		float maxMs = 0.0f;
+		float p50Ms = 0.0f;
+		float p95Ms = 0.0f;
+		float p99Ms = 0.0f;
+	};
+
+public:
+	// 記録開始 (次の InputManager::Update から)
+	void StartRecording();
+	// 記録終了 (ファイルに書き出す)
+	bool StopRecording(const wchar_t* filename);
+
+	// 再生開始 (frameLimit フレームか記録の最後まで、0 なら最後まで)
+	// quitWhenDone なら終わったら統計を書き出してアプリを終了する
+	bool StartReplay(const wchar_t* filename, uint32_t frameLimit = 0, bool quitWhenDone = false);
+	// 再生終了 (統計を求める)
+	void StopReplay();
+
+	// InputManager::Update から呼ぶ (記録中は状態を記録し、再生中は状態と経過時間を差し替える)
+	void Process(DirectX::Keyboard::State& keyState, DirectX::Mouse::State& mouseState, DirectX::GamePad::State& gamepadState);
+
+	MODE GetMode() const { return mode; }
+	uint32_t GetFrame() const { return frame; }
+	uint32_t GetFrameCount() const { return frameCount; }
+	size_t GetRecordedBytes() const { return log.size(); }
+	const BenchmarkResult& GetLastResult() const { return lastResult; }
+
+public:
+	// 0 より大きければ再生中は記録した経過時間の代わりにこの値を使う
+	float fixedDeltaTime = 0.0f;
+
+private:
+	// 変化フラグ
+	enum CHANGE_FLAG : uint8_t
+	{
+		KEYBOARD_CHANGED = 1 << 0,
+		MOUSE_CHANGED = 1 << 1,
+		GAMEPAD_CHANGED = 1 << 2,
+	};
+
+	// 記録する入力 (比較と書き出しに使うので隙間を詰める)
+#pragma pack(push, 1)
+	struct KeyboardRecord
+	{
+		uint8_t keys[32] = {};	// 256 キー分のビット
+	};
+	struct MouseRecord
+	{
+		int32_t x = 0;
+		int32_t y = 0;
+		int32_t scrollWheelValue = 0;
+		uint8_t buttons = 0;
+	};
+	struct GamePadRecord
+	{
+		uint8_t connected = 0;
+		uint16_t buttons = 0;
+		uint8_t dpad = 0;
+		float thumbSticks[4] = {};
+		float triggers[2] = {};
+	};
+#pragma pack(pop)
+
+	static KeyboardRecord Encode(const DirectX::Keyboard::State& state);
+	static MouseRecord Encode(const DirectX::Mouse::State& state);
+	static GamePadRecord Encode(const DirectX::GamePad::State& state);
+	static void Decode(const KeyboardRecord& record, DirectX::Keyboard::State& state);
+	static void Decode(const MouseRecord& record, DirectX::Mouse::State& state);
+	static void Decode(const GamePadRecord& record, DirectX::GamePad::State& state);
+
+	void Write(const void* data, size_t size);
+	bool Read(void* data, size_t size);
+
+	// 統計を求めて (quitWhenDone なら書き出して終了する)
+	void FinishReplay();
+
+private:
+	MODE mode = MODE::NONE;
+
+	std::vector<uint8_t> log;		// ヘッダーを除いたフレームの並び
+	size_t readCursor = 0;
+	uint32_t frame = 0;
+	uint32_t frameCount = 0;
+	uint32_t frameLimit = 0;
+	uint32_t seed = 0;
+
+	// 前のフレームの入力 (変わった所だけ記録する)
+	KeyboardRecord lastKeyboard;
+	MouseRecord lastMouse;
+	GamePadRecord lastGamePad;
+
+	// 再生中の実際のフレーム時間
+	std::vector<float> frameTimes;
+	std::wstring replayFilename;
+	bool quitWhenDone = false;
+
+	BenchmarkResult lastResult;
+};
@@ -1,7 +1,13 @@
 #pragma once
+#include <cstddef>
 // メモリリークの場所表示
 #if _DEBUG
-#define new_ new(_NORMAL_BLOCK, __FILE__, __LINE__)
+// 確保した場所をデバッグヒープに渡す (MemoryTracker.cpp で定義、タグの集計も行う)
+void* operator new(size_t size, const char* file, int line);
+void* operator new[](size_t size, const char* file, int line);
+void operator delete(void* p, const char* file, int line) noexcept;
+void operator delete[](void* p, const char* file, int line) noexcept;
+#define new_ new(__FILE__, __LINE__)
 #else
 #define new_ new
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,246 @@
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <malloc.h>
+#include <crtdbg.h>
+#include "MemoryTracker.h"
+#include "ImGui/Include/imgui.h"
+
+namespace
+{
+	// 確保したブロックの前に置く情報 (16 byte にして malloc のアラインメントを保つ)
+	struct BlockHeader
+	{
+		uint64_t size;
+		uint32_t offset;	// 確保した先頭からユーザー領域までの距離
+		uint16_t tag;
+		uint16_t aligned;	// _aligned_malloc で確保したか
+	};
+	static_assert(sizeof(BlockHeader) == 16, "BlockHeader must keep 16 byte alignment");
+
+	// タグごとのカウンタ
+	// 静的初期化より前の確保からも使うので、ゼロ初期化だけで使える形で置く
+	struct TagCounters
+	{
+		std::atomic<int64_t> liveBytes;
+		std::atomic<int64_t> peakBytes;
+		std::atomic<int64_t> liveCount;
+		std::atomic<uint32_t> frameAllocations;
+		std::atomic<uint64_t> frameBytes;
+		std::atomic<uint64_t> totalAllocations;
+	};
+	TagCounters counters[static_cast<size_t>(MemoryTracker::TAG::TAG_COUNT)];
+
+	thread_local MemoryTracker::TAG currentTag = MemoryTracker::TAG::GENERAL;
+
+	// 確保 (file が nullptr でなければ Debug ビルドでデバッグヒープに場所を渡す)
+	void* Allocate(size_t size, size_t alignment, const char* file, int line)
+	{
+		const bool aligned = alignment > sizeof(BlockHeader);
+		const size_t offset = aligned ? alignment : sizeof(BlockHeader);
+
+		void* base = nullptr;
+#if _DEBUG
+		if (file != nullptr)
+		{
+			base = aligned ? _aligned_malloc_dbg(size + offset, alignment, file, line) : _malloc_dbg(size + offset, _NORMAL_BLOCK, file, line);
+		}
+		else
+#endif
+		{
+			base = aligned ? _aligned_malloc(size + offset, alignment) : malloc(size + offset);
+		}
+		if (base == nullptr) return nullptr;
+
+		char* p = static_cast<char*>(base) + offset;
+		BlockHeader* header = reinterpret_cast<BlockHeader*>(p) - 1;
+		header->size = size;
+		header->offset = static_cast<uint32_t>(offset);
+		header->tag = static_cast<uint16_t>(currentTag);
+		header->aligned = aligned ? 1 : 0;
+
+		//--- < タグのカウンタに加える > ---
+		TagCounters& c = counters[header->tag];
+		const int64_t bytes = static_cast<int64_t>(size);
+		const int64_t live = c.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		c.liveCount.fetch_add(1, std::memory_order_relaxed);
+		c.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+		c.frameBytes.fetch_add(size, std::memory_order_relaxed);
+		c.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		int64_t peak = c.peakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+		return p;
+	}
+
+	void* AllocateOrThrow(size_t size, size_t alignment, const char* file, int line)
+	{
+		void* p = Allocate(size, alignment, file, line);
+		if (p == nullptr) throw std::bad_alloc();
+		return p;
+	}
+
+	// 解放 (確保した時のタグから引く)
+	void Free(void* p)
+	{
+		if (p == nullptr) return;
+
+		const BlockHeader* header = static_cast<const BlockHeader*>(p) - 1;
+		TagCounters& c = counters[header->tag];
+		c.liveBytes.fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+		c.liveCount.fetch_sub(1, std::memory_order_relaxed);
+
+		void* base = static_cast<char*>(p) - header->offset;
+		if (header->aligned) _aligned_free(base);
+		else free(base);
+	}
+}
+
+//--------------------------------------------------------------
+// グローバルの operator new / delete
+//--------------------------------------------------------------
+void* operator new(size_t size) { return AllocateOrThrow(size, 0, nullptr, 0); }
+void* operator new[](size_t size) { return AllocateOrThrow(size, 0, nullptr, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0, nullptr, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0, nullptr, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment), nullptr, 0); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment), nullptr, 0); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<size_t>(alignment), nullptr, 0); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<size_t>(alignment), nullptr, 0); }
+
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
+
+#if _DEBUG
+// new_ 用 (確保した場所をデバッグヒープに渡す)
+void* operator new(size_t size, const char* file, int line) { return AllocateOrThrow(size, 0, file, line); }
+void* operator new[](size_t size, const char* file, int line) { return AllocateOrThrow(size, 0, file, line); }
+void operator delete(void* p, const char*, int) noexcept { Free(p); }
+void operator delete[](void* p, const char*, int) noexcept { Free(p); }
+#endif
+
+//--------------------------------------------------------------
+// MemoryTracker
+//--------------------------------------------------------------
+MemoryTracker::TagScope::TagScope(TAG tag) : previous(currentTag)
+{
+	currentTag = tag;
+}
+
+MemoryTracker::TagScope::~TagScope()
+{
+	currentTag = previous;
+}
+
+// フレームの開始
+void MemoryTracker::BeginFrame()
+{
+	for (size_t i = 0; i < static_cast<size_t>(TAG::TAG_COUNT); ++i)
+	{
+		TagCounters& c = counters[i];
+		Statistics& s = statistics[i];
+
+		s.frameAllocations = c.frameAllocations.exchange(0, std::memory_order_relaxed);
+		s.frameBytes = c.frameBytes.exchange(0, std::memory_order_relaxed);
+		if (s.frameAllocations > s.peakFrameAllocations) s.peakFrameAllocations = s.frameAllocations;
+
+		s.liveBytes = c.liveBytes.load(std::memory_order_relaxed);
+		s.peakBytes = c.peakBytes.load(std::memory_order_relaxed);
+		s.liveCount = c.liveCount.load(std::memory_order_relaxed);
+		s.totalAllocations = c.totalAllocations.load(std::memory_order_relaxed);
+	}
+}
+
+// タグの名前
+const char* MemoryTracker::GetTagName(TAG tag)
+{
+	static const char* names[] =
+	{
+		"General",
+		"Animation",
+		"Mesh",
+		"Collision",
+		"Text",
+		"Effect",
+		"Audio",
+		"Render",
+	};
+	static_assert(_countof(names) == static_cast<size_t>(TAG::TAG_COUNT), "tag name is missing");
+	return names[static_cast<size_t>(tag)];
+}
+
+// このスレッドで今付いているタグ
+MemoryTracker::TAG MemoryTracker::GetCurrentTag()
+{
+	return currentTag;
+}
+
+// 統計を CSV で書き出す
+bool MemoryTracker::ExportCsv(const char* filename) const
+{
+	std::ofstream ofs(filename, std::ios::out);
+	if (!ofs) return false;
+
+	ofs << "tag,liveBytes,peakBytes,liveCount,frameAllocations,frameBytes,peakFrameAllocations,totalAllocations\n";
+	for (size_t i = 0; i < static_cast<size_t>(TAG::TAG_COUNT); ++i)
+	{
+		const Statistics& s = statistics[i];
+		ofs << GetTagName(static_cast<TAG>(i)) << ','
+			<< s.liveBytes << ',' << s.peakBytes << ',' << s.liveCount << ','
+			<< s.frameAllocations << ',' << s.frameBytes << ',' << s.peakFrameAllocations << ','
+			<< s.totalAllocations << '\n';
+	}
+	return true;
+}
+
+// ImGui 描画
+void MemoryTracker::DrawDebugGui()
+{
+	if (ImGui::CollapsingHeader("MemoryTracker", ImGuiTreeNodeFlags_None))
+	{
+		uint32_t frameAllocations = 0;
+		uint64_t frameBytes = 0;
+		for (const Statistics& s : statistics)
+		{
+			frameAllocations += s.frameAllocations;
+			frameBytes += s.frameBytes;
+		}
+		ImGui::Text("Frame : %u allocs  %llu bytes", frameAllocations, frameBytes);
+		ImGui::Separator();
+
+		// タグごと (live / peak は KB、frame は前フレームの確保回数とバイト数)
+		ImGui::Text("%-10s %10s %10s %8s %10s %8s", "Tag", "Live KB", "Peak KB", "Frame", "Frame B", "Max");
+		for (size_t i = 0; i < static_cast<size_t>(TAG::TAG_COUNT); ++i)
+		{
+			const Statistics& s = statistics[i];
+			ImGui::Text("%-10s %10.1f %10.1f %8u %10llu %8u",
+				GetTagName(static_cast<TAG>(i)),
+				s.liveBytes / 1024.0, s.peakBytes / 1024.0,
+				s.frameAllocations, s.frameBytes, s.peakFrameAllocations);
+		}
+
+		ImGui::Separator();
+		ImGui::InputText("File", csvFilename, sizeof(csvFilename));
+		if (ImGui::Button("Export CSV"))
+		{
+			csvExported = ExportCsv(csvFilename);
+		}
+		if (csvExported)
+		{
+			ImGui::SameLine();
+			ImGui::Text("saved");
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+
+//--------------------------------------------------------------
+// MemoryTracker
+//--------------------------------------------------------------
+// グローバルの operator new / delete を置き換えて、確保をタグ (サブシステム) ごとに数える
+// 確保したブロックの前に大きさとタグを書いておき、解放時にそのタグから引く
+// (カウンタは relaxed な atomic の加減算だけなので Release ビルドでも常に有効)
+//
+// タグは TagScope で付ける (スレッドごと、スコープを抜けると元に戻る)
+// 何も付いていない確保は GENERAL に入る
+//
+// 毎フレームの確保回数・バイト数を見れば、どのシステムがホットパスで確保しているかが分かる
+class MemoryTracker
+{
+public:
+	// タグ
+	enum class TAG : uint32_t
+	{
+		GENERAL,		// タグなし
+		ANIMATION,		// アニメーションの更新
+		MESH,			// モデルの読み込み・描画
+		COLLISION,		// 当たり判定
+		TEXT,			// 文字列・フォント
+		EFFECT,			// Effekseer
+		AUDIO,			// サウンド
+		RENDER,			// 描画コマンド (2D・デバッグ描画)
+
+		TAG_COUNT
+	};
+
+	// タグごとの統計
+	struct Statistics
+	{
+		int64_t liveBytes = 0;				// 確保中のバイト数
+		int64_t peakBytes = 0;				// liveBytes の最大
+		int64_t liveCount = 0;				// 確保中のブロック数
+		uint32_t frameAllocations = 0;		// 前フレームの確保回数
+		uint64_t frameBytes = 0;			// 前フレームの確保バイト数
+		uint32_t peakFrameAllocations = 0;	// frameAllocations の最大
+		uint64_t totalAllocations = 0;		// 起動からの確保回数
+	};
+
+	// スコープの間、このスレッドの確保に tag を付ける
+	class TagScope
+	{
+	public:
+		explicit TagScope(TAG tag);
+		~TagScope();
+
+		TagScope(const TagScope&) = delete;
+		TagScope& operator=(const TagScope&) = delete;
+
+	private:
+		TAG previous;
+	};
+
+private:
+	MemoryTracker() {}
+	~MemoryTracker() {}
+
+public:
+	static MemoryTracker& Instance()
+	{
+		static MemoryTracker instance;
+		return instance;
+	}
+
+	// フレームの開始 (フレームの確保回数・バイト数を前フレーム分へ移す)
+	void BeginFrame();
+
+	// 前フレーム時点の統計
+	const Statistics& GetStatistics(TAG tag) const { return statistics[static_cast<size_t>(tag)]; }
+
+	// タグの名前
+	static const char* GetTagName(TAG tag);
+
+	// このスレッドで今付いているタグ
+	static TAG GetCurrentTag();
+
+	// 統計を CSV で書き出す
+	bool ExportCsv(const char* filename) const;
+
+	// ImGui 描画
+	void DrawDebugGui();
+
+private:
+	Statistics statistics[static_cast<size_t>(TAG::TAG_COUNT)];
+
+	// ImGui で書き出すファイル名
+	char csvFilename[64] = "MemoryReport.csv";
+	bool csvExported = false;
+};
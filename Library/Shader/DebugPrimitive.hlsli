@@ -0,0 +1,19 @@
+struct VS_IN
+{
+    float4 position : POSITION;         // w : 図形ごとの伸ばす量 (instanceScale.w) を掛けて Y に足す割合
+    row_major float4x4 world : WORLD;   // 回転と平行移動 (拡大はしない)
+    float4 instanceScale : SCALE;       // xyz : 拡大, w : 伸ばす量
+    float4 color : COLOR;
+};
+
+struct VS_OUT
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+cbuffer SCENE_CONSTANT_BUFFER : register(b1)
+{
+    row_major float4x4 viewProjection;
+    float4 lightDirection;
+};
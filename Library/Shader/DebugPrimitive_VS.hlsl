@@ -0,0 +1,13 @@
+#include "DebugPrimitive.hlsli"
+
+VS_OUT main(VS_IN vin)
+{
+    // 拡大してから伸ばす (カプセルの半球や矢印の先端は拡大だけで形が変わらない)
+    float3 local = vin.position.xyz * vin.instanceScale.xyz;
+    local.y += vin.position.w * vin.instanceScale.w;
+    
+    VS_OUT vout;
+    vout.position = mul(float4(local, 1.0), mul(vin.world, viewProjection));
+    vout.color = vin.color;
+    return vout;
+}
@@ -1,6 +0,0 @@
-struct VS_OUT
-{
-    float4 position : SV_POSITION;
-    float4 color : COLOR;
-    float2 texcoord : TEXCOORD;
-};
\ No newline at end of file
@@ -12,8 +12,6 @@ struct PointLightData
     float range;
     float3 pad;
 };
-// 点光源の最大数
-static const int PointLightMax = 8;
 // スポットライト
 struct SpotLightData
 {
@@ -25,8 +23,41 @@ struct SpotLightData
     float outerCorn;
     float dummy;
 };
-// スポットライトの最大数
-static const int SpotLightMax = 8;
+
+//--------------------------------------------
+//	クラスターライティング
+//--------------------------------------------
+// 視錐台を分割したクラスターごとに、届く光源の番号リストを CPU (LightCluster) で作っておく
+// 分割数は LightCluster.h と合わせる
+static const float ClusterCountX = 16;
+static const float ClusterCountY = 9;
+static const float ClusterCountZ = 24;
+
+StructuredBuffer<PointLightData> pointLightData : register(t8);
+StructuredBuffer<SpotLightData> spotLightData : register(t9);
+// x : lightIndices の開始位置, y : 点光源の数 (下位 16bit) | スポットライトの数 (上位 16bit)
+StructuredBuffer<uint2> lightClusters : register(t10);
+// 点光源の番号、続けてスポットライトの番号が並ぶ
+StructuredBuffer<uint> lightIndices : register(t11);
+
+// クラスターの取得
+// clipPosition		: クリップ空間の座標 (w はビュー空間の深度)
+// depthSliceScale	: 深度からスライス番号を求める係数
+// offset			: lightIndices の開始位置
+// pointCount		: 点光源の数
+// spotCount		: スポットライトの数
+void FetchLightCluster(float4 clipPosition, float2 depthSliceScale, out uint offset, out uint pointCount, out uint spotCount)
+{
+    float2 ndc = clipPosition.xy / clipPosition.w;
+    uint x = (uint) clamp((ndc.x * 0.5 + 0.5) * ClusterCountX, 0, ClusterCountX - 1);
+    uint y = (uint) clamp((ndc.y * 0.5 + 0.5) * ClusterCountY, 0, ClusterCountY - 1);
+    uint z = (uint) clamp(log(max(clipPosition.w, 1.0e-4)) * depthSliceScale.x + depthSliceScale.y, 0, ClusterCountZ - 1);
+    
+    uint2 cluster = lightClusters[(z * (uint) ClusterCountY + y) * (uint) ClusterCountX + x];
+    offset = cluster.x;
+    pointCount = cluster.y & 0xFFFF;
+    spotCount = cluster.y >> 16;
+}
 
 
 //--------------------------------------------
@@ -1,5 +0,0 @@
-struct VS_OUT
-{
-    float4 position : SV_POSITION;
-    float4 color : COLOR;
-};
\ No newline at end of file
@@ -0,0 +1,26 @@
+// 2D 描画 1 つ分のインスタンスデータ
+struct VS_IN
+{
+    float4 rect : RECT;             // 左上の座標と大きさ (スクリーン座標)
+    float4 texcoord : TEXCOORD;     // 左上と右下の UV
+    float4 color : COLOR;
+    float4 transform : TRANSFORM;   // x : 回転 (ラジアン), yz : UV スクロール量
+    float4 effectParam : EFFECT_PARAM;  // x : ディゾルブ量, y : 縁の閾値
+    float4 effectColor : EFFECT_COLOR;  // 縁の色
+    uint vertexId : SV_VertexID;
+};
+
+struct VS_OUT
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+    float2 texcoord : TEXCOORD;
+    float4 effectParam : EFFECT_PARAM;
+    float4 effectColor : EFFECT_COLOR;
+};
+
+cbuffer RENDERER_2D_CONSTANT_BUFFER : register(b0)
+{
+    float2 screenScale;             // スクリーン座標から NDC への係数 (2 / 幅, 2 / 高さ)
+    float2 renderer2DPad;
+}
@@ -1,6 +1,7 @@
-#include "Primitive2D.hlsli"
+#include "Renderer2D.hlsli"
 
+// 単色 (Primitive2D)
 float4 main(VS_OUT pin) : SV_TARGET
 {
     return pin.color;
-}
\ No newline at end of file
+}
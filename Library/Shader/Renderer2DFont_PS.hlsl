@@ -1,5 +1,6 @@
-#include "FontTexture.hlsli"
+#include "Renderer2D.hlsli"
 
+// 文字 (DispString)
 Texture2D colorMap : register(t0);
 SamplerState pointSamplerState : register(s0);
 SamplerState linearSamplerState : register(s1);
@@ -9,4 +10,4 @@ SamplerState TextlinearSamplerState : register(s3);
 float4 main(VS_OUT pin) : SV_TARGET
 {
     return colorMap.Sample(TextlinearSamplerState, pin.texcoord) * pin.color;
-}
\ No newline at end of file
+}
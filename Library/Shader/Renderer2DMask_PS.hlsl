@@ -1,9 +1,10 @@
-#include "Mask.hlsli"
+#include "Renderer2D.hlsli"
 
 #define POINT 0
 #define LINEAR 1
 #define ANISOTROPIC 2
 
+// ディゾルブ (MaskSprite)
 SamplerState samplerStates[3] : register(s0);
 Texture2D texture0 : register(t0);
 
@@ -11,6 +12,9 @@ Texture2D maskTexture : register(t1);
 
 float4 main(VS_OUT pin) : SV_TARGET
 {
+    float dissolveThreshold = pin.effectParam.x;
+    float edgeThreshold = pin.effectParam.y;
+    
     float4 color = texture0.Sample(samplerStates[LINEAR], pin.texcoord) * pin.color;
     
     float mask = maskTexture.Sample(samplerStates[LINEAR], pin.texcoord).r;
@@ -21,7 +25,7 @@ float4 main(VS_OUT pin) : SV_TARGET
     // 縁の処理
     float edgeValue = step(mask - dissolveThreshold, dissolveThreshold) * step(dissolveThreshold, mask) * step(mask, dissolveThreshold + edgeThreshold);
 
-    color.rgb += edgeColor.rgb * edgeValue;
+    color.rgb += pin.effectColor.rgb * edgeValue;
     alpha = saturate(alpha + edgeValue);
 
 	// colorの透過値に乗算する
@@ -31,4 +35,4 @@ float4 main(VS_OUT pin) : SV_TARGET
     clip(color.a - 0.01f);
 
     return color;
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
-#include "UVScroll.hlsli"
+#include "Renderer2D.hlsli"
 
+// テクスチャ (Sprite, UVScrollSprite)
 Texture2D colorMap : register(t0);
 SamplerState pointSamplerState : register(s0);
 SamplerState linearSamplerState : register(s1);
@@ -8,4 +9,4 @@ SamplerState anisotropicSamplerState : register(s2);
 float4 main(VS_OUT pin) : SV_TARGET
 {
     return colorMap.Sample(linearSamplerState, pin.texcoord) * pin.color;
-}
\ No newline at end of file
+}
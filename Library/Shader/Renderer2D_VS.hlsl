@@ -0,0 +1,23 @@
+#include "Renderer2D.hlsli"
+
+// 頂点バッファは使わず、SV_VertexID (0 ~ 3 のストリップ) から矩形の角を作る
+VS_OUT main(VS_IN vin)
+{
+    // 0 : 左上, 1 : 右上, 2 : 左下, 3 : 右下
+    float2 corner = float2(vin.vertexId & 1, vin.vertexId >> 1);
+    
+    // 矩形の中心で回転させる
+    float2 center = vin.rect.xy + vin.rect.zw * 0.5;
+    float2 local = (corner - 0.5) * vin.rect.zw;
+    float s, c;
+    sincos(vin.transform.x, s, c);
+    float2 position = center + float2(c * local.x - s * local.y, s * local.x + c * local.y);
+    
+    VS_OUT vout;
+    vout.position = float4(position.x * screenScale.x - 1.0, 1.0 - position.y * screenScale.y, 0.0, 1.0);
+    vout.color = vin.color;
+    vout.texcoord = lerp(vin.texcoord.xy, vin.texcoord.zw, corner) + vin.transform.yz;
+    vout.effectParam = vin.effectParam;
+    vout.effectColor = vin.effectColor;
+    return vout;
+}
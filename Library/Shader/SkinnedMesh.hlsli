@@ -21,28 +21,35 @@ struct VS_OUT
 };
 
 static const int MAX_BONES = 256;
+
+// オブジェクトごと (メッシュ単位で ConstantRingBuffer から割り当てる)
 cbuffer OBJECT_CONSTANT_BUFFER : register(b0)
 {
     row_major float4x4 world;
     float4 materialColor;
-    row_major float4x4 boneTransforms[MAX_BONES];
+    float objectType;
+    float3 objectPad;
 }
 
 cbuffer SCENE_CONSTANT_BUFFER : register(b1)
 {
     row_major float4x4 viewProjection;
     DirectionalLightData directionalLightData;
-    PointLightData pointLightData[PointLightMax];
-    SpotLightData spotLightData[SpotLightMax];
     int pointLightCount;
     int spotLightCount;
-    float2 pad1;
+    float2 clusterDepthScale;
     float4 ambientLightColor;
     float4 cameraPosition;
 }
 
-cbuffer IS_BLOOM : register(b2)
-{    
-    float objectType;
-    float3 pad2;
+// マテリアルごと (読み込み時に作る変更しないバッファ)
+cbuffer MATERIAL_CONSTANT_BUFFER : register(b2)
+{
+    float4 Kd;
+}
+
+// スケルトンごと (実際のボーン数分だけ割り当てるので、それより後ろは 0 が読まれる)
+cbuffer SKELETON_CONSTANT_BUFFER : register(b3)
+{
+    row_major float4x4 boneTransforms[MAX_BONES];
 }
\ No newline at end of file
@@ -58,6 +58,51 @@ float4 main(VS_OUT pin) : SV_TARGET
     
     spec *= lerp(float3(1.0f, 1.0f, 1.0f), specColor, metallic);
     
+    // --- クラスターの取得 (このピクセルに届く光源だけを計算する) ---
+    uint lightOffset, clusterPointCount, clusterSpotCount;
+    FetchLightCluster(mul(float4(pin.worldPosition.xyz, 1.0f), viewProjection), clusterDepthScale, lightOffset, clusterPointCount, clusterSpotCount);
+    
+    // --- ポイントライト ---
+    uint i;
+    for (i = 0; i < clusterPointCount; ++i)
+    {
+        PointLightData pointLight = pointLightData[lightIndices[lightOffset + i]];
+        
+        float3 lightVector = pin.worldPosition.xyz - pointLight.position.xyz;
+        float lightLength = length(lightVector);
+        if (lightLength >= pointLight.range)
+            continue;
+        
+        float attenuate = saturate(1.0f - lightLength / pointLight.range);
+        lightVector = lightVector / lightLength;
+        
+        // ディレクションライトと同じく拡散反射と Cook-Torrance の鏡面反射を足す
+        diffuse += albedoColor.rgb * CalcDiffuseFromFresnel(N, -lightVector, ToCamera) * CalcLambertDiffse(N, lightVector, pointLight.color.rgb, Kd) / PI * attenuate;
+        spec += CookTorranceSpecular(-lightVector, ToCamera, N, smooth) * pointLight.color.rgb * lerp(float3(1.0f, 1.0f, 1.0f), specColor, metallic) * attenuate;
+    }
+    
+    // --- スポットライト ---
+    for (i = 0; i < clusterSpotCount; ++i)
+    {
+        SpotLightData spotLight = spotLightData[lightIndices[lightOffset + clusterPointCount + i]];
+        
+        float3 lightVector = pin.worldPosition.xyz - spotLight.position.xyz;
+        float lightLength = length(lightVector);
+        if (lightLength >= spotLight.range)
+            continue;
+        
+        float attenuate = saturate(1.0f - lightLength / spotLight.range);
+        lightVector = lightVector / lightLength;
+        
+        // 角度減数
+        float angle = dot(normalize(spotLight.direction.xyz), lightVector);
+        float area = spotLight.innerCorn - spotLight.outerCorn;
+        attenuate *= saturate(1.0f - (spotLight.innerCorn - angle) / area);
+        
+        diffuse += albedoColor.rgb * CalcDiffuseFromFresnel(N, -lightVector, ToCamera) * CalcLambertDiffse(N, lightVector, spotLight.color.rgb, Kd) / PI * attenuate;
+        spec += CookTorranceSpecular(-lightVector, ToCamera, N, smooth) * spotLight.color.rgb * lerp(float3(1.0f, 1.0f, 1.0f), specColor, metallic) * attenuate;
+    }
+    
     // 環境光
     float3 ambient = albedoColor.rgb * Ka;
     
@@ -60,54 +60,62 @@ float4 main(VS_OUT pin) : SV_TARGET
     float3 ToCamera = normalize(cameraPosition.xyz - pin.worldPosition.xyz); // 光が入射したサーフェースから視点に向かって伸びるベクトルを求めている
     float3 directionSpecular = CalcPhongSpecular(N, L, directionalLightData.color.rgb, ToCamera, 128.0f, Ks);
     
+    // --- クラスターの取得 (このピクセルに届く光源だけを計算する) ---
+    uint lightOffset, clusterPointCount, clusterSpotCount;
+    FetchLightCluster(mul(float4(pin.worldPosition.xyz, 1.0f), viewProjection), clusterDepthScale, lightOffset, clusterPointCount, clusterSpotCount);
+    
     // --- ポイントライト ---
     float3 pointDiffuse = (float3) 0;
     float3 pointSpecular = (float3) 0;
-    int i;
-    for (i = 0; i < pointLightCount; ++i)
+    uint i;
+    for (i = 0; i < clusterPointCount; ++i)
     {
+        PointLightData pointLight = pointLightData[lightIndices[lightOffset + i]];
+        
         // ライトのベクトルを算出
-        float3 lightVector = pin.worldPosition.xyz - pointLightData[i].position.xyz;
+        float3 lightVector = pin.worldPosition.xyz - pointLight.position.xyz;
         float lightLength = length(lightVector);
         
         // ライトの範囲外なら計算しない
-        if (lightLength >= pointLightData[i].range)
+        if (lightLength >= pointLight.range)
             continue;
         
         // 影響力は距離に比例して小さくなっていく
-        float attenuate = saturate(1.0f - lightLength / pointLightData[i].range);
+        float attenuate = saturate(1.0f - lightLength / pointLight.range);
         
         lightVector = lightVector / lightLength;    // 正規化
-        pointDiffuse += CalcLambertDiffse(N, lightVector, pointLightData[i].color.rgb, Kd) * attenuate;
-        pointSpecular += CalcPhongSpecular(N, lightVector, pointLightData[i].color.rgb, ToCamera, 128.0f, Ks) * attenuate;
+        pointDiffuse += CalcLambertDiffse(N, lightVector, pointLight.color.rgb, Kd) * attenuate;
+        pointSpecular += CalcPhongSpecular(N, lightVector, pointLight.color.rgb, ToCamera, 128.0f, Ks) * attenuate;
     }
     
     // --- スポットライト ---
     float3 spotDiffuse = (float3) 0;
     float3 spotSpecular = (float3) 0;
-    for (i = 0; i < spotLightCount; ++i)
+    for (i = 0; i < clusterSpotCount; ++i)
     {
+        SpotLightData spotLight = spotLightData[lightIndices[lightOffset + clusterPointCount + i]];
+        
         // ライトベクトルを算出
-        float3 lightVector = pin.worldPosition.xyz - spotLightData[i].position.xyz;
+        float3 lightVector = pin.worldPosition.xyz - spotLight.position.xyz;
         float lightLength = length(lightVector);
         
         // ライトの範囲外なら計算しない
-        if (lightLength >= spotLightData[i].range)
+        if (lightLength >= spotLight.range)
             continue;
         
         // 影響力は距離に比例して小さくなっていく
-        float attenuate = saturate(1.0f - lightLength / spotLightData[i].range);
+        float attenuate = saturate(1.0f - lightLength / spotLight.range);
         
         lightVector = lightVector / lightLength; // 正規化
         
         // 角度減数を算出してattenuateに乗算する
-        float3 spotDirection = normalize(spotLightData[i].direction.rgb);
+        float3 spotDirection = normalize(spotLight.direction.rgb);
         float angle = dot(spotDirection, lightVector);
-        float area = spotLightData[i].innerCorn - spotLightData[i].outerCorn;
-        attenuate *= saturate(1.0f - (spotLightData[i].innerCorn - angle) / area);
+        float area = spotLight.innerCorn - spotLight.outerCorn;
+        attenuate *= saturate(1.0f - (spotLight.innerCorn - angle) / area);
         
-        spotDiffuse += CalcLambertDiffse(N, lightVector, spotLightData[i].color.rgb, Kd) * attenuate;
-        spotSpecular += CalcPhongSpecular(N, lightVector, spotLightData[i].color.rgb, ToCamera, 128.0f, Ks) * attenuate;
+        spotDiffuse += CalcLambertDiffse(N, lightVector, spotLight.color.rgb, Kd) * attenuate;
+        spotSpecular += CalcPhongSpecular(N, lightVector, spotLight.color.rgb, ToCamera, 128.0f, Ks) * attenuate;
     }
     
     // 環境光
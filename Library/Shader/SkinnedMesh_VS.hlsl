@@ -29,7 +29,7 @@ VS_OUT main(VS_IN vin)
     vout.worldTangent.w = sigma;
     
     vout.texcoord = vin.texcoord;
-    vout.color = materialColor;
+    vout.color = materialColor * Kd;
      
     return vout;
 }
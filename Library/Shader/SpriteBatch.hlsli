@@ -0,0 +1,22 @@
+// スプライト 1 枚分のインスタンスデータ
+struct VS_IN
+{
+    float4 rect : RECT;             // 左上の座標と大きさ (スクリーン座標)
+    float4 texcoord : TEXCOORD;     // 左上と右下の UV
+    float4 color : COLOR;
+    float4 param : PARAM;           // x : 回転 (ラジアン), y : テクスチャ配列の番号, z : 深度
+    uint vertexId : SV_VertexID;
+};
+
+struct VS_OUT
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+    float3 texcoord : TEXCOORD;     // z はテクスチャ配列の番号
+};
+
+cbuffer SPRITE_BATCH_CONSTANT_BUFFER : register(b0)
+{
+    float2 screenScale;             // スクリーン座標から NDC への係数 (2 / 幅, 2 / 高さ)
+    float2 spriteBatchPad;
+}
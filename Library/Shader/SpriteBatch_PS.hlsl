@@ -0,0 +1,11 @@
+#include "SpriteBatch.hlsli"
+
+Texture2DArray colorMaps : register(t0);
+SamplerState pointSamplerState : register(s0);
+SamplerState linearSamplerState : register(s1);
+SamplerState anisotropicSamplerState : register(s2);
+
+float4 main(VS_OUT pin) : SV_TARGET
+{
+    return colorMaps.Sample(linearSamplerState, pin.texcoord) * pin.color;
+}
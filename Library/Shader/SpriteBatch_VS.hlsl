@@ -0,0 +1,21 @@
+#include "SpriteBatch.hlsli"
+
+// 頂点バッファは使わず、SV_VertexID (0 ~ 3 のストリップ) から矩形の角を作る
+VS_OUT main(VS_IN vin)
+{
+    // 0 : 左上, 1 : 右上, 2 : 左下, 3 : 右下
+    float2 corner = float2(vin.vertexId & 1, vin.vertexId >> 1);
+    
+    // 矩形の中心で回転させる
+    float2 center = vin.rect.xy + vin.rect.zw * 0.5;
+    float2 local = (corner - 0.5) * vin.rect.zw;
+    float s, c;
+    sincos(vin.param.x, s, c);
+    float2 position = center + float2(c * local.x - s * local.y, s * local.x + c * local.y);
+    
+    VS_OUT vout;
+    vout.position = float4(position.x * screenScale.x - 1.0, 1.0 - position.y * screenScale.y, vin.param.z, 1.0);
+    vout.color = vin.color;
+    vout.texcoord = float3(lerp(vin.texcoord.xy, vin.texcoord.zw, corner), vin.param.y);
+    return vout;
+}
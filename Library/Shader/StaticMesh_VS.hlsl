@@ -0,0 +1,31 @@
+#include "SkinnedMesh.hlsli"
+
+// 静的メッシュの頂点 (読み込み時にワールド空間へ変換済み、ボーンなし)
+struct STATIC_VS_IN
+{
+    float4 position : POSITION;
+    float4 normal : NORMAL;
+    float4 tangent : TANGENT;
+    float2 texcoord : TEXCOORD;
+};
+
+VS_OUT main(STATIC_VS_IN vin)
+{
+    float sigma = vin.tangent.w;
+    vin.position.w = 1;
+    vin.normal.w = 0;
+    vin.tangent.w = 0;
+
+    // world は通常単位行列 (変換済みの頂点をそのまま使う)
+    VS_OUT vout;
+    vout.worldPosition = mul(vin.position, world);
+    vout.position = mul(vout.worldPosition, viewProjection);
+    vout.worldNormal = normalize(mul(vin.normal, world));
+    vout.worldTangent = normalize(mul(vin.tangent, world));
+    vout.worldTangent.w = sigma;
+
+    vout.texcoord = vin.texcoord;
+    vout.color = materialColor * Kd;
+
+    return vout;
+}
@@ -119,7 +119,7 @@ void FontTexture::Create(TCHAR* c, int fontSize)
 	D3D11_MAPPED_SUBRESOURCE hMappedResource{};
 	if (tex2D != nullptr)
 	{
-		hr = gfx.deviceContext->Map(
+		hr = gfx.stateCache.Map(
 			tex2D,
 			0,
 			D3D11_MAP_WRITE_DISCARD,
@@ -151,7 +151,7 @@ void FontTexture::Create(TCHAR* c, int fontSize)
 			}
 		}
 
-		gfx.deviceContext->Unmap(tex2D, 0);
+		gfx.stateCache.Unmap(tex2D, 0);
 	}
 
 	// テクスチャ情報を取得する
@@ -1,6 +1,7 @@
 #include <filesystem>
 #include "Text.h"
 #include "../Graphics/Graphics.h"
+#include "../MemoryTracker.h"
 
 Text::Text()
 {
@@ -38,6 +39,8 @@ Text::~Text()
 
 void Text::drawText(FONTNO fontNo, FONTSIZE fontSize, std::string str, DirectX::XMFLOAT2 position, DirectX::XMFLOAT2 scale, DirectX::XMFLOAT4 color, TEXT_ALIGN align)
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::TEXT);
+
 	//-------- utf16へ変換 --------
 	auto text = std::filesystem::path(str).u16string();
 
@@ -72,6 +75,8 @@ void Text::drawText(FONTNO fontNo, FONTSIZE fontSize, std::string str, DirectX::
 
 	//これがないと透過処理が変になる
 	Graphics* gfx = &Graphics::Instance();
+	// SpriteBatch が deviceContext を直接触っているのでステートキャッシュの記憶を捨てる
+	gfx->stateCache.Invalidate();
 	gfx->SetBlend(BLEND_STATE::ALPHA);
 	gfx->SetDepthStencil(DEPTHSTENCIL_STATE::ZT_ON_ZW_ON);
 }
@@ -142,6 +142,12 @@ public:
 		}
 	}
 
+	// このフレームの経過時間を差し替える (Tick の後に呼ぶ、入力の再生用)
+	void OverrideDeltaTime(float overrideDeltaTime)
+	{
+		deltaTime = static_cast<double>(overrideDeltaTime);
+	}
+
 	// --- ゲッター ---
 	float DeltaTime() const
 	{
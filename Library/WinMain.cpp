@@ -1,8 +1,43 @@
 #include <Windows.h>
 #include <crtdbg.h>
+#include <shellapi.h>
+#include <cwchar>
 #include "Framework.h"
+#include "Input/InputRecorder.h"
+#include "Graphics/Graphics.h"
+#include "../SceneManager.h"
 #include "../Stage.h"
 
+// コマンドライン "-replay <ファイル> [-frames <フレーム数>] [-headless]" で入力を再生するベンチマークを行う
+// (SceneGame で再生し、終わったら統計を <ファイル>.benchmark.txt に追記して終了する)
+// -headless を付けると描画 API を呼ばずに更新と描画の発行だけを計測する
+static void StartReplayBenchmark(LPWSTR lpCmdLine)
+{
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(lpCmdLine, &argc);
+	if (argv == nullptr) return;
+
+	const wchar_t* replayFilename = nullptr;
+	uint32_t frameLimit = 0;
+	bool headless = false;
+	for (int i = 0; i < argc; ++i)
+	{
+		if (wcscmp(argv[i], L"-headless") == 0) headless = true;
+		else if (i + 1 >= argc) break;
+		else if (wcscmp(argv[i], L"-replay") == 0) replayFilename = argv[++i];
+		else if (wcscmp(argv[i], L"-frames") == 0) frameLimit = static_cast<uint32_t>(_wtoi(argv[++i]));
+	}
+
+	if (headless) Graphics::Instance().SetRecording(true, true);
+
+	if (replayFilename != nullptr && InputRecorder::Instance().StartReplay(replayFilename, frameLimit, true))
+	{
+		SceneManager::Instance().ChangeScene(new SceneGame);
+	}
+
+	LocalFree(argv);
+}
+
 //--------------------------------------------------------------
 //  WinMain
 //--------------------------------------------------------------
@@ -18,6 +53,12 @@ int APIENTRY wWinMain(
 	// 初期化
 	if (framework.Initialize(hInstance))
 	{
+		// 入力の再生ベンチマーク
+		if (lpCmdLine != nullptr && lpCmdLine[0] != L'\0')
+		{
+			StartReplayBenchmark(lpCmdLine);
+		}
+
 		// 更新
 		framework.Update();
 	}
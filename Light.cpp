@@ -9,7 +9,7 @@ Light::Light(LightType lightType)
 }
 
 // ライト情報を積む
-void Light::PushLightData(Graphics::SceneConstants& cBuffer) const
+void Light::PushLightData(Graphics::SceneConstants& cBuffer, LightCluster& cluster) const
 {
 	// 登録されている光源の情報を設定
 	switch (lightType)
@@ -22,34 +22,36 @@ void Light::PushLightData(Graphics::SceneConstants& cBuffer) const
 		cBuffer.directionalLightData.color = color;
 		break;
 	case LightType::Point:
-		if (cBuffer.pointLightCount >= Graphics::PointLightMax)
-			break;
-		cBuffer.pointLightData[cBuffer.pointLightCount].position.x = position.x;
-		cBuffer.pointLightData[cBuffer.pointLightCount].position.y = position.y;
-		cBuffer.pointLightData[cBuffer.pointLightCount].position.z = position.z;
-		cBuffer.pointLightData[cBuffer.pointLightCount].position.w = 0.0f;
-		cBuffer.pointLightData[cBuffer.pointLightCount].color = color;
-		cBuffer.pointLightData[cBuffer.pointLightCount].range = range;
-		cBuffer.pointLightCount++;
+	{
+		LightCluster::PointLightData data{};
+		data.position.x = position.x;
+		data.position.y = position.y;
+		data.position.z = position.z;
+		data.position.w = 0.0f;
+		data.color = color;
+		data.range = range;
+		cluster.AddPointLight(data);
 		break;
+	}
 	case LightType::Spot:
-		if (cBuffer.spotLightCount >= Graphics::SpotLightMax)
-			break;
-		cBuffer.spotLightData[cBuffer.spotLightCount].position.x = position.x;
-		cBuffer.spotLightData[cBuffer.spotLightCount].position.y = position.y;
-		cBuffer.spotLightData[cBuffer.spotLightCount].position.z = position.z;
-		cBuffer.spotLightData[cBuffer.spotLightCount].position.w = 1.0f;
-		cBuffer.spotLightData[cBuffer.spotLightCount].direction.x = direction.x;
-		cBuffer.spotLightData[cBuffer.spotLightCount].direction.y = direction.y;
-		cBuffer.spotLightData[cBuffer.spotLightCount].direction.z = direction.z;
-		cBuffer.spotLightData[cBuffer.spotLightCount].direction.w = 0.0f;
-		cBuffer.spotLightData[cBuffer.spotLightCount].color = color;
-		cBuffer.spotLightData[cBuffer.spotLightCount].range = range;
-		cBuffer.spotLightData[cBuffer.spotLightCount].innerCorn = innerCorn;
-		cBuffer.spotLightData[cBuffer.spotLightCount].outerCorn = outerCorn;
-		cBuffer.spotLightCount++;
+	{
+		LightCluster::SpotLightData data{};
+		data.position.x = position.x;
+		data.position.y = position.y;
+		data.position.z = position.z;
+		data.position.w = 1.0f;
+		data.direction.x = direction.x;
+		data.direction.y = direction.y;
+		data.direction.z = direction.z;
+		data.direction.w = 0.0f;
+		data.color = color;
+		data.range = range;
+		data.innerCorn = innerCorn;
+		data.outerCorn = outerCorn;
+		cluster.AddSpotLight(data);
 		break;
 	}
+	}
 }
 
 void Light::DrawDebugGUI()
@@ -16,8 +16,8 @@ class Light
 public:
 	Light(LightType lightType = LightType::Directional);
 
-	// ライト情報を積む
-	void PushLightData(Graphics::SceneConstants& cBuffer) const;
+	// ライト情報を積む (平行光源は定数バッファ、点光源・スポットライトは cluster へ)
+	void PushLightData(Graphics::SceneConstants& cBuffer, LightCluster& cluster) const;
 
 	// デバッグ情報の表示
 	void DrawDebugGUI();
@@ -35,16 +35,29 @@ void LightManager::Clear()
 }
 
 // ライト情報を積む
-void LightManager::PushLightData(Graphics::SceneConstants& cBuffer)
+void LightManager::PushLightData(Graphics::SceneConstants& cBuffer, const DirectX::XMFLOAT4X4& view, const DirectX::XMFLOAT4X4& projection)
 {
 	// 環境光の情報を追加
 	cBuffer.ambientLightColor = ambientColor;
 
 	// 登録されている光源の情報を設定
+	lightCluster.Clear();
 	for (Light* light : lights)
 	{
-		light->PushLightData(cBuffer);
+		light->PushLightData(cBuffer, lightCluster);
 	}
+
+	// 点光源・スポットライトをクラスターに割り当てる
+	lightCluster.Build(view, projection);
+	cBuffer.pointLightCount = static_cast<int>(lightCluster.GetPointLights().size());
+	cBuffer.spotLightCount = static_cast<int>(lightCluster.GetSpotLights().size());
+	cBuffer.clusterDepthScale = lightCluster.GetDepthSliceScale();
+
+	// --- Graphics 取得 ---
+	Graphics& gfx = Graphics::Instance();
+
+	gfx.lightClusterBuffer.Update(gfx.stateCache, lightCluster);
+	gfx.lightClusterBuffer.Bind(gfx.stateCache);
 }
 
 // デバッグ情報の表示
@@ -53,6 +66,13 @@ void LightManager::DrawDebugGui()
 	if (ImGui::TreeNode("Lights"))
 	{
 		ImGui::ColorEdit3("AmbientColor", &ambientColor.x);
+
+		// クラスターへの割り当て
+		const LightCluster::Statistics& statistics = lightCluster.GetStatistics();
+		ImGui::Text("Cluster Point:%u Spot:%u Dropped:%u", statistics.pointLightCount, statistics.spotLightCount, statistics.droppedLightCount);
+		ImGui::Text("Cluster Indices:%u Clipped:%u", statistics.lightIndexCount, statistics.clippedLightIndexCount);
+		ImGui::Text("Cluster Occupied:%u/%d MaxPerCluster:%u", statistics.occupiedClusterCount, LightCluster::ClusterCount, statistics.maxLightsPerCluster);
+
 		int nodeId = 0;
 		for (Light* light : lights)
 		{
@@ -28,7 +28,8 @@ public:
 	void Clear();
 
 	// ライト情報を積む
-	void PushLightData(Graphics::SceneConstants& cBuffer);
+	// 点光源・スポットライトはクラスターに割り当てて Graphics::lightClusterBuffer に書き込み、ピクセルシェーダーに設定する
+	void PushLightData(Graphics::SceneConstants& cBuffer, const DirectX::XMFLOAT4X4& view, const DirectX::XMFLOAT4X4& projection);
 
 
 	// デバッグ情報の表示
@@ -45,7 +46,12 @@ public:
 	int GetLightCount() const { return static_cast<int>(lights.size()); }
 	Light* GetLight(int index) const { return lights.at(index); }
 
+	// クラスターへの割り当て結果
+	const LightCluster& GetLightCluster() const { return lightCluster; }
+
 private:
 	std::vector<Light*> lights;
 	DirectX::XMFLOAT4 ambientColor = { 0.2f, 0.2f, 0.2f, 1.0f };
+
+	LightCluster lightCluster;
 };
\ No newline at end of file
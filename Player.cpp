@@ -15,6 +15,7 @@
 #include "Library/Audio/AudioManager.h"
 #include "DamageTextManager.h"
 #include "Library/3D/ResourceManager.h"
+#include "Library/FrameArena.h"
 
 //==========================================================================
 //
@@ -25,9 +26,7 @@
 // コンストラクタ
 Player::Player()
 {
-	//model = ResourceManager::Instance().LoadModelResource("Data/Fbx/Chara/character.fbx");
-
-	model = std::make_unique<SkinnedMesh>("Data/Fbx/Chara/character.fbx");
+	model = ResourceManager::Instance().LoadModelResource("Data/Fbx/Chara/character.fbx");
 
 	// 待機ステートへ遷移
 	TransitionIdleState();
@@ -291,7 +290,7 @@ void Player::CollisionPlayerVsEnemies()
 		// 
 		if (enemy->model->skeletonSpheres.size() > 0)
 		{
-			for (auto skeletonSphere : enemy->model->skeletonSpheres)
+			for (const SkeletonSphere& skeletonSphere : enemy->model->skeletonSpheres)
 			{
 
 				DirectX::XMFLOAT3 collisionPosition = { 0,0,0 };
@@ -299,28 +298,8 @@ void Player::CollisionPlayerVsEnemies()
 
 				if (skeletonSphere.name != "")
 				{
-					// ボーンごとの処理
-					Animation::KeyFrame& keyframe = enemy->model->animationClips.at(enemy->currentAnimationIndex).sequence.at(enemy->currentKeyFrame);
-
-					int nodeCount = keyframe.nodes.size();
-					for (int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
-					{
-						Animation::KeyFrame::Node& node = keyframe.nodes.at(nodeIndex);
-
-						// ボーンのノードと同じ名前なら処理する
-						if (node.name != skeletonSphere.name) continue;
-
-						DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&node.globalTransform);
-
-						DirectX::XMMATRIX T = DirectX::XMLoadFloat4x4(&enemy->GetTransform());
-
-						DirectX::XMMATRIX W = M * T;
-						DirectX::XMFLOAT4X4 w;
-						DirectX::XMStoreFloat4x4(&w, W);
-
-						collisionPosition = { w._41, w._42, w._43 };
-						break;
-					}
+					// ボーンのノード番号から位置を取得
+					collisionPosition = enemy->GetNodeWorldPosition(skeletonSphere.nodeIndex);
 				}
 
 				// 衝突処理
@@ -428,10 +407,7 @@ void Player::CollisionProjectilesVsEnemies()
 
 					// ダメージ表示
 					int damage = 1;
-					std::wstring damageString = std::to_wstring(damage);
-					const TCHAR* damageTChar = damageString.c_str();
-					DamageText* damageText = new_ DamageText(e, damageTChar);
-					DamageTextManager::Instance().Register(damageText);
+					DamageTextManager::Instance().Register(e, FrameArena::Instance().Format(L"%d", damage));
 				}
 			}
 		}
@@ -443,16 +419,12 @@ void Player::CollisionNodeVsEnemies()
 {
 	EnemyManager& enemyManager = EnemyManager::Instance();
 
-	// sphere
-	int collisionCount = model->animationClips.at(currentAnimationIndex).spheres.size();
+	// sphere (現在のフレームで有効なものだけ)
 	int enemyCount = enemyManager.GetEnemyCount();
 
-	for (int i = 0; i < collisionCount; i++)
+	model->animationClips.at(currentAnimationIndex).sphereTrack.ForEachActive(currentKeyFrame, [&](const AnimationEventTrack::Event& sphereEvent)
 	{
-		int startFrame = model->animationClips.at(currentAnimationIndex).spheres.at(i).startFrame;
-		int endFrame = model->animationClips.at(currentAnimationIndex).spheres.at(i).endFrame;
-
-		if (currentKeyFrame < startFrame || currentKeyFrame > endFrame) continue;
+		int i = sphereEvent.index;
 
 		DirectX::XMFLOAT4 color = model->animationClips.at(currentAnimationIndex).spheres.at(i).color;
 
@@ -461,27 +433,8 @@ void Player::CollisionNodeVsEnemies()
 
 		if (model->animationClips.at(currentAnimationIndex).spheres.at(i).bindBoneName != "")
 		{
-			// ボーンごとの処理
-			Animation::KeyFrame& keyframe = model->animationClips.at(currentAnimationIndex).sequence.at(currentKeyFrame);
-
-			int nodeCount = keyframe.nodes.size();
-			for (int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
-			{
-				Animation::KeyFrame::Node& node = keyframe.nodes.at(nodeIndex);
-
-				// ボーンのノードと同じ名前なら処理する
-				if (node.name != model->animationClips.at(currentAnimationIndex).spheres.at(i).bindBoneName) continue;
-
-				DirectX::XMMATRIX T = DirectX::XMLoadFloat4x4(&transform);
-				DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&node.globalTransform);
-
-				DirectX::XMMATRIX W = M * T;
-				DirectX::XMFLOAT4X4 w;
-				DirectX::XMStoreFloat4x4(&w, W);
-
-				playerCollisionPosition = { w._41, w._42, w._43 };
-				break;
-			}
+			// ボーンのノード番号から位置を取得
+			playerCollisionPosition = GetNodeWorldPosition(model->animationClips.at(currentAnimationIndex).spheres.at(i).bindNodeIndex);
 		}
 		else
 		{
@@ -520,35 +473,15 @@ void Player::CollisionNodeVsEnemies()
 			// skeletonSphere を持つ場合
 			if (enemy->model->skeletonSpheres.size() > 0)
 			{
-				for (auto skeletonSphere : enemy->model->skeletonSpheres)
+				for (const SkeletonSphere& skeletonSphere : enemy->model->skeletonSpheres)
 				{
 
 					DirectX::XMFLOAT3 collisionPosition = { 0,0,0 };
 
 					if (skeletonSphere.name != "")
 					{
-						// ボーンごとの処理
-						Animation::KeyFrame& keyframe = enemy->model->animationClips.at(enemy->currentAnimationIndex).sequence.at(enemy->currentKeyFrame);
-
-						int nodeCount = keyframe.nodes.size();
-						for (int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
-						{
-							Animation::KeyFrame::Node& node = keyframe.nodes.at(nodeIndex);
-
-							// ボーンのノードと同じ名前なら処理する
-							if (node.name != skeletonSphere.name) continue;
-
-							DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&node.globalTransform);
-
-							DirectX::XMMATRIX T = DirectX::XMLoadFloat4x4(&enemy->GetTransform());
-
-							DirectX::XMMATRIX W = M * T;
-							DirectX::XMFLOAT4X4 w;
-							DirectX::XMStoreFloat4x4(&w, W);
-
-							collisionPosition = { w._41, w._42, w._43 };
-							break;
-						}
+						// ボーンのノード番号から位置を取得
+						collisionPosition = enemy->GetNodeWorldPosition(skeletonSphere.nodeIndex);
 					}
 
 					// 衝突処理
@@ -570,10 +503,7 @@ void Player::CollisionNodeVsEnemies()
 
 							// ダメージ表示
 							int damage = 1;
-							std::wstring damageString = std::to_wstring(damage);
-							const TCHAR* damageTChar = damageString.c_str();
-							DamageText* damageText = new_ DamageText(e, damageTChar);
-							DamageTextManager::Instance().Register(damageText);
+							DamageTextManager::Instance().Register(e, FrameArena::Instance().Format(L"%d", damage));
 						}
 					}
 				}
@@ -617,16 +547,13 @@ void Player::CollisionNodeVsEnemies()
 
 						// ダメージ表示
 						int damage = 1;
-						std::wstring damageString = std::to_wstring(damage);
-						const TCHAR* damageTChar = damageString.c_str();
-						DamageText* damageText = new_ DamageText(e, damageTChar);
-						DamageTextManager::Instance().Register(damageText);
+						DamageTextManager::Instance().Register(e, FrameArena::Instance().Format(L"%d", damage));
 					}
 				}
 			}
 		}
 		
-	}
+	});
 }
 
 
@@ -797,13 +724,16 @@ void Player::Render()
 	//DebugPrimitive::Instance().AddSphere(position, radius, { 1,0,0,1 });
 	DebugPrimitive::Instance().AddCylinder(position, radius, height, { 1,0,0,1 });
 
-	// 弾丸描画処理
-	projectileManager.Render();
-
 	// デバッグプリミティブ描画
 	DrawDebugPrimitive();
 }
 
+// 弾丸描画処理 (視錐台カリングでプレイヤーが描画されなくても呼ぶ)
+void Player::RenderProjectiles()
+{
+	projectileManager.Render();
+}
+
 // デバッグ用GUI描画
 void Player::DrawDebugGui()
 {
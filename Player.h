@@ -26,6 +26,8 @@ public:
 
 	// 描画処理
 	void Render();
+	// 弾丸描画処理
+	void RenderProjectiles();
 
 	// デバッグ用GUI描画
 	void DrawDebugGui();
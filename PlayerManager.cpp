@@ -1,4 +1,6 @@
 #include "PlayerManager.h"
+#include "Library/3D/Camera.h"
+#include "Library/3D/OcclusionCuller.h"
 
 // 更新処理
 void PlayerManager::Update()
@@ -28,9 +30,33 @@ void PlayerManager::Update()
 //　描画処理
 void PlayerManager::Render()
 {
+	// 視錐台カリング
+	cullingBatch.Clear();
 	for (Player* player : players)
 	{
-		player->Render();
+		DirectX::XMFLOAT3 center, extents;
+		if (player->GetWorldBounds(center, extents))
+		{
+			cullingBatch.Add(center, extents);
+		}
+		else
+		{
+			cullingBatch.AddAlwaysVisible();
+		}
+	}
+	Camera::Instance().Cull(cullingBatch);
+	// 遮蔽カリング (ステージの壁の裏にあるもの)
+	OcclusionCuller::Instance().Cull(cullingBatch);
+
+	for (size_t i = 0; i < players.size(); i++)
+	{
+		if (cullingBatch.IsVisible(i))
+		{
+			players[i]->Render();
+		}
+
+		// 弾丸はプレイヤーが画面外でも見えることがあるので別に描画する
+		players[i]->RenderProjectiles();
 	}
 }
 
@@ -3,6 +3,7 @@
 #include <vector>
 #include <set>
 #include "Player.h"
+#include "Library/3D/Frustum.h"
 
 // プレイヤーマネージャー
 class PlayerManager
@@ -46,4 +47,7 @@ public:
 private:
 	std::vector<Player*> players;
 	std::set<Player*> removes;
+
+	// 視錐台カリング (players と同じ順番で登録する)
+	FrustumCullingBatch cullingBatch;
 };
\ No newline at end of file
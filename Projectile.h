@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include "Library/Graphics/Graphics.h"
 #include "Library/3D/SpherePrimitive.h"
 
@@ -28,6 +29,14 @@ public:
 	// 半径取得
 	float GetRadius() const { return radius; }
 
+	// 視錐台カリング用のワールド空間 AABB 取得
+	void GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const
+	{
+		const float r = (std::max)({ radius, scale.x, scale.y, scale.z });
+		center = position;
+		extents = { r, r, r };
+	}
+
 	// 破棄
 	void Destroy();
 
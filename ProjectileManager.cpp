@@ -1,4 +1,6 @@
 #include "ProjectileManager.h"
+#include "Library/3D/Camera.h"
+#include "Library/3D/OcclusionCuller.h"
 
 // コンストラクタ
 ProjectileManager::ProjectileManager()
@@ -39,9 +41,23 @@ void ProjectileManager::Update()
 // 描画処理
 void ProjectileManager::Render()
 {
+	// 視錐台カリング
+	cullingBatch.Clear();
 	for (Projectile* projectile : projectiles)
 	{
-		projectile->Render();
+		DirectX::XMFLOAT3 center, extents;
+		projectile->GetWorldBounds(center, extents);
+		cullingBatch.Add(center, extents);
+	}
+	Camera::Instance().Cull(cullingBatch);
+	// 遮蔽カリング (ステージの壁の裏にあるもの)
+	OcclusionCuller::Instance().Cull(cullingBatch);
+
+	for (size_t i = 0; i < projectiles.size(); i++)
+	{
+		if (!cullingBatch.IsVisible(i)) continue;
+
+		projectiles[i]->Render();
 	}
 }
 
@@ -3,6 +3,7 @@
 #include <vector>
 #include <set>
 #include "Projectile.h"
+#include "Library/3D/Frustum.h"
 
 // 弾丸マネージャー
 class ProjectileManager
@@ -35,4 +36,7 @@ public:
 private:
 	std::vector<Projectile*> projectiles;
 	std::set<Projectile*> removes;
+
+	// 視錐台カリング (projectiles と同じ順番で登録する)
+	FrustumCullingBatch cullingBatch;
 };
\ No newline at end of file
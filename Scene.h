@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "Library/3D/AssetManifest.h"
 
 //--------------------------------------------------------------
 //  Scene
@@ -11,6 +12,10 @@ public:
 	virtual ~Scene() {}
 
 
+	// 使うモデル・テクスチャの一覧 (SceneManager が切り替え時、前のシーンを消す前に呼ぶ)
+	// 載せたものは前のシーンと共通なら残され、足りなければ AsyncLoader で並列に読み込まれる
+	virtual void DeclareAssets(AssetManifest& manifest) const {}
+
 	// 初期化
 	virtual void Initialize() = 0;
 
@@ -83,61 +83,48 @@ void SceneAnimation::Update()
 			// 停止中
 			else
 			{
-				ClearEffectFlag();
-				ClearSEFlag();
 				currentFrameFloat = currentFrameInt;
 			}
 
+			// タイムラインで編集された時 (アイテムの追加・削除・移動) とアニメーションを切り替えた時だけ並べ直す
+			Animation& animation = model->animationClips.at(animationClipIndex);
+			if (eventTracksDirty)
+			{
+				animation.BuildEventTracks();
+				eventTracksDirty = false;
+			}
+
+			// 停止中は再生位置を現在フレームの手前に合わせておく
+			if (!isPlay)
+			{
+				effectCursor.Seek(animationClipIndex, animation.effectTrack, currentFrameInt - 1);
+				seCursor.Seek(animationClipIndex, animation.seTrack, currentFrameInt - 1);
+			}
+
 			// エフェクト処理
 			if (isPlay)
 			{
-				int effectCount = model->animationClips.at(animationClipIndex).animEffects.size();
-
-				for (int i = 0; i < effectCount; i++)
+				effectCursor.Advance(animationClipIndex, animation.effectTrack, currentFrameInt, [&](uint32_t i)
 				{
-					// 既に再生されているなら再生しない
-					if (model->animationClips.at(animationClipIndex).animEffects.at(i).isPlay) continue;
-
-					int startFrame = model->animationClips.at(animationClipIndex).animEffects.at(i).startFrame;
-					int endFrame = model->animationClips.at(animationClipIndex).animEffects.at(i).endFrame;
-
-					//if (currentFrameInt < startFrame || currentFrameInt > endFrame) continue;
-					if (currentFrameInt != startFrame) continue;
-
-					model->animationClips.at(animationClipIndex).animEffects.at(i).isPlay = true;
+					EffectType type = animation.animEffects.at(i).effectType;
+					float scale = animation.animEffects.at(i).scale;
 
-					EffectType type = model->animationClips.at(animationClipIndex).animEffects.at(i).effectType;
-					float scale = model->animationClips.at(animationClipIndex).animEffects.at(i).scale;
-
-					DirectX::XMFLOAT3 position = model->animationClips.at(animationClipIndex).animEffects.at(i).position;
-					DirectX::XMFLOAT3 angle = model->animationClips.at(animationClipIndex).animEffects.at(i).angle;
+					DirectX::XMFLOAT3 position = animation.animEffects.at(i).position;
+					DirectX::XMFLOAT3 angle = animation.animEffects.at(i).angle;
 
 					Effect::Instance().Play(type, position, angle, scale);
-				}
+				});
 			}
 
 			// 効果音処理
 			if (isPlay)
 			{
-				int seCount = model->animationClips.at(animationClipIndex).animSEs.size();
-
-				for (int i = 0; i < seCount; i++)
+				seCursor.Advance(animationClipIndex, animation.seTrack, currentFrameInt, [&](uint32_t i)
 				{
-					// 既に再生されているなら再生しない
-					if (model->animationClips.at(animationClipIndex).animSEs.at(i).isPlay) continue;
-
-					int startFrame = model->animationClips.at(animationClipIndex).animSEs.at(i).startFrame;
-					int endFrame = model->animationClips.at(animationClipIndex).animSEs.at(i).endFrame;
-
-					//if (currentFrameInt < startFrame || currentFrameInt > endFrame) continue;
-					if (currentFrameInt != startFrame) continue;
-
-					model->animationClips.at(animationClipIndex).animSEs.at(i).isPlay = true;
-
-					MUSIC_LABEL type = model->animationClips.at(animationClipIndex).animSEs.at(i).musicType;
+					MUSIC_LABEL type = animation.animSEs.at(i).musicType;
 
 					AudioManager::Instance().PlayMusic(static_cast<int>(type));
-				}
+				});
 			}
 		}
 	}
@@ -161,9 +148,9 @@ void SceneAnimation::Render()
 	data.directionalLightData.color = lightColor;
 	data.ambientLightColor = ambientLightColor;
 	data.cameraPosition = { Camera::Instance().GetEye().x, Camera::Instance().GetEye().y, Camera::Instance().GetEye().z, 0 };
-	gfx.deviceContext->UpdateSubresource(gfx.constantBuffer.Get(), 0, 0, &data, 0, 0);
-	gfx.deviceContext->VSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
-	gfx.deviceContext->PSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
+	gfx.stateCache.UpdateSubresource(gfx.constantBuffer.Get(), 0, 0, &data, 0, 0);
+	gfx.stateCache.VSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
+	gfx.stateCache.PSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
 
 	// --- モデル描画 ---
 	if (model)
@@ -223,14 +210,12 @@ void SceneAnimation::Render()
 			{
 				Animation::KeyFrame& keyframe = model->animationClips.at(animationClipIndex).sequence.at(currentFrameInt);
 
-				int nodeCount = keyframe.nodes.size();
-				for (int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+				// ボーンのノード番号で直接参照する
+				int64_t nodeIndex = model->animationClips.at(animationClipIndex).spheres.at(i).bindNodeIndex;
+				if (nodeIndex >= 0 && nodeIndex < static_cast<int64_t>(keyframe.nodes.size()))
 				{
 					Animation::KeyFrame::Node& node = keyframe.nodes.at(nodeIndex);
 
-					// ボーンのノードと同じ名前なら処理する
-					if (node.name != model->animationClips.at(animationClipIndex).spheres.at(i).bindBoneName) continue;
-
 					DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&node.globalTransform);
 
 					const float scaleFactor = model->scaleFactors[model->fbxUnit];
@@ -549,6 +534,26 @@ void SceneAnimation::DrawDebugGUI()
 			ImGui::EndCombo();
 		}
 
+		// アニメーションの LOD (ドラッグ中は書き出さず、離した時に cereal 書き出し)
+		if (ImGui::CollapsingHeader(u8"アニメーション LOD"))
+		{
+			AnimationLodPolicy policy = model->animationLodPolicy;
+			bool edited = false;
+			ImGui::DragFloat(u8"Reduced 距離", &policy.reducedDistance, 0.1f, 0.0f, policy.farDistance);
+			edited |= ImGui::IsItemDeactivatedAfterEdit();
+			ImGui::DragFloat(u8"Far 距離", &policy.farDistance, 0.1f, policy.reducedDistance, 1000.0f);
+			edited |= ImGui::IsItemDeactivatedAfterEdit();
+			ImGui::SliderInt(u8"Reduced 間隔", &policy.reducedInterval, 1, 8);
+			edited |= ImGui::IsItemDeactivatedAfterEdit();
+			ImGui::SliderInt(u8"Far 間隔", &policy.farInterval, 1, 16);
+			edited |= ImGui::IsItemDeactivatedAfterEdit();
+			edited |= ImGui::Checkbox(u8"Far でもブレンド", &policy.blendOnFar);
+
+			// 値はすぐに反映して、書き出しは編集が終わった時だけ
+			model->animationLodPolicy = policy;
+			if (edited) model->SetAnimationLodPolicy(policy);
+		}
+
 		// トランスフォーム
 		if (ImGui::CollapsingHeader("Transform", ImGuiTreeNodeFlags_DefaultOpen))
 		{
@@ -607,6 +612,7 @@ void SceneAnimation::DrawDebugGUI()
 			if(ImGui::RadioButton((model->animationClips.at(animIndex).name).c_str(), &animationClipIndex, animIndex))
 			{
 				mySequence.mFrameMax = model->animationClips.at(animIndex).sequence.size() - 1;
+				eventTracksDirty = true;
 
 				currentFrameInt = 0;
 				currentFrameFloat = 0.0f;
@@ -711,7 +717,7 @@ void SceneAnimation::DrawDebugGUI()
 				std::ofstream ofs(newFilePath.c_str(), std::ios::out);
 				cereal::JSONOutputArchive  serialization(ofs);
 #endif
-				serialization(model->sceneView, model->coordinateSystemIndex, model->fbxUnit, model->skeletonSpheres);
+				serialization(model->sceneView, model->coordinateSystemIndex, model->fbxUnit, model->skeletonSpheres, model->animationLodPolicy);
 			}
 
 			static std::string boneName = "";
@@ -725,6 +731,7 @@ void SceneAnimation::DrawDebugGUI()
 				SkeletonSphere skeletonSphere;
 				skeletonSphere.name = boneName.c_str();
 				skeletonSphere.radius = boneRadius;
+				skeletonSphere.nodeIndex = model->FindNodeIndex(skeletonSphere.name);
 				model->skeletonSpheres.push_back(skeletonSphere);
 			}
 
@@ -752,14 +759,12 @@ void SceneAnimation::DrawDebugGUI()
 				{
 					Animation::KeyFrame& keyframe = model->animationClips.at(animationClipIndex).sequence.at(currentFrameInt);
 
-					int nodeCount = keyframe.nodes.size();
-					for (int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+					// ボーンのノード番号で直接参照する
+					int64_t nodeIndex = model->skeletonSpheres.at(boneSphereIndex).nodeIndex;
+					if (nodeIndex >= 0 && nodeIndex < static_cast<int64_t>(keyframe.nodes.size()))
 					{
 						Animation::KeyFrame::Node& node = keyframe.nodes.at(nodeIndex);
 
-						// ボーンのノードと同じ名前なら処理する
-						if (node.name != model->skeletonSpheres.at(boneSphereIndex).name) continue;
-
 						DirectX::XMMATRIX M = DirectX::XMLoadFloat4x4(&node.globalTransform);
 
 						const float scaleFactor = model->scaleFactors[model->fbxUnit];
@@ -883,6 +888,7 @@ void SceneAnimation::DrawDebugGUI()
 
 				// 削除後
 				animationClipIndex = 0;		// 選択中のアニメーションを最初のアニメーションにする
+				eventTracksDirty = true;
 				currentFrameInt = 0;
 				currentFrameFloat = 0.0f;
 				mySequence.mFrameMax = model->animationClips.at(animationClipIndex).sequence.size() - 1;
@@ -947,6 +953,7 @@ void SceneAnimation::DrawDebugGUI()
 					collision.endFrame = 10;
 					collision.radius = 1.0f;
 					model->animationClips.at(animationClipIndex).spheres.push_back(collision);
+					eventTracksDirty = true;
 
 					mySequence.Add(newSequenceName, selectSequencerItemTypeName, 0, 10);
 				}
@@ -958,6 +965,7 @@ void SceneAnimation::DrawDebugGUI()
 					animEffect.endFrame = 10;
 					animEffect.scale = 1.0f;
 					model->animationClips.at(animationClipIndex).animEffects.push_back(animEffect);
+					eventTracksDirty = true;
 
 					mySequence.Add(newSequenceName, selectSequencerItemTypeName, 0, 10);
 				}
@@ -968,6 +976,7 @@ void SceneAnimation::DrawDebugGUI()
 					animSE.startFrame = 0;
 					animSE.endFrame = 10;
 					model->animationClips.at(animationClipIndex).animSEs.push_back(animSE);
+					eventTracksDirty = true;
 
 					mySequence.Add(newSequenceName, selectSequencerItemTypeName, 0, 10);
 				}
@@ -997,6 +1006,7 @@ void SceneAnimation::DrawDebugGUI()
 
 						CollisionSphere collision = model->animationClips.at(animationClipIndex).spheres.at(index);
 						model->animationClips.at(animationClipIndex).spheres.push_back(collision);
+						eventTracksDirty = true;
 
 						mySequence.Add(collision.name, static_cast<int>(SequencerItemType::Sphere), collision.startFrame, collision.endFrame);
 
@@ -1007,6 +1017,7 @@ void SceneAnimation::DrawDebugGUI()
 
 						AnimEffect animEffect = model->animationClips.at(animationClipIndex).animEffects.at(index);
 						model->animationClips.at(animationClipIndex).animEffects.push_back(animEffect);
+						eventTracksDirty = true;
 
 						mySequence.Add(animEffect.name, static_cast<int>(SequencerItemType::Effect), animEffect.startFrame, animEffect.endFrame);
 					}
@@ -1035,6 +1046,8 @@ void SceneAnimation::DrawDebugGUI()
 						model->animationClips.at(animationClipIndex).animSEs.erase(model->animationClips.at(animationClipIndex).animSEs.begin() + index);
 					}
 
+					eventTracksDirty = true;
+
 					// mySequence 内のアイテムを削除
 					mySequence.myItems.erase(mySequence.myItems.begin() + mySequence.selectItemNum);
 
@@ -1068,7 +1081,12 @@ void SceneAnimation::DrawDebugGUI()
 					{
 						int index = mySequence.myItems.at(mySequence.selectItemNum).mTypeIndex;
 
-						// 値のセット
+						// 値のセット (フレームが動いたらイベントトラックを作り直す)
+						if (model->animationClips.at(animationClipIndex).spheres.at(index).startFrame != selectStartFrame ||
+							model->animationClips.at(animationClipIndex).spheres.at(index).endFrame != selectEndFrame)
+						{
+							eventTracksDirty = true;
+						}
 						model->animationClips.at(animationClipIndex).spheres.at(index).name = selectName.c_str();
 						model->animationClips.at(animationClipIndex).spheres.at(index).startFrame = selectStartFrame;
 						model->animationClips.at(animationClipIndex).spheres.at(index).endFrame = selectEndFrame;
@@ -1081,9 +1099,12 @@ void SceneAnimation::DrawDebugGUI()
 						ImGui::DragFloat(u8"半径", &radius, 0.01f);
 						ImGui::DragFloat3(u8"POSITION", &position.x, 0.01f);
 						ImGui::ColorEdit4(u8"COLOR", &color.x);
-						ImGui::InputText(u8"BONE名前", (char*)bindBoneName.c_str(), sizeof(bindBoneName));
-
-						model->animationClips.at(animationClipIndex).spheres.at(index).bindBoneName = bindBoneName.c_str();
+						// ノード番号は名前を書き換えた時だけ引き直す
+						if (ImGui::InputText(u8"BONE名前", (char*)bindBoneName.c_str(), sizeof(bindBoneName)))
+						{
+							model->animationClips.at(animationClipIndex).spheres.at(index).bindBoneName = bindBoneName.c_str();
+							model->animationClips.at(animationClipIndex).spheres.at(index).bindNodeIndex = model->FindNodeIndex(bindBoneName.c_str());
+						}
 					}
 
 					// --- Effect ---
@@ -1091,7 +1112,12 @@ void SceneAnimation::DrawDebugGUI()
 					{
 						int index = mySequence.myItems.at(mySequence.selectItemNum).mTypeIndex;
 
-						// 値のセット
+						// 値のセット (フレームが動いたらイベントトラックを作り直す)
+						if (model->animationClips.at(animationClipIndex).animEffects.at(index).startFrame != selectStartFrame ||
+							model->animationClips.at(animationClipIndex).animEffects.at(index).endFrame != selectEndFrame)
+						{
+							eventTracksDirty = true;
+						}
 						model->animationClips.at(animationClipIndex).animEffects.at(index).name = selectName.c_str();
 						model->animationClips.at(animationClipIndex).animEffects.at(index).startFrame = selectStartFrame;
 						model->animationClips.at(animationClipIndex).animEffects.at(index).endFrame = selectEndFrame;
@@ -1131,7 +1157,12 @@ void SceneAnimation::DrawDebugGUI()
 					{
 						int index = mySequence.myItems.at(mySequence.selectItemNum).mTypeIndex;
 
-						// 値のセット
+						// 値のセット (フレームが動いたらイベントトラックを作り直す)
+						if (model->animationClips.at(animationClipIndex).animSEs.at(index).startFrame != selectStartFrame ||
+							model->animationClips.at(animationClipIndex).animSEs.at(index).endFrame != selectEndFrame)
+						{
+							eventTracksDirty = true;
+						}
 						model->animationClips.at(animationClipIndex).animSEs.at(index).name = selectName.c_str();
 						model->animationClips.at(animationClipIndex).animSEs.at(index).startFrame = selectStartFrame;
 						model->animationClips.at(animationClipIndex).animSEs.at(index).endFrame = selectEndFrame;
@@ -1458,6 +1489,7 @@ void SceneAnimation::ModelClear()
 	animationClipIndex = 0;
 	currentFrameInt = 0;
 	currentFrameFloat = 0.0f;
+	eventTracksDirty = true;
 
 	isLoop = false;
 	isPlay = false;
@@ -1468,23 +1500,13 @@ void SceneAnimation::ModelClear()
 // エフェクトフラグクリア
 void SceneAnimation::ClearEffectFlag()
 {
-	int effectCount = model->animationClips.at(animationClipIndex).animEffects.size();
-
-	for (int i = 0; i < effectCount; i++)
-	{
-		model->animationClips.at(animationClipIndex).animEffects.at(i).isPlay = false;
-	}
+	effectCursor.Reset();
 }
 
 // 効果音フラグクリア
 void SceneAnimation::ClearSEFlag()
 {
-	int seCount = model->animationClips.at(animationClipIndex).animSEs.size();
-
-	for (int i = 0; i < seCount; i++)
-	{
-		model->animationClips.at(animationClipIndex).animSEs.at(i).isPlay = false;
-	}
+	seCursor.Reset();
 }
 
 
@@ -277,6 +277,8 @@ private:
 
 	// 現在選択中のアニメーション番号
 	int animationClipIndex = 0;
+	// イベントトラックを作り直すか (アイテムの追加・削除・移動、アニメーションの切り替えで立てる)
+	bool eventTracksDirty = true;
 	// 現在のフレーム(int)
 	int currentFrameInt = 0;
 	// 現在のフレーム(float)
@@ -289,6 +291,10 @@ private:
 	// 再生速度スケール
 	float timeScale = 1.0f;
 
+	// アニメーションイベントの再生位置
+	AnimationEventCursor effectCursor;
+	AnimationEventCursor seCursor;
+
 	// let's create the sequencer
 	int selectedEntry = -1;
 	int firstFrame = 0;
@@ -8,7 +8,10 @@
 #include "Library/Timer.h"
 #include "Library/MemoryLeak.h"
 #include "Library/Effekseer/EffectManager.h"
+#include "Library/Graphics/RenderQueue.h"
+#include "Library/Graphics/D3D11RenderBackend.h"
 #include "Library/3D/LineRenderer.h"
+#include "Library/2D/Renderer2D.h"
 
 #include "PlayerManager.h"
 #include "EnemyManager.h"
@@ -23,6 +26,14 @@
 #include "LightManager.h"
 
 
+// 使うモデル・テクスチャの一覧
+void SceneContextBase::DeclareAssets(AssetManifest& manifest) const
+{
+	manifest.AddModel("Data/Fbx/Chara/character.fbx");
+	manifest.AddModel("Data/Fbx/Slime/Slime.fbx");
+	manifest.AddStaticModel("Data/Fbx/MyStage/MyStage.fbx");
+}
+
 // 初期化
 void SceneContextBase::Initialize()
 {
@@ -88,6 +99,9 @@ void SceneContextBase::Update()
 	Camera::Instance().SetTarget(target);
 	Camera::Instance().Update();
 
+	// アニメーション LOD の集計をクリア
+	Character::ResetAnimationLodCounts();
+
 	PlayerManager::Instance().Update();
 
 	EnemyManager::Instance().Update();
@@ -114,20 +128,28 @@ void SceneContextBase::Render()
 	Graphics::SceneConstants data{};
 	XMMATRIX viewProjection = XMLoadFloat4x4(&Camera::Instance().GetView()) * XMLoadFloat4x4(&Camera::Instance().GetProjection());
 	DirectX::XMStoreFloat4x4(&data.viewProjection, viewProjection);	// ビュー　プロジェクション　変換行列をまとめる
-	LightManager::Instance().PushLightData(data);
+	LightManager::Instance().PushLightData(data, Camera::Instance().GetView(), Camera::Instance().GetProjection());
 	data.cameraPosition = { Camera::Instance().GetEye().x, Camera::Instance().GetEye().y, Camera::Instance().GetEye().z, 0 };
 
-	gfx.deviceContext->UpdateSubresource(gfx.constantBuffer.Get(), 0, 0, &data, 0, 0);
-	gfx.deviceContext->VSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
-	gfx.deviceContext->PSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
+	gfx.stateCache.UpdateSubresource(gfx.constantBuffer.Get(), 0, 0, &data, 0, 0);
+	gfx.stateCache.VSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
+	gfx.stateCache.PSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
 
 
+	// --- モデルはキューに積んで、ステートごとに並べ替えてから描く ---
+	RenderQueue& renderQueue = RenderQueue::Instance();
+	renderQueue.Begin(Camera::Instance().GetEye().x, Camera::Instance().GetEye().y, Camera::Instance().GetEye().z);
+
 	StageManager::Instance().Render();
 
 	PlayerManager::Instance().Render();
 
 	EnemyManager::Instance().Render();
 
+	renderQueue.End();
+	renderQueue.Sort();
+	renderQueue.Submit(D3D11RenderBackend::Instance());
+
 	//--- < ラスタライザのバインド > ---
 	gfx.SetRasterizer(RASTERIZER_STATE::CLOCK_FALSE_CULL_NONE);
 
@@ -138,6 +160,9 @@ void SceneContextBase::Render()
 
 	DamageTextManager::Instance().Render();
 
+	// HP ゲージとダメージを 1 レイヤーとして描く
+	Renderer2D::Instance().Flush();
+
 	// camear デバッグ
 	if (Camera::Instance().drawFocusSphere)
 	{
@@ -338,7 +363,7 @@ void SceneContextBase::RenderEnemyGauge()
 	// ビューポート
 	D3D11_VIEWPORT viewport;
 	UINT numViewports = 1;
-	gfx.deviceContext->RSGetViewports(&numViewports, &viewport);
+	gfx.stateCache.RSGetViewports(&numViewports, &viewport);
 
 	// 変換行列
 	DirectX::XMMATRIX View = DirectX::XMLoadFloat4x4(&Camera::Instance().GetView());
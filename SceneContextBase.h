@@ -20,6 +20,9 @@ public:
 	SceneContextBase() {}
 	~SceneContextBase() override {};
 
+	// 使うモデル・テクスチャの一覧
+	void DeclareAssets(AssetManifest& manifest) const override;
+
 	// 初期化
 	void Initialize() override;
 
@@ -1,4 +1,5 @@
 #include <tchar.h>
+#include <algorithm>
 #include "SceneGame.h"
 #include "Library/Framework.h"
 #include "Library/ImGui/Include/imgui.h"
@@ -8,6 +9,15 @@
 #include "Library/Timer.h"
 #include "Library/MemoryLeak.h"
 #include "Library/Effekseer/EffectManager.h"
+#include "Library/Effekseer/Effect.h"
+#include "Library/Audio/AudioManager.h"
+#include "Library/Input/InputRecorder.h"
+#include "Library/AsyncLoader.h"
+#include "Library/MemoryTracker.h"
+#include "Library/FrameArena.h"
+#include "Library/3D/ResourceManager.h"
+#include "Library/Graphics/RenderQueue.h"
+#include "Library/Graphics/D3D11RenderBackend.h"
 
 #include "PlayerManager.h"
 #include "EnemyManager.h"
@@ -20,11 +30,37 @@
 #include "LightManager.h"
 #include "Library/3D/DebugPrimitive.h"
 #include "Library/3D/LineRenderer.h"
+#include "Library/2D/Renderer2D.h"
 
 CONST LONG SHADOWMAP_WIDTH{ 1024 };
 CONST LONG SHADOWMAP_HEIGHT{ 1024 };
 CONST float SHADOWMAP_DRAWRECT{ 30 };
 
+// 使うモデル・テクスチャの一覧
+void SceneGame::DeclareAssets(AssetManifest& manifest) const
+{
+	manifest = MakeManifest();
+}
+
+// 一覧の作成
+AssetManifest SceneGame::MakeManifest()
+{
+	AssetManifest manifest;
+
+	// Initialize で作るキャラクター・ステージのモデル
+	manifest.AddModel("Data/Fbx/Chara/character.fbx");
+	manifest.AddModel("Data/Fbx/Jummo/Jummo.fbx");
+	manifest.AddModel("Data/Fbx/Albino/Albino.fbx");
+	manifest.AddStaticModel("Data/Fbx/ExampleStage/ExampleStage.fbx", true);
+
+	// テクスチャ (一番重いスカイマップを先に積む)
+	manifest.AddTexture(L"Data/Texture/kloppenheim_05_puresky_4k.hdr");
+	manifest.AddTexture(L"Data/Texture/Title.png");
+	manifest.AddTexture(L"Data/Texture/Nessie.png");
+
+	return manifest;
+}
+
 // 初期化
 void SceneGame::Initialize()
 {
@@ -37,6 +73,11 @@ void SceneGame::Initialize()
 	primitive2d = new_ Primitive2D();
 	sprite = new_ Sprite(L"Data/Texture/Title.png");
 	graphicsSpriteBatch = new_ GraphicsSpriteBatch(L"Data/Texture/Nessie.png", 2048);
+	instancedSpriteBatch = new_ InstancedSpriteBatch(4096);
+	{
+		const wchar_t* filenames[] = { L"Data/Texture/Nessie.png" };
+		spriteTextureArray.Load(filenames, _countof(filenames));
+	}
 	sprite3D = new_ Sprite3D(L"Data/Texture/Nessie.png");
 
 	Player* player = new_ Player();
@@ -109,6 +150,7 @@ void SceneGame::Finalize()
 	delete primitive2d;
 	delete sprite;
 	delete graphicsSpriteBatch;
+	delete instancedSpriteBatch;
 	delete sprite3D;
 
 	PlayerManager::Instance().Clear();
@@ -132,6 +174,9 @@ void SceneGame::Update()
 	Camera::Instance().SetTarget(target);
 	Camera::Instance().Update();
 
+	// アニメーション LOD の集計をクリア
+	Character::ResetAnimationLodCounts();
+
 	PlayerManager::Instance().Update();
 
 	EnemyManager::Instance().Update();
@@ -200,33 +245,60 @@ void SceneGame::Render()
 		{
 			float x = 0;
 			float y = 0;
-			graphicsSpriteBatch->begin();
-			for (size_t i = 0; i < batchCount; i++)
+			if (useInstancedSpriteBatch)
 			{
-				graphicsSpriteBatch->render(x, static_cast<float>(static_cast<int>(y) % 720), 64, 64, 1, 1, 1, 1, 0, 270 * 0, 270 * 0, 270, 270);
-				x += 32;
-				if (x > 1280 - 64)
+				instancedSpriteBatch->Begin();
+				for (int i = 0; i < batchCount; i++)
 				{
-					x = 0;
-					y += 24;
+					instancedSpriteBatch->Draw(spriteTextureArray, x, static_cast<float>(static_cast<int>(y) % 720), 64, 64, 1, 1, 1, 1, 0, 0, 0, 270, 270);
+					x += 32;
+					if (x > 1280 - 64)
+					{
+						x = 0;
+						y += 24;
+					}
 				}
+				instancedSpriteBatch->End();
+			}
+			else
+			{
+				// 頂点バッファの大きさ (2048 枚) までしか描けない
+				const int count = (std::min)(batchCount, 2048);
+				graphicsSpriteBatch->begin();
+				for (int i = 0; i < count; i++)
+				{
+					graphicsSpriteBatch->render(x, static_cast<float>(static_cast<int>(y) % 720), 64, 64, 1, 1, 1, 1, 0, 270 * 0, 270 * 0, 270, 270);
+					x += 32;
+					if (x > 1280 - 64)
+					{
+						x = 0;
+						y += 24;
+					}
+				}
+				graphicsSpriteBatch->end();
 			}
-			graphicsSpriteBatch->end();
 		}
 	}
 
+	// 3D より先に描く 2D をここで描く
+	Renderer2D::Instance().Flush();
+
 
 
 	Graphics::SceneConstants data{};
 	XMMATRIX viewProjection = XMLoadFloat4x4(&Camera::Instance().GetView()) * XMLoadFloat4x4(&Camera::Instance().GetProjection());
 	DirectX::XMStoreFloat4x4(&data.viewProjection, viewProjection);	// ビュー　プロジェクション　変換行列をまとめる
 	
-	LightManager::Instance().PushLightData(data);
+	LightManager::Instance().PushLightData(data, Camera::Instance().GetView(), Camera::Instance().GetProjection());
 
 	data.cameraPosition = { Camera::Instance().GetEye().x, Camera::Instance().GetEye().y, Camera::Instance().GetEye().z, 0};
-	gfx.deviceContext->UpdateSubresource(gfx.constantBuffer.Get(), 0, 0, &data, 0, 0);
-	gfx.deviceContext->VSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
-	gfx.deviceContext->PSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
+	gfx.stateCache.UpdateSubresource(gfx.constantBuffer.Get(), 0, 0, &data, 0, 0);
+	gfx.stateCache.VSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
+	gfx.stateCache.PSSetConstantBuffers(1, 1, gfx.constantBuffer.GetAddressOf());
+
+	// --- モデルはキューに積んで、ステートごとに並べ替えてから描く ---
+	RenderQueue& renderQueue = RenderQueue::Instance();
+	renderQueue.Begin(Camera::Instance().GetEye().x, Camera::Instance().GetEye().y, Camera::Instance().GetEye().z);
 
 	StageManager::Instance().Render();
 
@@ -234,6 +306,10 @@ void SceneGame::Render()
 
 	EnemyManager::Instance().Render();
 
+	renderQueue.End();
+	renderQueue.Sort();
+	renderQueue.Submit(D3D11RenderBackend::Instance());
+
 
 	
 
@@ -284,6 +360,9 @@ void SceneGame::Render()
 	// --- テキスト描画 ---
 	DispString::Instance().Draw(L"HOSHIN LIB", { 800, 60 }, 48, TEXT_ALIGN::MIDDLE, { 0, 0, 0, 1 });
 
+	// HP ゲージ・ダメージ・テキストを 1 レイヤーとして描く
+	Renderer2D::Instance().Flush();
+
 	// --- デバッグ描画 ---
 	DebugPrimitive::Instance().Render();
 	LineRenderer::Instance().Render();
@@ -296,8 +375,8 @@ void SceneGame::Render()
 
 #if 1
 	// --- 高輝度抽出 ---
-	gfx.deviceContext->UpdateSubresource(gfx.constantBuffers[4].Get(), 0, 0, &gfx.luminanceExtractionConstant, 0, 0);
-	gfx.deviceContext->PSSetConstantBuffers(0, 1, gfx.constantBuffers[4].GetAddressOf());
+	gfx.stateCache.UpdateSubresource(gfx.constantBuffers[4].Get(), 0, 0, &gfx.luminanceExtractionConstant, 0, 0);
+	gfx.stateCache.PSSetConstantBuffers(0, 1, gfx.constantBuffers[4].GetAddressOf());
 	gfx.frameBuffers[1]->Activate();
 	gfx.bitBlockTransfer->blit(gfx.frameBuffers[0]->shaderResourceViews[0].GetAddressOf(), 0, 2, gfx.pixelShaders[static_cast<size_t>(PS_TYPE::LuminanceExtraction_PS)].Get());
 	gfx.frameBuffers[1]->DeActivate();
@@ -305,8 +384,8 @@ void SceneGame::Render()
 
 	// --- ガウシアンフィルタ ---
 	gfx.CalcWeightsTableFromGaussian(gaussianPower);
-	gfx.deviceContext->UpdateSubresource(gfx.constantBuffers[3].Get(), 0, 0, &gfx.gaussianConstant, 0, 0);
-	gfx.deviceContext->PSSetConstantBuffers(0, 1, gfx.constantBuffers[3].GetAddressOf());
+	gfx.stateCache.UpdateSubresource(gfx.constantBuffers[3].Get(), 0, 0, &gfx.gaussianConstant, 0, 0);
+	gfx.stateCache.PSSetConstantBuffers(0, 1, gfx.constantBuffers[3].GetAddressOf());
 
 	gfx.frameBuffers[2]->Activate();
 	gfx.bitBlockTransfer->blit(gfx.frameBuffers[1]->shaderResourceViews[0].GetAddressOf(), 0, 1, gfx.pixelShaders[static_cast<size_t>(PS_TYPE::GaussianBlur_PS)].Get(), gfx.vertexShaders[static_cast<size_t>(VS_TYPE::GaussianBlurX_VS)].Get());
@@ -327,8 +406,8 @@ void SceneGame::Render()
 	gfx.frameBuffers[4]->DeActivate();
 
 	// --- カラーフィルター ---
-	gfx.deviceContext->UpdateSubresource(gfx.constantBuffers[2].Get(), 0, 0, &gfx.colorFilterConstant, 0, 0);
-	gfx.deviceContext->PSSetConstantBuffers(3, 1, gfx.constantBuffers[2].GetAddressOf());
+	gfx.stateCache.UpdateSubresource(gfx.constantBuffers[2].Get(), 0, 0, &gfx.colorFilterConstant, 0, 0);
+	gfx.stateCache.PSSetConstantBuffers(3, 1, gfx.constantBuffers[2].GetAddressOf());
 	
 	gfx.frameBuffers[5]->Activate();
 	gfx.bitBlockTransfer->blit(gfx.frameBuffers[4]->shaderResourceViews[0].GetAddressOf(), 0, 1, gfx.pixelShaders[static_cast<size_t>(PS_TYPE::ColorFilter_PS)].Get());
@@ -443,6 +522,144 @@ void SceneGame::DrawDebugGUI()
 				ImGui::Checkbox("Draw", &drawGraphicsSpriteBatch);
 				// 描画数
 				ImGui::InputInt("Count", &batchCount);
+				batchCount = (std::clamp)(batchCount, 0, 100000);
+				// インスタンス描画
+				ImGui::Checkbox("Instanced", &useInstancedSpriteBatch);
+				if (useInstancedSpriteBatch)
+				{
+					const InstancedSpriteBatch::Statistics& statistics = instancedSpriteBatch->GetStatistics();
+					ImGui::Text("Sprites : %u", statistics.spriteCount);
+					ImGui::Text("DrawCalls : %u", statistics.drawCalls);
+					ImGui::Text("Flush : %u", statistics.flushCount);
+					ImGui::Text("Capacity : %u", statistics.capacity);
+				}
+			}
+		}
+		// --- Renderer2D ---
+		{
+			if (ImGui::CollapsingHeader("Renderer2D", ImGuiTreeNodeFlags_None))
+			{
+				Renderer2D& renderer2D = Renderer2D::Instance();
+				const Renderer2D::Statistics& statistics = renderer2D.GetStatistics();
+				ImGui::Checkbox("Sort In Layer", &renderer2D.sortInLayer);
+				ImGui::Text("Commands : %u", statistics.commandCount);
+				ImGui::Text("DrawCalls : %u", statistics.drawCalls);
+				ImGui::Text("Layers : %u", statistics.layerCount);
+			}
+		}
+		// --- DamageText ---
+		{
+			DamageTextManager::Instance().DrawDebugGui();
+		}
+		// --- Effect ---
+		{
+			Effect::Instance().DrawDebugGui();
+		}
+		// --- Audio ---
+		{
+			AudioManager::Instance().DrawDebugGui();
+		}
+		// --- Replay ---
+		{
+			if (ImGui::CollapsingHeader("Replay", ImGuiTreeNodeFlags_None))
+			{
+				// 記録・再生はどちらもシーンを作り直してから始める (同じ状態から始めるため)
+				InputRecorder& inputRecorder = InputRecorder::Instance();
+				switch (inputRecorder.GetMode())
+				{
+				case InputRecorder::MODE::NONE:
+					if (ImGui::Button("Record"))
+					{
+						inputRecorder.StartRecording();
+						SceneManager::Instance().ChangeScene(new SceneGame);
+					}
+					ImGui::SameLine();
+					if (ImGui::Button("Replay"))
+					{
+						if (inputRecorder.StartReplay(L"Replay.bin"))
+						{
+							SceneManager::Instance().ChangeScene(new SceneGame);
+						}
+					}
+					break;
+				case InputRecorder::MODE::RECORD:
+					if (ImGui::Button("Stop"))
+					{
+						inputRecorder.StopRecording(L"Replay.bin");
+					}
+					ImGui::SameLine();
+					ImGui::Text("Recording : %u frames, %zu bytes", inputRecorder.GetFrameCount(), inputRecorder.GetRecordedBytes());
+					break;
+				case InputRecorder::MODE::REPLAY:
+					if (ImGui::Button("Stop"))
+					{
+						inputRecorder.StopReplay();
+					}
+					ImGui::SameLine();
+					ImGui::Text("Replaying : %u / %u", inputRecorder.GetFrame(), inputRecorder.GetFrameCount());
+					break;
+				}
+				ImGui::DragFloat("Fixed Delta Time", &inputRecorder.fixedDeltaTime, 0.001f, 0.0f, 0.1f);
+
+				const InputRecorder::BenchmarkResult& result = inputRecorder.GetLastResult();
+				ImGui::Text("Frames : %u (%.3f s)", result.frameCount, result.totalSeconds);
+				ImGui::Text("Avg : %.3f ms  Min : %.3f ms  Max : %.3f ms", result.averageMs, result.minMs, result.maxMs);
+				ImGui::Text("P50 : %.3f ms  P95 : %.3f ms  P99 : %.3f ms", result.p50Ms, result.p95Ms, result.p99Ms);
+			}
+		}
+		// --- RenderQueue ---
+		{
+			if (ImGui::CollapsingHeader("RenderQueue", ImGuiTreeNodeFlags_None))
+			{
+				const RenderQueue::Statistics& statistics = RenderQueue::Instance().GetStatistics();
+				ImGui::Text("Packets : %u  DrawCalls : %u", statistics.packetCount, statistics.drawCalls);
+				ImGui::Text("Pipeline : %u  RenderState : %u", statistics.pipelineBinds, statistics.renderStateBinds);
+				ImGui::Text("Material : %u  TextureSet : %u", statistics.materialBinds, statistics.textureSetBinds);
+				ImGui::Text("Geometry : %u  Constants : %u (%u bytes)", statistics.geometryBinds, statistics.constantUpdates, statistics.constantBytes);
+			}
+		}
+		// --- AsyncLoader ---
+		{
+			AsyncLoader::Instance().DrawDebugGui();
+			ResourceManager::Instance().DrawDebugGui();
+		}
+
+		// --- MemoryTracker ---
+		{
+			MemoryTracker::Instance().DrawDebugGui();
+			FrameArena::Instance().DrawDebugGui();
+		}
+		// --- StateCache ---
+		{
+			if (ImGui::CollapsingHeader("StateCache", ImGuiTreeNodeFlags_None))
+			{
+				ImGui::Checkbox("Enable", &gfx->stateCache.enable);
+				const StateCache::Statistics& statistics = gfx->stateCache.GetStatistics();
+				ImGui::Text("Requested : %u  Issued : %u", statistics.requestedCalls, statistics.issuedCalls);
+				ImGui::Text("Filtered : %u  CoalescedSRV : %u", statistics.GetFilteredCalls(), statistics.coalescedSlots);
+
+				// RecordingRenderDevice を差し込んで流した呼び出しを数える
+				bool recording = gfx->IsRecording();
+				bool headless = gfx->IsHeadless();
+				if (ImGui::Checkbox("Record", &recording)) gfx->SetRecording(recording, headless);
+				ImGui::SameLine();
+				if (ImGui::Checkbox("Headless", &headless)) gfx->SetRecording(recording || headless, headless);
+				if (recording)
+				{
+					const RecordingRenderDevice::Statistics& recorded = gfx->recordingRenderDevice.GetLastStatistics();
+					ImGui::Text("Draws : %u  Vertices : %llu", recorded.drawCalls, recorded.primitiveVertices);
+					ImGui::Text("StateChanges : %u  Clears : %u", recorded.stateChanges, recorded.clears);
+					ImGui::Text("Uploads : %u  Bytes : %llu", recorded.uploads, recorded.uploadedBytes);
+				}
+			}
+		}
+		// --- ConstantRingBuffer ---
+		{
+			if (ImGui::CollapsingHeader("ConstantRingBuffer", ImGuiTreeNodeFlags_None))
+			{
+				const ConstantRingBuffer::Statistics& statistics = gfx->constantRingBuffer.GetStatistics();
+				ImGui::Text("Uploads : %u  Bytes : %u / %u", statistics.uploadCount, statistics.uploadedBytes, gfx->constantRingBuffer.GetCapacity());
+				ImGui::Text("Wraps : %u", statistics.wrapCount);
 			}
 		}
 	}
@@ -480,7 +697,7 @@ void SceneGame::RenderEnemyGauge()
 	// ビューポート
 	D3D11_VIEWPORT viewport;
 	UINT numViewports = 1;
-	gfx.deviceContext->RSGetViewports(&numViewports, &viewport);
+	gfx.stateCache.RSGetViewports(&numViewports, &viewport);
 
 	// 変換行列
 	DirectX::XMMATRIX View = DirectX::XMLoadFloat4x4(&Camera::Instance().GetView());
@@ -3,7 +3,8 @@
 #include "Library/Graphics/Graphics.h"
 #include "Library/2D/Primitive2D.h"
 #include "Library/2D/Sprite.h"
-#include "Library/2D/GraphicsSpriteBatch.h"	
+#include "Library/2D/GraphicsSpriteBatch.h"
+#include "Library/2D/InstancedSpriteBatch.h"	
 #include "Library/3D/GeometricPrimitive.h"
 #include "Library/3D/SpherePrimitive.h"
 #include "Library/3D/CylinderPrimitive.h"
@@ -20,6 +21,11 @@ public:
 	SceneGame() {}
 	~SceneGame() override {};
 
+	// 使うモデル・テクスチャの一覧
+	void DeclareAssets(AssetManifest& manifest) const override;
+	// 一覧の作成 (他のシーンが先読みに使う)
+	static AssetManifest MakeManifest();
+
 	// 初期化
 	void Initialize() override;
 
@@ -71,6 +77,10 @@ private:
 	GraphicsSpriteBatch* graphicsSpriteBatch = nullptr;
 	bool drawGraphicsSpriteBatch = false;
 	int batchCount = 195;
+	// 描画数を増やしても 1 回の描画で済むインスタンス版
+	InstancedSpriteBatch* instancedSpriteBatch = nullptr;
+	InstancedSpriteBatch::TextureArray spriteTextureArray;
+	bool useInstancedSpriteBatch = true;
 
 	// View
 	DirectX::XMFLOAT4 viewEye = { 0,0,-10,0 };
@@ -1,11 +1,14 @@
+#include <algorithm>
 #include "SceneLoading.h"
 #include "SceneManager.h"
 #include "Library/Input/InputManager.h"
 #include "Library/Timer.h"
+#include "Library/AsyncLoader.h"
 
 void SceneLoading::Initialize()
 {
 	sprite = new Sprite(L"Data/Texture/LoadingIcon.png");
+	gauge = new Primitive2D();
 
 	// スレッド開始
 	thread = new std::thread(LoadingThread, this);
@@ -14,17 +17,31 @@ void SceneLoading::Initialize()
 void SceneLoading::Finalize()
 {
 	delete sprite;
+	delete gauge;
 	if (thread->joinable()) {
 		thread->join();
 	}
 	delete thread;
 }
 
+// 次のシーンの一覧
+void SceneLoading::DeclareAssets(AssetManifest& manifest) const
+{
+	manifest.AddTexture(L"Data/Texture/LoadingIcon.png");
+	nextScene->DeclareAssets(manifest);
+}
+
 void SceneLoading::Update()
 {
 	constexpr float speed = 180;
 	angle += speed * Timer::Instance().DeltaTime();
 
+	// 先読みの進捗 (初期化が終わるまでは 95% で止めておく)
+	float target = AsyncLoader::Instance().GetProgress() * 0.95f;
+	if (nextScene->IsReady()) target = 1.0f;
+	constexpr float gaugeSpeed = 2.0f;
+	progress = (std::min)(target, progress + gaugeSpeed * Timer::Instance().DeltaTime());
+
 	// 次のシーンの準備ができたらシーンを切り替える
 	if(nextScene->IsReady())
 	{
@@ -35,6 +52,14 @@ void SceneLoading::Update()
 void SceneLoading::Render()
 {
 	sprite->Render(0, 0, 256, 256, 1, 1, 1, 1, angle);
+
+	// 進捗ゲージ
+	constexpr float gaugeX = 40.0f;
+	constexpr float gaugeY = 680.0f;
+	constexpr float gaugeWidth = 1200.0f;
+	constexpr float gaugeHeight = 8.0f;
+	gauge->Render(gaugeX, gaugeY, gaugeWidth, gaugeHeight, 0.2f, 0.2f, 0.2f, 1, 0);
+	gauge->Render(gaugeX, gaugeY, gaugeWidth * progress, gaugeHeight, 1, 1, 1, 1, 0);
 }
 
 // ローディングスレッド
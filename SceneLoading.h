@@ -2,14 +2,21 @@
 #include <thread>
 #include "Scene.h"
 #include "Library/2D/Sprite.h"
+#include "Library/2D/Primitive2D.h"
 
-// タイトルシーン
+// ローディングシーン
+// 次のシーンの AssetManifest を自分の一覧として返すので、切り替え時に AsyncLoader で読み込みが始まる
+// 次のシーンの初期化は別スレッドで行う
+// GPU リソースの作成はメインスレッドで 1 フレームの予算内に分けて行うので、アイコンの回転は止まらない
 class SceneLoading : public Scene
 {
 public:
 	SceneLoading(Scene* nextScene) : nextScene(nextScene){}
 	~SceneLoading() override {};
 
+	// 次のシーンの一覧 (ローディング中に読み込ませる)
+	void DeclareAssets(AssetManifest& manifest) const override;
+
 	// 初期化
 	void Initialize() override;
 
@@ -31,6 +38,9 @@ private:
 	std::thread* thread = nullptr;
 
 	Sprite* sprite = nullptr;
+	Primitive2D* gauge = nullptr;
 	float angle = 0.0f;
 
+	// 表示する進捗 (実際の進捗に向かって滑らかに伸ばす)
+	float progress = 0.0f;
 };
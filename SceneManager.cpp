@@ -1,10 +1,19 @@
 #include "SceneManager.h"
+#include "Library/AsyncLoader.h"
+#include "Library/3D/ResourceManager.h"
 
 // 更新処理
 void SceneManager::Update()
 {
 	if (nextScene != nullptr)
 	{
+		// 新しいシーンのアセットを常駐させる
+		// (古いシーンを消す前に行うので、共通のモデルは解放されずに残る)
+		AssetManifest manifest;
+		nextScene->DeclareAssets(manifest);
+		AsyncLoader::Instance().BeginBatch();
+		ResourceManager::Instance().SetResident(manifest);
+
 		// 古いシーンを終了処理
 		Clear();
 
@@ -48,6 +57,12 @@ void SceneManager::Clear()
 // シーン切り替え
 void SceneManager::ChangeScene(Scene* scene)
 {
+	// まだ切り替わっていないシーンがあれば捨てる
+	if (nextScene != nullptr && nextScene != scene)
+	{
+		delete nextScene;
+	}
+
 	// 新しいシーンを設定
 	nextScene = scene;
 }
@@ -7,6 +7,16 @@
 #include "Library/Text/Text.h"
 #include "Library/Timer.h"
 
+// 使うモデル・テクスチャの一覧
+void SceneTitle::DeclareAssets(AssetManifest& manifest) const
+{
+	manifest.AddTexture(L"Data/Texture/Title.png");
+	manifest.AddTexture(L"Data/Texture/dissolve.png");
+
+	// 次に来るゲームシーンのアセットをタイトル中に読んでおく
+	manifest.AddPrefetch(SceneGame::MakeManifest());
+}
+
 void SceneTitle::Initialize()
 {
 	sprite = new Sprite(L"Data/Texture/Title.png");
@@ -13,6 +13,9 @@ public:
 	SceneTitle() {}
 	~SceneTitle() override {};
 
+	// 使うモデル・テクスチャの一覧
+	void DeclareAssets(AssetManifest& manifest) const override;
+
 	// 初期化
 	void Initialize() override;
 
@@ -2,6 +2,8 @@
 
 #include "Collision.h"
 
+class OcclusionCuller;
+
 // ステージ
 class Stage
 {
@@ -17,4 +19,10 @@ public:
 
 	// レイキャスト
 	virtual bool RayCast(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, HitResult& hit) = 0;
+
+	// 視錐台カリング用のワールド空間 AABB 取得 (false なら常に描画する)
+	virtual bool GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const { return false; }
+
+	// 遮蔽物の登録 (動かない大きな面を持つステージだけ実装する)
+	virtual void CollectOccluders(OcclusionCuller& culler) const {}
 };
\ No newline at end of file
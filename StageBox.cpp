@@ -42,6 +42,12 @@ bool StageBox::RayCast(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3&
 	return Collision::IntersectRayVsModel(start, end, model, transform, hit);
 }
 
+// 視錐台カリング用のワールド空間 AABB 取得
+bool StageBox::GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const
+{
+	return model->GetWorldBounds(transform, center, extents);
+}
+
 // 行列更新関数
 void StageBox::UpdateTransform()
 {
@@ -19,6 +19,9 @@ public:
 	// レイキャスト
 	bool RayCast(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, HitResult& hit) override;
 
+	// 視錐台カリング用のワールド空間 AABB 取得
+	bool GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const override;
+
 	// 位置取得
 	const DirectX::XMFLOAT3& GetPosition() const { return position; }
 	// 位置設定
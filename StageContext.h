@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include "Library/3D/SkinnedMesh.h"
+#include "Library/3D/StaticMesh.h"
 #include "Stage.h"
 
 // ステージ
@@ -19,7 +20,17 @@ public:
 	// レイキャスト
 	bool RayCast(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, HitResult& hit) override;
 
+	// 視錐台カリング用のワールド空間 AABB 取得
+	bool GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const override;
+
+	// 遮蔽物の登録
+	void CollectOccluders(OcclusionCuller& culler) const override;
+
 private:
-	SkinnedMesh* model = nullptr;
-	SkinnedMesh* collisionModel = nullptr;
+	// ResourceManager の共有モデル (当たり判定などに使う、頂点は StaticMesh に焼き込んだ後に捨てられる)
+	std::shared_ptr<SkinnedMesh> model;
+	// 描画用 (読み込み時にワールド空間へ変換してマテリアルごとにまとめたもの、モデルと共有)
+	std::shared_ptr<StaticMesh> staticMesh;
+	// 簡略化した当たり判定用メッシュ (用意されていなければ model の当たり判定を使う)
+	CollisionMesh* collisionMesh = nullptr;
 };
\ No newline at end of file
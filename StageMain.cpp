@@ -2,23 +2,44 @@
 #include "Library/MemoryLeak.h"
 #include "Library/Graphics/Graphics.h"
 #include "Library/3D/ResourceManager.h"
+#include "Library/3D/OcclusionCuller.h"
 
 
 // コンストラクタ
 StageMain::StageMain()
 {
-	model = new_ SkinnedMesh("Data/Fbx/ExampleStage/ExampleStage.fbx", true);
+	model = ResourceManager::Instance().LoadStaticModelResource("Data/Fbx/ExampleStage/ExampleStage.fbx", true);
 	//model = new_ SkinnedMesh("Data/Fbx/MyStage/MyStage.fbx");
-	//collisionModel = new_ SkinnedMesh("Data/Fbx/MyStageCollision/MyStageCollision.fbx");
 
-	model->isBloomConstants.objectType = 1;
+	// 当たり判定専用のモデルがあればそちらを使う
+	collisionMesh = new_ CollisionMesh();
+	if (!collisionMesh->LoadFromFbx("Data/Fbx/ExampleStageCollision/ExampleStageCollision.fbx"))
+	{
+		delete collisionMesh;
+		collisionMesh = nullptr;
+	}
+
+	// サイズの修正 (ステージは動かないので、ワールド行列は読み込み時に 1 回だけ作って頂点に焼き込む)
+	const float scaleFactor = model->scaleFactors[model->fbxUnit];
+	DirectX::XMMATRIX C = DirectX::XMLoadFloat4x4(&model->coordinateSystemTransform[model->coordinateSystemIndex]) * DirectX::XMMatrixScaling(scaleFactor, scaleFactor, scaleFactor);
+
+	DirectX::XMMATRIX S = DirectX::XMMatrixScaling(1, 1, 1);
+	DirectX::XMMATRIX R = DirectX::XMMatrixRotationRollPitchYaw(0, 0, 0);
+	DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(0, 0, 0);
+
+	DirectX::XMFLOAT4X4 world;
+	DirectX::XMStoreFloat4x4(&world, C * S * R * T);
+
+	// 描画は変換済みの StaticMesh で行う
+	// (焼き込んだものはモデルが持っているので、次にこのステージを作る時はそれを使う)
+	staticMesh = ResourceManager::Instance().LoadStaticMeshResource("Data/Fbx/ExampleStage/ExampleStage.fbx", true, world);
+	staticMesh->objectType = 1;
 }
 
 // デストラクタ
 StageMain::~StageMain()
 {
-	delete model;
-	//delete collisionModel;
+	delete collisionMesh;
 }
 
 // 更新処理
@@ -36,23 +57,29 @@ void StageMain::Render()
 	gfx.SetRasterizer(RASTERIZER_STATE::CLOCK_TRUE_SOLID);
 
 
-	// サイズの修正
-	const float scaleFactor = model->scaleFactors[model->fbxUnit];
-	DirectX::XMMATRIX C = DirectX::XMLoadFloat4x4(&model->coordinateSystemTransform[model->coordinateSystemIndex]) * DirectX::XMMatrixScaling(scaleFactor, scaleFactor, scaleFactor);
-
-	DirectX::XMMATRIX S = DirectX::XMMatrixScaling(1, 1, 1);
-	DirectX::XMMATRIX R = DirectX::XMMatrixRotationRollPitchYaw(0, 0, 0);
-	DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(0, 0, 0);
-
-	DirectX::XMFLOAT4X4 world;
-	DirectX::XMStoreFloat4x4(&world, C * S * R * T);
-
-	model->Render(world, {1, 1, 1, 1 }, 0);
+	staticMesh->Render({ 1, 1, 1, 1 });
 }
 
 // レイキャスト
 bool StageMain::RayCast(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, HitResult& hit)
 {
-	return Collision::IntersectRayVsModel(start, end, model, hit);
-	//return Collision::IntersectRayVsModel(start, end, collisionModel, hit);
+	if (collisionMesh)
+	{
+		return Collision::IntersectRayVsCollisionMesh(start, end, *collisionMesh, hit);
+	}
+	return Collision::IntersectRayVsModel(start, end, model.get(), hit);
+}
+
+// 視錐台カリング用のワールド空間 AABB 取得
+bool StageMain::GetWorldBounds(DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extents) const
+{
+	return staticMesh->GetWorldBounds(center, extents);
+}
+
+// 遮蔽物の登録
+void StageMain::CollectOccluders(OcclusionCuller& culler) const
+{
+	// 焼き込み済みの当たり判定メッシュを遮蔽物に使う (簡略化したものがあればそちら)
+	const CollisionMesh& occluder = collisionMesh ? *collisionMesh : model->collisionMesh;
+	culler.AddOccluder(occluder, occluder.systemTransform);
 }
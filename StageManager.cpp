@@ -1,4 +1,7 @@
 #include "StageManager.h"
+#include "Library/3D/Camera.h"
+#include "Library/3D/OcclusionCuller.h"
+#include "Library/MemoryTracker.h"
 
 // 更新処理
 void StageManager::Update()
@@ -12,9 +15,32 @@ void StageManager::Update()
 // 描画処理
 void StageManager::Render()
 {
+	Camera& camera = Camera::Instance();
+
+	// 遮蔽物の深度を描いておく (この後に描くプレイヤー・敵・弾丸の遮蔽判定に使う)
+	OcclusionCuller::Instance().Update(camera.GetView(), camera.GetProjection());
+
+	// 視錐台カリング (ステージは遮蔽物そのものなので遮蔽判定はしない)
+	cullingBatch.Clear();
 	for (Stage* stage : stages)
 	{
-		stage->Render();
+		DirectX::XMFLOAT3 center, extents;
+		if (stage->GetWorldBounds(center, extents))
+		{
+			cullingBatch.Add(center, extents);
+		}
+		else
+		{
+			cullingBatch.AddAlwaysVisible();
+		}
+	}
+	camera.Cull(cullingBatch);
+
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		if (!cullingBatch.IsVisible(i)) continue;
+
+		stages[i]->Render();
 	}
 }
 
@@ -22,17 +48,24 @@ void StageManager::Render()
 void StageManager::Register(Stage* stage)
 {
 	stages.emplace_back(stage);
+
+	// 遮蔽物の登録
+	stage->CollectOccluders(OcclusionCuller::Instance());
 }
 
 // ステージ全削除
 void StageManager::Clear()
 {
 	stages.clear();
+
+	OcclusionCuller::Instance().ClearOccluders();
 }
 
 // レイキャスト
 bool StageManager::RayCast(const DirectX::XMFLOAT3& start, const DirectX::XMFLOAT3& end, HitResult& hit)
 {
+	MemoryTracker::TagScope memoryTag(MemoryTracker::TAG::COLLISION);
+
 	bool result = false;
 
 	hit.distance = FLT_MAX;
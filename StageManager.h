@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "Stage.h"
+#include "Library/3D/Frustum.h"
 
 // ステージマネージャー
 class StageManager
@@ -36,4 +37,7 @@ public:
 
 private:
 	std::vector<Stage*> stages;
+
+	// 視錐台カリング (stages と同じ順番で登録する)
+	FrustumCullingBatch cullingBatch;
 };
\ No newline at end of file
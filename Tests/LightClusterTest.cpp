@@ -0,0 +1,112 @@
+#include <cmath>
+#include "Test.h"
+#include "../Library/Graphics/LightCluster.h"
+
+using namespace DirectX;
+
+namespace
+{
+	// 原点から +z を向いた視点 (左手系、縦 60 度、16:9、0.1 ~ 1000)
+	void MakeCamera(XMFLOAT4X4& view, XMFLOAT4X4& projection)
+	{
+		const float n = 0.1f;
+		const float f = 1000.0f;
+		const float yScale = 1.0f / std::tan(1.0471976f * 0.5f);
+
+		view = {};
+		view._11 = view._22 = view._33 = view._44 = 1.0f;
+
+		projection = {};
+		projection._11 = yScale / (16.0f / 9.0f);
+		projection._22 = yScale;
+		projection._33 = f / (f - n);
+		projection._34 = 1.0f;
+		projection._43 = -n * f / (f - n);
+	}
+
+	LightCluster::PointLightData MakePointLight(float x, float y, float z, float range)
+	{
+		LightCluster::PointLightData light{};
+		light.position = { x, y, z, 1.0f };
+		light.range = range;
+		return light;
+	}
+}
+
+// 点光源は届く位置のクラスターに入り、届かない位置には入らない
+TEST(LightClusterAssignsPointLight)
+{
+	XMFLOAT4X4 view, projection;
+	MakeCamera(view, projection);
+
+	LightCluster cluster;
+	cluster.AddPointLight(MakePointLight(0.0f, 0.0f, 10.0f, 1.0f));
+	cluster.AddPointLight(MakePointLight(5.0f, 0.0f, 30.0f, 2.0f));
+	cluster.Build(view, projection);
+
+	const std::vector<LightCluster::Cluster>& clusters = cluster.GetClusters();
+	const std::vector<uint32_t>& indices = cluster.GetLightIndices();
+
+	const LightCluster::Cluster& first = clusters[cluster.FindCluster({ 0.0f, 0.0f, 10.0f })];
+	CHECK(first.GetPointLightCount() == 1);
+	CHECK(first.GetSpotLightCount() == 0);
+	CHECK(indices[first.offset] == 0);
+
+	const LightCluster::Cluster& second = clusters[cluster.FindCluster({ 5.0f, 0.0f, 30.0f })];
+	CHECK(second.GetPointLightCount() == 1);
+	CHECK(indices[second.offset] == 1);
+
+	const LightCluster::Cluster& empty = clusters[cluster.FindCluster({ 0.0f, 0.0f, 200.0f })];
+	CHECK(empty.GetPointLightCount() == 0);
+
+	CHECK(cluster.GetStatistics().pointLightCount == 2);
+	CHECK(cluster.GetStatistics().occupiedClusterCount > 0);
+}
+
+// スポットライトはコーンの中に入り、点光源の後に並ぶ
+TEST(LightClusterAssignsSpotLightAfterPointLights)
+{
+	XMFLOAT4X4 view, projection;
+	MakeCamera(view, projection);
+
+	LightCluster cluster;
+	cluster.AddPointLight(MakePointLight(0.0f, 0.0f, 25.0f, 1.0f));
+
+	LightCluster::SpotLightData spot{};
+	spot.position = { 0.0f, 0.0f, 20.0f, 1.0f };
+	spot.direction = { 0.0f, 0.0f, 1.0f, 0.0f };
+	spot.range = 10.0f;
+	spot.innerCorn = 0.99f;
+	spot.outerCorn = 0.9f;
+	cluster.AddSpotLight(spot);
+	cluster.Build(view, projection);
+
+	const LightCluster::Cluster& inside = cluster.GetClusters()[cluster.FindCluster({ 0.0f, 0.0f, 25.0f })];
+	CHECK(inside.GetPointLightCount() == 1);
+	CHECK(inside.GetSpotLightCount() == 1);
+	CHECK(cluster.GetLightIndices()[inside.offset] == 0);
+	CHECK(cluster.GetLightIndices()[inside.offset + 1] == 0);
+
+	// 範囲の外
+	const LightCluster::Cluster& outside = cluster.GetClusters()[cluster.FindCluster({ 0.0f, 0.0f, 60.0f })];
+	CHECK(outside.GetSpotLightCount() == 0);
+}
+
+// 1 クラスターに入る数は上限で切られる
+TEST(LightClusterClipsPerClusterLimit)
+{
+	XMFLOAT4X4 view, projection;
+	MakeCamera(view, projection);
+
+	LightCluster cluster;
+	for (int i = 0; i < LightCluster::LightsPerClusterMax + 8; i++)
+	{
+		cluster.AddPointLight(MakePointLight(0.0f, 0.0f, 10.0f, 0.5f));
+	}
+	cluster.Build(view, projection);
+
+	const LightCluster::Cluster& full = cluster.GetClusters()[cluster.FindCluster({ 0.0f, 0.0f, 10.0f })];
+	CHECK(full.GetPointLightCount() == LightCluster::LightsPerClusterMax);
+	CHECK(cluster.GetStatistics().maxLightsPerCluster == LightCluster::LightsPerClusterMax);
+	CHECK(cluster.GetStatistics().clippedLightIndexCount > 0);
+}
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "Test.h"
+#include "../Library/Audio/MusicStream.h"
+
+namespace
+{
+	// 44.1kHz ステレオ 16bit の PCM WAV を書き出す
+	std::filesystem::path WriteWave(const char* name, size_t dataSize)
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+
+		auto u16 = [](std::vector<uint8_t>& out, uint16_t v) { out.push_back(v & 0xFF); out.push_back(v >> 8); };
+		auto u32 = [&](std::vector<uint8_t>& out, uint32_t v) { u16(out, v & 0xFFFF); u16(out, v >> 16); };
+
+		std::vector<uint8_t> bytes = { 'R','I','F','F' };
+		u32(bytes, static_cast<uint32_t>(36 + dataSize));
+		bytes.insert(bytes.end(), { 'W','A','V','E','f','m','t',' ' });
+		u32(bytes, 16);
+		u16(bytes, 1);			// PCM
+		u16(bytes, 2);			// channels
+		u32(bytes, 44100);
+		u32(bytes, 44100 * 4);
+		u16(bytes, 4);			// blockAlign
+		u16(bytes, 16);
+		bytes.insert(bytes.end(), { 'd','a','t','a' });
+		u32(bytes, static_cast<uint32_t>(dataSize));
+		for (size_t i = 0; i < dataSize; i++) bytes.push_back(static_cast<uint8_t>(i));
+
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		return path;
+	}
+}
+
+// FREE → FILLED → QUEUED → FREE と回り、最後まで読んだら終わる
+TEST(MusicStreamEndOfStream)
+{
+	// 2.5 バッファ分
+	const std::filesystem::path path = WriteWave("HSNLibTests_end.wav", MusicStream::BufferSize * 5 / 2);
+
+	MusicStream stream;
+	CHECK(stream.Open(path.wstring().c_str(), false, false));
+
+	// FREE → FILLED (3 つ目で最後まで読む、それ以上は埋めない)
+	CHECK(stream.Fill());
+	CHECK(stream.Fill());
+	CHECK(stream.Fill());
+	CHECK(!stream.Fill());
+	CHECK(!stream.IsFinished());
+
+	// FILLED → QUEUED
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	CHECK(stream.Acquire(data, size));
+	CHECK(size == MusicStream::BufferSize);
+	CHECK(data != nullptr && data[1] == 1);
+	CHECK(stream.Acquire(data, size));
+	CHECK(stream.Acquire(data, size));
+	CHECK(size == MusicStream::BufferSize / 2);
+	CHECK(!stream.Acquire(data, size));
+
+	// QUEUED → FREE (音声 API がまだ 1 つ持っている間は終わらない)
+	stream.Retire(1);
+	CHECK(!stream.IsFinished());
+	stream.Retire(0);
+	CHECK(stream.IsFinished());
+
+	stream.Close();
+	std::filesystem::remove(path);
+}
+
+// 空きがなければ埋めず、空きに戻したら埋められる
+// ループ時は最後まで来ても先頭からつなげて読み、終わらない
+TEST(MusicStreamLoop)
+{
+	const std::filesystem::path path = WriteWave("HSNLibTests_loop.wav", MusicStream::BufferSize * 3 / 2);
+
+	MusicStream stream;
+	CHECK(stream.Open(path.wstring().c_str(), true, false));
+
+	for (size_t i = 0; i < MusicStream::BufferCount; i++)
+	{
+		CHECK(stream.Fill());
+	}
+	CHECK(!stream.Fill());
+
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	for (int round = 0; round < 8; round++)
+	{
+		CHECK(stream.Acquire(data, size));
+		CHECK(size == MusicStream::BufferSize);
+		stream.Retire(0);
+		CHECK(stream.Fill());
+		CHECK(!stream.Fill());
+	}
+	CHECK(!stream.IsFinished());
+
+	stream.Close();
+	std::filesystem::remove(path);
+}
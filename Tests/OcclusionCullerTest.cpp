@@ -0,0 +1,127 @@
+#include <cmath>
+#include <algorithm>
+#include "Test.h"
+#include "../Library/3D/OcclusionCuller.h"
+#include "../Library/3D/Frustum.h"
+
+using namespace DirectX;
+
+namespace
+{
+	// 原点から +z を向いた視点 (左手系、縦 60 度、2:1、0.1 ~ 100)
+	void MakeCamera(XMFLOAT4X4& view, XMFLOAT4X4& projection)
+	{
+		const float n = 0.1f;
+		const float f = 100.0f;
+		const float yScale = 1.0f / std::tan(1.0471976f * 0.5f);
+
+		view = {};
+		view._11 = view._22 = view._33 = view._44 = 1.0f;
+
+		projection = {};
+		projection._11 = yScale / 2.0f;
+		projection._22 = yScale;
+		projection._33 = f / (f - n);
+		projection._34 = 1.0f;
+		projection._43 = -n * f / (f - n);
+	}
+
+	// z = 10 に幅 12・高さ 6 の壁を置いて深度バッファを作る (64x32)
+	OcclusionCuller& SetupWall()
+	{
+		OcclusionCuller& culler = OcclusionCuller::Instance();
+		culler.enable = true;
+		culler.Resize(64, 32);
+		culler.ClearOccluders();
+		culler.AddOccluder({ -6.0f, -3.0f, 10.0f }, { -6.0f, 3.0f, 10.0f }, { 6.0f, 3.0f, 10.0f });
+		culler.AddOccluder({ -6.0f, -3.0f, 10.0f }, { 6.0f, 3.0f, 10.0f }, { 6.0f, -3.0f, 10.0f });
+
+		XMFLOAT4X4 view, projection;
+		MakeCamera(view, projection);
+		culler.Update(view, projection);
+		return culler;
+	}
+}
+
+// 壁の真後ろの箱は隠れる
+TEST(OcclusionCullerHidesBoxBehindWall)
+{
+	OcclusionCuller& culler = SetupWall();
+	CHECK(culler.GetOccluderTriangleCount() == 2);
+	CHECK(!culler.IsVisible({ 0.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+}
+
+// 壁の横・壁の手前の箱は見える
+TEST(OcclusionCullerKeepsBoxBesideOrInFront)
+{
+	OcclusionCuller& culler = SetupWall();
+	CHECK(culler.IsVisible({ 16.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+	CHECK(culler.IsVisible({ 0.0f, 0.0f, 5.0f }, { 1.0f, 1.0f, 1.0f }));
+}
+
+// near 平面をまたぐ箱は投影できないので見える扱いのまま
+TEST(OcclusionCullerKeepsBoxCrossingNearPlane)
+{
+	OcclusionCuller& culler = SetupWall();
+	CHECK(culler.IsVisible({ 0.0f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.5f }));
+}
+
+// 上の段は 2x2 の最も奥の深度で、大きな箱は粗い段で判定される
+TEST(OcclusionCullerHiZLevels)
+{
+	OcclusionCuller& culler = SetupWall();
+	CHECK(culler.GetHiZLevelCount() > 3);
+
+	for (size_t level = 1; level < culler.GetHiZLevelCount(); level++)
+	{
+		const std::vector<float>& source = culler.GetHiZ(level - 1);
+		const std::vector<float>& destination = culler.GetHiZ(level);
+		const int sourceWidth = culler.GetHiZWidth(level - 1);
+		const int sourceHeight = culler.GetHiZHeight(level - 1);
+		const int destinationWidth = culler.GetHiZWidth(level);
+
+		bool match = true;
+		for (int y = 0; y < culler.GetHiZHeight(level); y++)
+		{
+			for (int x = 0; x < destinationWidth; x++)
+			{
+				float farthest = 0.0f;
+				for (int j = 0; j < 2; j++)
+				{
+					for (int i = 0; i < 2; i++)
+					{
+						const int sx = (std::min)(x * 2 + i, sourceWidth - 1);
+						const int sy = (std::min)(y * 2 + j, sourceHeight - 1);
+						farthest = (std::max)(farthest, source[static_cast<size_t>(sy) * sourceWidth + sx]);
+					}
+				}
+				if (destination[static_cast<size_t>(y) * destinationWidth + x] != farthest) match = false;
+			}
+		}
+		CHECK(match);
+	}
+
+	// 壁は画面全体を覆っていないので、最上段 (1x1) は最も奥のまま
+	CHECK(culler.GetHiZ(culler.GetHiZLevelCount() - 1).front() == 1.0f);
+
+	// 壁の中に収まる大きな箱は隠れ、壁からはみ出す大きな箱は見える
+	CHECK(!culler.IsVisible({ 0.0f, 0.0f, 30.0f }, { 6.0f, 3.0f, 1.0f }));
+	CHECK(culler.IsVisible({ 0.0f, 0.0f, 30.0f }, { 20.0f, 3.0f, 1.0f }));
+}
+
+// Cull は視錐台カリング済みのうち、隠れているものだけを見えない扱いにする
+TEST(OcclusionCullerCullsBatch)
+{
+	OcclusionCuller& culler = SetupWall();
+
+	FrustumCullingBatch batch;
+	const size_t hidden = batch.Add({ 0.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f });
+	const size_t beside = batch.Add({ 16.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f });
+	const size_t always = batch.AddAlwaysVisible();
+	batch.SetAllVisible();
+
+	culler.Cull(batch);
+	CHECK(!batch.IsVisible(hidden));
+	CHECK(batch.IsVisible(beside));
+	CHECK(batch.IsVisible(always));
+}
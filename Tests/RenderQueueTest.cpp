@@ -0,0 +1,190 @@
+#include "Test.h"
+#include "../Library/Graphics/RenderQueue.h"
+
+namespace
+{
+	// キーとステートを揃えたパケット
+	RenderQueue::Packet MakePacket(RenderKey::PASS pass, uint32_t pipeline, uint32_t material, uint32_t textureSet, float distance, uint32_t geometry)
+	{
+		RenderQueue::Packet packet;
+		packet.pipeline = pipeline;
+		packet.material = material;
+		packet.textureSet = textureSet;
+		packet.geometry = geometry;
+		packet.indexCount = 3;
+		packet.startIndexLocation = geometry;	// 描かれた順の確認用
+		packet.key = RenderKey::Make(pass, pipeline, 0, material, textureSet, RenderKey::QuantizeDepth(pass, distance, 1000.0f));
+		return packet;
+	}
+}
+
+// キーのフィールドは取り出せる
+TEST(RenderKeyFields)
+{
+	const uint64_t key = RenderKey::Make(RenderKey::SOLID_PASS, 0x12, 0x3, 0x4567, 0x89AB, 0xCDEF);
+	CHECK(RenderKey::GetPass(key) == RenderKey::SOLID_PASS);
+	CHECK(RenderKey::GetPipeline(key) == 0x12);
+	CHECK(RenderKey::GetRenderState(key) == 0x3);
+	CHECK(RenderKey::GetMaterial(key) == 0x4567);
+	CHECK(RenderKey::GetTextureSet(key) == 0x89AB);
+	CHECK(RenderKey::GetDepth(key) == 0xCDEF);
+
+	// 半透明は深度の位置が違っても同じ値が取り出せる
+	const uint64_t translucent = RenderKey::Make(RenderKey::TRANSLUCENT_PASS, 0x12, 0x3, 0x4567, 0x89AB, 0xCDEF);
+	CHECK(RenderKey::GetPass(translucent) == RenderKey::TRANSLUCENT_PASS);
+	CHECK(RenderKey::GetPipeline(translucent) == 0x12);
+	CHECK(RenderKey::GetRenderState(translucent) == 0x3);
+	CHECK(RenderKey::GetMaterial(translucent) == 0x4567);
+	CHECK(RenderKey::GetTextureSet(translucent) == 0x89AB);
+	CHECK(RenderKey::GetDepth(translucent) == 0xCDEF);
+}
+
+// パスが先、同じステートは手前から
+TEST(RenderQueueSortOrder)
+{
+	RenderQueue queue;
+	queue.Begin(0, 0, 0);
+	queue.Push(MakePacket(RenderKey::TRANSLUCENT_PASS, 0, 0, 0, 10.0f, 0));
+	queue.Push(MakePacket(RenderKey::SOLID_PASS, 1, 0, 0, 50.0f, 1));
+	queue.Push(MakePacket(RenderKey::SOLID_PASS, 0, 2, 0, 10.0f, 2));
+	queue.Push(MakePacket(RenderKey::SOLID_PASS, 0, 1, 0, 90.0f, 3));
+	queue.Push(MakePacket(RenderKey::SOLID_PASS, 0, 1, 0, 20.0f, 4));
+	queue.Push(MakePacket(RenderKey::SHADOW_PASS, 1, 0, 0, 0.0f, 5));
+	queue.End();
+	queue.Sort();
+
+	const uint32_t expected[] = { 5, 4, 3, 2, 1, 0 };
+	CHECK(queue.GetPacketCount() == 6);
+	for (size_t i = 0; i < 6; i++)
+	{
+		CHECK(queue.GetSortedPacket(i).geometry == expected[i]);
+	}
+}
+
+// 同じキーは積んだ順を保つ
+TEST(RenderQueueSortStable)
+{
+	RenderQueue queue;
+	queue.Begin(0, 0, 0);
+	for (uint32_t i = 0; i < 300; i++)
+	{
+		queue.Push(MakePacket(RenderKey::SOLID_PASS, i % 2, 0, 0, 0.0f, i));
+	}
+	queue.End();
+	queue.Sort();
+
+	for (size_t i = 1; i < 150; i++)
+	{
+		CHECK(queue.GetSortedPacket(i - 1).geometry < queue.GetSortedPacket(i).geometry);
+		CHECK(queue.GetSortedPacket(i - 1).pipeline == 0);
+	}
+}
+
+// 同じステートの再設定は省かれる
+TEST(RenderQueueSubmitSkipsRedundantBinds)
+{
+	RenderQueue queue;
+	queue.Begin(0, 0, 0);
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		queue.Push(MakePacket(RenderKey::SOLID_PASS, 0, i / 2, 0, static_cast<float>(i), i));
+	}
+	queue.End();
+	queue.Sort();
+
+	RecordingRenderBackend backend;
+	queue.Submit(backend);
+
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::BIND_PIPELINE) == 1);
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::BIND_MATERIAL) == 2);
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::BIND_TEXTURE_SET) == 1);
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::BIND_GEOMETRY) == 4);
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::DRAW_INDEXED) == 4);
+	CHECK(queue.GetStatistics().drawCalls == 4);
+}
+
+// 1 回の描画で使う定数はまとめて渡され、同じ位置なら渡し直さない
+TEST(RenderQueueSubmitGroupsConstants)
+{
+	RenderQueue queue;
+	queue.Begin(0, 0, 0);
+
+	const float object[16] = {};
+	const float skeleton[64] = {};
+	const uint32_t objectOffset = queue.PushConstants(object, sizeof(object));
+	const uint32_t skeletonOffset = queue.PushConstants(skeleton, sizeof(skeleton));
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		RenderQueue::Packet packet = MakePacket(RenderKey::SOLID_PASS, 0, 0, 0, 0.0f, 0);
+		packet.constantsOffset[RenderBackend::OBJECT_CONSTANTS] = objectOffset;
+		packet.constantsSize[RenderBackend::OBJECT_CONSTANTS] = sizeof(object);
+		packet.constantsOffset[RenderBackend::SKELETON_CONSTANTS] = skeletonOffset;
+		packet.constantsSize[RenderBackend::SKELETON_CONSTANTS] = sizeof(skeleton);
+		queue.Push(packet);
+	}
+	queue.End();
+	queue.Sort();
+
+	RecordingRenderBackend backend;
+	queue.Submit(backend);
+
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::UPDATE_CONSTANTS) == 1);
+	for (const RecordingRenderBackend::Command& command : backend.commands)
+	{
+		if (command.type != RecordingRenderBackend::COMMAND::UPDATE_CONSTANTS) continue;
+		CHECK(command.start == ((1u << RenderBackend::OBJECT_CONSTANTS) | (1u << RenderBackend::SKELETON_CONSTANTS)));
+		CHECK(command.value == sizeof(object) + sizeof(skeleton));
+	}
+}
+
+// 半透明はマテリアル・パイプラインが違っても奥から順に描かれる
+TEST(RenderQueueSubmitTranslucentBackToFront)
+{
+	RenderQueue queue;
+	queue.Begin(0, 0, 0);
+	queue.Push(MakePacket(RenderKey::TRANSLUCENT_PASS, 0, 1, 0, 10.0f, 0));
+	queue.Push(MakePacket(RenderKey::TRANSLUCENT_PASS, 1, 0, 0, 30.0f, 1));
+	queue.Push(MakePacket(RenderKey::TRANSLUCENT_PASS, 0, 0, 2, 20.0f, 2));
+	queue.Push(MakePacket(RenderKey::TRANSLUCENT_PASS, 0, 1, 0, 40.0f, 3));
+	queue.Push(MakePacket(RenderKey::SOLID_PASS, 0, 1, 0, 50.0f, 4));
+	queue.End();
+	queue.Sort();
+
+	RecordingRenderBackend backend;
+	queue.Submit(backend);
+
+	// 不透明が先、半透明は遠い順 (40 → 30 → 20 → 10)
+	const uint32_t expected[] = { 4, 3, 1, 2, 0 };
+	size_t drawIndex = 0;
+	for (const RecordingRenderBackend::Command& command : backend.commands)
+	{
+		if (command.type != RecordingRenderBackend::COMMAND::DRAW_INDEXED) continue;
+		CHECK(drawIndex < 5 && command.start == expected[drawIndex]);
+		drawIndex++;
+	}
+	CHECK(drawIndex == 5);
+}
+
+// 不透明は距離が入り混じっても同じステートがまとまる
+TEST(RenderQueueSubmitSolidGroupedByState)
+{
+	RenderQueue queue;
+	queue.Begin(0, 0, 0);
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		queue.Push(MakePacket(RenderKey::SOLID_PASS, 0, i % 2, 0, static_cast<float>(100 - i * 10), i));
+	}
+	queue.End();
+	queue.Sort();
+
+	RecordingRenderBackend backend;
+	queue.Submit(backend);
+
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::BIND_MATERIAL) == 2);
+	CHECK(Test::Count(backend.commands, RecordingRenderBackend::COMMAND::DRAW_INDEXED) == 8);
+
+	// 同じマテリアルの中では手前から
+	CHECK(queue.GetSortedPacket(0).geometry == 6);
+	CHECK(queue.GetSortedPacket(3).geometry == 0);
+	CHECK(queue.GetSortedPacket(4).geometry == 7);
+}
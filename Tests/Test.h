@@ -0,0 +1,37 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+//--------------------------------------------------------------
+// Test
+//--------------------------------------------------------------
+// GPU・音声デバイスなしで動く部分の確認用の最小のテスト実行
+// TEST(name) { ... } で登録し、CHECK が失敗したら場所を出して数える
+// (TestMain.cpp の main が全て実行し、失敗があれば 1 を返す)
+namespace Test
+{
+	using Function = void(*)();
+
+	// 登録 (静的初期化の時に行う)
+	struct Registrar
+	{
+		Registrar(const char* name, Function function);
+	};
+
+	// 失敗の記録
+	void Fail(const char* expression, const char* file, int line);
+
+	// 記録したコマンドのうち type の数 (RecordingRenderBackend・NullAudioBackend の commands)
+	template<class Command, class Type>
+	size_t Count(const std::vector<Command>& commands, Type type)
+	{
+		return static_cast<size_t>(std::count_if(commands.begin(), commands.end(), [type](const Command& command) { return command.type == type; }));
+	}
+}
+
+#define TEST(name) \
+	static void name(); \
+	static Test::Registrar name##Registrar(#name, name); \
+	static void name()
+
+#define CHECK(expression) ((expression) ? (void)0 : Test::Fail(#expression, __FILE__, __LINE__))
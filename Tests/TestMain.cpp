@@ -0,0 +1,49 @@
+#include <cstdio>
+#include <vector>
+#include "Test.h"
+
+namespace
+{
+	struct Entry
+	{
+		const char* name;
+		Test::Function function;
+	};
+
+	// 静的初期化の順番に依存しないように関数内で持つ
+	std::vector<Entry>& GetEntries()
+	{
+		static std::vector<Entry> entries;
+		return entries;
+	}
+
+	int failureCount = 0;
+}
+
+Test::Registrar::Registrar(const char* name, Function function)
+{
+	GetEntries().push_back({ name, function });
+}
+
+void Test::Fail(const char* expression, const char* file, int line)
+{
+	std::printf("  %s(%d): CHECK(%s) failed\n", file, line, expression);
+	++failureCount;
+}
+
+int main()
+{
+	int failedTests = 0;
+	for (const Entry& entry : GetEntries())
+	{
+		const int before = failureCount;
+		entry.function();
+
+		const bool passed = failureCount == before;
+		if (!passed) ++failedTests;
+		std::printf("[%s] %s\n", passed ? "  OK  " : "FAILED", entry.name);
+	}
+
+	std::printf("%zu tests, %d failed\n", GetEntries().size(), failedTests);
+	return failedTests == 0 ? 0 : 1;
+}
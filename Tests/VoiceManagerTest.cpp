@@ -0,0 +1,102 @@
+#include "Test.h"
+#include "../Library/Audio/VoiceManager.h"
+
+namespace
+{
+	VoiceManager::SoundSetting MakeSetting(int poolSize, int priority)
+	{
+		VoiceManager::SoundSetting setting;
+		setting.poolSize = poolSize;
+		setting.priority = priority;
+		return setting;
+	}
+}
+
+// 同じフレームの同じ音は 1 つにまとめる
+TEST(VoiceManagerMergesSameFrame)
+{
+	NullAudioBackend backend;
+	VoiceManager manager;
+	manager.SetBackend(&backend);
+	manager.RegisterSound(0, MakeSetting(4, 0));
+
+	const uint32_t first = manager.Play(0, false, 10.0f);
+	CHECK(manager.Play(0, false, 5.0f) == first);
+	CHECK(manager.GetActiveCount(0) == 1);
+	CHECK(Test::Count(backend.commands, NullAudioBackend::COMMAND::PLAY) == 1);
+
+	manager.Update();
+	CHECK(manager.GetStatistics().merged == 1);
+}
+
+// 音のプールが埋まっていたら、その音の中で一番古いものを止める
+TEST(VoiceManagerStealsOldestInPool)
+{
+	NullAudioBackend backend;
+	VoiceManager manager;
+	manager.SetBackend(&backend);
+	manager.RegisterSound(0, MakeSetting(2, 0));
+
+	const uint32_t first = manager.Play(0);
+	manager.Update();
+	const uint32_t second = manager.Play(0);
+	manager.Update();
+	CHECK(first != second);
+
+	// 距離が同じなら古い方が弱い
+	CHECK(manager.Play(0) == first);
+	CHECK(manager.GetActiveCount(0) == 2);
+	CHECK(Test::Count(backend.commands, NullAudioBackend::COMMAND::STOP) == 1);
+
+	// 遠すぎる新しい声は鳴らさない
+	manager.Update();
+	CHECK(manager.Play(0, false, 100.0f) == VoiceManager::InvalidVoice);
+	manager.Update();
+	CHECK(manager.GetStatistics().rejected == 1);
+}
+
+// 全体の上限を超えたら一番弱い声を止め、新しい方が弱ければ鳴らさない
+TEST(VoiceManagerStealsWeakestGlobally)
+{
+	NullAudioBackend backend;
+	VoiceManager manager;
+	manager.SetBackend(&backend);
+	manager.maxVoices = 2;
+	manager.RegisterSound(0, MakeSetting(4, 0));	// 弱い
+	manager.RegisterSound(1, MakeSetting(4, 5));	// 強い
+	manager.RegisterSound(2, MakeSetting(4, -1));	// もっと弱い
+
+	manager.Play(0);
+	manager.Play(1);
+	manager.Update();
+	CHECK(manager.GetTotalActiveCount() == 2);
+
+	// 優先度の低い音は止めてまで鳴らさない
+	CHECK(manager.Play(2) == VoiceManager::InvalidVoice);
+	CHECK(manager.GetActiveCount(0) == 1);
+
+	// 強い音は一番弱い音 (0) を止めて鳴らす
+	manager.Update();
+	CHECK(manager.Play(1) != VoiceManager::InvalidVoice);
+	CHECK(manager.GetActiveCount(0) == 0);
+	CHECK(manager.GetActiveCount(1) == 2);
+	CHECK(manager.GetTotalActiveCount() == 2);
+}
+
+// 鳴り終わった声は Update で空きに戻る
+TEST(VoiceManagerReleasesFinishedVoices)
+{
+	NullAudioBackend backend;
+	VoiceManager manager;
+	manager.SetBackend(&backend);
+	manager.RegisterSound(0, MakeSetting(1, 0));
+
+	const uint32_t voice = manager.Play(0);
+	CHECK(manager.IsInUse(0));
+
+	// 登録した声は 1 つだけなので、番号は backend の声と同じ
+	backend.Finish(voice);
+	manager.Update();
+	CHECK(!manager.IsInUse(0));
+	CHECK(manager.GetTotalActiveCount() == 0);
+}
@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "Test.h"
+#include "../Library/Audio/WaveStream.h"
+
+namespace
+{
+	// MS-ADPCM の WAV を書き出す (標準の 7 組の予測係数)
+	std::filesystem::path WriteAdpcmWave(const char* name, uint16_t channels, uint16_t blockAlign, uint16_t samplesPerBlock, const std::vector<uint8_t>& data)
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+		auto u16 = [](std::vector<uint8_t>& out, uint16_t v) { out.push_back(v & 0xFF); out.push_back(v >> 8); };
+		auto u32 = [&](std::vector<uint8_t>& out, uint32_t v) { u16(out, v & 0xFFFF); u16(out, v >> 16); };
+
+		const int16_t coefficients[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+
+		std::vector<uint8_t> fmt;
+		u16(fmt, 2);			// MS-ADPCM
+		u16(fmt, channels);
+		u32(fmt, 22050);
+		u32(fmt, 22050 * blockAlign / samplesPerBlock);
+		u16(fmt, blockAlign);
+		u16(fmt, 4);
+		u16(fmt, 32);			// cbSize
+		u16(fmt, samplesPerBlock);
+		u16(fmt, 7);
+		for (int16_t coefficient : coefficients) u16(fmt, static_cast<uint16_t>(coefficient));
+
+		std::vector<uint8_t> bytes = { 'R','I','F','F' };
+		u32(bytes, static_cast<uint32_t>(4 + 8 + fmt.size() + 8 + data.size()));
+		bytes.insert(bytes.end(), { 'W','A','V','E','f','m','t',' ' });
+		u32(bytes, static_cast<uint32_t>(fmt.size()));
+		bytes.insert(bytes.end(), fmt.begin(), fmt.end());
+		bytes.insert(bytes.end(), { 'd','a','t','a' });
+		u32(bytes, static_cast<uint32_t>(data.size()));
+		bytes.insert(bytes.end(), data.begin(), data.end());
+
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		return path;
+	}
+
+	// 最後まで読んで 16bit のサンプル列にする
+	std::vector<int16_t> ReadAll(const std::filesystem::path& path, WaveStream::Format& format)
+	{
+		WaveStream stream;
+		if (!stream.Open(path.wstring().c_str())) return {};
+		format = stream.GetFormat();
+
+		std::vector<uint8_t> buffer(1024);
+		const size_t size = stream.Read(buffer.data(), buffer.size(), false);
+		if (!stream.IsEnd()) return {};
+
+		std::vector<int16_t> samples(size / 2);
+		std::memcpy(samples.data(), buffer.data(), samples.size() * 2);
+		return samples;
+	}
+}
+
+// モノラル 1 ブロック (予測係数 1 番、ヘッダーの 2 サンプル + 4bit x 4)
+TEST(WaveStreamDecodesAdpcmMono)
+{
+	const std::vector<uint8_t> data =
+	{
+		1,				// predictor
+		20, 0,			// delta
+		100, 0,			// sample1
+		50, 0,			// sample2
+		0x12, 0xF8,		// +1, +2, -1, -8
+	};
+	const std::filesystem::path path = WriteAdpcmWave("HSNLibTests_adpcm_mono.wav", 1, 9, 6, data);
+
+	WaveStream::Format format;
+	const std::vector<int16_t> samples = ReadAll(path, format);
+	CHECK(format.channels == 1);
+	CHECK(format.bitsPerSample == 16);
+	CHECK(format.blockAlign == 2);
+
+	const std::vector<int16_t> expected = { 50, 100, 170, 274, 362, 322 };
+	CHECK(samples == expected);
+
+	std::filesystem::remove(path);
+}
+
+// ステレオ 1 ブロック (左右で別の予測係数、4bit は左右交互)
+TEST(WaveStreamDecodesAdpcmStereo)
+{
+	const std::vector<uint8_t> data =
+	{
+		0, 1,					// predictor L, R
+		16, 0, 32, 0,			// delta L, R
+		0xE8, 0x03, 0x9C, 0xFF,	// sample1 L = 1000, R = -100
+		0x84, 0x03, 0xCE, 0xFF,	// sample2 L = 900, R = -50
+		0x31, 0xE7,				// L +3, R +1, L -2, R +7
+	};
+	const std::filesystem::path path = WriteAdpcmWave("HSNLibTests_adpcm_stereo.wav", 2, 16, 4, data);
+
+	WaveStream::Format format;
+	const std::vector<int16_t> samples = ReadAll(path, format);
+	CHECK(format.channels == 2);
+	CHECK(format.blockAlign == 4);
+
+	const std::vector<int16_t> expected = { 900, -50, 1000, -100, 1048, -118, 1016, 60 };
+	CHECK(samples == expected);
+
+	std::filesystem::remove(path);
+}
+
+// 最後のブロックが blockAlign より短い場合は入っている分だけ展開する
+TEST(WaveStreamDecodesPartialAdpcmBlock)
+{
+	const std::vector<uint8_t> data =
+	{
+		// 1 ブロック目 (9 バイト、6 サンプル)
+		1, 20, 0, 100, 0, 50, 0, 0x12, 0xF8,
+		// 2 ブロック目 (8 バイトで終わる、ヘッダーの 2 サンプル + 4bit x 2)
+		0, 16, 0, 10, 0, 0xF6, 0xFF, 0x11,
+	};
+	const std::filesystem::path path = WriteAdpcmWave("HSNLibTests_adpcm_partial.wav", 1, 9, 6, data);
+
+	WaveStream::Format format;
+	const std::vector<int16_t> samples = ReadAll(path, format);
+
+	const std::vector<int16_t> expected = { 50, 100, 170, 274, 362, 322, -10, 10, 26, 42 };
+	CHECK(samples == expected);
+
+	std::filesystem::remove(path);
+}